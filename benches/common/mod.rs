@@ -0,0 +1,148 @@
+//! Helpers shared by the benchmarks.
+#![allow(dead_code)]
+use std::fs::read_to_string;
+use std::path::Path;
+use std::sync::Arc;
+
+use rand::{Rng, SeedableRng};
+use rand_chacha::ChaCha8Rng;
+
+use optirustic::core::utils::dummy_evaluator;
+use optirustic::core::{
+    BoundedNumber, Individual, Objective, ObjectiveDirection, Problem, VariableType,
+};
+use optirustic::utils::fast_non_dominated_sort;
+
+/// The Pagmo files used as fixed inputs for the hyper-volume benchmarks.
+/// See https://github.com/esa/pagmo2/tree/master/tests/hypervolume_test_data
+pub const PAGMO_FILES: [&str; 4] = [
+    "c_max_t100_d2_n128",
+    "c_max_t100_d3_n128",
+    "c_max_t1_d3_n2048",
+    "c_max_t1_d5_n1024",
+];
+
+/// The data for one test in a Pagmo file.
+pub struct PagmoTestData {
+    /// The objective values of each point.
+    pub objective_values: Vec<Vec<f64>>,
+    /// The reference point.
+    pub reference_point: Vec<f64>,
+    /// The expected hyper-volume.
+    pub hyper_volume: f64,
+}
+
+/// Parse a Pagmo test data file. The first line contains the number of tests; each test then
+/// contains the number of objectives, the number of points, the reference point, the points and
+/// the hyper-volume.
+///
+/// # Arguments
+///
+/// * `filename`: The name of the file in the `src/metrics/test_data` folder.
+///
+/// returns: `Vec<PagmoTestData>`
+pub fn parse_pagmo_file(filename: &str) -> Vec<PagmoTestData> {
+    let path = Path::new(env!("CARGO_MANIFEST_DIR"))
+        .join("src")
+        .join("metrics")
+        .join("test_data")
+        .join(filename);
+    let content = read_to_string(&path).unwrap_or_else(|_| panic!("Cannot read {:?}", path));
+    let parse_row = |line: &str| -> Vec<f64> {
+        line.split_whitespace()
+            .map(|v| v.parse::<f64>().unwrap())
+            .collect()
+    };
+
+    let mut lines = content.lines().skip(1).filter(|l| !l.trim().is_empty());
+    let mut all_data = vec![];
+    while lines.next().is_some() {
+        let total_points = lines.next().unwrap().trim().parse::<usize>().unwrap();
+        let reference_point = parse_row(lines.next().unwrap());
+        let objective_values = (0..total_points)
+            .map(|_| parse_row(lines.next().unwrap()))
+            .collect();
+        let hyper_volume = lines.next().unwrap().trim().parse::<f64>().unwrap();
+
+        all_data.push(PagmoTestData {
+            objective_values,
+            reference_point,
+            hyper_volume,
+        });
+    }
+    all_data
+}
+
+/// Create the individuals for a problem with minimised objectives from their objective values.
+///
+/// # Arguments
+///
+/// * `objective_values`: The objective values of each individual.
+///
+/// returns: `Vec<Individual>`
+pub fn individuals_from_values(objective_values: &[Vec<f64>]) -> Vec<Individual> {
+    let number_of_objectives = objective_values.first().map_or(0, |v| v.len());
+    let objectives = (0..number_of_objectives)
+        .map(|i| Objective::new(format!("obj{i}").as_str(), ObjectiveDirection::Minimise))
+        .collect();
+    let variables = vec![VariableType::Real(
+        BoundedNumber::new("X", 0.0, 1.0).unwrap(),
+    )];
+    let problem = Arc::new(Problem::new(objectives, variables, None, dummy_evaluator()).unwrap());
+
+    objective_values
+        .iter()
+        .map(|values| {
+            let mut individual = Individual::new(problem.clone());
+            for (i, value) in values.iter().enumerate() {
+                individual
+                    .update_objective(format!("obj{i}").as_str(), *value)
+                    .unwrap();
+            }
+            individual
+        })
+        .collect()
+}
+
+/// Create a population with random objective values in the unit hyper-cube.
+///
+/// # Arguments
+///
+/// * `number_of_individuals`: The number of individuals.
+/// * `number_of_objectives`: The number of objectives.
+///
+/// returns: `Vec<Individual>`
+pub fn random_individuals(
+    number_of_individuals: usize,
+    number_of_objectives: usize,
+) -> Vec<Individual> {
+    let mut rng = ChaCha8Rng::seed_from_u64(1);
+    let objective_values: Vec<Vec<f64>> = (0..number_of_individuals)
+        .map(|_| {
+            (0..number_of_objectives)
+                .map(|_| rng.gen::<f64>())
+                .collect()
+        })
+        .collect();
+    individuals_from_values(&objective_values)
+}
+
+/// Get the objective values of the non-dominated points. The hyper-volume backends working on
+/// the raw objective values expect the points on the Pareto front, which the metrics in
+/// `optirustic::metrics` extract before calling them.
+///
+/// # Arguments
+///
+/// * `objective_values`: The objective values of each point.
+///
+/// returns: `Vec<Vec<f64>>`
+pub fn non_dominated_values(objective_values: &[Vec<f64>]) -> Vec<Vec<f64>> {
+    let mut individuals = individuals_from_values(objective_values);
+    fast_non_dominated_sort(&mut individuals, true)
+        .unwrap()
+        .front_indexes
+        .remove(0)
+        .into_iter()
+        .map(|i| objective_values[i].clone())
+        .collect()
+}
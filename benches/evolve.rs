@@ -0,0 +1,78 @@
+//! Measure one full generation (reproduction, evaluation and survival) of each algorithm. NSGA2
+//! solves the ZDT1 problem with 30 variables and NSGA3 and its adaptive version solve the DTLZ1
+//! problem with 3 objectives. The algorithms are initialised once and each iteration evolves
+//! the population by one generation.
+//!
+//! Run with `cargo bench --features bench --bench evolve`. Criterion stores the estimates of
+//! each benchmark in `target/criterion/<group>/<benchmark>/new/estimates.json`; add
+//! `-- --save-baseline <name>` to store them as a named baseline.
+use criterion::{criterion_group, criterion_main, Criterion};
+
+use optirustic::algorithms::{
+    AdaptiveNSGA3, Algorithm, MaxGenerationValue, NSGA2Arg, NSGA3Arg, Nsga3NumberOfIndividuals,
+    StoppingConditionType, NSGA2, NSGA3,
+};
+use optirustic::core::builtin_problems::{DTLZ1Problem, ZTD1Problem};
+use optirustic::core::Problem;
+use optirustic::utils::NumberOfPartitions;
+
+/// The number of objectives of the DTLZ1 problem.
+const DTLZ1_OBJECTIVES: usize = 3;
+
+/// Get the NSGA3 options for the DTLZ1 problem.
+///
+/// returns: `NSGA3Arg`
+fn nsga3_args() -> NSGA3Arg {
+    NSGA3Arg {
+        number_of_individuals: Nsga3NumberOfIndividuals::EqualToReferencePointCount,
+        number_of_partitions: NumberOfPartitions::OneLayer(12),
+        crossover_operator_options: None,
+        mutation_operator_options: None,
+        stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(usize::MAX)),
+        parallel: Some(false),
+        export_history: None,
+        seed: Some(1),
+    }
+}
+
+/// Get the DTLZ1 problem.
+///
+/// returns: `Problem`
+fn dtlz1_problem() -> Problem {
+    // k = 5 as suggested in the DTLZ paper
+    DTLZ1Problem::create(DTLZ1_OBJECTIVES + 4, DTLZ1_OBJECTIVES, false).unwrap()
+}
+
+fn bench_evolve(c: &mut Criterion) {
+    let mut group = c.benchmark_group("evolve");
+    group.sample_size(20);
+
+    let args = NSGA2Arg {
+        number_of_individuals: 100,
+        stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(usize::MAX)),
+        crossover_operator_options: None,
+        mutation_operator_options: None,
+        parallel: Some(false),
+        export_history: None,
+        resume_from_file: None,
+        seed: Some(1),
+    };
+    let mut algorithm = NSGA2::new(ZTD1Problem::create(30).unwrap(), args).unwrap();
+    algorithm.initialise().unwrap();
+    group.bench_function("NSGA2_ZDT1", |b| b.iter(|| algorithm.evolve().unwrap()));
+
+    let mut algorithm = NSGA3::new(dtlz1_problem(), nsga3_args(), false).unwrap();
+    algorithm.initialise().unwrap();
+    group.bench_function("NSGA3_DTLZ1", |b| b.iter(|| algorithm.evolve().unwrap()));
+
+    let mut algorithm = AdaptiveNSGA3::new(dtlz1_problem(), nsga3_args()).unwrap();
+    algorithm.initialise().unwrap();
+    group.bench_function("AdaptiveNSGA3_DTLZ1", |b| {
+        b.iter(|| algorithm.evolve().unwrap())
+    });
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_evolve);
+criterion_main!(benches);
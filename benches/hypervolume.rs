@@ -0,0 +1,125 @@
+//! Measure the hyper-volume backends on the Pagmo test data files, which are used as fixed
+//! inputs so that the results can be compared across runs and machines. Each benchmark
+//! calculates the hyper-volume of all the tests in a file.
+//!
+//! The variant of the algorithm by Fonseca et al. (2006) used by
+//! `hv_fonseca_et_al_2006_sys::calculate_hv` is selected at build time with the `HV_VARIANT`
+//! environment variable (1 to 4, 4 by default). To compare the variants, run the benchmark once
+//! for each value, for example with:
+//!
+//! `HV_VARIANT=1 cargo bench --features bench --bench hypervolume -- calculate_hv`
+//!
+//! The variant is included in the benchmark name. Criterion stores the estimates of each
+//! benchmark in `target/criterion/<group>/<benchmark>/new/estimates.json`; add
+//! `-- --save-baseline <name>` to store them as a named baseline.
+use std::env;
+use std::hint::black_box;
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion};
+
+use hv_fonseca_et_al_2006_sys::calculate_hv;
+use optirustic::bench::{wfg_hyper_volume, Optimisation, Wfg};
+use optirustic::metrics::HyperVolume2D;
+
+use crate::common::{individuals_from_values, non_dominated_values, parse_pagmo_file, PAGMO_FILES};
+
+mod common;
+
+/// Assert that a calculated hyper-volume matches the value in the Pagmo file.
+///
+/// # Arguments
+///
+/// * `calculated`: The calculated value.
+/// * `expected`: The expected value.
+///
+/// returns: `()`
+fn check(calculated: f64, expected: f64) {
+    let tolerance = 1e-6 * expected.abs().max(1.0);
+    assert!(
+        (calculated - expected).abs() < tolerance,
+        "the hyper-volume {calculated} does not match {expected}"
+    );
+}
+
+fn bench_hypervolume_2d(c: &mut Criterion) {
+    let mut group = c.benchmark_group("hypervolume_2d");
+    for file in PAGMO_FILES.iter().filter(|f| f.contains("_d2_")) {
+        let all_data = parse_pagmo_file(file);
+        let mut all_individuals: Vec<_> = all_data
+            .iter()
+            .map(|d| individuals_from_values(&d.objective_values))
+            .collect();
+        group.bench_function(BenchmarkId::new("HyperVolume2D", file), |b| {
+            b.iter(|| {
+                for (individuals, data) in all_individuals.iter_mut().zip(&all_data) {
+                    let hv = HyperVolume2D::new(individuals, &data.reference_point)
+                        .unwrap()
+                        .compute();
+                    check(black_box(hv), data.hyper_volume);
+                }
+            })
+        });
+    }
+    group.finish();
+}
+
+fn bench_fonseca_2006(c: &mut Criterion) {
+    let variant = env::var("HV_VARIANT").unwrap_or("4".to_string());
+    let mut group = c.benchmark_group("calculate_hv");
+    group.sample_size(10);
+    // the HyperVolumeFonseca2006 metric only supports 3 or more objectives
+    for file in PAGMO_FILES.iter().filter(|f| !f.contains("_d2_")) {
+        let all_data = parse_pagmo_file(file);
+        let fronts: Vec<_> = all_data
+            .iter()
+            .map(|d| non_dominated_values(&d.objective_values))
+            .collect();
+        group.bench_function(BenchmarkId::new(format!("variant{variant}"), file), |b| {
+            b.iter(|| {
+                for (front, data) in fronts.iter().zip(&all_data) {
+                    let hv = calculate_hv(front, &data.reference_point);
+                    check(black_box(hv), data.hyper_volume);
+                }
+            })
+        });
+    }
+    group.finish();
+}
+
+fn bench_wfg(c: &mut Criterion) {
+    let mut group = c.benchmark_group("wfg");
+    group.sample_size(10);
+    for file in PAGMO_FILES {
+        let all_data = parse_pagmo_file(file);
+        let fronts: Vec<_> = all_data
+            .iter()
+            .map(|d| non_dominated_values(&d.objective_values))
+            .collect();
+        group.bench_function(BenchmarkId::new("O2", file), |b| {
+            b.iter(|| {
+                for (front, data) in fronts.iter().zip(&all_data) {
+                    let hv = Wfg::new(front, &data.reference_point, Optimisation::O2)
+                        .calculate()
+                        .unwrap();
+                    check(black_box(hv), data.hyper_volume);
+                }
+            })
+        });
+
+        let flat_fronts: Vec<Vec<f64>> = fronts.iter().map(|f| f.concat()).collect();
+        for (label, parallel) in [("flat", false), ("flat_parallel", true)] {
+            group.bench_function(BenchmarkId::new(label, file), |b| {
+                b.iter(|| {
+                    for (front, data) in flat_fronts.iter().zip(&all_data) {
+                        let hv = wfg_hyper_volume(front, &data.reference_point, parallel);
+                        check(black_box(hv), data.hyper_volume);
+                    }
+                })
+            });
+        }
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_hypervolume_2d, bench_fonseca_2006, bench_wfg);
+criterion_main!(benches);
@@ -0,0 +1,83 @@
+//! Compare the non-dominated sorting methods on random populations with 2, 3 and 5 objectives.
+//!
+//! Run with `cargo bench --bench non_dominated_sort`.
+use std::sync::Arc;
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion};
+use rand::{Rng, SeedableRng};
+use rand_chacha::ChaCha8Rng;
+
+use optirustic::core::utils::dummy_evaluator;
+use optirustic::core::{
+    BoundedNumber, Individual, Objective, ObjectiveDirection, Problem, VariableType,
+};
+use optirustic::utils::{non_dominated_sort_with, NonDominatedSortMethod};
+
+/// Create a population with random objective values in the unit hyper-cube.
+///
+/// # Arguments
+///
+/// * `number_of_individuals`: The number of individuals.
+/// * `number_of_objectives`: The number of objectives.
+///
+/// returns: `Vec<Individual>`
+fn random_individuals(
+    number_of_individuals: usize,
+    number_of_objectives: usize,
+) -> Vec<Individual> {
+    let objectives = (0..number_of_objectives)
+        .map(|i| Objective::new(format!("obj{i}").as_str(), ObjectiveDirection::Minimise))
+        .collect();
+    let variables = vec![VariableType::Real(
+        BoundedNumber::new("X", 0.0, 1.0).unwrap(),
+    )];
+    let problem = Arc::new(Problem::new(objectives, variables, None, dummy_evaluator()).unwrap());
+
+    let mut rng = ChaCha8Rng::seed_from_u64(1);
+    (0..number_of_individuals)
+        .map(|_| {
+            let mut individual = Individual::new(problem.clone());
+            for i in 0..number_of_objectives {
+                individual
+                    .update_objective(format!("obj{i}").as_str(), rng.gen::<f64>())
+                    .unwrap();
+            }
+            individual
+        })
+        .collect()
+}
+
+fn bench_sorting(c: &mut Criterion) {
+    for number_of_objectives in [2, 3, 5] {
+        let mut group = c.benchmark_group(format!("non_dominated_sort_{number_of_objectives}obj"));
+        group.sample_size(10);
+        for number_of_individuals in [1_000, 5_000, 20_000] {
+            let mut individuals = random_individuals(number_of_individuals, number_of_objectives);
+            for method in [
+                NonDominatedSortMethod::Deb,
+                NonDominatedSortMethod::EnsSequential,
+                NonDominatedSortMethod::EnsBinary,
+                NonDominatedSortMethod::JensenFortin,
+                NonDominatedSortMethod::Auto,
+            ] {
+                // the O(N^2) memory of the NSGA2 sort makes the largest population too slow
+                if method == NonDominatedSortMethod::Deb && number_of_individuals > 5_000 {
+                    continue;
+                }
+                group.bench_with_input(
+                    BenchmarkId::new(format!("{method:?}"), number_of_individuals),
+                    &method,
+                    |b, method| {
+                        b.iter(|| {
+                            non_dominated_sort_with(&mut individuals, false, *method).unwrap()
+                        })
+                    },
+                );
+            }
+        }
+        group.finish();
+    }
+}
+
+criterion_group!(benches, bench_sorting);
+criterion_main!(benches);
@@ -0,0 +1,99 @@
+//! Measure the NSGA3 survival steps (normalisation, association to the reference points and
+//! niching) separately, on random populations with 3, 5 and 8 objectives. The population size
+//! is twice the number of reference points, as in the merged population of parents and
+//! offsprings at each generation.
+//!
+//! Run with `cargo bench --features bench --bench nsga3`. Criterion stores the estimates of
+//! each benchmark in `target/criterion/<group>/<benchmark>/new/estimates.json`; add
+//! `-- --save-baseline <name>` to store them as a named baseline.
+use criterion::{criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion};
+use rand::{RngCore, SeedableRng};
+use rand_chacha::ChaCha8Rng;
+
+use optirustic::bench::{nsga3_associate, nsga3_niching, nsga3_normalise};
+use optirustic::core::Population;
+use optirustic::utils::{DasDarren1998, NumberOfPartitions};
+
+use crate::common::random_individuals;
+
+mod common;
+
+/// The number of objectives and the number of partitions used to generate the reference points.
+const CASES: [(usize, usize); 3] = [(3, 12), (5, 6), (8, 3)];
+
+fn bench_survival(c: &mut Criterion) {
+    let mut group = c.benchmark_group("nsga3");
+    for (number_of_objectives, partitions) in CASES {
+        let reference_points = DasDarren1998::new(
+            number_of_objectives,
+            &NumberOfPartitions::OneLayer(partitions),
+        )
+        .unwrap()
+        .get_weights();
+        let number_of_individuals = 2 * reference_points.len();
+        let individuals = random_individuals(number_of_individuals, number_of_objectives);
+        let parameter = format!("{number_of_objectives}obj_{number_of_individuals}ind");
+
+        group.bench_function(BenchmarkId::new("Normalise", &parameter), |b| {
+            b.iter_batched(
+                || {
+                    (
+                        vec![f64::INFINITY; number_of_objectives],
+                        individuals.clone(),
+                    )
+                },
+                |(mut ideal_point, mut individuals)| {
+                    nsga3_normalise(&mut ideal_point, &mut individuals).unwrap()
+                },
+                BatchSize::SmallInput,
+            )
+        });
+
+        // the association needs the normalised objectives
+        let mut normalised = individuals.clone();
+        nsga3_normalise(
+            &mut vec![f64::INFINITY; number_of_objectives],
+            &mut normalised,
+        )
+        .unwrap();
+        group.bench_function(BenchmarkId::new("AssociateToRefPoint", &parameter), |b| {
+            b.iter_batched_ref(
+                || normalised.clone(),
+                |individuals| nsga3_associate(individuals, &reference_points).unwrap(),
+                BatchSize::SmallInput,
+            )
+        });
+
+        // split the associated population in half, as if the second half were the last front,
+        // and select half of the last front with the niching
+        let mut associated = normalised.clone();
+        let reference_point_indexes = nsga3_associate(&mut associated, &reference_points).unwrap();
+        let potential = associated.split_off(number_of_individuals / 2);
+        let selected = Population::new_with(associated);
+        group.bench_function(BenchmarkId::new("Niching", &parameter), |b| {
+            b.iter_batched(
+                || {
+                    let rng: Box<dyn RngCore + Send> = Box::new(ChaCha8Rng::seed_from_u64(1));
+                    (selected.clone(), potential.clone(), rng)
+                },
+                |(mut selected, mut potential, mut rng)| {
+                    let number_to_add = potential.len() / 2;
+                    nsga3_niching(
+                        &mut selected,
+                        &mut potential,
+                        number_to_add,
+                        &reference_point_indexes[..number_of_individuals / 2],
+                        reference_points.len(),
+                        &mut rng,
+                    )
+                    .unwrap()
+                },
+                BatchSize::SmallInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_survival);
+criterion_main!(benches);
@@ -0,0 +1,70 @@
+//! Measure the ranking of a population with the fast non-dominated sorting and the NSGA2
+//! crowding distance of the first front, for random populations of different sizes and number
+//! of objectives.
+//!
+//! Run with `cargo bench --features bench --bench ranking`. Criterion stores the estimates of
+//! each benchmark in `target/criterion/<group>/<benchmark>/new/estimates.json`; add
+//! `-- --save-baseline <name>` to store them as a named baseline and
+//! `-- --baseline <name>` to compare a later run against it.
+use criterion::{criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion};
+
+use optirustic::bench::set_crowding_distance;
+use optirustic::utils::fast_non_dominated_sort;
+
+use crate::common::random_individuals;
+
+mod common;
+
+/// The population sizes.
+const NUMBER_OF_INDIVIDUALS: [usize; 3] = [100, 1_000, 5_000];
+
+/// The number of objectives.
+const NUMBER_OF_OBJECTIVES: [usize; 3] = [2, 3, 5];
+
+fn bench_fast_non_dominated_sort(c: &mut Criterion) {
+    for number_of_objectives in NUMBER_OF_OBJECTIVES {
+        let mut group =
+            c.benchmark_group(format!("fast_non_dominated_sort_{number_of_objectives}obj"));
+        group.sample_size(10);
+        for number_of_individuals in NUMBER_OF_INDIVIDUALS {
+            let mut individuals = random_individuals(number_of_individuals, number_of_objectives);
+            group.bench_function(BenchmarkId::from_parameter(number_of_individuals), |b| {
+                b.iter(|| fast_non_dominated_sort(&mut individuals, false).unwrap())
+            });
+        }
+        group.finish();
+    }
+}
+
+fn bench_crowding_distance(c: &mut Criterion) {
+    for number_of_objectives in NUMBER_OF_OBJECTIVES {
+        let mut group =
+            c.benchmark_group(format!("set_crowding_distance_{number_of_objectives}obj"));
+        for number_of_individuals in NUMBER_OF_INDIVIDUALS {
+            // the distance is calculated on the first front only, as in the algorithm
+            let mut individuals = random_individuals(number_of_individuals, number_of_objectives);
+            let front = fast_non_dominated_sort(&mut individuals, true)
+                .unwrap()
+                .fronts
+                .remove(0);
+            group.bench_function(
+                BenchmarkId::new("first_front", number_of_individuals),
+                |b| {
+                    b.iter_batched_ref(
+                        || front.clone(),
+                        |front| set_crowding_distance(front).unwrap(),
+                        BatchSize::SmallInput,
+                    )
+                },
+            );
+        }
+        group.finish();
+    }
+}
+
+criterion_group!(
+    benches,
+    bench_fast_non_dominated_sort,
+    bench_crowding_distance
+);
+criterion_main!(benches);
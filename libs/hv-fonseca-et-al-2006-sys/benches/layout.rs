@@ -0,0 +1,125 @@
+//! Compare the run time of the pointer-based node layout ([`HvContext::calculate_matrix`]) with
+//! the structure-of-arrays layout ([`HvContext::calculate_matrix_soa`]) on the Pagmo test data
+//! stored in the `optirustic` crate.
+//!
+//! Run with `cargo bench -p hv-fonseca-et-al-2006-sys --bench layout`.
+use std::fs::read_to_string;
+use std::hint::black_box;
+use std::path::Path;
+use std::time::{Duration, Instant};
+
+use hv_fonseca_et_al_2006_sys::{HvContext, ObjectiveMatrix};
+
+/// The Pagmo files to use in the benchmark.
+const FILES: [&str; 4] = [
+    "c_max_t100_d2_n128",
+    "c_max_t100_d3_n128",
+    "c_max_t1_d3_n2048",
+    "c_max_t1_d5_n1024",
+];
+
+/// The number of times each set is calculated.
+const REPETITIONS: usize = 5;
+
+/// The data for one test in a Pagmo file.
+struct TestData {
+    /// The number of objectives.
+    number_of_objectives: usize,
+    /// The flat row-major objective values.
+    objective_values: Vec<f64>,
+    /// The reference point.
+    reference_point: Vec<f64>,
+    /// The expected hyper-volume.
+    hyper_volume: f64,
+}
+
+/// Parse a Pagmo test data file. The first line contains the number of tests; each test then
+/// contains the number of objectives, the number of points, the reference point, the points and
+/// the hyper-volume.
+///
+/// # Arguments
+///
+/// * `filename`: The name of the file in the test data folder.
+///
+/// returns: `Vec<TestData>`
+fn parse_file(filename: &str) -> Vec<TestData> {
+    let path = Path::new(env!("CARGO_MANIFEST_DIR"))
+        .join("../../src/metrics/test_data")
+        .join(filename);
+    let content = read_to_string(&path).unwrap_or_else(|_| panic!("Cannot read {:?}", path));
+    let parse_row = |line: &str| -> Vec<f64> {
+        line.split_whitespace()
+            .map(|v| v.parse::<f64>().unwrap())
+            .collect()
+    };
+
+    let mut lines = content.lines().skip(1).filter(|l| !l.trim().is_empty());
+    let mut all_data = vec![];
+    while let Some(line) = lines.next() {
+        let number_of_objectives = line.trim().parse::<usize>().unwrap();
+        let total_points = lines.next().unwrap().trim().parse::<usize>().unwrap();
+        let reference_point = parse_row(lines.next().unwrap());
+        let mut objective_values = Vec::with_capacity(total_points * number_of_objectives);
+        for _ in 0..total_points {
+            objective_values.extend(parse_row(lines.next().unwrap()));
+        }
+        let hyper_volume = lines.next().unwrap().trim().parse::<f64>().unwrap();
+
+        all_data.push(TestData {
+            number_of_objectives,
+            objective_values,
+            reference_point,
+            hyper_volume,
+        });
+    }
+    all_data
+}
+
+/// Time a calculation over all the tests in a file.
+///
+/// # Arguments
+///
+/// * `all_data`: The tests.
+/// * `calculate`: The function calculating the hyper-volume.
+///
+/// returns: `Duration`. The total time.
+fn time_layout(
+    all_data: &[TestData],
+    mut calculate: impl FnMut(&ObjectiveMatrix, &[f64]) -> f64,
+) -> Duration {
+    let start = Instant::now();
+    for _ in 0..REPETITIONS {
+        for data in all_data {
+            let matrix = ObjectiveMatrix::new(
+                &data.objective_values,
+                data.objective_values.len() / data.number_of_objectives,
+                data.number_of_objectives,
+            )
+            .unwrap();
+            let hv = calculate(&matrix, &data.reference_point);
+            let tolerance = 1e-6 * data.hyper_volume.abs().max(1.0);
+            assert!((black_box(hv) - data.hyper_volume).abs() < tolerance);
+        }
+    }
+    start.elapsed()
+}
+
+fn main() {
+    println!(
+        "{:<20} {:>14} {:>14} {:>8}",
+        "file", "pointers [ms]", "SoA [ms]", "speed-up"
+    );
+    for file in FILES {
+        let all_data = parse_file(file);
+        let mut ctx = HvContext::new();
+        let pointers = time_layout(&all_data, |m, r| ctx.calculate_matrix(m, r));
+        let soa = time_layout(&all_data, |m, r| ctx.calculate_matrix_soa(m, r));
+        println!(
+            "{:<20} {:>14.3} {:>14.3} {:>8.2}",
+            file,
+            pointers.as_secs_f64() * 1000.0,
+            soa.as_secs_f64() * 1000.0,
+            pointers.as_secs_f64() / soa.as_secs_f64()
+        );
+    }
+}
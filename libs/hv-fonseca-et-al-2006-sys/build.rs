@@ -1,7 +1,7 @@
 extern crate bindgen;
 
 use std::env;
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
 
 fn main() {
     let versions: [String; 2] = ["hv-1.3-src".to_string(), "hv-2.0rc2-src".to_string()];
@@ -21,9 +21,62 @@ fn main() {
         .write_to_file(file)
         .expect("Couldn't write 'hv' bindings");
 
-    // Compile library with version #4 - see section IV of the paper
+    // Compile library with version #4 - see section IV of the paper. A different version can be
+    // selected with the HV_VARIANT environment variable (for example to compare the versions)
+    println!("cargo:rerun-if-env-changed=HV_VARIANT");
+    let variant = env::var("HV_VARIANT").unwrap_or("4".to_string());
+    if !["1", "2", "3", "4"].contains(&variant.as_str()) {
+        panic!(
+            "HV_VARIANT must be either 1, 2, 3 or 4, but '{}' was given",
+            variant
+        );
+    }
     cc::Build::new()
-        .define("VARIANT", "4")
+        .define("VARIANT", variant.as_str())
         .file(lib_path.join("hv.c"))
         .compile("hv-fonseca-et-al-2006-sys");
+
+    if env::var_os("CARGO_FEATURE_CLI").is_some() {
+        build_cli(&lib_path, &variant);
+    }
+}
+
+/// Compile the `hv` command-line tool, including its multi-threaded batch mode, into the output
+/// directory and export its path in the `HV_CLI_PATH` variable at compile time.
+///
+/// # Arguments
+///
+/// * `lib_path`: The path to the library source.
+/// * `variant`: The algorithm version to use.
+///
+/// returns: `()`
+fn build_cli(lib_path: &Path, variant: &str) {
+    if env::var_os("CARGO_CFG_UNIX").is_none() {
+        println!("cargo:warning=The 'hv' command-line tool can only be built on Unix targets");
+        return;
+    }
+
+    let binary = PathBuf::from(env::var("OUT_DIR").unwrap()).join("hv");
+    let mut command = cc::Build::new().opt_level(3).get_compiler().to_command();
+    command.args([
+        "-std=gnu99",
+        "-D_GNU_SOURCE",
+        "-DDEBUG=0",
+        "-DVERSION=\"2.0rc2\"",
+    ]);
+    command.arg(format!("-DVARIANT={}", variant));
+    for file in ["main-hv.c", "io.c", "timer.c", "batch.c", "hv.c"] {
+        let file = lib_path.join(file);
+        println!("cargo:rerun-if-changed={}", file.display());
+        command.arg(file);
+    }
+    command.arg("-o").arg(&binary).args(["-pthread", "-lm"]);
+
+    let status = command
+        .status()
+        .expect("Cannot run the compiler for the 'hv' command-line tool");
+    if !status.success() {
+        panic!("Cannot compile the 'hv' command-line tool");
+    }
+    println!("cargo:rustc-env=HV_CLI_PATH={}", binary.display());
 }
@@ -0,0 +1,466 @@
+use crate::{HvContext, ObjectiveMatrix};
+
+/// Track the hyper-volume of a set of points with 3 objectives, when points are added or removed
+/// one at a time. Instead of calculating the metric of the whole set after each change, the
+/// value is updated with the exclusive contribution of the point being added or removed.
+///
+/// The set keeps its non-dominated points (the front) sorted by the third objective, so that the
+/// contribution of a point `p` is calculated with a sweep along this objective: the points of the
+/// front are projected onto the box between `p` and the reference point and added, one slab at a
+/// time, to a 2D staircase whose covered area is updated as each point is inserted. The sweep
+/// stops at the first point dominating `p` on the first two objectives, after which `p` has no
+/// exclusive volume, so only the region of the front around `p` is visited. The dominated points
+/// are stored separately and only checked when a point of the front is removed, to find the
+/// points that become non-dominated.
+///
+/// Finding the points of the front dominated by an inserted point, or the dominated points
+/// promoted by a removal, is linear in the size of the set but only compares coordinates, while
+/// the sweep is O(`k log k`) where `k` is the number of visited points (at most the front size).
+/// The exact hyper-volume of the set is calculated with [`HvContext`] only by
+/// [`IncrementalHv3D::recompute`].
+///
+/// **IMPLEMENTATION NOTES**:
+/// 1) All objectives are assumed to be minimised.
+/// 2) The set may contain dominated points or points that do not dominate the reference point;
+///    their contribution is 0.
+/// 3) Rounding errors may accumulate after many updates. Use [`IncrementalHv3D::recompute`] to
+///    reset the value to the exact hyper-volume of the set.
+///
+/// # Examples
+///
+/// ```
+/// use hv_fonseca_et_al_2006_sys::IncrementalHv3D;
+/// let mut hv = IncrementalHv3D::new([3.0, 3.0, 3.0]);
+/// hv.insert([1.0, 1.0, 1.0]);
+/// hv.insert([2.0, 2.0, 0.5]);
+/// assert_eq!(hv.value(), 8.5);
+/// hv.remove(&[1.0, 1.0, 1.0]);
+/// assert_eq!(hv.value(), 2.5);
+/// ```
+#[derive(Debug)]
+pub struct IncrementalHv3D {
+    /// The context used to recompute the hyper-volume.
+    ctx: HvContext,
+    /// The reference point.
+    reference_point: [f64; 3],
+    /// The non-dominated points that dominate the reference point, sorted by the third objective.
+    front: Vec<[f64; 3]>,
+    /// The points weakly dominated by a point in the front, including duplicates.
+    dominated: Vec<[f64; 3]>,
+    /// The points that do not dominate the reference point.
+    outside: Vec<[f64; 3]>,
+    /// The buffer with the 2D staircase used by the sweep.
+    staircase: Vec<[f64; 2]>,
+    /// The current hyper-volume.
+    value: f64,
+}
+
+impl IncrementalHv3D {
+    /// Create an empty set.
+    ///
+    /// # Arguments
+    ///
+    /// * `reference_point`: The reference or anti-optimal point to use in the calculation.
+    ///
+    /// returns: `IncrementalHv3D`
+    pub fn new(reference_point: [f64; 3]) -> Self {
+        Self {
+            ctx: HvContext::new(),
+            reference_point,
+            front: Vec::new(),
+            dominated: Vec::new(),
+            outside: Vec::new(),
+            staircase: Vec::new(),
+            value: 0.0,
+        }
+    }
+
+    /// Add a point to the set and update the hyper-volume.
+    ///
+    /// # Arguments
+    ///
+    /// * `point`: The point to add.
+    ///
+    /// returns: `f64`. The exclusive contribution of the new point to the hyper-volume.
+    pub fn insert(&mut self, point: [f64; 3]) -> f64 {
+        if !self.is_inside(&point) {
+            self.outside.push(point);
+            return 0.0;
+        }
+        if self.front.iter().any(|q| weakly_dominates(q, &point)) {
+            self.dominated.push(point);
+            return 0.0;
+        }
+
+        let contribution = self.contribution(&point);
+        // the points dominated by the new one leave the front
+        let dominated = &mut self.dominated;
+        self.front.retain(|q| {
+            let is_dominated = weakly_dominates(&point, q);
+            if is_dominated {
+                dominated.push(*q);
+            }
+            !is_dominated
+        });
+        self.insert_in_front(point);
+
+        self.value += contribution;
+        contribution
+    }
+
+    /// Remove a point from the set and update the hyper-volume. If the point was added more than
+    /// once, only one copy is removed.
+    ///
+    /// # Arguments
+    ///
+    /// * `point`: The point to remove.
+    ///
+    /// returns: `Option<f64>`. The exclusive contribution of the point to the hyper-volume or
+    /// `None` if the point is not in the set.
+    pub fn remove(&mut self, point: &[f64; 3]) -> Option<f64> {
+        if !self.is_inside(point) {
+            let index = self.outside.iter().position(|q| q == point)?;
+            self.outside.swap_remove(index);
+            return Some(0.0);
+        }
+        // a copy in the dominated points is weakly dominated by a point that stays in the front
+        if let Some(index) = self.dominated.iter().position(|q| q == point) {
+            self.dominated.swap_remove(index);
+            return Some(0.0);
+        }
+        let index = self.front_position(point)?;
+        self.front.remove(index);
+
+        // promote the dominated points that were only dominated by the removed point. These are
+        // visited by increasing sum of the coordinates, so that a point is visited after all
+        // the points dominating it
+        let mut candidates: Vec<usize> = (0..self.dominated.len())
+            .filter(|&i| weakly_dominates(point, &self.dominated[i]))
+            .collect();
+        candidates.sort_by(|&a, &b| {
+            let sum = |i: usize| self.dominated[i].iter().sum::<f64>();
+            sum(a).total_cmp(&sum(b))
+        });
+        let mut promoted: Vec<usize> = Vec::new();
+        for i in candidates {
+            let q = self.dominated[i];
+            let is_dominated = self.front.iter().any(|f| weakly_dominates(f, &q))
+                || promoted
+                    .iter()
+                    .any(|&j| weakly_dominates(&self.dominated[j], &q));
+            if !is_dominated {
+                promoted.push(i);
+            }
+        }
+        promoted.sort_unstable_by(|a, b| b.cmp(a));
+        for i in promoted {
+            let q = self.dominated.swap_remove(i);
+            self.insert_in_front(q);
+        }
+
+        let contribution = self.contribution(point);
+        self.value = if self.front.is_empty() {
+            0.0
+        } else {
+            (self.value - contribution).max(0.0)
+        };
+        Some(contribution)
+    }
+
+    /// Get the hyper-volume of the set.
+    ///
+    /// returns: `f64`
+    pub fn value(&self) -> f64 {
+        self.value
+    }
+
+    /// Get the number of points in the set.
+    ///
+    /// returns: `usize`
+    pub fn len(&self) -> usize {
+        self.front.len() + self.dominated.len() + self.outside.len()
+    }
+
+    /// Whether the set is empty.
+    ///
+    /// returns: `bool`
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Get the non-dominated points in the set that dominate the reference point, sorted by the
+    /// third objective.
+    ///
+    /// returns: `ObjectiveMatrix`
+    pub fn front(&self) -> ObjectiveMatrix<'_> {
+        ObjectiveMatrix::new(self.front.as_flattened(), self.front.len(), 3).unwrap()
+    }
+
+    /// Get all the points in the set. The non-dominated points are returned first.
+    ///
+    /// returns: `Vec<[f64; 3]>`
+    pub fn points(&self) -> Vec<[f64; 3]> {
+        [self.front.as_slice(), &self.dominated, &self.outside].concat()
+    }
+
+    /// Get the reference point.
+    ///
+    /// returns: `[f64; 3]`
+    pub fn reference_point(&self) -> [f64; 3] {
+        self.reference_point
+    }
+
+    /// Calculate the exact hyper-volume of the set from scratch and use it as the new value. Only
+    /// the non-dominated points are used.
+    ///
+    /// returns: `f64`. The hyper-volume.
+    pub fn recompute(&mut self) -> f64 {
+        self.value = if self.front.is_empty() {
+            0.0
+        } else {
+            let front = self.front.as_flattened();
+            let matrix = ObjectiveMatrix::new(front, self.front.len(), 3).unwrap();
+            self.ctx.calculate_matrix(&matrix, &self.reference_point)
+        };
+        self.value
+    }
+
+    /// Whether a point strictly dominates the reference point.
+    ///
+    /// # Arguments
+    ///
+    /// * `point`: The point.
+    ///
+    /// returns: `bool`
+    fn is_inside(&self, point: &[f64; 3]) -> bool {
+        point
+            .iter()
+            .zip(self.reference_point.iter())
+            .all(|(p, r)| p < r)
+    }
+
+    /// Add a point to the front, keeping the points sorted by the third objective.
+    ///
+    /// # Arguments
+    ///
+    /// * `point`: The point.
+    fn insert_in_front(&mut self, point: [f64; 3]) {
+        let index = self.front.partition_point(|q| q[2] <= point[2]);
+        self.front.insert(index, point);
+    }
+
+    /// Find a point in the front.
+    ///
+    /// # Arguments
+    ///
+    /// * `point`: The point.
+    ///
+    /// returns: `Option<usize>`. The index of the point in the front.
+    fn front_position(&self, point: &[f64; 3]) -> Option<usize> {
+        let start = self.front.partition_point(|q| q[2] < point[2]);
+        self.front[start..]
+            .iter()
+            .take_while(|q| q[2] == point[2])
+            .position(|q| q == point)
+            .map(|i| start + i)
+    }
+
+    /// Calculate the exclusive contribution of a point, which dominates the reference point, with
+    /// respect to the front, which must not contain the point. The volume of the box between the
+    /// point and the reference point is swept along the third objective: at each point of the
+    /// front, the area of the slab not covered by the front points below it is multiplied by the
+    /// slab height.
+    ///
+    /// # Arguments
+    ///
+    /// * `point`: The point.
+    ///
+    /// returns: `f64`
+    fn contribution(&mut self, point: &[f64; 3]) -> f64 {
+        let [rx, ry, rz] = self.reference_point;
+        let box_area = (rx - point[0]) * (ry - point[1]);
+        let staircase = &mut self.staircase;
+        staircase.clear();
+
+        let mut covered = 0.0;
+        let mut volume = 0.0;
+        let mut z = point[2];
+        for q in self.front.iter() {
+            if q[2] > z {
+                volume += (box_area - covered).max(0.0) * (q[2] - z);
+                z = q[2];
+            }
+            // a point dominating the box on the first two objectives covers the following slabs
+            if q[0] <= point[0] && q[1] <= point[1] {
+                return volume;
+            }
+            covered += add_to_staircase(
+                staircase,
+                [q[0].max(point[0]), q[1].max(point[1])],
+                [rx, ry],
+            );
+        }
+        volume + (box_area - covered).max(0.0) * (rz - z)
+    }
+}
+
+/// Whether a point is not worse than another point in all the objectives.
+///
+/// # Arguments
+///
+/// * `a`: The first point.
+/// * `b`: The second point.
+///
+/// returns: `bool`
+fn weakly_dominates(a: &[f64; 3], b: &[f64; 3]) -> bool {
+    a[0] <= b[0] && a[1] <= b[1] && a[2] <= b[2]
+}
+
+/// Add a point to a 2D staircase of non-dominated points, sorted by increasing first coordinate
+/// (and decreasing second coordinate), and remove the points it dominates.
+///
+/// # Arguments
+///
+/// * `staircase`: The staircase.
+/// * `point`: The point to add.
+/// * `reference_point`: The reference point bounding the area.
+///
+/// returns: `f64`. The area, bounded by the reference point, that the point adds to the area
+/// covered by the staircase.
+fn add_to_staircase(
+    staircase: &mut Vec<[f64; 2]>,
+    point: [f64; 2],
+    reference_point: [f64; 2],
+) -> f64 {
+    let [x, y] = point;
+    let start = staircase.partition_point(|s| s[0] < x);
+    // the point on the left covers the area above its second coordinate
+    let mut top = match start.checked_sub(1) {
+        Some(left) if staircase[left][1] <= y => return 0.0,
+        Some(left) => staircase[left][1],
+        None => reference_point[1],
+    };
+    if staircase.get(start).is_some_and(|s| s[0] == x && s[1] <= y) {
+        return 0.0;
+    }
+
+    let mut area = 0.0;
+    let mut left_x = x;
+    let mut end = start;
+    while end < staircase.len() && staircase[end][1] >= y {
+        area += (staircase[end][0] - left_x) * (top - y);
+        left_x = staircase[end][0];
+        top = staircase[end][1];
+        end += 1;
+    }
+    let right_x = staircase.get(end).map_or(reference_point[0], |s| s[0]);
+    area += (right_x - left_x) * (top - y);
+
+    staircase.splice(start..end, [point]);
+    area
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::{calculate_hv, IncrementalHv3D};
+
+    /// Generate pseudo-random points in the unit cube with a linear congruential generator.
+    ///
+    /// # Arguments
+    ///
+    /// * `size`: The number of points.
+    /// * `seed`: The generator seed.
+    ///
+    /// returns: `Vec<[f64; 3]>`
+    fn random_points(size: usize, seed: u64) -> Vec<[f64; 3]> {
+        let mut state = seed;
+        let mut next = || {
+            state = state
+                .wrapping_mul(6364136223846793005)
+                .wrapping_add(1442695040888963407);
+            (state >> 11) as f64 / (1u64 << 53) as f64
+        };
+        (0..size).map(|_| [next(), next(), next()]).collect()
+    }
+
+    /// Calculate the hyper-volume of the points from scratch.
+    fn exact(points: &[[f64; 3]], ref_point: &[f64; 3]) -> f64 {
+        if points.is_empty() {
+            return 0.0;
+        }
+        let data: Vec<Vec<f64>> = points.iter().map(|p| p.to_vec()).collect();
+        calculate_hv(&data, ref_point)
+    }
+
+    #[test]
+    fn test_insert_remove() {
+        let ref_point = [1.1, 1.1, 1.1];
+        let points = random_points(300, 7);
+        let mut hv = IncrementalHv3D::new(ref_point);
+
+        for (i, point) in points.iter().enumerate() {
+            hv.insert(*point);
+            let expected = exact(&points[0..=i], &ref_point);
+            assert!((hv.value() - expected).abs() < 1e-10);
+        }
+        assert_eq!(hv.len(), 300);
+
+        // remove in a different order
+        let mut remaining = points.clone();
+        for point in points
+            .iter()
+            .step_by(3)
+            .chain(points.iter().skip(1).step_by(3))
+        {
+            hv.remove(point).unwrap();
+            remaining.retain(|p| p != point);
+            let expected = exact(&remaining, &ref_point);
+            assert!((hv.value() - expected).abs() < 1e-10);
+        }
+        assert_eq!(hv.len(), 100);
+        assert!((hv.recompute() - exact(&remaining, &ref_point)).abs() < 1e-14);
+    }
+
+    #[test]
+    /// Points on a grid share coordinates, so the sweep and the staircase handle ties and the
+    /// dominated points are promoted when the points dominating them are removed.
+    fn test_ties() {
+        let ref_point = [4.0, 4.0, 4.0];
+        let points: Vec<[f64; 3]> = random_points(200, 11)
+            .into_iter()
+            .map(|p| p.map(|v| (v * 4.0).floor()))
+            .collect();
+        let mut hv = IncrementalHv3D::new(ref_point);
+        for (i, point) in points.iter().enumerate() {
+            hv.insert(*point);
+            assert_eq!(hv.value(), exact(&points[0..=i], &ref_point));
+        }
+        for (i, point) in points.iter().enumerate() {
+            hv.remove(point).unwrap();
+            assert_eq!(hv.value(), exact(&points[i + 1..], &ref_point));
+        }
+        assert!(hv.is_empty());
+    }
+
+    #[test]
+    fn test_special_points() {
+        let mut hv = IncrementalHv3D::new([3.0, 3.0, 3.0]);
+        assert_eq!(hv.insert([1.0, 1.0, 1.0]), 8.0);
+        // dominated, duplicated or outside the reference point
+        assert_eq!(hv.insert([2.0, 2.0, 2.0]), 0.0);
+        assert_eq!(hv.insert([1.0, 1.0, 1.0]), 0.0);
+        assert_eq!(hv.insert([0.0, 0.0, 4.0]), 0.0);
+        assert_eq!(hv.value(), 8.0);
+        assert_eq!(hv.len(), 4);
+        assert_eq!(hv.front().number_of_individuals(), 1);
+
+        assert!(hv.remove(&[0.5, 0.5, 0.5]).is_none());
+        assert_eq!(hv.remove(&[1.0, 1.0, 1.0]), Some(0.0));
+        assert_eq!(hv.remove(&[1.0, 1.0, 1.0]), Some(7.0));
+        assert_eq!(hv.value(), 1.0);
+        assert_eq!(hv.remove(&[2.0, 2.0, 2.0]), Some(1.0));
+        assert_eq!(hv.remove(&[0.0, 0.0, 4.0]), Some(0.0));
+        assert!(hv.is_empty());
+        assert_eq!(hv.value(), 0.0);
+    }
+}
@@ -4,6 +4,481 @@
 
 include!(concat!(env!("OUT_DIR"), "/bindings.rs"));
 
+use std::cell::RefCell;
+use std::mem;
+use std::ptr::NonNull;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::thread;
+
+pub use incremental::IncrementalHv3D;
+pub use slices::HvSlices;
+
+mod incremental;
+mod slices;
+
+/// The path to the `hv` command-line tool of the library, compiled by the build script when the
+/// `cli` feature is enabled (on Unix targets only). Besides the original options, the tool has a
+/// batch mode for large numbers of files: with `--jobs=N` the files are mapped in memory and
+/// parsed by one thread, while `N` threads calculate the hyper-volume of the sets and the results
+/// are printed in input order. With `--binary` the tool reads the binary format described in the
+/// `io.h` header of the library.
+#[cfg(all(feature = "cli", unix))]
+pub const HV_CLI_PATH: &str = env!("HV_CLI_PATH");
+
+/// A contiguous row-major matrix with the objective values of `n` individuals and `d` objectives.
+/// The value of the `j`-th objective of the `i`-th individual is stored at index `i * d + j`. The
+/// matrix borrows the values, therefore it can be used to calculate the hyper-volume without
+/// copying the data.
+///
+/// # Examples
+///
+/// ```
+/// use hv_fonseca_et_al_2006_sys::{calculate_hv_matrix, ObjectiveMatrix};
+/// let data = [1.0, 1.0, 1.0, 2.0, 2.0, 2.0];
+/// let matrix = ObjectiveMatrix::new(&data, 2, 3).unwrap();
+/// assert_eq!(calculate_hv_matrix(&matrix, &[3.0, 3.0, 3.0]), 8.0);
+/// ```
+#[derive(Debug, Clone, Copy)]
+pub struct ObjectiveMatrix<'a> {
+    /// The objective values.
+    data: &'a [f64],
+    /// The number of individuals or rows `n`.
+    number_of_individuals: usize,
+    /// The number of objectives or columns `d`.
+    number_of_objectives: usize,
+}
+
+impl<'a> ObjectiveMatrix<'a> {
+    /// Create the matrix.
+    ///
+    /// # Arguments
+    ///
+    /// * `data`: The row-major objective values of size `n * d`.
+    /// * `number_of_individuals`: The number of individuals `n`.
+    /// * `number_of_objectives`: The number of objectives `d`.
+    ///
+    /// returns: `Result<ObjectiveMatrix, String>`. An error is returned if the size of `data` does
+    /// not match `n * d` or `d` is 0.
+    pub fn new(
+        data: &'a [f64],
+        number_of_individuals: usize,
+        number_of_objectives: usize,
+    ) -> Result<Self, String> {
+        if number_of_objectives == 0 {
+            return Err("The number of objectives must be larger than 0".to_string());
+        }
+        if data.len() != number_of_individuals * number_of_objectives {
+            return Err(format!(
+                "The data size ({}) does not match the number of individuals ({}) times the number of objectives ({})",
+                data.len(),
+                number_of_individuals,
+                number_of_objectives
+            ));
+        }
+        Ok(Self {
+            data,
+            number_of_individuals,
+            number_of_objectives,
+        })
+    }
+
+    /// Get the objective values.
+    ///
+    /// returns: `&[f64]`
+    pub fn data(&self) -> &[f64] {
+        self.data
+    }
+
+    /// Get the number of individuals or rows.
+    ///
+    /// returns: `usize`
+    pub fn number_of_individuals(&self) -> usize {
+        self.number_of_individuals
+    }
+
+    /// Get the number of objectives or columns.
+    ///
+    /// returns: `usize`
+    pub fn number_of_objectives(&self) -> usize {
+        self.number_of_objectives
+    }
+
+    /// Get the objective values of an individual.
+    ///
+    /// # Arguments
+    ///
+    /// * `index`: The individual index.
+    ///
+    /// returns: `&[f64]`
+    pub fn row(&self, index: usize) -> &[f64] {
+        let start = index * self.number_of_objectives;
+        &self.data[start..start + self.number_of_objectives]
+    }
+}
+
+/// A hyper-volume calculation context. This owns the AVL tree, the bound vector and the stop
+/// dimension used by the algorithm, so that different contexts can be used concurrently from
+/// different threads. A context can be reused for several calculations but it cannot be shared
+/// between threads at the same time (it is [`Send`] but not [`Sync`]).
+///
+/// The context also owns a workspace with the nodes of the linked lists used by the algorithm.
+/// This grows to the largest number of points and objectives seen so far and is reused by the
+/// following calculations, so that no memory is allocated once the workspace is large enough.
+///
+/// With 5 or more objectives, the calculation can be split across several threads with
+/// [`HvContext::set_workers`].
+///
+/// # Examples
+///
+/// ```
+/// use hv_fonseca_et_al_2006_sys::HvContext;
+/// let mut ctx = HvContext::new();
+/// let data = [vec![1.0, 1.0, 1.0], vec![2.0, 2.0, 2.0]];
+/// let ref_point = vec![3.0, 3.0, 3.0];
+/// assert_eq!(ctx.calculate(&data, &ref_point), 8.0);
+/// ```
+#[derive(Debug)]
+pub struct HvContext {
+    /// The pointer to the C context.
+    ctx: NonNull<hv_ctx_t>,
+    /// The buffer with the flatten objective values passed to the library by
+    /// [`HvContext::calculate`].
+    buffer: Vec<f64>,
+    /// The dimension where the recursion of the algorithm stops.
+    stop_dimension: usize,
+    /// The number of threads to use with 5 or more objectives.
+    workers: usize,
+    /// The contexts used by each thread when `workers` is larger than 1.
+    worker_contexts: Vec<HvContext>,
+    /// The slices along the last objective, used when `workers` is larger than 1.
+    slices: HvSlices,
+}
+
+/// The minimum number of objectives to split the calculation across threads. With less
+/// objectives, each slice is solved with the 3D sweep and the sequential algorithm is faster.
+const PARALLEL_MIN_OBJECTIVES: usize = 5;
+
+// The context is only ever accessed through a mutable reference and does not use any global
+// state, therefore it can be moved to another thread.
+unsafe impl Send for HvContext {}
+
+impl HvContext {
+    /// Create a new context.
+    ///
+    /// returns: `HvContext`
+    pub fn new() -> Self {
+        let ctx = unsafe { hv_ctx_new() };
+        Self {
+            ctx: NonNull::new(ctx).expect("Cannot allocate the hyper-volume context"),
+            buffer: Vec::new(),
+            stop_dimension: 2,
+            workers: 1,
+            worker_contexts: Vec::new(),
+            slices: HvSlices::default(),
+        }
+    }
+
+    /// Calculate the hyper-volume. See [`calculate_hv`] for a description of the arguments.
+    ///
+    /// # Arguments
+    ///
+    /// * `data`: The vector with the objective values.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation.
+    ///
+    /// returns: `f64`. The hyper-volume.
+    pub fn calculate(&mut self, data: &[Vec<f64>], ref_point: &[f64]) -> f64 {
+        let total_objectives = data.first().unwrap().len();
+        let mut buffer = mem::take(&mut self.buffer);
+        buffer.clear();
+        buffer.extend(data.iter().flatten());
+        let hv = self.compute(&buffer, total_objectives, ref_point, false);
+        self.buffer = buffer;
+        hv
+    }
+
+    /// Calculate the hyper-volume of the objective values stored in an [`ObjectiveMatrix`]. The
+    /// values are passed to the library without being copied.
+    ///
+    /// # Arguments
+    ///
+    /// * `matrix`: The objective values.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation. Its length
+    ///    must match [`ObjectiveMatrix::number_of_objectives`].
+    ///
+    /// returns: `f64`. The hyper-volume.
+    pub fn calculate_matrix(&mut self, matrix: &ObjectiveMatrix, ref_point: &[f64]) -> f64 {
+        self.compute(matrix.data, matrix.number_of_objectives, ref_point, false)
+    }
+
+    /// Calculate the hyper-volume of the objective values stored in an [`ObjectiveMatrix`] after
+    /// reordering the objectives. With more than 3 objectives, the order in which the objectives
+    /// are processed can greatly affect the runtime of the algorithm; the order is chosen with the
+    /// heuristic by [While et al. (2005)](http://dx.doi.org/10.1109/CEC.2005.1554971) to maximise
+    /// the number of points dominated in the objectives processed first. With 3 objectives or
+    /// less, this is the same as [`HvContext::calculate_matrix`].
+    ///
+    /// The values are first copied into a buffer owned by the context, because the coordinates
+    /// are permuted in place.
+    ///
+    /// # Arguments
+    ///
+    /// * `matrix`: The objective values.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation. Its length
+    ///    must match [`ObjectiveMatrix::number_of_objectives`].
+    ///
+    /// returns: `f64`. The hyper-volume.
+    pub fn calculate_matrix_ordered(&mut self, matrix: &ObjectiveMatrix, ref_point: &[f64]) -> f64 {
+        self.compute(matrix.data, matrix.number_of_objectives, ref_point, true)
+    }
+
+    /// Calculate the hyper-volume of the objective values stored in an [`ObjectiveMatrix`] using
+    /// a structure-of-arrays layout for the linked lists of the algorithm. Instead of allocating
+    /// one node per point, with the pointers to the next and previous node in each objective, the
+    /// points are identified by a 32-bit index and the links, areas and volumes of each objective
+    /// are stored in contiguous arrays aligned to a cache line. This reduces the memory traffic
+    /// of the loops on one objective at the cost of copying the values into the context. The
+    /// result is the same as [`HvContext::calculate_matrix`].
+    ///
+    /// # Arguments
+    ///
+    /// * `matrix`: The objective values.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation. Its length
+    ///    must match [`ObjectiveMatrix::number_of_objectives`].
+    ///
+    /// returns: `f64`. The hyper-volume.
+    pub fn calculate_matrix_soa(&mut self, matrix: &ObjectiveMatrix, ref_point: &[f64]) -> f64 {
+        // ctx, data, nobj, popsize, reference
+        unsafe {
+            fpli_hv_soa_ctx(
+                self.ctx.as_ptr(),
+                matrix.data.as_ptr(),
+                matrix.number_of_objectives as i32,
+                matrix.number_of_individuals as i32,
+                ref_point.as_ptr(),
+            )
+        }
+    }
+
+    /// Set the dimension where the recursion of the algorithm stops. With `2` (the default), the
+    /// recursion stops at 3 objectives and the remaining volume is calculated with the sweep
+    /// algorithm using an AVL tree; with `1` or `0` the recursion continues down to 2 or 1
+    /// objectives.
+    ///
+    /// # Arguments
+    ///
+    /// * `stop_dimension`: The dimension index (`0`, `1` or `2`).
+    ///
+    /// returns: `Result<(), String>`. An error is returned if the dimension is not valid.
+    pub fn set_stop_dimension(&mut self, stop_dimension: usize) -> Result<(), String> {
+        if stop_dimension > 2
+            || unsafe { hv_ctx_set_stop_dimension(self.ctx.as_ptr(), stop_dimension as i32) } != 0
+        {
+            return Err(format!(
+                "The stop dimension ({}) must be 0, 1 or 2",
+                stop_dimension
+            ));
+        }
+        self.stop_dimension = stop_dimension;
+        for worker in self.worker_contexts.iter_mut() {
+            worker.set_stop_dimension(stop_dimension)?;
+        }
+        Ok(())
+    }
+
+    /// Set the number of threads used to calculate the hyper-volume with 5 or more objectives.
+    /// With `1` (the default), the calculation is sequential. Otherwise, the outermost level of
+    /// the recursion of the algorithm is split across the threads: the points are sorted by the
+    /// last objective and the hyper-volume of each slice between two consecutive points is
+    /// calculated independently on the first `d - 1` objectives. Each thread uses its own context
+    /// (with its own linked lists and AVL tree), which is kept and reused by the following
+    /// calculations, while the threads are spawned at each calculation. To run the slices on the
+    /// threads of an existing pool instead, use [`HvSlices`].
+    ///
+    /// Because each slice is calculated from scratch, the total work is larger than with the
+    /// sequential algorithm; this pays off only when the hyper-volume of the front is expensive
+    /// (for example with many points or 6 or more objectives). This applies to
+    /// [`HvContext::calculate`], [`HvContext::calculate_matrix`] and
+    /// [`HvContext::calculate_matrix_ordered`].
+    ///
+    /// # Arguments
+    ///
+    /// * `workers`: The number of threads.
+    ///
+    /// returns: `Result<(), String>`. An error is returned if the number of threads is 0.
+    pub fn set_workers(&mut self, workers: usize) -> Result<(), String> {
+        if workers == 0 {
+            return Err("The number of workers must be at least 1".to_string());
+        }
+        self.workers = workers;
+        self.worker_contexts.truncate(workers);
+        Ok(())
+    }
+
+    /// Calculate the hyper-volume, using more threads if the context was configured to do so.
+    ///
+    /// # Arguments
+    ///
+    /// * `data`: The flat row-major objective values.
+    /// * `number_of_objectives`: The number of objectives `d`.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation of length `d`.
+    /// * `ordered`: Whether to reorder the objectives with [`fpli_hv_order_ctx`].
+    ///
+    /// returns: `f64`. The hyper-volume.
+    fn compute(
+        &mut self,
+        data: &[f64],
+        number_of_objectives: usize,
+        ref_point: &[f64],
+        ordered: bool,
+    ) -> f64 {
+        if self.workers > 1 && number_of_objectives >= PARALLEL_MIN_OBJECTIVES {
+            self.compute_parallel(data, number_of_objectives, ref_point, ordered)
+        } else {
+            Self::compute_sequential(self.ctx, data, number_of_objectives, ref_point, ordered)
+        }
+    }
+
+    /// Call the library using the context `ctx`.
+    ///
+    /// # Arguments
+    ///
+    /// * `ctx`: The pointer to the C context.
+    /// * `data`: The flat row-major objective values.
+    /// * `number_of_objectives`: The number of objectives `d`.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation of length `d`.
+    /// * `ordered`: Whether to reorder the objectives with [`fpli_hv_order_ctx`].
+    ///
+    /// returns: `f64`. The hyper-volume.
+    fn compute_sequential(
+        ctx: NonNull<hv_ctx_t>,
+        data: &[f64],
+        number_of_objectives: usize,
+        ref_point: &[f64],
+        ordered: bool,
+    ) -> f64 {
+        let total_individuals = data.len() / number_of_objectives;
+
+        // ctx, data, nobj, popsize, reference[, order]
+        unsafe {
+            if ordered {
+                fpli_hv_order_ctx(
+                    ctx.as_ptr(),
+                    data.as_ptr(),
+                    number_of_objectives as i32,
+                    total_individuals as i32,
+                    ref_point.as_ptr(),
+                    std::ptr::null_mut(),
+                )
+            } else {
+                fpli_hv_ctx(
+                    ctx.as_ptr(),
+                    data.as_ptr(),
+                    number_of_objectives as i32,
+                    total_individuals as i32,
+                    ref_point.as_ptr(),
+                )
+            }
+        }
+    }
+
+    /// Calculate the hyper-volume by splitting the slices along the last objective across
+    /// threads. The volume of the slice between the `k`-th and `(k+1)`-th point, sorted by the
+    /// last objective, is the hyper-volume of the first `k + 1` points on the remaining
+    /// objectives times the slice height. The slices are assigned to the threads dynamically,
+    /// starting from the largest one, and their volumes are summed in order so that the result
+    /// does not depend on the scheduling.
+    ///
+    /// # Arguments
+    ///
+    /// * `data`: The flat row-major objective values.
+    /// * `number_of_objectives`: The number of objectives `d`.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation of length `d`.
+    /// * `ordered`: Whether to reorder the objectives of each slice with [`fpli_hv_order_ctx`].
+    ///
+    /// returns: `f64`. The hyper-volume.
+    fn compute_parallel(
+        &mut self,
+        data: &[f64],
+        number_of_objectives: usize,
+        ref_point: &[f64],
+        ordered: bool,
+    ) -> f64 {
+        let matrix = ObjectiveMatrix::new(
+            data,
+            data.len() / number_of_objectives,
+            number_of_objectives,
+        )
+        .unwrap();
+        self.slices.update(&matrix, ref_point);
+        if self.slices.is_empty() {
+            return 0.0;
+        }
+
+        let total_slices = self.slices.len();
+        let threads = self.workers.min(total_slices);
+        while self.worker_contexts.len() < threads {
+            let mut worker = HvContext::new();
+            worker.set_stop_dimension(self.stop_dimension).unwrap();
+            self.worker_contexts.push(worker);
+        }
+
+        let next_slice = AtomicUsize::new(0);
+        let slices = &self.slices;
+        let mut volumes = vec![0.0; total_slices];
+        thread::scope(|scope| {
+            let handles: Vec<_> = self.worker_contexts[0..threads]
+                .iter_mut()
+                .map(|worker| {
+                    let next_slice = &next_slice;
+                    scope.spawn(move || {
+                        let mut worker_volumes = vec![];
+                        loop {
+                            let j = next_slice.fetch_add(1, Ordering::Relaxed);
+                            if j >= total_slices {
+                                break;
+                            }
+                            // start from the slice with the most points
+                            let k = total_slices - 1 - j;
+                            // ties in the last objective give empty slices
+                            if slices.height(k) <= 0.0 {
+                                continue;
+                            }
+                            let area = Self::compute_sequential(
+                                worker.ctx,
+                                slices.points(k).data(),
+                                number_of_objectives - 1,
+                                slices.reference_point(),
+                                ordered,
+                            );
+                            worker_volumes.push((k, area * slices.height(k)));
+                        }
+                        worker_volumes
+                    })
+                })
+                .collect();
+            for handle in handles {
+                for (k, volume) in handle.join().unwrap() {
+                    volumes[k] = volume;
+                }
+            }
+        });
+
+        volumes.iter().sum()
+    }
+}
+
+impl Default for HvContext {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl Drop for HvContext {
+    fn drop(&mut self) {
+        unsafe { hv_ctx_free(self.ctx.as_ptr()) }
+    }
+}
+
 /// Calculate the hyper-volume using the algorithm proposed by [Fonseca et al. (2006)](http://dx.doi.org/10.1109/CEC.2006.1688440)
 /// for a problem with `d` objectives and `n` individuals. The function calls version 4 of the
 /// algorithm, therefore its complexity is O(`n^(d-2)*log n`).
@@ -13,6 +488,8 @@ include!(concat!(env!("OUT_DIR"), "/bindings.rs"));
 ///    reference point are automatically excluded from the calculation.
 /// 2) The program assumes that all objectives are minimised. Maximisation objectives may be
 ///    multiplied by -1 to convert them to minimisation.
+/// 3) Each thread uses its own [`HvContext`], therefore this function is thread-safe. The context
+///    is reused by the following calls from the same thread to avoid allocating memory.
 ///
 /// # Arguments
 ///
@@ -33,24 +510,125 @@ include!(concat!(env!("OUT_DIR"), "/bindings.rs"));
 /// assert_eq!(hv, 8.0);
 /// ```
 pub fn calculate_hv(data: &[Vec<f64>], ref_point: &[f64]) -> f64 {
-    let total_objectives = data.first().unwrap().len();
-    let total_individuals = data.len();
-    let mut flatten_data = data.iter().flatten().cloned().collect::<Vec<f64>>();
-
-    // data, nobj, popsize, reference
-    unsafe {
-        fpli_hv(
-            flatten_data.as_mut_ptr(),
-            total_objectives as i32,
-            total_individuals as i32,
-            ref_point.as_ptr(),
-        )
-    }
+    CONTEXT.with(|ctx| ctx.borrow_mut().calculate(data, ref_point))
+}
+
+/// Calculate the hyper-volume of the objective values stored in an [`ObjectiveMatrix`] without
+/// copying them. See [`calculate_hv`] for the implementation notes.
+///
+/// # Arguments
+///
+/// * `matrix`: The objective values.
+/// * `ref_point`: The reference or anti-optimal point to use in the calculation. Its length must
+///    match [`ObjectiveMatrix::number_of_objectives`].
+///
+/// returns: `f64`. The hyper-volume.
+pub fn calculate_hv_matrix(matrix: &ObjectiveMatrix, ref_point: &[f64]) -> f64 {
+    CONTEXT.with(|ctx| ctx.borrow_mut().calculate_matrix(matrix, ref_point))
+}
+
+/// Calculate the hyper-volume of the objective values stored in an [`ObjectiveMatrix`] after
+/// reordering the objectives to speed up the calculation when there are more than 3 objectives.
+/// See [`HvContext::calculate_matrix_ordered`] and [`calculate_hv`] for the implementation notes.
+///
+/// # Arguments
+///
+/// * `matrix`: The objective values.
+/// * `ref_point`: The reference or anti-optimal point to use in the calculation. Its length must
+///    match [`ObjectiveMatrix::number_of_objectives`].
+///
+/// returns: `f64`. The hyper-volume.
+pub fn calculate_hv_matrix_ordered(matrix: &ObjectiveMatrix, ref_point: &[f64]) -> f64 {
+    CONTEXT.with(|ctx| ctx.borrow_mut().calculate_matrix_ordered(matrix, ref_point))
+}
+
+thread_local! {
+    /// The context used by [`calculate_hv`] on the current thread.
+    static CONTEXT: RefCell<HvContext> = RefCell::new(HvContext::new());
 }
 
 #[cfg(test)]
 mod tests {
-    use crate::calculate_hv;
+    use std::thread;
+
+    use crate::{
+        calculate_hv, calculate_hv_matrix, calculate_hv_matrix_ordered, HvContext, ObjectiveMatrix,
+    };
+
+    #[cfg(all(feature = "cli", unix))]
+    #[test]
+    /// Run the command-line tool in batch mode.
+    fn test_cli_batch() {
+        use std::process::Command;
+
+        let file = std::env::temp_dir().join("hv_fonseca_cli_batch.dat");
+        std::fs::write(&file, "1 1 1\n2 2 2\n\n# second set\n0.5 2.5 2.0\n").unwrap();
+        let output = Command::new(crate::HV_CLI_PATH)
+            .args(["--jobs=2", "-r", "3 3 3"])
+            .arg(&file)
+            .output()
+            .unwrap();
+        std::fs::remove_file(&file).unwrap();
+
+        assert!(output.status.success());
+        let values: Vec<f64> = String::from_utf8(output.stdout)
+            .unwrap()
+            .lines()
+            .map(|l| l.trim().parse().unwrap())
+            .collect();
+        assert_eq!(
+            values,
+            vec![
+                calculate_hv(&[vec![1.0, 1.0, 1.0], vec![2.0, 2.0, 2.0]], &[3.0; 3]),
+                calculate_hv(&[vec![0.5, 2.5, 2.0]], &[3.0; 3]),
+            ]
+        );
+    }
+
+    #[cfg(all(feature = "cli", unix))]
+    #[test]
+    /// The batch mode stops at the first set with no point dominating the reference point and
+    /// prints the same output and messages as the serial mode.
+    fn test_cli_batch_stops_as_serial() {
+        use std::process::Command;
+
+        let folder = std::env::temp_dir().join("hv_fonseca_cli_batch_stop");
+        std::fs::create_dir_all(&folder).unwrap();
+        let files = [
+            ("good.dat", "1 1\n2 0.5\n\n0.5 2\n"),
+            ("bad.dat", "5 5\n6 6\n"),
+            ("warn.dat", "1 1\n9 0.1\n"),
+        ]
+        .map(|(name, content)| {
+            let file = folder.join(name);
+            std::fs::write(&file, content).unwrap();
+            file
+        });
+
+        let run = |jobs: Option<&str>| {
+            let output = Command::new(crate::HV_CLI_PATH)
+                .args(jobs)
+                .args(["-v", "-r", "3 3"])
+                .args(&files)
+                .output()
+                .unwrap();
+            // the times are not the same between runs
+            let stdout: Vec<String> = String::from_utf8(output.stdout)
+                .unwrap()
+                .lines()
+                .filter(|l| !l.starts_with("# Time"))
+                .map(String::from)
+                .collect();
+            (output.status.code(), stdout, output.stderr)
+        };
+        let serial = run(None);
+        let batch = run(Some("--jobs=2"));
+        std::fs::remove_dir_all(&folder).unwrap();
+
+        assert_eq!(serial.0, Some(1));
+        assert!(serial.1.last().unwrap().starts_with("# Data set 1"));
+        assert_eq!(batch, serial);
+    }
 
     #[test]
     fn test_hv3d() {
@@ -59,4 +637,185 @@ mod tests {
         let hv = calculate_hv(&data, &ref_point);
         assert_eq!(hv, 8.0);
     }
+
+    #[test]
+    fn test_hv3d_matrix() {
+        let data = [1.0, 1.0, 1.0, 2.0, 2.0, 2.0, 0.5, 2.5, 2.0];
+        let ref_point = vec![3.0, 3.0, 3.0];
+        let nested = [
+            vec![1.0, 1.0, 1.0],
+            vec![2.0, 2.0, 2.0],
+            vec![0.5, 2.5, 2.0],
+        ];
+        let matrix = ObjectiveMatrix::new(&data, 3, 3).unwrap();
+        assert_eq!(matrix.row(2), &[0.5, 2.5, 2.0]);
+        assert_eq!(
+            calculate_hv_matrix(&matrix, &ref_point),
+            calculate_hv(&nested, &ref_point)
+        );
+        // the data are not modified
+        assert_eq!(data, [1.0, 1.0, 1.0, 2.0, 2.0, 2.0, 0.5, 2.5, 2.0]);
+
+        assert!(ObjectiveMatrix::new(&data, 2, 3)
+            .unwrap_err()
+            .contains("does not match the number of individuals (2)"));
+        assert!(ObjectiveMatrix::new(&data, 3, 0).is_err());
+    }
+
+    #[test]
+    /// Run the calculation on independent contexts from multiple threads.
+    fn test_hv3d_threads() {
+        let handles: Vec<_> = (1..=8)
+            .map(|t| {
+                thread::spawn(move || {
+                    let mut ctx = HvContext::new();
+                    let data: Vec<Vec<f64>> = (0..t)
+                        .map(|i| vec![i as f64, (t - i) as f64, 1.0])
+                        .collect();
+                    let ref_point = vec![t as f64 + 1.0; 3];
+                    (0..50)
+                        .map(|_| ctx.calculate(&data, &ref_point))
+                        .collect::<Vec<f64>>()
+                })
+            })
+            .collect();
+
+        for (t, handle) in (1..=8).zip(handles) {
+            let data: Vec<Vec<f64>> = (0..t)
+                .map(|i| vec![i as f64, (t - i) as f64, 1.0])
+                .collect();
+            let expected = calculate_hv(&data, &[t as f64 + 1.0; 3]);
+            for value in handle.join().unwrap() {
+                assert_eq!(value, expected);
+            }
+        }
+    }
+
+    #[test]
+    /// Reuse the same context with fronts of different sizes.
+    fn test_reuse_context() {
+        let mut ctx = HvContext::new();
+        for n in [10, 200, 1, 50, 200, 3] {
+            let data: Vec<Vec<f64>> = (0..n)
+                .map(|i| vec![i as f64, (n - i) as f64, ((i * 7) % n) as f64])
+                .collect();
+            let ref_point = vec![n as f64 + 1.0; 3];
+            let mut new_ctx = HvContext::new();
+            assert_eq!(
+                ctx.calculate(&data, &ref_point),
+                new_ctx.calculate(&data, &ref_point)
+            );
+        }
+
+        let data = [vec![1.0, 1.0], vec![2.0, 0.5]];
+        assert_eq!(ctx.calculate(&data, &[3.0, 3.0]), 4.5);
+    }
+
+    #[test]
+    /// The hyper-volume with reordered objectives matches the one with the original order.
+    fn test_ordered() {
+        for number_of_objectives in 2..=6 {
+            let n = 40;
+            let data: Vec<f64> = (0..n * number_of_objectives)
+                .map(|i| ((i * 7919) % 97) as f64 / 97.0)
+                .collect();
+            let copy = data.clone();
+            let matrix = ObjectiveMatrix::new(&data, n, number_of_objectives).unwrap();
+            let ref_point = vec![1.1; number_of_objectives];
+
+            let expected = calculate_hv_matrix(&matrix, &ref_point);
+            let calculated = calculate_hv_matrix_ordered(&matrix, &ref_point);
+            assert!((calculated - expected).abs() < 1e-12);
+            assert_eq!(data, copy);
+        }
+    }
+
+    #[test]
+    /// The structure-of-arrays layout gives the same hyper-volume with any stop dimension and
+    /// when the context is reused with smaller or larger sets.
+    fn test_soa() {
+        let mut ctx = HvContext::new();
+        for (n, number_of_objectives) in [(60, 5), (10, 2), (200, 3), (25, 6), (80, 4)] {
+            let data: Vec<f64> = (0..n * number_of_objectives)
+                .map(|i| ((i * 7919) % 97) as f64 / 97.0)
+                .collect();
+            let matrix = ObjectiveMatrix::new(&data, n, number_of_objectives).unwrap();
+            let ref_point = vec![1.1; number_of_objectives];
+
+            let expected = calculate_hv_matrix(&matrix, &ref_point);
+            for stop_dimension in 0..=2 {
+                ctx.set_stop_dimension(stop_dimension).unwrap();
+                let calculated = ctx.calculate_matrix_soa(&matrix, &ref_point);
+                assert!((calculated - expected).abs() < 1e-12);
+            }
+        }
+    }
+
+    #[test]
+    /// Reusing a context with fewer and then more points lays out the buffers again for the
+    /// larger set.
+    fn test_soa_shrink_and_grow() {
+        let mut ctx = HvContext::new();
+        let number_of_objectives = 3;
+        for n in [40, 10, 40] {
+            let data: Vec<f64> = (0..n * number_of_objectives)
+                .map(|i| ((i * 7919) % 97) as f64 / 97.0)
+                .collect();
+            let matrix = ObjectiveMatrix::new(&data, n, number_of_objectives).unwrap();
+            let ref_point = vec![1.1; number_of_objectives];
+
+            let expected = calculate_hv_matrix(&matrix, &ref_point);
+            let calculated = ctx.calculate_matrix_soa(&matrix, &ref_point);
+            assert!((calculated - expected).abs() < 1e-12);
+        }
+    }
+
+    #[test]
+    /// Splitting the outermost slices across threads gives the same hyper-volume as the
+    /// sequential algorithm, including when points share the same last objective.
+    fn test_workers() {
+        let mut ctx = HvContext::new();
+        assert!(ctx.set_workers(0).is_err());
+
+        for number_of_objectives in 4..=6 {
+            let n = 50;
+            let data: Vec<f64> = (0..n * number_of_objectives)
+                .map(|i| ((i * 7919) % 23) as f64 / 23.0)
+                .collect();
+            let matrix = ObjectiveMatrix::new(&data, n, number_of_objectives).unwrap();
+            let ref_point = vec![1.1; number_of_objectives];
+            let expected = calculate_hv_matrix(&matrix, &ref_point);
+
+            for workers in [2, 3, 8] {
+                ctx.set_workers(workers).unwrap();
+                for stop_dimension in [2, 1] {
+                    ctx.set_stop_dimension(stop_dimension).unwrap();
+                    let calculated = ctx.calculate_matrix(&matrix, &ref_point);
+                    assert!((calculated - expected).abs() < 1e-12);
+                    let calculated = ctx.calculate_matrix_ordered(&matrix, &ref_point);
+                    assert!((calculated - expected).abs() < 1e-12);
+                }
+            }
+        }
+
+        // no point dominates the reference point
+        let data = vec![vec![2.0; 5], vec![1.0, 1.0, 1.0, 1.0, 3.0]];
+        assert_eq!(ctx.calculate(&data, &[2.0; 5]), 0.0);
+    }
+
+    #[test]
+    fn test_stop_dimension() {
+        let data: Vec<Vec<f64>> = (0..30)
+            .map(|i| vec![i as f64, (30 - i) as f64, ((i * 7) % 30) as f64, 1.0])
+            .collect();
+        let ref_point = vec![31.0; 4];
+        let expected = calculate_hv(&data, &ref_point);
+
+        let mut ctx = HvContext::new();
+        for stop_dimension in 0..=2 {
+            ctx.set_stop_dimension(stop_dimension).unwrap();
+            assert!((ctx.calculate(&data, &ref_point) - expected).abs() < 1e-8);
+        }
+        assert!(ctx.set_stop_dimension(3).is_err());
+    }
 }
@@ -0,0 +1,127 @@
+use crate::ObjectiveMatrix;
+
+/// Split the hyper-volume of a set of points into slices along the last objective, to calculate
+/// them on different threads. The points dominating the reference point are sorted by the last
+/// objective: the slice between the `k`-th and `(k+1)`-th point (or the reference point for the
+/// last one) has the height of the gap between the two points, and its volume is the height times
+/// the hyper-volume of the first `k + 1` points projected onto the first `d - 1` objectives.
+///
+/// The hyper-volume of the slices can be calculated in any order and on any thread, for example
+/// with [`crate::calculate_hv_matrix`] that uses one context per thread, and it runs on the
+/// threads of an existing pool. [`crate::HvContext::set_workers`] uses this split with its own
+/// threads.
+///
+/// # Examples
+///
+/// ```
+/// use hv_fonseca_et_al_2006_sys::{calculate_hv_matrix, HvSlices, ObjectiveMatrix};
+/// let data = [1.0, 1.0, 1.0, 2.0, 2.0, 2.0];
+/// let matrix = ObjectiveMatrix::new(&data, 2, 3).unwrap();
+/// let slices = HvSlices::new(&matrix, &[3.0, 3.0, 3.0]);
+/// let hv: f64 = (0..slices.len())
+///     .map(|k| slices.height(k) * calculate_hv_matrix(&slices.points(k), slices.reference_point()))
+///     .sum();
+/// assert_eq!(hv, 8.0);
+/// ```
+#[derive(Debug, Default)]
+pub struct HvSlices {
+    /// The points sorted by the last objective and projected onto the first `d - 1` objectives,
+    /// stored as a row-major matrix.
+    points: Vec<f64>,
+    /// The height of each slice.
+    heights: Vec<f64>,
+    /// The first `d - 1` coordinates of the reference point.
+    reference_point: Vec<f64>,
+}
+
+impl HvSlices {
+    /// Split the hyper-volume of a set of points into slices.
+    ///
+    /// # Arguments
+    ///
+    /// * `matrix`: The objective values with at least 2 objectives.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation of length `d`.
+    ///
+    /// returns: `HvSlices`
+    pub fn new(matrix: &ObjectiveMatrix, ref_point: &[f64]) -> Self {
+        let mut slices = Self::default();
+        slices.update(matrix, ref_point);
+        slices
+    }
+
+    /// Split the hyper-volume of another set of points, reusing the buffers.
+    ///
+    /// # Arguments
+    ///
+    /// * `matrix`: The objective values with at least 2 objectives.
+    /// * `ref_point`: The reference or anti-optimal point to use in the calculation of length `d`.
+    pub fn update(&mut self, matrix: &ObjectiveMatrix, ref_point: &[f64]) {
+        let d = matrix.number_of_objectives();
+        let last = d - 1;
+
+        // only the points dominating the reference point contribute to the metric
+        let mut points: Vec<&[f64]> = matrix
+            .data()
+            .chunks_exact(d)
+            .filter(|p| p.iter().zip(ref_point).all(|(x, r)| x < r))
+            .collect();
+        points.sort_by(|a, b| a[last].total_cmp(&b[last]));
+
+        self.heights.clear();
+        self.heights.extend((0..points.len()).map(|k| {
+            let next = points.get(k + 1).map_or(ref_point[last], |p| p[last]);
+            next - points[k][last]
+        }));
+        self.points.clear();
+        self.points
+            .extend(points.iter().flat_map(|p| p[0..last].iter()));
+        self.reference_point.clear();
+        self.reference_point.extend_from_slice(&ref_point[0..last]);
+    }
+
+    /// Get the number of slices.
+    ///
+    /// returns: `usize`
+    pub fn len(&self) -> usize {
+        self.heights.len()
+    }
+
+    /// Whether there are no slices (no point dominates the reference point).
+    ///
+    /// returns: `bool`
+    pub fn is_empty(&self) -> bool {
+        self.heights.is_empty()
+    }
+
+    /// Get the height of a slice. This is 0 when two points share the same last objective.
+    ///
+    /// # Arguments
+    ///
+    /// * `k`: The slice index.
+    ///
+    /// returns: `f64`
+    pub fn height(&self, k: usize) -> f64 {
+        self.heights[k]
+    }
+
+    /// Get the points whose hyper-volume, times the height, gives the volume of a slice. These
+    /// are the first `k + 1` points projected onto the first `d - 1` objectives.
+    ///
+    /// # Arguments
+    ///
+    /// * `k`: The slice index.
+    ///
+    /// returns: `ObjectiveMatrix`
+    pub fn points(&self, k: usize) -> ObjectiveMatrix<'_> {
+        let d = self.reference_point.len();
+        ObjectiveMatrix::new(&self.points[0..(k + 1) * d], k + 1, d).unwrap()
+    }
+
+    /// Get the reference point to use with the points of the slices (the first `d - 1`
+    /// coordinates).
+    ///
+    /// returns: `&[f64]`
+    pub fn reference_point(&self) -> &[f64] {
+        &self.reference_point
+    }
+}
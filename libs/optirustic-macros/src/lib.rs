@@ -93,7 +93,7 @@ pub fn as_algorithm_args(_attrs: TokenStream, input: TokenStream) -> TokenStream
 
 /// This macro adds the following private fields to the struct defining an algorithm:
 /// `problem`, `number_of_individuals`, `population`, `generation`,`stopping_condition`, `number_of_function_evaluations`,
-/// `start_time`, `export_history` and `parallel`.
+/// `start_time`, `export_history`, `parallel` and `instrumentation`.
 ///
 /// It also implements the `Display` trait.
 ///
@@ -189,12 +189,21 @@ pub fn as_algorithm(attrs: TokenStream, input: TokenStream) -> TokenStream {
                         })
                         .expect("Cannot add `parallel` field"),
                 );
+                fields.named.push(
+                    syn::Field::parse_named
+                        .parse2(quote! {
+                            /// The timers and counters collected at each generation.
+                            instrumentation: Instrumentation
+                        })
+                        .expect("Cannot add `instrumentation` field"),
+                );
             }
 
             let expand = quote! {
                 use std::time::Instant;
                 use std::sync::Arc;
                 use crate::core::{Problem, Population};
+                use crate::algorithms::Instrumentation;
 
                 #ast
 
@@ -213,7 +222,8 @@ pub fn as_algorithm(attrs: TokenStream, input: TokenStream) -> TokenStream {
 /// This macro adds common items when the `Algorithm` trait is implemented for a new algorithm
 /// struct. This adds the following items: `Algorithm::name()`, `Algorithm::stopping_condition()`
 /// `Algorithm::start_time()`, `Algorithm::problem()`,  `Algorithm::population()`,
-/// `Algorithm::generation()`, `Algorithm::number_of_function_evaluations()` and `Algorithm::export_history()`.
+/// `Algorithm::generation()`, `Algorithm::number_of_function_evaluations()`, `Algorithm::export_history()`,
+/// `Algorithm::instrumentation()` and `Algorithm::instrumentation_mut()`.
 ///
 #[proc_macro_attribute]
 pub fn impl_algorithm_trait_items(attrs: TokenStream, input: TokenStream) -> TokenStream {
@@ -300,6 +310,24 @@ pub fn impl_algorithm_trait_items(attrs: TokenStream, input: TokenStream) -> Tok
             .into(),
         )
         .expect("Failed to parse `number_of_function_evaluations` item"),
+        syn::parse::<syn::ImplItem>(
+            quote!(
+                fn instrumentation(&self) -> &Instrumentation {
+                    &self.instrumentation
+                }
+            )
+            .into(),
+        )
+        .expect("Failed to parse `instrumentation` item"),
+        syn::parse::<syn::ImplItem>(
+            quote!(
+                fn instrumentation_mut(&mut self) -> &mut Instrumentation {
+                    &mut self.instrumentation
+                }
+            )
+            .into(),
+        )
+        .expect("Failed to parse `instrumentation_mut` item"),
         syn::parse::<syn::ImplItem>(
             quote!(
                 fn algorithm_options(&self) -> #arg_type {
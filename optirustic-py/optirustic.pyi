@@ -1,8 +1,9 @@
 from datetime import timedelta, datetime
 from enum import Enum
-from typing import TypedDict
+from typing import Callable, TypedDict
 
 import matplotlib.pyplot as plt
+import numpy as np
 
 class ObjectiveDirection(Enum):
     """
@@ -24,6 +25,13 @@ class Objective:
     direction: ObjectiveDirection
     """ Whether the objective should be minimised or maximised. """
 
+    def __init__(self, name: str, direction: ObjectiveDirection):
+        """
+        Create a new objective.
+        :param name: The objective name.
+        :param direction: Whether the objective should be minimised or maximised.
+        """
+
 class RelationalOperator(Enum):
     """
     Operator used to check a bounded constraint.
@@ -49,6 +57,15 @@ class Constraint:
     target: float
     """ The constraint target """
 
+    def __init__(self, name: str, operator: RelationalOperator, target: float):
+        """
+        Create a new constraint.
+        :param name: The constraint name.
+        :param operator: The relational operator used to compare a value against the
+        constraint target value.
+        :param target: The constraint target.
+        """
+
 class VariableType(Enum):
     """
     The type of variable
@@ -75,6 +92,24 @@ class Variable:
     """ The maximum bound. This is None if the variable
     does not support bounds. """
 
+    def __init__(
+        self,
+        name: str,
+        var_type: VariableType,
+        min_value: float | None = None,
+        max_value: float | None = None,
+    ):
+        """
+        Create a new variable. Choice variables cannot be used to solve a problem
+        from Python.
+        :param name: The variable name.
+        :param var_type: The type of variable.
+        :param min_value: The minimum bound. This is mandatory for real and integer
+        variables.
+        :param max_value: The maximum bound. This is mandatory for real and integer
+        variables.
+        """
+
 class Problem:
     """
     Class holding information about the solved problem.
@@ -174,6 +209,16 @@ class AlgorithmData:
     the reference point for NSGA3) """
     exported_on: datetime
     """  The date and time when the parsed JSON file was exported """
+    objective_values: np.ndarray
+    """ The objective values as a (N, M) array, with one row per individual and the
+    columns ordered as `problem.objective_names` """
+    constraint_values: np.ndarray
+    """ The constraint values as a (N, C) array, with one row per individual and the
+    columns ordered as `problem.constraint_names` """
+    variable_values: np.ndarray
+    """ The variable values as a (N, V) array, with one row per individual and the
+    columns ordered as `problem.variable_names`. Integer and boolean values are
+    converted to floats and choice variables are set to NaN """
 
     def __init__(self, file: str):
         """
@@ -269,18 +314,84 @@ class AlgorithmData:
         :return: The figure object.
         """
 
+type BatchEvaluator = Callable[
+    [np.ndarray], np.ndarray | tuple[np.ndarray, np.ndarray]
+]
+
 class NSGA2(AlgorithmData):
     """
     Class to parse data exported with the NSGA2 algorithm.
     """
 
-    pass
+    @staticmethod
+    def run(
+        variables: list[Variable],
+        objectives: list[Objective],
+        evaluator: BatchEvaluator,
+        number_of_individuals: int,
+        number_of_generations: int,
+        constraints: list[Constraint] | None = None,
+        batch_size: int | None = None,
+        seed: int | None = None,
+    ) -> "NSGA2":
+        """
+        Solve a problem with the NSGA2 algorithm.
+        :param variables: The problem variables.
+        :param objectives: The problem objectives.
+        :param evaluator: The function evaluating a batch of solutions. This receives a
+        (N, V) array with the variable values of N individuals (with the columns ordered
+        as `variables`) and must return a (N, M) array with the objective values or, when
+        constraints are set, a tuple with the (N, M) objective array and the (N, C)
+        constraint array. The GIL is released while the algorithm runs and is only
+        acquired to call this function.
+        :param number_of_individuals: The number of individuals in the population.
+        :param number_of_generations: The number of generations to evolve.
+        :param constraints: The optional problem constraints.
+        :param batch_size: The maximum number of individuals passed to the evaluator at
+        once. This defaults to the population size.
+        :param seed: The seed to reproduce the results.
+        :return: The data at the last generation.
+        """
 
 class NSGA3(AlgorithmData):
     """
     Class to parse data exported with the NSGA3 algorithm.
     """
 
+    @staticmethod
+    def run(
+        variables: list[Variable],
+        objectives: list[Objective],
+        evaluator: BatchEvaluator,
+        number_of_partitions: int | TwoLayerPartitions,
+        number_of_generations: int,
+        number_of_individuals: int | None = None,
+        constraints: list[Constraint] | None = None,
+        batch_size: int | None = None,
+        seed: int | None = None,
+    ) -> "NSGA3":
+        """
+        Solve a problem with the NSGA3 algorithm.
+        :param variables: The problem variables.
+        :param objectives: The problem objectives.
+        :param evaluator: The function evaluating a batch of solutions. This receives a
+        (N, V) array with the variable values of N individuals (with the columns ordered
+        as `variables`) and must return a (N, M) array with the objective values or, when
+        constraints are set, a tuple with the (N, M) objective array and the (N, C)
+        constraint array. The GIL is released while the algorithm runs and is only
+        acquired to call this function.
+        :param number_of_partitions: The number of partitions used to generate the
+        reference points (see `DasDarren1998`).
+        :param number_of_generations: The number of generations to evolve.
+        :param number_of_individuals: The number of individuals in the population. This
+        defaults to the number of reference points.
+        :param constraints: The optional problem constraints.
+        :param batch_size: The maximum number of individuals passed to the evaluator at
+        once. This defaults to the population size.
+        :param seed: The seed to reproduce the results.
+        :return: The data at the last generation.
+        """
+
     def plot_reference_points(self, reference_points: list[list[float]]) -> plt.Figure:
         """
         Generate a chart showing the reference point locations used by the algorithm and
@@ -0,0 +1,97 @@
+use numpy::{PyArray1, PyArray2, PyArrayMethods};
+use pyo3::prelude::*;
+
+use optirustic::core::{Individual, ObjectiveDirection, VariableValue};
+
+/// Move a row-major matrix into a NumPy array without copying it. The array takes ownership of
+/// the Rust vector, which is freed when the array is garbage-collected.
+///
+/// # Arguments
+///
+/// * `values`: The matrix values stored by row.
+/// * `rows`: The number of rows.
+/// * `columns`: The number of columns.
+///
+/// returns: `PyResult<Bound<PyArray2<f64>>>`
+pub fn into_array2(
+    py: Python<'_>,
+    values: Vec<f64>,
+    rows: usize,
+    columns: usize,
+) -> PyResult<Bound<'_, PyArray2<f64>>> {
+    PyArray1::from_vec_bound(py, values).reshape([rows, columns])
+}
+
+/// Collect the objective values of the individuals in a row-major matrix, with one row per
+/// individual and the columns in the same order as the problem objective names. Maximised
+/// objectives are returned with their original sign.
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals.
+///
+/// returns: `Vec<f64>`
+pub fn objective_matrix(individuals: &[Individual]) -> Vec<f64> {
+    let Some(first) = individuals.first() else {
+        return vec![];
+    };
+    let problem = first.problem();
+    let signs: Vec<f64> = problem
+        .objectives()
+        .iter()
+        .map(|(_, objective)| match objective.direction() {
+            ObjectiveDirection::Minimise => 1.0,
+            ObjectiveDirection::Maximise => -1.0,
+        })
+        .collect();
+
+    let mut values = Vec::with_capacity(individuals.len() * signs.len());
+    for individual in individuals {
+        values.extend(
+            individual
+                .objective_values_slice()
+                .iter()
+                .zip(&signs)
+                .map(|(v, s)| v * s),
+        );
+    }
+    values
+}
+
+/// Collect the constraint values of the individuals in a row-major matrix, with one row per
+/// individual and the columns in the same order as the problem constraint names.
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals.
+///
+/// returns: `Vec<f64>`
+pub fn constraint_matrix(individuals: &[Individual]) -> Vec<f64> {
+    individuals
+        .iter()
+        .flat_map(|i| i.constraint_values_slice().iter().copied())
+        .collect()
+}
+
+/// Collect the variable values of the individuals in a row-major matrix, with one row per
+/// individual and the columns in the same order as the problem variable names. Integer and
+/// boolean values are converted to floats; choice variables are stored as `NaN`.
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals.
+///
+/// returns: `Vec<f64>`
+pub fn variable_matrix(individuals: &[&Individual]) -> Vec<f64> {
+    individuals
+        .iter()
+        .flat_map(|i| {
+            i.variable_values_slice().iter().map(|v| match v {
+                VariableValue::Real(v) => *v,
+                VariableValue::Integer(v) => *v as f64,
+                VariableValue::Boolean(v) => f64::from(u8::from(*v)),
+                VariableValue::Choice(_) => f64::NAN,
+            })
+        })
+        .collect()
+}
@@ -6,7 +6,7 @@ use optirustic::core::{Constraint, RelationalOperator};
 
 /// Constraint
 #[pyclass(name = "RelationalOperator", eq, eq_int)]
-#[derive(PartialEq)]
+#[derive(Clone, PartialEq)]
 pub enum PyRelationalOperator {
     EqualTo,
     NotEqualTo,
@@ -39,6 +39,16 @@ pub struct PyConstraint {
 
 #[pymethods]
 impl PyConstraint {
+    #[new]
+    /// Create a new constraint.
+    pub fn new(name: String, operator: PyRelationalOperator, target: f64) -> Self {
+        Self {
+            name,
+            operator,
+            target,
+        }
+    }
+
     pub fn __repr__(&self) -> PyResult<String> {
         Ok(format!(
             "Constraint(name='{}', operator='{}', target={})",
@@ -68,3 +78,18 @@ impl From<&Constraint> for PyConstraint {
         }
     }
 }
+
+/// Convert `PyConstraint` to `Constraint`
+impl From<&PyConstraint> for Constraint {
+    fn from(value: &PyConstraint) -> Self {
+        let operator = match value.operator {
+            PyRelationalOperator::EqualTo => RelationalOperator::EqualTo,
+            PyRelationalOperator::NotEqualTo => RelationalOperator::NotEqualTo,
+            PyRelationalOperator::LessOrEqualTo => RelationalOperator::LessOrEqualTo,
+            PyRelationalOperator::LessThan => RelationalOperator::LessThan,
+            PyRelationalOperator::GreaterOrEqualTo => RelationalOperator::GreaterOrEqualTo,
+            PyRelationalOperator::GreaterThan => RelationalOperator::GreaterThan,
+        };
+        Constraint::new(&value.name, operator, value.target)
+    }
+}
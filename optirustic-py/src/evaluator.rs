@@ -0,0 +1,133 @@
+use std::error::Error;
+
+use numpy::{PyReadonlyArray2, PyUntypedArrayMethods};
+use pyo3::exceptions::PyValueError;
+use pyo3::prelude::*;
+
+use optirustic::core::{BatchEvaluationResult, BatchEvaluator, Individual};
+
+use crate::arrays::{into_array2, variable_matrix};
+
+/// Evaluate the individuals with a Python function receiving a batch of solutions. The
+/// function is called with a `(N, V)` NumPy array with the variable values of `N` individuals
+/// (in the same order as the problem variable names) and must return a `(N, M)` array with the
+/// objective values or, for constrained problems, a tuple with the `(N, M)` objective array
+/// and the `(N, C)` constraint array.
+///
+/// The GIL is only held while the function runs, so that the rest of the algorithm work (such as
+/// the sorting and the reproduction) does not block other Python threads.
+#[derive(Debug)]
+pub struct PyBatchEvaluator {
+    /// The Python function.
+    function: Py<PyAny>,
+    /// The number of problem objectives.
+    number_of_objectives: usize,
+    /// The number of problem constraints.
+    number_of_constraints: usize,
+}
+
+impl PyBatchEvaluator {
+    /// Create the evaluator.
+    ///
+    /// # Arguments
+    ///
+    /// * `function`: The Python function.
+    /// * `number_of_objectives`: The number of problem objectives.
+    /// * `number_of_constraints`: The number of problem constraints.
+    ///
+    /// returns: `PyResult<PyBatchEvaluator>`
+    pub fn new(
+        py: Python<'_>,
+        function: Py<PyAny>,
+        number_of_objectives: usize,
+        number_of_constraints: usize,
+    ) -> PyResult<Self> {
+        if !function.bind(py).is_callable() {
+            return Err(PyValueError::new_err("The evaluator must be a function"));
+        }
+        Ok(Self {
+            function,
+            number_of_objectives,
+            number_of_constraints,
+        })
+    }
+
+    /// Copy a two-dimensional array returned by the Python function and check its shape.
+    ///
+    /// # Arguments
+    ///
+    /// * `array`: The array.
+    /// * `rows`: The expected number of rows.
+    /// * `columns`: The expected number of columns.
+    /// * `label`: The label describing the array in the error message.
+    ///
+    /// returns: `PyResult<Vec<f64>>`. The values stored by row.
+    fn to_matrix(
+        array: &PyReadonlyArray2<f64>,
+        rows: usize,
+        columns: usize,
+        label: &str,
+    ) -> PyResult<Vec<f64>> {
+        if array.shape() != [rows, columns] {
+            return Err(PyValueError::new_err(format!(
+                "The evaluator returned a {label} array with shape {:?}, but ({rows}, {columns}) was expected",
+                array.shape()
+            )));
+        }
+        // C-contiguous arrays are copied at once; the other layouts are copied by row
+        Ok(match array.as_slice() {
+            Ok(values) => values.to_vec(),
+            Err(_) => array.as_array().iter().copied().collect(),
+        })
+    }
+}
+
+impl BatchEvaluator for PyBatchEvaluator {
+    fn evaluate_batch(
+        &self,
+        individuals: &[&Individual],
+    ) -> Result<BatchEvaluationResult, Box<dyn Error>> {
+        let rows = individuals.len();
+        let columns = individuals
+            .first()
+            .map_or(0, |i| i.problem().number_of_variables());
+        let variables = variable_matrix(individuals);
+
+        let result = Python::with_gil(|py| -> PyResult<BatchEvaluationResult> {
+            let variables = into_array2(py, variables, rows, columns)?;
+            let output = self.function.call1(py, (variables,))?;
+            let output = output.bind(py);
+
+            if self.number_of_constraints == 0 {
+                let objectives = output.extract::<PyReadonlyArray2<f64>>()?;
+                return Ok(BatchEvaluationResult {
+                    objectives: Self::to_matrix(
+                        &objectives,
+                        rows,
+                        self.number_of_objectives,
+                        "objective",
+                    )?,
+                    constraints: vec![],
+                });
+            }
+
+            let (objectives, constraints) =
+                output.extract::<(PyReadonlyArray2<f64>, PyReadonlyArray2<f64>)>()?;
+            Ok(BatchEvaluationResult {
+                objectives: Self::to_matrix(
+                    &objectives,
+                    rows,
+                    self.number_of_objectives,
+                    "objective",
+                )?,
+                constraints: Self::to_matrix(
+                    &constraints,
+                    rows,
+                    self.number_of_constraints,
+                    "constraint",
+                )?,
+            })
+        })?;
+        Ok(result)
+    }
+}
@@ -7,20 +7,25 @@ use pyo3::exceptions::PyValueError;
 use pyo3::prelude::*;
 use pyo3::types::PyDict;
 
+use numpy::PyArray2;
 use optirustic::algorithms::{
-    Algorithm, AlgorithmExport, AlgorithmSerialisedExport, NSGA2Arg, NSGA3Arg, NSGA2 as RustNSGA2,
-    NSGA3 as RustNSGA3,
+    Algorithm, AlgorithmExport, AlgorithmSerialisedExport, MaxGenerationValue, NSGA2Arg, NSGA3Arg,
+    Nsga3NumberOfIndividuals, StoppingConditionType, NSGA2 as RustNSGA2, NSGA3 as RustNSGA3,
 };
-use optirustic::core::OError;
-use optirustic::metrics::HyperVolume;
+use optirustic::core::{Individual, OError};
+use optirustic::metrics::{AllHyperVolumeFileData, HyperVolume};
 
-use crate::constraint::PyRelationalOperator;
+use crate::arrays::{constraint_matrix, into_array2, objective_matrix, variable_matrix};
+use crate::constraint::{PyConstraint, PyRelationalOperator};
 use crate::individual::{PyData, PyIndividual};
-use crate::objective::PyObjectiveDirection;
-use crate::problem::PyProblem;
-use crate::reference_points::PyDasDarren1998;
+use crate::objective::{PyObjective, PyObjectiveDirection};
+use crate::problem::{batch_problem, PyProblem};
+use crate::reference_points::{PyDasDarren1998, PyNumberOfPartitions};
+use crate::variable::{PyVariable, PyVariableType};
 
+mod arrays;
 mod constraint;
+mod evaluator;
 mod individual;
 mod objective;
 mod problem;
@@ -55,32 +60,34 @@ macro_rules! create_interface {
             exported_on: DateTime<Utc>,
         }
 
-        #[pymethods]
         impl $name {
-            #[new]
-            /// Initialise the class
-            pub fn new(file: String) -> PyResult<Self> {
-                let path = PathBuf::from(file);
-                let file_data: AlgorithmSerialisedExport<$ArgType> =
-                    $type::read_json_file(&path)
-                        .map_err(|e| PyValueError::new_err(e.to_string()))?;
-
+            /// Wrap the data exported by an algorithm.
+            ///
+            /// # Arguments
+            ///
+            /// * `export_data`: The exported data.
+            /// * `exported_on`: The date and time when the data was exported.
+            ///
+            /// returns: `PyResult<Self>`
+            fn from_export(
+                export_data: AlgorithmExport,
+                exported_on: DateTime<Utc>,
+            ) -> PyResult<Self> {
                 // Algorthm data
-                let additional_data = file_data.additional_data.clone().map(|data_map| {
-                    data_map
-                        .iter()
-                        .map(|(n, v)| {
-                            let v: PyData = v.into();
-                            (n.clone(), v)
-                        })
-                        .collect()
-                });
-                let exported_on = file_data.exported_on.clone();
-
-                // Convert export
-                let export_data: AlgorithmExport = file_data
-                    .try_into()
-                    .map_err(|e: OError| PyValueError::new_err(e.to_string()))?;
+                let additional_data = if export_data.additional_data.is_empty() {
+                    None
+                } else {
+                    Some(
+                        export_data
+                            .additional_data
+                            .iter()
+                            .map(|(n, v)| {
+                                let v: PyData = v.into();
+                                (n.clone(), v)
+                            })
+                            .collect(),
+                    )
+                };
 
                 // Problem
                 let p = &export_data.problem;
@@ -133,6 +140,43 @@ macro_rules! create_interface {
                 })
             }
 
+            /// Calculate the hyper-volume from the objective values exported in a folder.
+            ///
+            /// # Arguments
+            ///
+            /// * `folder`: The folder with the exported files.
+            /// * `reference_point`: The reference point.
+            ///
+            /// returns: `PyResult<AllHyperVolumeFileData>`
+            fn hyper_volume_from_files(
+                folder: PathBuf,
+                reference_point: &[f64],
+            ) -> PyResult<AllHyperVolumeFileData> {
+                let objectives = $type::read_objective_files(&folder)
+                    .map_err(|e| PyValueError::new_err(e.to_string()))?;
+                HyperVolume::from_objectives(&objectives, reference_point)
+                    .map_err(|e| PyValueError::new_err(e.to_string()))
+            }
+        }
+
+        #[pymethods]
+        impl $name {
+            #[new]
+            /// Initialise the class
+            pub fn new(file: String) -> PyResult<Self> {
+                let path = PathBuf::from(file);
+                let file_data: AlgorithmSerialisedExport<$ArgType> =
+                    $type::read_json_file(&path)
+                        .map_err(|e| PyValueError::new_err(e.to_string()))?;
+                let exported_on = file_data.exported_on.clone();
+
+                // Convert export
+                let export_data: AlgorithmExport = file_data
+                    .try_into()
+                    .map_err(|e: OError| PyValueError::new_err(e.to_string()))?;
+                Self::from_export(export_data, exported_on)
+            }
+
             #[getter]
             /// Get the generation number.
             pub fn generation(&self) -> usize {
@@ -145,21 +189,83 @@ macro_rules! create_interface {
                 self.export_data.algorithm.clone()
             }
 
-            /// Calculate the hyper-volume metric.
-            pub fn hyper_volume(&mut self, reference_point: Vec<f64>) -> PyResult<f64> {
-                let hv = HyperVolume::from_individual(
-                    &mut self.export_data.individuals,
-                    &reference_point,
+            #[getter]
+            /// Get the objective values as a `(N, M)` NumPy array, with one row per individual and
+            /// the columns ordered as the problem objective names.
+            pub fn objective_values<'py>(
+                &self,
+                py: Python<'py>,
+            ) -> PyResult<Bound<'py, PyArray2<f64>>> {
+                let individuals = &self.export_data.individuals;
+                let values = py.allow_threads(|| objective_matrix(individuals));
+                into_array2(
+                    py,
+                    values,
+                    individuals.len(),
+                    self.problem.number_of_objectives,
+                )
+            }
+
+            #[getter]
+            /// Get the constraint values as a `(N, C)` NumPy array, with one row per individual
+            /// and the columns ordered as the problem constraint names.
+            pub fn constraint_values<'py>(
+                &self,
+                py: Python<'py>,
+            ) -> PyResult<Bound<'py, PyArray2<f64>>> {
+                let individuals = &self.export_data.individuals;
+                let values = py.allow_threads(|| constraint_matrix(individuals));
+                into_array2(
+                    py,
+                    values,
+                    individuals.len(),
+                    self.problem.number_of_constraints,
                 )
-                .map_err(|e| PyValueError::new_err(e.to_string()))?;
+            }
+
+            #[getter]
+            /// Get the variable values as a `(N, V)` NumPy array, with one row per individual and
+            /// the columns ordered as the problem variable names. Choice variables are set to NaN.
+            pub fn variable_values<'py>(
+                &self,
+                py: Python<'py>,
+            ) -> PyResult<Bound<'py, PyArray2<f64>>> {
+                let individuals = &self.export_data.individuals;
+                let values = py.allow_threads(|| {
+                    let individuals: Vec<&Individual> = individuals.iter().collect();
+                    variable_matrix(&individuals)
+                });
+                into_array2(
+                    py,
+                    values,
+                    individuals.len(),
+                    self.problem.number_of_variables,
+                )
+            }
+
+            /// Calculate the hyper-volume metric.
+            pub fn hyper_volume(
+                &mut self,
+                py: Python<'_>,
+                reference_point: Vec<f64>,
+            ) -> PyResult<f64> {
+                let individuals = &mut self.export_data.individuals;
+                let hv = py
+                    .allow_threads(|| HyperVolume::from_individual(individuals, &reference_point))
+                    .map_err(|e| PyValueError::new_err(e.to_string()))?;
                 Ok(hv)
             }
 
             /// Estimate the reference point from serialised data.
             #[pyo3(signature = (offset=None))]
-            pub fn estimate_reference_point(&self, offset: Option<Vec<f64>>) -> PyResult<Vec<f64>> {
+            pub fn estimate_reference_point(
+                &self,
+                py: Python<'_>,
+                offset: Option<Vec<f64>>,
+            ) -> PyResult<Vec<f64>> {
                 let individuals = &self.export_data.individuals;
-                let ref_point = HyperVolume::estimate_reference_point(individuals, offset)
+                let ref_point = py
+                    .allow_threads(|| HyperVolume::estimate_reference_point(individuals, offset))
                     .map_err(|e| PyValueError::new_err(e.to_string()))?;
                 Ok(ref_point)
             }
@@ -168,30 +274,27 @@ macro_rules! create_interface {
             #[staticmethod]
             #[pyo3(signature = (folder, offset=None))]
             pub fn estimate_reference_point_from_files(
+                py: Python<'_>,
                 folder: PathBuf,
                 offset: Option<Vec<f64>>,
             ) -> PyResult<Vec<f64>> {
-                let all_serialise_data_vec = $type::read_json_files(&folder)
-                    .map_err(|e| PyValueError::new_err(e.to_string()))?;
-                let ref_point = HyperVolume::estimate_reference_point_from_files(
-                    &all_serialise_data_vec,
-                    offset,
-                )
-                .map_err(|e| PyValueError::new_err(e.to_string()))?;
-                Ok(ref_point)
+                py.allow_threads(|| {
+                    let objectives = $type::read_objective_files(&folder)
+                        .map_err(|e| PyValueError::new_err(e.to_string()))?;
+                    HyperVolume::estimate_reference_point_from_objectives(&objectives, offset)
+                        .map_err(|e| PyValueError::new_err(e.to_string()))
+                })
             }
 
             #[staticmethod]
             pub fn convergence_data(
+                py: Python<'_>,
                 folder: String,
                 reference_point: Vec<f64>,
             ) -> PyResult<(Vec<usize>, Vec<DateTime<Utc>>, Vec<f64>)> {
-                let folder = PathBuf::from(folder);
-                let all_serialise_data = $type::read_json_files(&folder)
-                    .map_err(|e| PyValueError::new_err(e.to_string()))?;
-                let data = HyperVolume::from_files(&all_serialise_data, &reference_point)
-                    .map_err(|e| PyValueError::new_err(e.to_string()))?;
-
+                let data = py.allow_threads(|| {
+                    Self::hyper_volume_from_files(PathBuf::from(folder), &reference_point)
+                })?;
                 Ok((data.generations(), data.times(), data.values()))
             }
 
@@ -219,19 +322,15 @@ macro_rules! create_interface {
 
             #[staticmethod]
             pub fn plot_convergence(
+                py: Python<'_>,
                 folder: String,
                 reference_point: Vec<f64>,
             ) -> PyResult<PyObject> {
-                let folder = PathBuf::from(folder);
-                let all_serialise_data = $type::read_json_files(&folder)
-                    .map_err(|e| PyValueError::new_err(e.to_string()))?;
-                let data = HyperVolume::from_files(&all_serialise_data, &reference_point)
-                    .map_err(|e| PyValueError::new_err(e.to_string()))?;
-
-                Python::with_gil(|py| {
-                    let fun: Py<PyAny> = get_plot_fun("plot_convergence", py)?;
-                    fun.call1(py, (data.generations(), data.values()))
-                })
+                let data = py.allow_threads(|| {
+                    Self::hyper_volume_from_files(PathBuf::from(folder), &reference_point)
+                })?;
+                let fun: Py<PyAny> = get_plot_fun("plot_convergence", py)?;
+                fun.call1(py, (data.generations(), data.values()))
             }
         }
     };
@@ -241,8 +340,116 @@ macro_rules! create_interface {
 create_interface!(NSGA2, RustNSGA2, NSGA2Arg);
 create_interface!(NSGA3, RustNSGA3, NSGA3Arg);
 
+#[pymethods]
+impl NSGA2 {
+    /// Solve a problem with the NSGA2 algorithm. The solutions are evaluated in batches by the
+    /// Python `evaluator` function; the GIL is released while the algorithm runs and only
+    /// acquired to call the function.
+    #[staticmethod]
+    #[pyo3(signature = (variables, objectives, evaluator, number_of_individuals, number_of_generations, constraints=None, batch_size=None, seed=None))]
+    #[allow(clippy::too_many_arguments)]
+    pub fn run(
+        py: Python<'_>,
+        variables: Vec<PyRef<'_, PyVariable>>,
+        objectives: Vec<PyRef<'_, PyObjective>>,
+        evaluator: Py<PyAny>,
+        number_of_individuals: usize,
+        number_of_generations: usize,
+        constraints: Option<Vec<PyRef<'_, PyConstraint>>>,
+        batch_size: Option<usize>,
+        seed: Option<u64>,
+    ) -> PyResult<Self> {
+        let problem = batch_problem(
+            py,
+            variables,
+            objectives,
+            constraints,
+            evaluator,
+            batch_size.unwrap_or(number_of_individuals),
+        )?;
+        let args = NSGA2Arg {
+            number_of_individuals,
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(
+                number_of_generations,
+            )),
+            parallel: None,
+            export_history: None,
+            resume_from_file: None,
+            seed,
+        };
+
+        let export_data = py
+            .allow_threads(|| -> Result<AlgorithmExport, OError> {
+                let mut algo = RustNSGA2::new(problem, args)?;
+                algo.run()?;
+                Ok(algo.get_results())
+            })
+            .map_err(|e| PyValueError::new_err(e.to_string()))?;
+        Self::from_export(export_data, Utc::now())
+    }
+}
+
 #[pymethods]
 impl NSGA3 {
+    /// Solve a problem with the NSGA3 algorithm. The number of individuals is set equal to the
+    /// number of reference points, unless `number_of_individuals` is given. The solutions are
+    /// evaluated in batches by the Python `evaluator` function; the GIL is released while the
+    /// algorithm runs and only acquired to call the function.
+    #[staticmethod]
+    #[pyo3(signature = (variables, objectives, evaluator, number_of_partitions, number_of_generations, number_of_individuals=None, constraints=None, batch_size=None, seed=None))]
+    #[allow(clippy::too_many_arguments)]
+    pub fn run(
+        py: Python<'_>,
+        variables: Vec<PyRef<'_, PyVariable>>,
+        objectives: Vec<PyRef<'_, PyObjective>>,
+        evaluator: Py<PyAny>,
+        number_of_partitions: PyNumberOfPartitions,
+        number_of_generations: usize,
+        number_of_individuals: Option<usize>,
+        constraints: Option<Vec<PyRef<'_, PyConstraint>>>,
+        batch_size: Option<usize>,
+        seed: Option<u64>,
+    ) -> PyResult<Self> {
+        // by default, evaluate the whole population at once
+        let batch_size = batch_size.unwrap_or(number_of_individuals.unwrap_or(usize::MAX));
+        let number_of_individuals = match number_of_individuals {
+            Some(n) => Nsga3NumberOfIndividuals::Custom(n),
+            None => Nsga3NumberOfIndividuals::EqualToReferencePointCount,
+        };
+        let number_of_partitions = (&number_of_partitions).into();
+        let problem = batch_problem(
+            py,
+            variables,
+            objectives,
+            constraints,
+            evaluator,
+            batch_size,
+        )?;
+        let args = NSGA3Arg {
+            number_of_individuals,
+            number_of_partitions,
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(
+                number_of_generations,
+            )),
+            parallel: None,
+            export_history: None,
+            seed,
+        };
+
+        let export_data = py
+            .allow_threads(|| -> Result<AlgorithmExport, OError> {
+                let mut algo = RustNSGA3::new(problem, args, false)?;
+                algo.run()?;
+                Ok(algo.get_results())
+            })
+            .map_err(|e| PyValueError::new_err(e.to_string()))?;
+        Self::from_export(export_data, Utc::now())
+    }
+
     /// Refrence point plot using the points exported by the NSGA3 algorithm
     pub fn plot_reference_points(&self) -> PyResult<PyObject> {
         let algorithm_data = self.additional_data.as_ref().unwrap();
@@ -261,6 +468,10 @@ fn optirustic_py(m: &Bound<'_, PyModule>) -> PyResult<()> {
     m.add_class::<PyObjectiveDirection>()?;
     m.add_class::<PyRelationalOperator>()?;
     m.add_class::<PyDasDarren1998>()?;
+    m.add_class::<PyVariableType>()?;
+    m.add_class::<PyVariable>()?;
+    m.add_class::<PyObjective>()?;
+    m.add_class::<PyConstraint>()?;
 
     Ok(())
 }
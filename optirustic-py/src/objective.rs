@@ -28,6 +28,12 @@ pub struct PyObjective {
 
 #[pymethods]
 impl PyObjective {
+    #[new]
+    /// Create a new objective.
+    pub fn new(name: String, direction: PyObjectiveDirection) -> Self {
+        Self { name, direction }
+    }
+
     pub fn __repr__(&self) -> PyResult<String> {
         Ok(format!(
             "Objective(name='{}', direction='{}')",
@@ -52,3 +58,14 @@ impl From<&Objective> for PyObjective {
         }
     }
 }
+
+/// Convert `PyObjective` to `Objective`
+impl From<&PyObjective> for Objective {
+    fn from(value: &PyObjective) -> Self {
+        let direction = match value.direction {
+            PyObjectiveDirection::Minimise => ObjectiveDirection::Minimise,
+            PyObjectiveDirection::Maximise => ObjectiveDirection::Maximise,
+        };
+        Objective::new(&value.name, direction)
+    }
+}
@@ -1,10 +1,12 @@
 use std::collections::HashMap;
 
+use pyo3::exceptions::PyValueError;
 use pyo3::prelude::*;
 
-use optirustic::core::{Constraint, Objective, VariableType};
+use optirustic::core::{Constraint, Objective, Problem, VariableType};
 
 use crate::constraint::PyConstraint;
+use crate::evaluator::PyBatchEvaluator;
 use crate::objective::PyObjective;
 use crate::variable::PyVariable;
 
@@ -71,3 +73,46 @@ impl PyProblem {
         self.__repr__().unwrap()
     }
 }
+
+/// Build a problem whose solutions are evaluated in batches by a Python function.
+///
+/// # Arguments
+///
+/// * `variables`: The problem variables.
+/// * `objectives`: The problem objectives.
+/// * `constraints`: The optional problem constraints.
+/// * `evaluator`: The Python function evaluating a batch of solutions (see [`PyBatchEvaluator`]).
+/// * `batch_size`: The maximum number of individuals passed to the function at once.
+///
+/// returns: `PyResult<Problem>`
+pub fn batch_problem(
+    py: Python<'_>,
+    variables: Vec<PyRef<'_, PyVariable>>,
+    objectives: Vec<PyRef<'_, PyObjective>>,
+    constraints: Option<Vec<PyRef<'_, PyConstraint>>>,
+    evaluator: Py<PyAny>,
+    batch_size: usize,
+) -> PyResult<Problem> {
+    let variable_types = variables
+        .iter()
+        .map(|v| VariableType::try_from(&**v))
+        .collect::<PyResult<Vec<_>>>()?;
+    let objectives: Vec<Objective> = objectives.iter().map(|o| (&**o).into()).collect();
+    let constraints: Option<Vec<Constraint>> =
+        constraints.map(|c| c.iter().map(|c| (&**c).into()).collect());
+
+    let evaluator = PyBatchEvaluator::new(
+        py,
+        evaluator,
+        objectives.len(),
+        constraints.as_ref().map_or(0, |c| c.len()),
+    )?;
+    Problem::new_with_batch_evaluator(
+        objectives,
+        variable_types,
+        constraints,
+        Box::new(evaluator),
+        batch_size,
+    )
+    .map_err(|e| PyValueError::new_err(e.to_string()))
+}
@@ -21,6 +21,22 @@ pub enum PyNumberOfPartitions {
     TwoLayers(PyTwoLayerPartitions),
 }
 
+/// Convert `PyNumberOfPartitions` to `NumberOfPartitions`
+impl From<&PyNumberOfPartitions> for NumberOfPartitions {
+    fn from(value: &PyNumberOfPartitions) -> Self {
+        match value {
+            PyNumberOfPartitions::OneLayer(n) => NumberOfPartitions::OneLayer(*n),
+            PyNumberOfPartitions::TwoLayers(data) => {
+                NumberOfPartitions::TwoLayers(TwoLayerPartitions {
+                    boundary_layer: data.boundary_layer,
+                    inner_layer: data.inner_layer,
+                    scaling: data.scaling,
+                })
+            }
+        }
+    }
+}
+
 #[pyclass(name = "DasDarren1998")]
 #[derive(Clone)]
 pub struct PyDasDarren1998 {
@@ -43,16 +59,7 @@ impl PyDasDarren1998 {
     }
 
     pub fn calculate(&self) -> PyResult<Vec<Vec<f64>>> {
-        let number_of_partitions = match &self.number_of_partitions {
-            PyNumberOfPartitions::OneLayer(n) => NumberOfPartitions::OneLayer(*n),
-            PyNumberOfPartitions::TwoLayers(data) => {
-                NumberOfPartitions::TwoLayers(TwoLayerPartitions {
-                    boundary_layer: data.boundary_layer,
-                    inner_layer: data.inner_layer,
-                    scaling: data.scaling,
-                })
-            }
-        };
+        let number_of_partitions: NumberOfPartitions = (&self.number_of_partitions).into();
         let ds = DasDarren1998::new(self.number_of_objectives, &number_of_partitions)
             .map_err(|e| PyValueError::new_err(e.to_string()))?;
         Ok(ds.get_weights())
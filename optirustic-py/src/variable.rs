@@ -1,6 +1,7 @@
+use pyo3::exceptions::PyValueError;
 use pyo3::prelude::*;
 
-use optirustic::core::VariableType;
+use optirustic::core::{Boolean, BoundedNumber, VariableType};
 
 #[pyclass(name = "VariableType", eq, eq_int)]
 #[derive(Clone, PartialEq)]
@@ -64,6 +65,23 @@ impl From<&VariableType> for PyVariable {
 
 #[pymethods]
 impl PyVariable {
+    #[new]
+    #[pyo3(signature = (name, var_type, min_value=None, max_value=None))]
+    /// Create a new variable. Real and integer variables need the bounds.
+    pub fn new(
+        name: String,
+        var_type: PyVariableType,
+        min_value: Option<f64>,
+        max_value: Option<f64>,
+    ) -> Self {
+        Self {
+            name,
+            var_type,
+            min_value,
+            max_value,
+        }
+    }
+
     pub fn __repr__(&self) -> PyResult<String> {
         let args = if let (Some(min_value), Some(max_value)) = (self.min_value, self.max_value) {
             format!(", min-value={min_value}, max_value={max_value}")
@@ -81,3 +99,42 @@ impl PyVariable {
         self.__repr__().unwrap()
     }
 }
+
+/// Convert `PyVariable` to `VariableType`. Choice variables are not supported because their
+/// values cannot be passed to the batch evaluator in a NumPy array of floats.
+impl TryFrom<&PyVariable> for VariableType {
+    type Error = PyErr;
+
+    fn try_from(value: &PyVariable) -> Result<Self, Self::Error> {
+        let bounds = || match (value.min_value, value.max_value) {
+            (Some(min_value), Some(max_value)) => Ok((min_value, max_value)),
+            _ => Err(PyValueError::new_err(format!(
+                "The variable '{}' must have a minimum and maximum value",
+                value.name
+            ))),
+        };
+        let to_err = |e: optirustic::core::OError| PyValueError::new_err(e.to_string());
+        Ok(match value.var_type {
+            PyVariableType::Real => {
+                let (min_value, max_value) = bounds()?;
+                VariableType::Real(
+                    BoundedNumber::new(&value.name, min_value, max_value).map_err(to_err)?,
+                )
+            }
+            PyVariableType::Integer => {
+                let (min_value, max_value) = bounds()?;
+                VariableType::Integer(
+                    BoundedNumber::new(&value.name, min_value as i64, max_value as i64)
+                        .map_err(to_err)?,
+                )
+            }
+            PyVariableType::Boolean => VariableType::Boolean(Boolean::new(&value.name)),
+            PyVariableType::Choice => {
+                return Err(PyValueError::new_err(format!(
+                    "The choice variable '{}' cannot be used in a Python problem",
+                    value.name
+                )))
+            }
+        })
+    }
+}
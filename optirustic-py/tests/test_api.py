@@ -2,11 +2,15 @@ import unittest
 from pathlib import Path
 
 import matplotlib.pyplot as plt
+import numpy as np
 from optirustic import (
     NSGA3,
     ObjectiveDirection,
     NSGA2,
     DasDarren1998,
+    Objective,
+    Variable,
+    VariableType,
 )
 
 
@@ -39,6 +43,40 @@ class PythonTest(unittest.TestCase):
 
         self.assertAlmostEqual(data.hyper_volume([100, 100, 100]), 999999.97, 2)
 
+    def test_arrays(self):
+        file = (
+            self.root_folder / "examples" / "results" / "DTLZ1_3obj_NSGA3_gen400.json"
+        )
+        data = NSGA3(file.as_posix())
+
+        objectives = data.objective_values
+        self.assertEqual(objectives.shape, (len(data.individuals), 3))
+        self.assertAlmostEqual(
+            objectives[0, 1], data.individuals[0].get_objective_value("f2")
+        )
+        self.assertEqual(data.constraint_values.shape, (len(data.individuals), 1))
+        self.assertEqual(data.variable_values.shape, (len(data.individuals), 7))
+
+    def test_run(self):
+        def evaluator(x: np.ndarray) -> np.ndarray:
+            return np.column_stack((x[:, 0] ** 2, (x[:, 0] - 2) ** 2))
+
+        data = NSGA2.run(
+            variables=[Variable("x", VariableType.Real, -1000, 1000)],
+            objectives=[
+                Objective("x^2", ObjectiveDirection.Minimise),
+                Objective("(x-2)^2", ObjectiveDirection.Minimise),
+            ],
+            evaluator=evaluator,
+            number_of_individuals=20,
+            number_of_generations=50,
+            seed=1,
+        )
+        self.assertEqual(data.generation, 50)
+        self.assertEqual(data.objective_values.shape, (20, 2))
+        # the Pareto-optimal solutions are in [0, 2]
+        self.assertTrue(np.all((data.variable_values > -0.1) & (data.variable_values < 2.1)))
+
     def test_plot(self):
         self.assertTrue(
             isinstance(
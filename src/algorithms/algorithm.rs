@@ -1,8 +1,7 @@
 use std::collections::HashMap;
 use std::fmt::{Debug, Display, Formatter};
-use std::fs::read_dir;
 use std::path::PathBuf;
-use std::sync::Arc;
+use std::sync::{Arc, Mutex};
 use std::time::Instant;
 use std::{fmt, fs};
 
@@ -12,10 +11,18 @@ use rayon::prelude::*;
 use serde::de::DeserializeOwned;
 use serde::{Deserialize, Serialize};
 
-use crate::algorithms::{StoppingCondition, StoppingConditionType};
+use crate::algorithms::history::{
+    is_history_file, read_generations, read_last_generation, GenerationBlock, GenerationMetadata,
+    HistoryColumns, HistoryHeader, HistoryWriter,
+};
+use crate::algorithms::objectives::{export_files, read_objective_files};
+use crate::algorithms::{
+    GenerationObjectives, HistoryFormat, Instrumentation, StoppingCondition, StoppingConditionType,
+    HISTORY_FILE_EXTENSION,
+};
 use crate::core::{
-    DataValue, Individual, IndividualExport, OError, ObjectiveDirection, Population, Problem,
-    ProblemExport,
+    BatchEvaluator, DataValue, EvaluationCache, EvaluationCacheStats, Individual, IndividualExport,
+    OError, ObjectiveDirection, Population, Problem, ProblemExport,
 };
 
 #[derive(Serialize, Deserialize, Debug)]
@@ -47,6 +54,9 @@ pub struct AlgorithmSerialisedExport<T: Serialize> {
     pub algorithm: String,
     /// Any additional data exported by the algorithm.
     pub additional_data: Option<HashMap<String, DataValue>>,
+    /// The counters of the evaluation cache, when enabled on the problem.
+    #[serde(default)]
+    pub evaluation_cache: Option<EvaluationCacheStats>,
     /// The time took to reach the `generation`.
     pub took: Elapsed,
     /// The date and time when the data was exported
@@ -105,6 +115,7 @@ impl<T: Serialize> TryInto<AlgorithmExport> for AlgorithmSerialisedExport<T> {
             number_of_function_evaluations: self.number_of_function_evaluations,
             took: self.took,
             additional_data: self.additional_data.unwrap_or_default(),
+            evaluation_cache: self.evaluation_cache,
         };
         Ok(data)
     }
@@ -127,6 +138,8 @@ pub struct AlgorithmExport {
     pub took: Elapsed,
     /// Additional data stored in the algorithm (such as reference points for [`NSGA3`]).
     pub additional_data: HashMap<String, DataValue>,
+    /// The counters of the evaluation cache, when enabled on the problem.
+    pub evaluation_cache: Option<EvaluationCacheStats>,
 }
 
 impl AlgorithmExport {
@@ -173,6 +186,12 @@ pub struct ExportHistory {
     generation_step: usize,
     /// Serialise the algorithm history and export the results to a JSON file in the given folder.
     destination: PathBuf,
+    /// The format of the exported files.
+    #[serde(default)]
+    format: HistoryFormat,
+    /// The thread writing the binary history file, started at the first export.
+    #[serde(skip)]
+    writer: Arc<Mutex<Option<HistoryWriter>>>,
 }
 
 impl ExportHistory {
@@ -188,6 +207,27 @@ impl ExportHistory {
     ///
     /// returns: `Result<ExportHistory, OError>`
     pub fn new(generation_step: usize, destination: &PathBuf) -> Result<Self, OError> {
+        Self::new_with_format(generation_step, destination, HistoryFormat::Json)
+    }
+
+    /// Initialise the export history configuration with the format of the exported files. This
+    /// returns an error if the destination folder does not exist.
+    ///
+    /// # Arguments
+    ///
+    /// * `generation_step`: export the algorithm data each time the generation counter in a genetic
+    //  algorithm increases by the provided step.
+    /// * `destination`: serialise the algorithm history and export the results to the given
+    ///    folder.
+    /// * `format`: the format of the exported files. With [`HistoryFormat::Binary`] all the
+    ///    generations are appended to one file by a background thread.
+    ///
+    /// returns: `Result<ExportHistory, OError>`
+    pub fn new_with_format(
+        generation_step: usize,
+        destination: &PathBuf,
+        format: HistoryFormat,
+    ) -> Result<Self, OError> {
         if !destination.exists() {
             return Err(OError::Generic(format!(
                 "The destination folder '{:?}' does not exist",
@@ -197,8 +237,63 @@ impl ExportHistory {
         Ok(Self {
             generation_step,
             destination: destination.to_owned(),
+            format,
+            writer: Arc::default(),
         })
     }
+
+    /// Get the format of the exported files.
+    ///
+    /// returns: `HistoryFormat`
+    pub fn format(&self) -> HistoryFormat {
+        self.format
+    }
+
+    /// Get the number of generations between two exports.
+    ///
+    /// returns: `usize`
+    pub(crate) fn generation_step(&self) -> usize {
+        self.generation_step
+    }
+
+    /// Append a generation to the binary history file. The file is created with its header at
+    /// the first call. This does not wait for the block to be written and returns the error of a
+    /// previous write that failed.
+    ///
+    /// # Arguments
+    ///
+    /// * `algorithm`: The algorithm name used in the file name.
+    /// * `header`: The function returning the header of the file.
+    /// * `block`: The block with the generation data.
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn write_block(
+        &self,
+        algorithm: &str,
+        header: impl FnOnce() -> Result<HistoryHeader, OError>,
+        block: GenerationBlock,
+    ) -> Result<(), OError> {
+        let mut writer = self.writer.lock().unwrap();
+        if writer.is_none() {
+            let file = self
+                .destination
+                .join(format!("History_{algorithm}.{HISTORY_FILE_EXTENSION}"));
+            info!("Saving history to {:?}", file);
+            *writer = Some(HistoryWriter::new(&file, &header()?)?);
+        }
+        writer.as_mut().unwrap().write(block)
+    }
+
+    /// Wait for the binary history file to be written. This returns an error if a generation
+    /// could not be written.
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn finish(&self) -> Result<(), OError> {
+        match self.writer.lock().unwrap().take() {
+            Some(mut writer) => writer.finish(),
+            None => Ok(()),
+        }
+    }
 }
 
 impl Display for AlgorithmExport {
@@ -266,6 +361,17 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
     /// return: `Option<&ExportHistory>`.
     fn export_history(&self) -> Option<&ExportHistory>;
 
+    /// Get the timers and counters collected at each generation.
+    ///
+    /// return: `&Instrumentation`.
+    fn instrumentation(&self) -> &Instrumentation;
+
+    /// Get the mutable timers and counters collected at each generation, for example to register
+    /// an observer with [`Instrumentation::add_observer`].
+    ///
+    /// return: `&mut Instrumentation`.
+    fn instrumentation_mut(&mut self) -> &mut Instrumentation;
+
     /// Export additional data stored by the algorithm.
     ///
     /// return: `Option<HashMap<String, DataValue>>`
@@ -273,6 +379,20 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
         None
     }
 
+    /// Get the data exported with the individuals. This is the data from
+    /// [`Self::additional_export_data`] and, after the first evolved generation, the metrics
+    /// of the last generation stored with the `generation_metrics` key.
+    ///
+    /// return: `Option<HashMap<String, DataValue>>`
+    fn export_data(&self) -> Option<HashMap<String, DataValue>> {
+        let mut data = self.additional_export_data();
+        if let Some(metrics) = self.instrumentation().export_data() {
+            data.get_or_insert_with(HashMap::new)
+                .insert("generation_metrics".to_string(), metrics);
+        }
+        data
+    }
+
     /// Get the elapsed hours, minutes and seconds since the start of the algorithm.
     ///
     /// return: `[u64; 3]`. An array with the number of elapsed hours, minutes and seconds.
@@ -312,10 +432,24 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
         nfe: &mut usize,
     ) -> Result<(), OError> {
         let delta_nfe = Self::count_unevaluated(individuals);
-        individuals
-            .into_par_iter()
-            .enumerate()
-            .try_for_each(|(idx, i)| Self::evaluate_individual(idx, i))?;
+        let problem = match individuals.first() {
+            Some(i) => i.problem(),
+            None => return Ok(()),
+        };
+        if let Some((evaluator, batch_size)) = problem.batch_evaluator() {
+            let mut pending: Vec<&mut Individual> = individuals
+                .iter_mut()
+                .filter(|i| !i.is_evaluated())
+                .collect();
+            pending
+                .par_chunks_mut(batch_size)
+                .try_for_each(|batch| Self::evaluate_batch(evaluator, batch))?;
+        } else {
+            individuals
+                .into_par_iter()
+                .enumerate()
+                .try_for_each(|(idx, i)| Self::evaluate_individual(idx, i))?;
+        }
         *nfe += delta_nfe;
         Ok(())
     }
@@ -335,10 +469,24 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
     /// return `Result<usize, OError>`.
     fn do_evaluation(individuals: &mut [Individual], nfe: &mut usize) -> Result<(), OError> {
         let delta_nfe = Self::count_unevaluated(individuals);
-        individuals
-            .iter_mut()
-            .enumerate()
-            .try_for_each(|(idx, i)| Self::evaluate_individual(idx, i))?;
+        let problem = match individuals.first() {
+            Some(i) => i.problem(),
+            None => return Ok(()),
+        };
+        if let Some((evaluator, batch_size)) = problem.batch_evaluator() {
+            let mut pending: Vec<&mut Individual> = individuals
+                .iter_mut()
+                .filter(|i| !i.is_evaluated())
+                .collect();
+            pending
+                .chunks_mut(batch_size)
+                .try_for_each(|batch| Self::evaluate_batch(evaluator, batch))?;
+        } else {
+            individuals
+                .iter_mut()
+                .enumerate()
+                .try_for_each(|(idx, i)| Self::evaluate_individual(idx, i))?;
+        }
         *nfe += delta_nfe;
         Ok(())
     }
@@ -362,6 +510,18 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
             return Ok(());
         }
         let problem = i.problem();
+        let cache = problem.evaluation_cache();
+        let key = cache.map(|_| EvaluationCache::key(i.variable_values_slice()));
+        if let (Some(cache), Some(key)) = (cache, &key) {
+            if let Some((objectives, constraints)) = cache.get(key) {
+                debug!("Using cached objectives and constraints for individual #{idx}");
+                i.update_objective_values(&objectives)?;
+                i.update_constraint_values(&constraints)?;
+                i.set_evaluated();
+                return Ok(());
+            }
+        }
+
         let results = problem
             .evaluator()
             .evaluate(i)
@@ -369,28 +529,125 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
 
         // update the objectives and constraints for the individual
         debug!("Updating individual #{idx} objectives and constraints");
-        for name in problem.objective_names() {
-            if !results.objectives.contains_key(&name) {
-                return Err(OError::Evaluation(format!(
-                    "The evaluation function did non return the value for the objective named '{}'",
-                    name
-                )));
+        let objective_values = problem
+            .objective_list()
+            .iter()
+            .map(|o| {
+                results.objectives.get(o.name_ref()).copied().ok_or_else(|| {
+                    OError::Evaluation(format!(
+                        "The evaluation function did non return the value for the objective named '{}'",
+                        o.name_ref()
+                    ))
+                })
+            })
+            .collect::<Result<Vec<f64>, OError>>()?;
+        i.update_objective_values(&objective_values)?;
+
+        // when the evaluator does not return the constraints, their values are left as NaN and
+        // the solution is not cached, as the values could not be restored from the cache
+        let cacheable = results.constraints.is_some() || problem.number_of_constraints() == 0;
+        if let Some(constraints) = results.constraints {
+            let constraint_values = problem
+                .constraint_list()
+                .iter()
+                .map(|c| {
+                    constraints.get(c.name_ref()).copied().ok_or_else(|| {
+                        OError::Evaluation(format!(
+                            "The evaluation function did non return the value for the constraints named '{}'",
+                            c.name_ref()
+                        ))
+                    })
+                })
+                .collect::<Result<Vec<f64>, OError>>()?;
+            i.update_constraint_values(&constraint_values)?;
+        }
+        i.set_evaluated();
+
+        if let (Some(cache), Some(key), true) = (cache, key, cacheable) {
+            cache.insert(key, objective_values, i.constraint_values_slice().to_vec());
+        }
+        Ok(())
+    }
+
+    /// Evaluate the objectives and constraints for a batch of unevaluated individuals with one
+    /// call to [`BatchEvaluator::evaluate_batch`]. This returns an error if the evaluation
+    /// function fails or the size of the returned matrices does not match the number of
+    /// individuals, objectives and constraints.
+    ///
+    /// # Arguments
+    ///
+    /// * `evaluator`: The batch evaluator.
+    /// * `batch`: The individuals to evaluate.
+    ///
+    /// return `Result<(), OError>`
+    fn evaluate_batch(
+        evaluator: &dyn BatchEvaluator,
+        batch: &mut [&mut Individual],
+    ) -> Result<(), OError> {
+        debug!("Evaluating batch of {} individuals", batch.len());
+        let Some(problem) = batch.first().map(|i| i.problem()) else {
+            return Ok(());
+        };
+
+        // only send the individuals missing from the cache to the evaluator
+        let cache = problem.evaluation_cache();
+        let mut misses: Vec<(usize, Option<Vec<u8>>)> = Vec::with_capacity(batch.len());
+        for (bi, i) in batch.iter_mut().enumerate() {
+            let Some(cache) = cache else {
+                misses.push((bi, None));
+                continue;
             };
-            i.update_objective(&name, results.objectives[&name])?;
+            let key = EvaluationCache::key(i.variable_values_slice());
+            match cache.get(&key) {
+                Some((objectives, constraints)) => {
+                    i.update_objective_values(&objectives)?;
+                    i.update_constraint_values(&constraints)?;
+                    i.set_evaluated();
+                }
+                None => misses.push((bi, Some(key))),
+            }
+        }
+        if misses.is_empty() {
+            debug!("All the individuals in the batch were found in the evaluation cache");
+            return Ok(());
         }
-        if let Some(constraints) = results.constraints {
-            for name in problem.constraint_names() {
-                if !constraints.contains_key(&name) {
-                    return Err(OError::Evaluation(format!(
-                        "The evaluation function did non return the value for the constraints named '{}'",
-                        name
-                    )));
-                };
 
-                i.update_constraint(&name, constraints[&name])?;
+        let individuals: Vec<&Individual> = misses.iter().map(|(bi, _)| &*batch[*bi]).collect();
+        let results = evaluator
+            .evaluate_batch(&individuals)
+            .map_err(|e| OError::Evaluation(e.to_string()))?;
+
+        // check the size of the results once for the whole batch
+        let number_of_objectives = problem.number_of_objectives();
+        let number_of_constraints = problem.number_of_constraints();
+        if results.objectives.len() != misses.len() * number_of_objectives {
+            return Err(OError::Evaluation(format!(
+                "The evaluation function returned {} objective values, but {} were expected",
+                results.objectives.len(),
+                misses.len() * number_of_objectives
+            )));
+        }
+        if results.constraints.len() != misses.len() * number_of_constraints {
+            return Err(OError::Evaluation(format!(
+                "The evaluation function returned {} constraint values, but {} were expected",
+                results.constraints.len(),
+                misses.len() * number_of_constraints
+            )));
+        }
+
+        for (ri, (bi, key)) in misses.into_iter().enumerate() {
+            let objectives =
+                &results.objectives[ri * number_of_objectives..(ri + 1) * number_of_objectives];
+            let constraints =
+                &results.constraints[ri * number_of_constraints..(ri + 1) * number_of_constraints];
+            let i = &mut batch[bi];
+            i.update_objective_values(objectives)?;
+            i.update_constraint_values(constraints)?;
+            i.set_evaluated();
+            if let (Some(cache), Some(key)) = (cache, key) {
+                cache.insert(key, objectives.to_vec(), constraints.to_vec());
             }
         }
-        i.set_evaluated();
         Ok(())
     }
 
@@ -420,16 +677,15 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
         info!("Starting {}", self.name());
         self.initialise()?;
         // Export at init
-        if let Some(export) = self.export_history() {
-            self.save_to_json(&export.destination, Some("Init"))?;
-        }
+        self.save_history(Some("Init"))?;
 
         let mut history_gen_step: usize = 0;
         loop {
             // Export history
             if let Some(export) = self.export_history() {
                 if history_gen_step == export.generation_step - 1 {
-                    self.save_to_json(&export.destination, None)?;
+                    self.save_history(None)?;
+                    self.save_evaluation_cache()?;
                     history_gen_step = 0;
                 } else {
                     history_gen_step += 1;
@@ -453,9 +709,11 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
             let terminate = self.is_stopping_condition_met(cond)?;
             if terminate {
                 // save last file
+                self.save_history(Some("Final"))?;
                 if let Some(export) = self.export_history() {
-                    self.save_to_json(&export.destination, Some("Final"))?;
+                    export.finish()?;
                 }
+                self.save_evaluation_cache()?;
 
                 info!("Stopping evolution because the {} was reached", cond.name());
                 info!("Took {}", self.elapsed_as_string());
@@ -474,37 +732,13 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
     ///
     /// returns: `Result<bool, OError>`
     fn is_stopping_condition_met(&self, condition: &StoppingConditionType) -> Result<bool, OError> {
-        let is_met = match condition {
-            StoppingConditionType::MaxDuration(cond) => cond.is_met(Instant::now().elapsed()),
-            StoppingConditionType::MaxGeneration(cond) => cond.is_met(self.generation()),
-            StoppingConditionType::MaxFunctionEvaluations(cond) => {
-                cond.is_met(self.number_of_function_evaluations())
-            }
-            StoppingConditionType::Any(conditions) => {
-                if StoppingConditionType::has_nested_vector(conditions) {
-                    return Err(OError::AlgorithmRun(
-                        self.name(),
-                        "A vector of stopping condition vector is not allowed".to_string(),
-                    ));
-                }
-                conditions
-                    .iter()
-                    .any(|c| self.is_stopping_condition_met(c).unwrap())
-            }
-            StoppingConditionType::All(conditions) => {
-                if StoppingConditionType::has_nested_vector(conditions) {
-                    return Err(OError::AlgorithmRun(
-                        self.name(),
-                        "A vector of stopping condition vector is not allowed".to_string(),
-                    ));
-                }
-
-                conditions
-                    .iter()
-                    .all(|c| self.is_stopping_condition_met(c).unwrap())
-            }
-        };
-        Ok(is_met)
+        condition
+            .is_met(
+                self.generation(),
+                self.number_of_function_evaluations(),
+                self.start_time().elapsed(),
+            )
+            .map_err(|e| OError::AlgorithmRun(self.name(), e))
     }
 
     /// Get the results of the run.
@@ -523,12 +757,77 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
                 minutes,
                 seconds,
             },
-            additional_data: self.additional_export_data().unwrap_or_default(),
+            additional_data: self.export_data().unwrap_or_default(),
+            evaluation_cache: self.problem().evaluation_cache().map(|c| c.stats()),
         }
     }
 
     fn algorithm_options(&self) -> AlgorithmOptions;
 
+    /// Save the evaluation cache of the problem to its file, when the cache and the file are set
+    /// with [`Problem::set_evaluation_cache`]. This returns an error if the file cannot be saved.
+    ///
+    /// return `Result<(), OError>`
+    fn save_evaluation_cache(&self) -> Result<(), OError> {
+        match self.problem().evaluation_cache() {
+            Some(cache) => cache.save(),
+            None => Ok(()),
+        }
+    }
+
+    /// Export the algorithm data to the history folder, when the history export is enabled. With
+    /// [`HistoryFormat::Json`] this calls [`Self::save_to_json`]; with [`HistoryFormat::Binary`]
+    /// the population is appended to the binary history file by a background thread. This
+    /// returns an error if the data cannot be saved.
+    ///
+    /// # Arguments
+    ///
+    /// * `file_prefix`: The prefix of the JSON file name or the label of the binary block.
+    ///    This defaults to `History` when `None`.
+    ///
+    /// return `Result<(), OError>`
+    fn save_history(&self, file_prefix: Option<&str>) -> Result<(), OError> {
+        let Some(export) = self.export_history() else {
+            return Ok(());
+        };
+        match export.format {
+            HistoryFormat::Json => self.save_to_json(&export.destination, file_prefix),
+            HistoryFormat::Binary => {
+                let [hours, minutes, seconds] = self.elapsed();
+                let metadata = GenerationMetadata {
+                    label: file_prefix.unwrap_or("History").to_string(),
+                    generation: self.generation(),
+                    number_of_function_evaluations: self.number_of_function_evaluations(),
+                    number_of_individuals: self.population().len(),
+                    took: Elapsed {
+                        hours,
+                        minutes,
+                        seconds,
+                    },
+                    exported_on: Utc::now(),
+                    additional_data: self.export_data(),
+                    evaluation_cache: self.problem().evaluation_cache().map(|c| c.stats()),
+                };
+                let header = || {
+                    Ok(HistoryHeader {
+                        algorithm: self.name(),
+                        options: serde_json::to_value(self.algorithm_options()).map_err(|e| {
+                            OError::AlgorithmExport(format!(
+                                "The following error occurred while converting the history struct: {e}"
+                            ))
+                        })?,
+                        problem: self.problem().serialise(),
+                    })
+                };
+                export.write_block(
+                    &self.name(),
+                    header,
+                    GenerationBlock::new(self.population(), metadata),
+                )
+            }
+        }
+    }
+
     /// Save the algorithm data (individuals' objective, variables and constraints, the problem,
     /// ...) to a JSON file. This returns an error if the file cannot be saved.
     ///
@@ -549,7 +848,8 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
             generation: self.generation(),
             number_of_function_evaluations: self.number_of_function_evaluations(),
             algorithm: self.name(),
-            additional_data: self.additional_export_data(),
+            additional_data: self.export_data(),
+            evaluation_cache: self.problem().evaluation_cache().map(|c| c.stats()),
             took: Elapsed {
                 hours,
                 minutes,
@@ -581,7 +881,9 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
         Ok(())
     }
 
-    /// Read the results previously exported with [`Self::save_to_json`].
+    /// Read the results previously exported with [`Self::save_to_json`]. When `file` is a binary
+    /// history file (with the [`HISTORY_FILE_EXTENSION`] extension), this reads the last
+    /// generation in the file.
     ///
     /// # Arguments
     ///
@@ -597,7 +899,11 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
                 "the file does not exist".to_string(),
             ));
         }
-        let data = fs::File::open(file).map_err(|e| {
+        if is_history_file(file) {
+            return read_last_generation(file, HistoryColumns::ALL);
+        }
+        // read the whole file at once, which is much faster than parsing from the file stream
+        let data = fs::read(file).map_err(|e| {
             OError::File(
                 file.to_path_buf(),
                 format!("cannot read the JSON file because: {e}"),
@@ -605,7 +911,7 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
         })?;
 
         let mut history: AlgorithmSerialisedExport<AlgorithmOptions> =
-            serde_json::from_reader(data).map_err(|e| {
+            serde_json::from_slice(&data).map_err(|e| {
                 OError::File(
                     file.to_path_buf(),
                     format!("cannot parse the JSON file because: {e}"),
@@ -624,8 +930,25 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
         Ok(history)
     }
 
+    /// Read all the generations stored in a binary history file exported with
+    /// [`HistoryFormat::Binary`]. This returns an error if the file does not exist or is not a
+    /// valid history file.
+    ///
+    /// # Arguments
+    ///
+    /// * `file`: The path to the history file.
+    ///
+    /// returns: `Result<Vec<AlgorithmSerialisedExport<T>>, OError>`
+    fn read_history_file(
+        file: &PathBuf,
+    ) -> Result<Vec<AlgorithmSerialisedExport<AlgorithmOptions>>, OError> {
+        read_generations(file, HistoryColumns::ALL)
+    }
+
     /// Read the results from files exported during an algorithm evolution. This returns an error if
-    /// the path does not exist or does not contain valid JSON files.
+    /// the path does not exist or does not contain valid JSON files. The generations stored in
+    /// binary history files in the folder are read as well and the files are parsed in parallel.
+    /// Use [`Self::read_objective_files`] when only the objective values are needed.
     ///
     /// # Arguments
     ///
@@ -634,25 +957,36 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
     /// returns: `Result<Vec<AlgorithmSerialisedExport<T>>, OError>`
     fn read_json_files(
         folder: &PathBuf,
-    ) -> Result<Vec<AlgorithmSerialisedExport<AlgorithmOptions>>, OError> {
-        let json_files: Vec<_> = read_dir(folder)
-            .map_err(|e| OError::Generic(format!("Cannot read folder because {e}")))?
-            .filter_map(|res| res.ok())
-            .map(|dir_entry| dir_entry.path())
-            .filter_map(|path| {
-                if path.extension().map_or(false, |ext| ext == "json") {
-                    Some(path)
+    ) -> Result<Vec<AlgorithmSerialisedExport<AlgorithmOptions>>, OError>
+    where
+        AlgorithmOptions: Send,
+    {
+        let results = export_files(folder)?
+            .par_iter()
+            .map(|file| {
+                if is_history_file(file) {
+                    Self::read_history_file(file)
                 } else {
-                    None
+                    Ok(vec![Self::read_json_file(file)?])
                 }
             })
-            .collect();
-
-        let results = json_files
-            .iter()
-            .map(|file| Self::read_json_file(file))
             .collect::<Result<Vec<_>, OError>>()?;
-        Ok(results)
+        Ok(results.into_iter().flatten().collect())
+    }
+
+    /// Read only the objective values from the files exported during an algorithm evolution.
+    /// Unlike [`Self::read_json_files`], the variables, constraints and individual's data are
+    /// skipped when the files are parsed and the objectives of each generation are returned as a
+    /// flat matrix. The files are parsed in parallel. This returns an error if the path does not
+    /// exist or does not contain valid files.
+    ///
+    /// # Arguments
+    ///
+    /// * `folder`: The path to the folder with the JSON or binary history files.
+    ///
+    /// returns: `Result<Vec<GenerationObjectives>, OError>`. The data sorted by generation.
+    fn read_objective_files(folder: &PathBuf) -> Result<Vec<GenerationObjectives>, OError> {
+        read_objective_files(folder)
     }
 
     /// Seed the population using the values of variables, objectives and constraints exported
@@ -664,7 +998,8 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
     /// * `name`: The algorithm name.
     /// * `expected_individuals`: The number of individuals to expect in the file. If this does not
     ///     match the population size, being used in the algorithm, an error is thrown.
-    /// * `file`: The path to the JSON file exported from this library.
+    /// * `file`: The path to the JSON file exported from this library. When this is a binary
+    ///    history file, the last generation is used.
     ///
     /// returns: `Result<Population, OError>`
     fn seed_population_from_file(
@@ -673,7 +1008,11 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
         expected_individuals: usize,
         file: &PathBuf,
     ) -> Result<Population, OError> {
-        let data = Self::read_json_file(file)?;
+        let data: AlgorithmSerialisedExport<AlgorithmOptions> = if is_history_file(file) {
+            read_last_generation(file, HistoryColumns::POPULATION)?
+        } else {
+            Self::read_json_file(file)?
+        };
 
         // check number of variables
         if problem.number_of_variables() != data.problem.variables.len() {
@@ -701,14 +1040,24 @@ pub trait Algorithm<AlgorithmOptions: Serialize + DeserializeOwned>: Display {
             ));
         }
 
-        Population::deserialise(&data.individuals, problem.clone())
+        let population = Population::deserialise(&data.individuals, problem.clone())?;
+        // the solutions in the file are already evaluated
+        if let Some(cache) = problem.evaluation_cache() {
+            for individual in population.individuals() {
+                cache.insert_individual(individual);
+            }
+        }
+        Ok(population)
     }
 }
 
 #[cfg(test)]
 mod test {
+    use std::collections::HashMap;
     use std::env;
+    use std::error::Error;
     use std::path::Path;
+    use std::sync::atomic::{AtomicUsize, Ordering};
     use std::sync::Arc;
 
     use crate::algorithms::stopping_condition::MaxFunctionEvaluationValue;
@@ -716,6 +1065,250 @@ mod test {
         Algorithm, MaxGenerationValue, NSGA2Arg, StoppingConditionType, NSGA2,
     };
     use crate::core::builtin_problems::{SCHProblem, ZTD1Problem};
+    use crate::core::{
+        BatchEvaluationResult, BatchEvaluator, BoundedNumber, Constraint, EvaluationCacheArgs,
+        EvaluationResult, Evaluator, Individual, Objective, ObjectiveDirection, Problem,
+        RelationalOperator, VariableType, VariableValue,
+    };
+
+    /// Batch evaluator for the SCH problem with one constraint, counting the number of batches.
+    #[derive(Debug)]
+    struct SCHBatchEvaluator {
+        /// The number of calls to the evaluator.
+        calls: Arc<AtomicUsize>,
+        /// The number of objective values to return for each individual.
+        number_of_objectives: usize,
+    }
+
+    impl BatchEvaluator for SCHBatchEvaluator {
+        fn evaluate_batch(
+            &self,
+            individuals: &[&Individual],
+        ) -> Result<BatchEvaluationResult, Box<dyn Error>> {
+            self.calls.fetch_add(1, Ordering::SeqCst);
+            let mut objectives = vec![];
+            let mut constraints = vec![];
+            for i in individuals {
+                let x = i.get_variable_value("x")?.as_real()?;
+                objectives
+                    .extend([x.powi(2), (x - 2.0).powi(2)][..self.number_of_objectives].iter());
+                constraints.push(x);
+            }
+            Ok(BatchEvaluationResult {
+                objectives,
+                constraints,
+            })
+        }
+    }
+
+    /// Create the SCH problem evaluated in batches.
+    ///
+    /// # Arguments
+    ///
+    /// * `batch_size`: The batch size.
+    /// * `number_of_objectives`: The number of objective values returned by the evaluator.
+    ///
+    /// returns: `(Arc<Problem>, Arc<AtomicUsize>)`. The problem and the counter of batches.
+    fn batch_problem(
+        batch_size: usize,
+        number_of_objectives: usize,
+    ) -> (Arc<Problem>, Arc<AtomicUsize>) {
+        let calls = Arc::new(AtomicUsize::new(0));
+        let objectives = vec![
+            Objective::new("x^2", ObjectiveDirection::Minimise),
+            Objective::new("(x-2)^2", ObjectiveDirection::Maximise),
+        ];
+        let variables = vec![VariableType::Real(
+            BoundedNumber::new("x", -10.0, 10.0).unwrap(),
+        )];
+        let constraints = vec![Constraint::new(
+            "x",
+            RelationalOperator::GreaterOrEqualTo,
+            0.0,
+        )];
+        let evaluator = Box::new(SCHBatchEvaluator {
+            calls: calls.clone(),
+            number_of_objectives,
+        });
+        let problem = Problem::new_with_batch_evaluator(
+            objectives,
+            variables,
+            Some(constraints),
+            evaluator,
+            batch_size,
+        )
+        .unwrap();
+        (Arc::new(problem), calls)
+    }
+
+    #[test]
+    /// Test the evaluation of the individuals in batches.
+    fn test_batch_evaluation() {
+        for parallel in [false, true] {
+            let (problem, calls) = batch_problem(4, 2);
+            let mut individuals: Vec<Individual> =
+                (0..10).map(|_| Individual::new(problem.clone())).collect();
+            // already evaluated individuals are skipped
+            individuals[0].set_evaluated();
+
+            let mut nfe = 0;
+            if parallel {
+                NSGA2::do_parallel_evaluation(&mut individuals, &mut nfe).unwrap();
+            } else {
+                NSGA2::do_evaluation(&mut individuals, &mut nfe).unwrap();
+            }
+            assert_eq!(nfe, 9);
+            assert_eq!(calls.load(Ordering::SeqCst), 3);
+
+            for i in individuals.iter().skip(1) {
+                assert!(i.is_evaluated());
+                let x = i.get_variable_value("x").unwrap().as_real().unwrap();
+                assert_eq!(i.get_objective_value("x^2").unwrap(), x.powi(2));
+                // maximised objective is stored with the opposite sign
+                assert_eq!(
+                    i.get_objective_value("(x-2)^2").unwrap(),
+                    -(x - 2.0).powi(2)
+                );
+                assert_eq!(i.get_constraint_value("x").unwrap(), x);
+            }
+
+            // the single evaluator uses the batch evaluator
+            let result = problem.evaluator().evaluate(&individuals[1]).unwrap();
+            assert_eq!(result.objectives.len(), 2);
+            assert_eq!(result.constraints.unwrap().len(), 1);
+        }
+    }
+
+    #[test]
+    /// Test the batch evaluation when the evaluator returns the wrong number of values.
+    fn test_batch_evaluation_error() {
+        let (problem, _) = batch_problem(4, 1);
+        let mut individuals: Vec<Individual> =
+            (0..5).map(|_| Individual::new(problem.clone())).collect();
+        let mut nfe = 0;
+        let err = NSGA2::do_evaluation(&mut individuals, &mut nfe)
+            .unwrap_err()
+            .to_string();
+        assert!(err.contains("returned 4 objective values, but 8 were expected"));
+    }
+
+    #[test]
+    /// Test that the cached individuals are not sent to the batch evaluator.
+    fn test_cached_batch_evaluation() {
+        let (problem, calls) = batch_problem(4, 2);
+        let mut problem = Arc::try_unwrap(problem).unwrap();
+        problem
+            .set_evaluation_cache(EvaluationCacheArgs {
+                capacity: 100,
+                file: None,
+            })
+            .unwrap();
+        let problem = Arc::new(problem);
+        let mut individuals: Vec<Individual> = (0..10)
+            .map(|x| {
+                let mut i = Individual::new(problem.clone());
+                i.update_variable("x", VariableValue::Real((x % 5) as f64))
+                    .unwrap();
+                i
+            })
+            .collect();
+
+        let mut nfe = 0;
+        NSGA2::do_evaluation(&mut individuals, &mut nfe).unwrap();
+        // the last batch is fully cached
+        assert_eq!(calls.load(Ordering::SeqCst), 2);
+        assert_eq!(nfe, 10);
+        for i in &individuals {
+            let x = i.get_variable_value("x").unwrap().as_real().unwrap();
+            assert_eq!(i.get_objective_value("x^2").unwrap(), x.powi(2));
+            assert_eq!(
+                i.get_objective_value("(x-2)^2").unwrap(),
+                -(x - 2.0).powi(2)
+            );
+            assert_eq!(i.get_constraint_value("x").unwrap(), x);
+        }
+
+        let stats = problem.evaluation_cache().unwrap().stats();
+        assert_eq!(stats.hits, 5);
+        assert_eq!(stats.misses, 5);
+        assert_eq!(stats.size, 5);
+    }
+
+    /// Evaluator for the SCH problem that does not return the values of the problem constraints.
+    #[derive(Debug)]
+    struct NoConstraintsEvaluator {
+        /// The number of calls to the evaluator.
+        calls: Arc<AtomicUsize>,
+    }
+
+    impl Evaluator for NoConstraintsEvaluator {
+        fn evaluate(&self, i: &Individual) -> Result<EvaluationResult, Box<dyn Error>> {
+            self.calls.fetch_add(1, Ordering::SeqCst);
+            let x = i.get_variable_value("x")?.as_real()?;
+            Ok(EvaluationResult {
+                constraints: None,
+                objectives: HashMap::from([
+                    ("x^2".to_string(), x.powi(2)),
+                    ("(x-2)^2".to_string(), (x - 2.0).powi(2)),
+                ]),
+            })
+        }
+    }
+
+    #[test]
+    /// The solutions whose constraints are not returned by the evaluator are not cached, so that
+    /// an individual with the same variables is evaluated again.
+    fn test_cached_evaluation_without_constraints() {
+        let calls = Arc::new(AtomicUsize::new(0));
+        let objectives = vec![
+            Objective::new("x^2", ObjectiveDirection::Minimise),
+            Objective::new("(x-2)^2", ObjectiveDirection::Minimise),
+        ];
+        let variables = vec![VariableType::Real(
+            BoundedNumber::new("x", -10.0, 10.0).unwrap(),
+        )];
+        let constraints = vec![Constraint::new(
+            "x",
+            RelationalOperator::GreaterOrEqualTo,
+            0.0,
+        )];
+        let evaluator = Box::new(NoConstraintsEvaluator {
+            calls: calls.clone(),
+        });
+        let mut problem =
+            Problem::new(objectives, variables, Some(constraints), evaluator).unwrap();
+        problem
+            .set_evaluation_cache(EvaluationCacheArgs {
+                capacity: 100,
+                file: None,
+            })
+            .unwrap();
+        let problem = Arc::new(problem);
+
+        // the same variable vector is repeated
+        let mut individuals: Vec<Individual> = (0..6)
+            .map(|x| {
+                let mut i = Individual::new(problem.clone());
+                i.update_variable("x", VariableValue::Real((x % 3) as f64))
+                    .unwrap();
+                i
+            })
+            .collect();
+        let mut nfe = 0;
+        NSGA2::do_evaluation(&mut individuals, &mut nfe).unwrap();
+        assert_eq!(nfe, 6);
+        assert_eq!(calls.load(Ordering::SeqCst), 6);
+        for i in &individuals {
+            assert!(i.is_evaluated());
+            let x = i.get_variable_value("x").unwrap().as_real().unwrap();
+            assert_eq!(i.get_objective_value("x^2").unwrap(), x.powi(2));
+            assert!(i.get_constraint_value("x").unwrap().is_nan());
+        }
+
+        let stats = problem.evaluation_cache().unwrap().stats();
+        assert_eq!(stats.hits, 0);
+        assert_eq!(stats.size, 0);
+    }
 
     #[test]
     /// Test seed_population_from_file
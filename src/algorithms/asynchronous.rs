@@ -0,0 +1,228 @@
+//! Pool of workers evaluating individuals asynchronously, used by the steady-state mode of the
+//! algorithms (see [`crate::algorithms::NSGA2::run_async`]).
+use std::sync::mpsc::{channel, sync_channel, Receiver, Sender, SyncSender};
+use std::sync::{Arc, Mutex};
+use std::thread::{available_parallelism, Scope};
+
+use log::debug;
+use serde::{Deserialize, Serialize};
+
+use crate::core::{Individual, OError};
+
+/// The function used by a worker to evaluate an individual.
+pub(crate) type EvaluationFunction = fn(usize, &mut Individual) -> Result<(), OError>;
+
+/// Options to configure the asynchronous evaluation of the individuals.
+#[derive(Serialize, Deserialize, Clone, Debug, Default)]
+pub struct AsyncEvaluationArgs {
+    /// The number of threads evaluating the individuals at the same time. This defaults to the
+    /// number of available CPUs.
+    pub number_of_workers: Option<usize>,
+    /// The number of individuals that can wait in the queue when all the workers are busy, so that
+    /// a worker can pick a new individual as soon as it completes an evaluation. Because the
+    /// queued individuals are generated from the population available when they are submitted,
+    /// a long queue delays the use of the most recent solutions. This defaults to `0`.
+    pub queue_size: Option<usize>,
+}
+
+impl AsyncEvaluationArgs {
+    /// Get the number of workers.
+    ///
+    /// returns: `usize`
+    pub(crate) fn number_of_workers(&self) -> usize {
+        self.number_of_workers
+            .unwrap_or_else(|| available_parallelism().map_or(1, |n| n.get()))
+    }
+}
+
+/// A job sent to the workers with the identifier of the individual to evaluate.
+type Job = (usize, Individual);
+
+/// A bounded queue of individuals evaluated by a fixed number of threads. Results are collected in
+/// the order in which the evaluations complete. The workers stop when the pool is dropped, after
+/// completing the evaluation they are running.
+pub(crate) struct WorkerPool {
+    /// The sender of the bounded job queue.
+    jobs: Option<SyncSender<Job>>,
+    /// The receiver of the evaluated individuals.
+    results: Receiver<(usize, Result<Individual, OError>)>,
+    /// The number of submitted individuals whose result has not been received yet.
+    in_flight: usize,
+    /// The maximum number of individuals being evaluated or waiting in the queue.
+    capacity: usize,
+    /// The identifier to assign to the next submitted individual.
+    next_id: usize,
+}
+
+impl WorkerPool {
+    /// Spawn the workers in the given thread scope.
+    ///
+    /// # Arguments
+    ///
+    /// * `scope`: The scope the worker threads are spawned in.
+    /// * `options`: The options with the number of workers and the queue size.
+    /// * `evaluate`: The function evaluating one individual.
+    ///
+    /// returns: `Result<WorkerPool, OError>`
+    pub(crate) fn new<'scope>(
+        scope: &'scope Scope<'scope, '_>,
+        options: &AsyncEvaluationArgs,
+        evaluate: EvaluationFunction,
+    ) -> Result<Self, OError> {
+        let number_of_workers = options.number_of_workers();
+        if number_of_workers == 0 {
+            return Err(OError::Generic(
+                "The number of workers must be at least 1".to_string(),
+            ));
+        }
+        let queue_size = options.queue_size.unwrap_or(0);
+
+        let (job_sender, job_receiver) = sync_channel::<Job>(queue_size);
+        let job_receiver = Arc::new(Mutex::new(job_receiver));
+        let (result_sender, results) = channel();
+        for worker in 0..number_of_workers {
+            let job_receiver = job_receiver.clone();
+            let result_sender: Sender<(usize, Result<Individual, OError>)> = result_sender.clone();
+            scope.spawn(move || loop {
+                // release the lock before evaluating so that other workers can pick a job
+                let job = job_receiver.lock().unwrap().recv();
+                let Ok((id, mut individual)) = job else {
+                    debug!("Stopping worker #{worker}");
+                    break;
+                };
+                let result = evaluate(id, &mut individual).map(|_| individual);
+                if result_sender.send((id, result)).is_err() {
+                    break;
+                }
+            });
+        }
+
+        Ok(Self {
+            jobs: Some(job_sender),
+            results,
+            in_flight: 0,
+            capacity: number_of_workers + queue_size,
+            next_id: 0,
+        })
+    }
+
+    /// Whether a new individual can be submitted without waiting for a worker.
+    ///
+    /// returns: `bool`
+    pub(crate) fn has_capacity(&self) -> bool {
+        self.in_flight < self.capacity
+    }
+
+    /// The number of submitted individuals whose evaluation has not been received yet.
+    ///
+    /// returns: `usize`
+    pub(crate) fn in_flight(&self) -> usize {
+        self.in_flight
+    }
+
+    /// Send an individual to the workers.
+    ///
+    /// # Arguments
+    ///
+    /// * `individual`: The individual to evaluate.
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn submit(&mut self, individual: Individual) -> Result<(), OError> {
+        let jobs = self
+            .jobs
+            .as_ref()
+            .ok_or(OError::Generic("The worker pool was shut down".to_string()))?;
+        jobs.send((self.next_id, individual))
+            .map_err(|_| OError::Generic("All the workers stopped".to_string()))?;
+        self.next_id += 1;
+        self.in_flight += 1;
+        Ok(())
+    }
+
+    /// Wait for the next completed evaluation. This returns an error if the evaluation failed or
+    /// no individual is being evaluated.
+    ///
+    /// returns: `Result<Individual, OError>`
+    pub(crate) fn receive(&mut self) -> Result<Individual, OError> {
+        if self.in_flight == 0 {
+            return Err(OError::Generic(
+                "No individual is being evaluated".to_string(),
+            ));
+        }
+        let (id, result) = self
+            .results
+            .recv()
+            .map_err(|_| OError::Generic("All the workers stopped".to_string()))?;
+        self.in_flight -= 1;
+        debug!("Received evaluation #{id}");
+        result
+    }
+}
+
+impl Drop for WorkerPool {
+    fn drop(&mut self) {
+        // closing the queue stops the workers once their current evaluation is complete
+        self.jobs.take();
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use std::sync::Arc;
+    use std::thread;
+
+    use crate::algorithms::asynchronous::{AsyncEvaluationArgs, WorkerPool};
+    use crate::core::builtin_problems::SCHProblem;
+    use crate::core::{Individual, OError, VariableValue};
+
+    /// Set the objectives from the variable and fail when the variable is negative.
+    fn evaluate(_id: usize, individual: &mut Individual) -> Result<(), OError> {
+        let x = individual.get_real_value("x")?;
+        if x < 0.0 {
+            return Err(OError::Evaluation("negative x".to_string()));
+        }
+        individual.update_objective("x^2", x.powi(2))?;
+        individual.update_objective("(x-2)^2", (x - 2.0).powi(2))?;
+        individual.set_evaluated();
+        Ok(())
+    }
+
+    #[test]
+    /// All the submitted individuals are received and the errors are forwarded.
+    fn test_worker_pool() {
+        let problem = Arc::new(SCHProblem::create().unwrap());
+        let options = AsyncEvaluationArgs {
+            number_of_workers: Some(3),
+            queue_size: Some(2),
+        };
+        thread::scope(|scope| {
+            let mut pool = WorkerPool::new(scope, &options, evaluate).unwrap();
+            let mut submitted = 0;
+            while pool.has_capacity() {
+                let mut ind = Individual::new(problem.clone());
+                ind.update_variable("x", VariableValue::Real(submitted as f64))
+                    .unwrap();
+                pool.submit(ind).unwrap();
+                submitted += 1;
+            }
+            assert_eq!(submitted, 5);
+
+            let mut values: Vec<f64> = (0..submitted)
+                .map(|_| {
+                    let ind = pool.receive().unwrap();
+                    assert!(ind.is_evaluated());
+                    ind.get_objective_value("x^2").unwrap()
+                })
+                .collect();
+            values.sort_by(|a, b| a.total_cmp(b));
+            assert_eq!(values, vec![0.0, 1.0, 4.0, 9.0, 16.0]);
+            assert_eq!(pool.in_flight(), 0);
+            assert!(pool.receive().is_err());
+
+            let mut ind = Individual::new(problem.clone());
+            ind.update_variable("x", VariableValue::Real(-1.0)).unwrap();
+            pool.submit(ind).unwrap();
+            assert!(pool.receive().is_err());
+        });
+    }
+}
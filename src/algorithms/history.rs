@@ -0,0 +1,986 @@
+//! The binary history format. Instead of writing a JSON document with the problem and all the
+//! individuals at each export, the history is stored in one append-only file. The file starts
+//! with a header containing the algorithm name and options and the problem (serialised
+//! as JSON), followed by one block for each exported generation. Each block contains the generation
+//! metadata and the individuals' data stored by columns (objectives, constraints, variables and
+//! individual's data). Each column is prefixed by its size in bytes, so that a reader can skip the
+//! columns it does not need. Numbers are stored in little-endian.
+//!
+//! The blocks are encoded and written by a background thread (see [`HistoryWriter`]), so that the
+//! algorithm does not wait for the file to be written.
+use std::collections::HashMap;
+use std::fs::File;
+use std::io::{BufReader, BufWriter, ErrorKind, Read, Seek, SeekFrom, Write};
+use std::path::{Path, PathBuf};
+use std::sync::mpsc::{channel, Sender};
+use std::thread::JoinHandle;
+use std::{io, thread};
+
+use chrono::{DateTime, Utc};
+use serde::de::DeserializeOwned;
+use serde::{Deserialize, Serialize};
+
+use crate::algorithms::algorithm::Elapsed;
+use crate::algorithms::AlgorithmSerialisedExport;
+use crate::core::{
+    DataValue, EvaluationCacheStats, IndividualExport, OError, ObjectiveDirection, Population,
+    ProblemExport, VariableValue,
+};
+
+/// The extension of the binary history files.
+pub const HISTORY_FILE_EXTENSION: &str = "history";
+
+/// The bytes at the beginning of a binary history file.
+const MAGIC: &[u8; 8] = b"OPTHIST\0";
+
+/// The version of the file format.
+const VERSION: u32 = 1;
+
+/// The format of the history files exported with [`crate::algorithms::ExportHistory`].
+#[derive(Serialize, Deserialize, Clone, Copy, Debug, Default, PartialEq)]
+pub enum HistoryFormat {
+    /// Export a JSON file for each exported generation (see
+    /// [`crate::algorithms::Algorithm::save_to_json`]).
+    #[default]
+    Json,
+    /// Append each exported generation to one binary file named `History_<algorithm>.history`.
+    /// The file is written by a background thread and can be read with
+    /// [`crate::algorithms::Algorithm::read_json_files`],
+    /// [`crate::algorithms::Algorithm::read_history_file`] or
+    /// [`crate::metrics::HyperVolume::from_history_file`].
+    Binary,
+}
+
+/// The header of a history file.
+#[derive(Serialize, Deserialize)]
+pub(crate) struct HistoryHeader {
+    /// The algorithm name.
+    pub(crate) algorithm: String,
+    /// The algorithm options.
+    pub(crate) options: serde_json::Value,
+    /// The problem configuration.
+    pub(crate) problem: ProblemExport,
+}
+
+impl HistoryHeader {
+    /// Get the direction of each objective, in the order of the objective names. This returns an
+    /// error if an objective name is not in the problem objectives.
+    ///
+    /// returns: `Result<Vec<ObjectiveDirection>, OError>`
+    pub(crate) fn objective_directions(&self) -> Result<Vec<ObjectiveDirection>, OError> {
+        self.problem
+            .objective_names
+            .iter()
+            .map(|name| {
+                self.problem
+                    .objectives
+                    .get(name)
+                    .map(|o| o.direction())
+                    .ok_or_else(|| {
+                        OError::AlgorithmExport(format!(
+                            "The objective '{name}' is missing from the history header"
+                        ))
+                    })
+            })
+            .collect()
+    }
+}
+
+/// The data of an exported generation, other than the individuals.
+#[derive(Serialize, Deserialize)]
+pub(crate) struct GenerationMetadata {
+    /// The label of the export (for example `Init`, `History` or `Final`).
+    pub(crate) label: String,
+    /// The generation the export was collected at.
+    pub(crate) generation: usize,
+    /// The number of function evaluations.
+    pub(crate) number_of_function_evaluations: usize,
+    /// The number of individuals in the block.
+    pub(crate) number_of_individuals: usize,
+    /// The time took to reach the `generation`.
+    pub(crate) took: Elapsed,
+    /// The date and time when the data was exported.
+    pub(crate) exported_on: DateTime<Utc>,
+    /// Any additional data exported by the algorithm.
+    pub(crate) additional_data: Option<HashMap<String, DataValue>>,
+    /// The counters of the evaluation cache.
+    pub(crate) evaluation_cache: Option<EvaluationCacheStats>,
+}
+
+/// The columns stored in a generation block. The values of the `i`-th individual are stored from
+/// `i * n` to `(i + 1) * n` (excluded), where `n` is the number of objectives, constraints or
+/// variables.
+pub(crate) struct GenerationBlock {
+    /// The generation metadata.
+    pub(crate) metadata: GenerationMetadata,
+    /// The objective values. Maximised objectives are stored with the opposite sign.
+    pub(crate) objectives: Vec<f64>,
+    /// The constraint values, or `None` when the column was not read.
+    pub(crate) constraints: Option<Vec<f64>>,
+    /// The constraint violation and the flags (evaluated and feasible) of each individual, or
+    /// `None` when the column was not read.
+    pub(crate) status: Option<Vec<(f64, u8)>>,
+    /// The variable values, or `None` when the column was not read.
+    pub(crate) variables: Option<Vec<VariableValue>>,
+    /// The individual's data, or `None` when the column was not read.
+    pub(crate) data: Option<Vec<HashMap<String, DataValue>>>,
+}
+
+/// The flag set on evaluated individuals.
+const EVALUATED_FLAG: u8 = 1;
+/// The flag set on feasible individuals.
+const FEASIBLE_FLAG: u8 = 2;
+
+impl GenerationBlock {
+    /// Collect the data of the population to export.
+    ///
+    /// # Arguments
+    ///
+    /// * `population`: The population.
+    /// * `metadata`: The generation metadata.
+    ///
+    /// returns: `GenerationBlock`
+    pub(crate) fn new(population: &Population, metadata: GenerationMetadata) -> Self {
+        let individuals = population.individuals();
+        let mut objectives = vec![];
+        let mut constraints = vec![];
+        let mut variables = vec![];
+        let mut status = Vec::with_capacity(individuals.len());
+        let mut data = Vec::with_capacity(individuals.len());
+        for ind in individuals {
+            objectives.extend_from_slice(ind.objective_values_slice());
+            constraints.extend_from_slice(ind.constraint_values_slice());
+            variables.extend_from_slice(ind.variable_values_slice());
+            let mut flags = 0;
+            if ind.is_evaluated() {
+                flags |= EVALUATED_FLAG;
+            }
+            if ind.is_feasible() {
+                flags |= FEASIBLE_FLAG;
+            }
+            status.push((ind.constraint_violation(), flags));
+            data.push(ind.data());
+        }
+        Self {
+            metadata,
+            objectives,
+            constraints: Some(constraints),
+            status: Some(status),
+            variables: Some(variables),
+            data: Some(data),
+        }
+    }
+
+    /// Encode the block.
+    ///
+    /// returns: `Result<Vec<u8>, OError>`
+    fn encode(&self) -> Result<Vec<u8>, OError> {
+        let mut buffer: Vec<u8> = vec![];
+        put_section(&mut buffer, |b| {
+            serde_json::to_writer(b, &self.metadata).map_err(to_export_error)
+        })?;
+        put_section(&mut buffer, |b| {
+            self.objectives
+                .iter()
+                .for_each(|v| b.extend(v.to_le_bytes()));
+            Ok(())
+        })?;
+        put_section(&mut buffer, |b| {
+            for v in self.constraints.iter().flatten() {
+                b.extend(v.to_le_bytes());
+            }
+            for (violation, flags) in self.status.iter().flatten() {
+                b.extend(violation.to_le_bytes());
+                b.push(*flags);
+            }
+            Ok(())
+        })?;
+        put_section(&mut buffer, |b| {
+            self.variables
+                .iter()
+                .flatten()
+                .for_each(|v| put_variable(b, v));
+            Ok(())
+        })?;
+        put_section(&mut buffer, |b| {
+            serde_json::to_writer(b, &self.data).map_err(to_export_error)
+        })?;
+        Ok(buffer)
+    }
+
+    /// Convert the block to the serialised data of an algorithm. This returns an error if a
+    /// column was not read from the file.
+    ///
+    /// # Arguments
+    ///
+    /// * `header`: The file header.
+    ///
+    /// returns: `Result<AlgorithmSerialisedExport<T>, OError>`
+    pub(crate) fn into_export<T: Serialize + DeserializeOwned>(
+        self,
+        header: &HistoryHeader,
+    ) -> Result<AlgorithmSerialisedExport<T>, OError> {
+        let missing = || OError::AlgorithmExport("The history block is incomplete".to_string());
+        let problem = &header.problem;
+        let (constraints, status, variables) = match (self.constraints, self.status, self.variables)
+        {
+            (Some(c), Some(s), Some(v)) => (c, s, v),
+            _ => return Err(missing()),
+        };
+        let mut data = self
+            .data
+            .unwrap_or_else(|| vec![HashMap::new(); self.metadata.number_of_individuals])
+            .into_iter();
+
+        // the blocks store the objectives as minimised, invert the maximised ones for the user
+        // as in `Individual::serialise`
+        let signs: Vec<f64> = header
+            .objective_directions()?
+            .into_iter()
+            .map(|direction| match direction {
+                ObjectiveDirection::Minimise => 1.0,
+                ObjectiveDirection::Maximise => -1.0,
+            })
+            .collect();
+
+        let n_obj = problem.objective_names.len();
+        let n_cons = problem.constraint_names.len();
+        let n_var = problem.variable_names.len();
+        let individuals = (0..self.metadata.number_of_individuals)
+            .map(|i| {
+                let (constraint_violation, flags) = status[i];
+                IndividualExport {
+                    objective_values: problem
+                        .objective_names
+                        .iter()
+                        .cloned()
+                        .zip(
+                            self.objectives[i * n_obj..(i + 1) * n_obj]
+                                .iter()
+                                .zip(&signs)
+                                .map(|(value, sign)| sign * value),
+                        )
+                        .collect(),
+                    constraint_values: problem
+                        .constraint_names
+                        .iter()
+                        .cloned()
+                        .zip(constraints[i * n_cons..(i + 1) * n_cons].iter().copied())
+                        .collect(),
+                    variable_values: problem
+                        .variable_names
+                        .iter()
+                        .cloned()
+                        .zip(variables[i * n_var..(i + 1) * n_var].iter().cloned())
+                        .collect(),
+                    constraint_violation,
+                    is_feasible: flags & FEASIBLE_FLAG != 0,
+                    evaluated: flags & EVALUATED_FLAG != 0,
+                    data: data.next().unwrap_or_default(),
+                }
+            })
+            .collect();
+
+        Ok(AlgorithmSerialisedExport {
+            options: serde_json::from_value(header.options.clone()).map_err(|e| {
+                OError::AlgorithmExport(format!("Cannot read the algorithm options because: {e}"))
+            })?,
+            problem: problem.clone(),
+            individuals,
+            generation: self.metadata.generation,
+            number_of_function_evaluations: self.metadata.number_of_function_evaluations,
+            algorithm: header.algorithm.clone(),
+            additional_data: self.metadata.additional_data,
+            evaluation_cache: self.metadata.evaluation_cache,
+            took: self.metadata.took,
+            exported_on: self.metadata.exported_on,
+        })
+    }
+}
+
+/// Convert an error to [`OError::AlgorithmExport`].
+fn to_export_error(e: impl std::fmt::Display) -> OError {
+    OError::AlgorithmExport(format!(
+        "The following error occurred while exporting the history file: {e}"
+    ))
+}
+
+/// Append a section prefixed by its size.
+///
+/// # Arguments
+///
+/// * `buffer`: The buffer.
+/// * `write`: The function appending the section content to the buffer.
+///
+/// returns: `Result<(), OError>`
+fn put_section(
+    buffer: &mut Vec<u8>,
+    write: impl FnOnce(&mut Vec<u8>) -> Result<(), OError>,
+) -> Result<(), OError> {
+    let start = buffer.len();
+    buffer.extend(0_u64.to_le_bytes());
+    write(buffer)?;
+    let size = (buffer.len() - start - 8) as u64;
+    buffer[start..start + 8].copy_from_slice(&size.to_le_bytes());
+    Ok(())
+}
+
+/// Append a variable value with its type tag.
+fn put_variable(buffer: &mut Vec<u8>, value: &VariableValue) {
+    match value {
+        VariableValue::Real(v) => {
+            buffer.push(0);
+            buffer.extend(v.to_le_bytes());
+        }
+        VariableValue::Integer(v) => {
+            buffer.push(1);
+            buffer.extend(v.to_le_bytes());
+        }
+        VariableValue::Boolean(v) => {
+            buffer.push(2);
+            buffer.push(*v as u8);
+        }
+        VariableValue::Choice(v) => {
+            buffer.push(3);
+            buffer.extend((v.len() as u32).to_le_bytes());
+            buffer.extend(v.as_bytes());
+        }
+    }
+}
+
+/// Write the blocks to a history file in a background thread.
+#[derive(Debug)]
+pub(crate) struct HistoryWriter {
+    /// The channel to send the blocks to the thread.
+    sender: Option<Sender<GenerationBlock>>,
+    /// The thread writing the file.
+    handle: Option<JoinHandle<Result<(), OError>>>,
+}
+
+impl HistoryWriter {
+    /// Create the history file, write its header and start the thread. This returns an error if
+    /// the file cannot be created.
+    ///
+    /// # Arguments
+    ///
+    /// * `file`: The path to the file. An existing file is replaced.
+    /// * `header`: The file header.
+    ///
+    /// returns: `Result<HistoryWriter, OError>`
+    pub(crate) fn new(file: &Path, header: &HistoryHeader) -> Result<Self, OError> {
+        let mut writer = BufWriter::new(File::create(file).map_err(to_export_error)?);
+        let header = serde_json::to_vec(header).map_err(to_export_error)?;
+        writer.write_all(MAGIC).map_err(to_export_error)?;
+        writer
+            .write_all(&VERSION.to_le_bytes())
+            .map_err(to_export_error)?;
+        writer
+            .write_all(&(header.len() as u64).to_le_bytes())
+            .map_err(to_export_error)?;
+        writer.write_all(&header).map_err(to_export_error)?;
+        writer.flush().map_err(to_export_error)?;
+
+        let (sender, receiver) = channel::<GenerationBlock>();
+        let handle = thread::spawn(move || {
+            for block in receiver {
+                let data = block.encode()?;
+                writer
+                    .write_all(&(data.len() as u64).to_le_bytes())
+                    .map_err(to_export_error)?;
+                writer.write_all(&data).map_err(to_export_error)?;
+                // flush each block so that the file can be read while the algorithm runs
+                writer.flush().map_err(to_export_error)?;
+            }
+            Ok(())
+        });
+        Ok(Self {
+            sender: Some(sender),
+            handle: Some(handle),
+        })
+    }
+
+    /// Send a block to the thread. This returns the error of the thread if a previous block
+    /// could not be written.
+    ///
+    /// # Arguments
+    ///
+    /// * `block`: The block to append to the file.
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn write(&mut self, block: GenerationBlock) -> Result<(), OError> {
+        let sent = self
+            .sender
+            .as_ref()
+            .is_some_and(|sender| sender.send(block).is_ok());
+        if sent {
+            Ok(())
+        } else {
+            // the thread stopped because of an error
+            self.finish()?;
+            Err(to_export_error("the writer thread stopped"))
+        }
+    }
+
+    /// Wait for the thread to write all the blocks. This returns an error if a block could not be
+    /// written.
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn finish(&mut self) -> Result<(), OError> {
+        drop(self.sender.take());
+        match self.handle.take() {
+            Some(handle) => handle
+                .join()
+                .map_err(|_| to_export_error("the writer thread panicked"))?,
+            None => Ok(()),
+        }
+    }
+}
+
+impl Drop for HistoryWriter {
+    fn drop(&mut self) {
+        let _ = self.finish();
+    }
+}
+
+/// The columns to read from a history file. The objectives are always read.
+#[derive(Clone, Copy)]
+pub(crate) struct HistoryColumns {
+    /// Read the constraint values, violations and flags.
+    pub(crate) constraints: bool,
+    /// Read the variable values.
+    pub(crate) variables: bool,
+    /// Read the individual's data.
+    pub(crate) data: bool,
+}
+
+impl HistoryColumns {
+    /// Read all the columns.
+    pub(crate) const ALL: Self = Self {
+        constraints: true,
+        variables: true,
+        data: true,
+    };
+    /// Read the columns needed to restore a population.
+    pub(crate) const POPULATION: Self = Self {
+        constraints: true,
+        variables: true,
+        data: false,
+    };
+    /// Read the objectives only.
+    pub(crate) const OBJECTIVES: Self = Self {
+        constraints: false,
+        variables: false,
+        data: false,
+    };
+}
+
+/// Read a binary history file.
+pub(crate) struct HistoryReader {
+    /// The path to the file.
+    path: PathBuf,
+    /// The buffered file.
+    reader: BufReader<File>,
+    /// The file header.
+    header: HistoryHeader,
+}
+
+impl HistoryReader {
+    /// Open a history file and read its header. This returns an error if the file does not exist
+    /// or is not a history file.
+    ///
+    /// # Arguments
+    ///
+    /// * `file`: The path to the file.
+    ///
+    /// returns: `Result<HistoryReader, OError>`
+    pub(crate) fn open(file: &Path) -> Result<Self, OError> {
+        let to_error = |e: io::Error| {
+            OError::File(
+                file.to_path_buf(),
+                format!("cannot read the history file because: {e}"),
+            )
+        };
+        let mut reader = BufReader::new(File::open(file).map_err(to_error)?);
+        let mut magic = [0; 8];
+        reader.read_exact(&mut magic).map_err(to_error)?;
+        if &magic != MAGIC {
+            return Err(OError::File(
+                file.to_path_buf(),
+                "the file is not a history file".to_string(),
+            ));
+        }
+        let version = read_u32(&mut reader).map_err(to_error)?;
+        if version != VERSION {
+            return Err(OError::File(
+                file.to_path_buf(),
+                format!("the history file version {version} is not supported"),
+            ));
+        }
+        let header = read_bytes(&mut reader).map_err(to_error)?;
+        let header: HistoryHeader = serde_json::from_slice(&header).map_err(|e| {
+            OError::File(
+                file.to_path_buf(),
+                format!("cannot parse the history file header because: {e}"),
+            )
+        })?;
+        Ok(Self {
+            path: file.to_path_buf(),
+            reader,
+            header,
+        })
+    }
+
+    /// The file header.
+    ///
+    /// returns: `&HistoryHeader`
+    pub(crate) fn header(&self) -> &HistoryHeader {
+        &self.header
+    }
+
+    /// Read all the blocks in the file. Truncated blocks at the end of the file (for example when
+    /// the file is being written) are ignored.
+    ///
+    /// # Arguments
+    ///
+    /// * `columns`: The columns to read.
+    ///
+    /// returns: `Result<Vec<GenerationBlock>, OError>`
+    pub(crate) fn read_blocks(
+        &mut self,
+        columns: HistoryColumns,
+    ) -> Result<Vec<GenerationBlock>, OError> {
+        let mut blocks = vec![];
+        while let Some(block) = self.next_block(columns)? {
+            blocks.push(block);
+        }
+        Ok(blocks)
+    }
+
+    /// Read the last block in the file. The other blocks are skipped without reading them.
+    ///
+    /// # Arguments
+    ///
+    /// * `columns`: The columns to read.
+    ///
+    /// returns: `Result<Option<GenerationBlock>, OError>`
+    pub(crate) fn read_last_block(
+        &mut self,
+        columns: HistoryColumns,
+    ) -> Result<Option<GenerationBlock>, OError> {
+        let mut last_position = None;
+        loop {
+            let position = self.reader.stream_position().map_err(|e| self.error(e))?;
+            match self.skip_block().map_err(|e| self.error(e))? {
+                true => last_position = Some(position),
+                false => break,
+            }
+        }
+        match last_position {
+            None => Ok(None),
+            Some(position) => {
+                self.reader
+                    .seek(SeekFrom::Start(position))
+                    .map_err(|e| self.error(e))?;
+                self.next_block(columns)
+            }
+        }
+    }
+
+    /// Convert an IO error to [`OError::File`].
+    fn error(&self, e: io::Error) -> OError {
+        OError::File(
+            self.path.clone(),
+            format!("cannot read the history file because: {e}"),
+        )
+    }
+
+    /// Skip the next block.
+    ///
+    /// returns: `io::Result<bool>`. `false` when there are no more complete blocks.
+    fn skip_block(&mut self) -> io::Result<bool> {
+        let size = match read_u64(&mut self.reader) {
+            Ok(size) => size,
+            Err(e) if e.kind() == ErrorKind::UnexpectedEof => return Ok(false),
+            Err(e) => return Err(e),
+        };
+        let position = self.reader.stream_position()?;
+        let end = self.reader.get_ref().metadata()?.len();
+        if position + size > end {
+            return Ok(false);
+        }
+        self.reader.seek_relative(size as i64)?;
+        Ok(true)
+    }
+
+    /// Read the next block.
+    ///
+    /// # Arguments
+    ///
+    /// * `columns`: The columns to read.
+    ///
+    /// returns: `Result<Option<GenerationBlock>, OError>`. `None` when there are no more complete
+    /// blocks.
+    fn next_block(&mut self, columns: HistoryColumns) -> Result<Option<GenerationBlock>, OError> {
+        let start = self.reader.stream_position().map_err(|e| self.error(e))?;
+        if !self.skip_block().map_err(|e| self.error(e))? {
+            return Ok(None);
+        }
+        self.reader
+            .seek(SeekFrom::Start(start + 8))
+            .map_err(|e| self.error(e))?;
+
+        let problem = &self.header.problem;
+        let n_obj = problem.objective_names.len();
+        let n_cons = problem.constraint_names.len();
+        let n_var = problem.variable_names.len();
+
+        let block = (|| -> io::Result<GenerationBlock> {
+            let metadata: GenerationMetadata =
+                serde_json::from_slice(&read_bytes(&mut self.reader)?)
+                    .map_err(|e| io::Error::new(ErrorKind::InvalidData, e))?;
+            let n = metadata.number_of_individuals;
+
+            let objectives = read_f64s(&read_bytes(&mut self.reader)?);
+            if objectives.len() != n * n_obj {
+                return Err(invalid_data("the number of objective values is wrong"));
+            }
+
+            let (constraints, status) = if columns.constraints {
+                let section = read_bytes(&mut self.reader)?;
+                if section.len() != n * (n_cons * 8 + 9) {
+                    return Err(invalid_data("the number of constraint values is wrong"));
+                }
+                let (values, status) = section.split_at(n * n_cons * 8);
+                let status = status
+                    .chunks_exact(9)
+                    .map(|s| (f64::from_le_bytes(s[..8].try_into().unwrap()), s[8]))
+                    .collect();
+                (Some(read_f64s(values)), Some(status))
+            } else {
+                skip_section(&mut self.reader)?;
+                (None, None)
+            };
+
+            let variables = if columns.variables {
+                let section = read_bytes(&mut self.reader)?;
+                let variables = read_variables(&section)?;
+                if variables.len() != n * n_var {
+                    return Err(invalid_data("the number of variable values is wrong"));
+                }
+                Some(variables)
+            } else {
+                skip_section(&mut self.reader)?;
+                None
+            };
+
+            let data = if columns.data {
+                let data: Vec<HashMap<String, DataValue>> =
+                    serde_json::from_slice(&read_bytes(&mut self.reader)?)
+                        .map_err(|e| io::Error::new(ErrorKind::InvalidData, e))?;
+                Some(data)
+            } else {
+                skip_section(&mut self.reader)?;
+                None
+            };
+
+            Ok(GenerationBlock {
+                metadata,
+                objectives,
+                constraints,
+                status,
+                variables,
+                data,
+            })
+        })()
+        .map_err(|e| self.error(e))?;
+        Ok(Some(block))
+    }
+}
+
+/// Create an [`ErrorKind::InvalidData`] error.
+fn invalid_data(message: &str) -> io::Error {
+    io::Error::new(ErrorKind::InvalidData, message)
+}
+
+fn read_u32(reader: &mut impl Read) -> io::Result<u32> {
+    let mut value = [0; 4];
+    reader.read_exact(&mut value)?;
+    Ok(u32::from_le_bytes(value))
+}
+
+fn read_u64(reader: &mut impl Read) -> io::Result<u64> {
+    let mut value = [0; 8];
+    reader.read_exact(&mut value)?;
+    Ok(u64::from_le_bytes(value))
+}
+
+/// Read a section prefixed by its size.
+fn read_bytes(reader: &mut impl Read) -> io::Result<Vec<u8>> {
+    let size = read_u64(reader)? as usize;
+    let mut data = Vec::new();
+    reader.take(size as u64).read_to_end(&mut data)?;
+    if data.len() != size {
+        return Err(ErrorKind::UnexpectedEof.into());
+    }
+    Ok(data)
+}
+
+/// Skip a section prefixed by its size without reading it.
+fn skip_section(reader: &mut BufReader<File>) -> io::Result<()> {
+    let size = read_u64(reader)?;
+    reader.seek_relative(size as i64)
+}
+
+/// Decode the numbers in a section.
+fn read_f64s(data: &[u8]) -> Vec<f64> {
+    data.chunks_exact(8)
+        .map(|v| f64::from_le_bytes(v.try_into().unwrap()))
+        .collect()
+}
+
+/// Decode the variable values in a section.
+fn read_variables(mut data: &[u8]) -> io::Result<Vec<VariableValue>> {
+    fn take<'a>(data: &mut &'a [u8], n: usize) -> io::Result<&'a [u8]> {
+        if data.len() < n {
+            return Err(invalid_data("the variable values are truncated"));
+        }
+        let (value, rest) = data.split_at(n);
+        *data = rest;
+        Ok(value)
+    }
+
+    let mut variables = vec![];
+    while !data.is_empty() {
+        let value = match take(&mut data, 1)?[0] {
+            0 => VariableValue::Real(f64::from_le_bytes(take(&mut data, 8)?.try_into().unwrap())),
+            1 => {
+                VariableValue::Integer(i64::from_le_bytes(take(&mut data, 8)?.try_into().unwrap()))
+            }
+            2 => VariableValue::Boolean(take(&mut data, 1)?[0] != 0),
+            3 => {
+                let size = u32::from_le_bytes(take(&mut data, 4)?.try_into().unwrap()) as usize;
+                let value = String::from_utf8(take(&mut data, size)?.to_vec())
+                    .map_err(|e| io::Error::new(ErrorKind::InvalidData, e))?;
+                VariableValue::Choice(value)
+            }
+            tag => {
+                return Err(invalid_data(&format!(
+                    "the variable tag {tag} is not valid"
+                )))
+            }
+        };
+        variables.push(value);
+    }
+    Ok(variables)
+}
+
+/// Check whether a file is a binary history file, based on its extension.
+///
+/// # Arguments
+///
+/// * `file`: The file path.
+///
+/// returns: `bool`
+pub(crate) fn is_history_file(file: &Path) -> bool {
+    file.extension()
+        .is_some_and(|ext| ext == HISTORY_FILE_EXTENSION)
+}
+
+/// Read all the generations stored in a binary history file.
+///
+/// # Arguments
+///
+/// * `file`: The file path.
+/// * `columns`: The columns to read; the individual's data are empty when these are not read.
+///
+/// returns: `Result<Vec<AlgorithmSerialisedExport<T>>, OError>`
+pub(crate) fn read_generations<T: Serialize + DeserializeOwned>(
+    file: &Path,
+    columns: HistoryColumns,
+) -> Result<Vec<AlgorithmSerialisedExport<T>>, OError> {
+    let mut reader = HistoryReader::open(file)?;
+    reader
+        .read_blocks(columns)?
+        .into_iter()
+        .map(|block| block.into_export(reader.header()))
+        .collect()
+}
+
+/// Read the last generation stored in a binary history file. This returns an error if the file
+/// does not contain any generation.
+///
+/// # Arguments
+///
+/// * `file`: The file path.
+/// * `columns`: The columns to read; the individual's data are empty when these are not read.
+///
+/// returns: `Result<AlgorithmSerialisedExport<T>, OError>`
+pub(crate) fn read_last_generation<T: Serialize + DeserializeOwned>(
+    file: &Path,
+    columns: HistoryColumns,
+) -> Result<AlgorithmSerialisedExport<T>, OError> {
+    let mut reader = HistoryReader::open(file)?;
+    match reader.read_last_block(columns)? {
+        Some(block) => block.into_export(reader.header()),
+        None => Err(OError::File(
+            file.to_path_buf(),
+            "the history file does not contain any generation".to_string(),
+        )),
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use std::collections::HashMap;
+    use std::env;
+    use std::error::Error;
+    use std::fs;
+    use std::sync::Arc;
+
+    use crate::algorithms::{
+        Algorithm, ExportHistory, HistoryFormat, MaxGenerationValue, NSGA2Arg,
+        StoppingConditionType, NSGA2,
+    };
+    use crate::core::builtin_problems::SCHProblem;
+    use crate::core::{
+        BoundedNumber, EvaluationResult, Evaluator, Individual, Objective, ObjectiveDirection,
+        Problem, VariableType,
+    };
+    use crate::metrics::HyperVolume;
+
+    /// The SCH problem with the second objective maximised.
+    #[derive(Debug)]
+    struct MaximisedSCHProblem;
+
+    impl MaximisedSCHProblem {
+        fn create() -> Problem {
+            let objectives = vec![
+                Objective::new("x^2", ObjectiveDirection::Minimise),
+                Objective::new("-(x-2)^2", ObjectiveDirection::Maximise),
+            ];
+            let variables = vec![VariableType::Real(
+                BoundedNumber::new("x", -1000.0, 1000.0).unwrap(),
+            )];
+            Problem::new(objectives, variables, None, Box::new(MaximisedSCHProblem)).unwrap()
+        }
+    }
+
+    impl Evaluator for MaximisedSCHProblem {
+        fn evaluate(&self, i: &Individual) -> Result<EvaluationResult, Box<dyn Error>> {
+            let x = i.get_variable_value("x")?.as_real()?;
+            let objectives = HashMap::from([
+                ("x^2".to_string(), SCHProblem::f1(x)),
+                ("-(x-2)^2".to_string(), -SCHProblem::f2(x)),
+            ]);
+            Ok(EvaluationResult {
+                constraints: None,
+                objectives,
+            })
+        }
+    }
+
+    #[test]
+    /// The generations appended to the binary history file are read back.
+    fn test_binary_history() {
+        let destination = env::temp_dir().join("optirustic_binary_history_test");
+        let _ = fs::remove_dir_all(&destination);
+        fs::create_dir_all(&destination).unwrap();
+
+        let args = NSGA2Arg {
+            number_of_individuals: 10,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(6)),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            parallel: Some(false),
+            export_history: Some(
+                ExportHistory::new_with_format(2, &destination, HistoryFormat::Binary).unwrap(),
+            ),
+            resume_from_file: None,
+            seed: Some(1),
+        };
+        let mut algo = NSGA2::new(SCHProblem::create().unwrap(), args).unwrap();
+        algo.run().unwrap();
+        let results = algo.get_results();
+
+        let file = destination.join("History_NSGA2.history");
+        let history = NSGA2::read_history_file(&file).unwrap();
+        // init, every other generation and final export
+        let generations: Vec<usize> = history.iter().map(|h| h.generation).collect();
+        assert_eq!(generations, vec![0, 1, 3, 5, 6]);
+        assert_eq!(NSGA2::read_json_files(&destination).unwrap().len(), 5);
+
+        // the last generation matches the final population
+        let last = NSGA2::read_json_file(&file).unwrap();
+        assert_eq!(last.algorithm, "NSGA2");
+        assert_eq!(last.options.number_of_individuals, 10);
+        assert_eq!(
+            last.number_of_function_evaluations,
+            results.number_of_function_evaluations
+        );
+        for (exported, ind) in last.individuals.iter().zip(&results.individuals) {
+            assert_eq!(exported.objective_values, ind.serialise().objective_values);
+            assert_eq!(exported.variable_values, ind.variables());
+            assert!(exported.evaluated);
+            assert!(exported.data.contains_key("rank"));
+        }
+
+        // restart from the file
+        let problem = Arc::new(SCHProblem::create().unwrap());
+        let population = NSGA2::seed_population_from_file(problem, "NSGA2", 10, &file).unwrap();
+        assert_eq!(population.len(), 10);
+
+        let hv = HyperVolume::from_history_file(&file, &[1e7, 1e7]).unwrap();
+        assert_eq!(hv.generations(), generations);
+        assert!(hv.values().iter().all(|v| *v > 0.0));
+    }
+
+    #[test]
+    /// The maximised objectives read from the binary history file have the same sign as in the
+    /// problem, and are restored when the population is seeded from the file.
+    fn test_binary_history_maximised_objective() {
+        let destination = env::temp_dir().join("optirustic_binary_history_max_test");
+        let _ = fs::remove_dir_all(&destination);
+        fs::create_dir_all(&destination).unwrap();
+
+        let args = NSGA2Arg {
+            number_of_individuals: 10,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(4)),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            parallel: Some(false),
+            export_history: Some(
+                ExportHistory::new_with_format(1, &destination, HistoryFormat::Binary).unwrap(),
+            ),
+            resume_from_file: None,
+            seed: Some(1),
+        };
+        let mut algo = NSGA2::new(MaximisedSCHProblem::create(), args).unwrap();
+        algo.run().unwrap();
+        let mut results = algo.get_results();
+        let file = destination.join("History_NSGA2.history");
+
+        let history = NSGA2::read_history_file(&file).unwrap();
+        let last = NSGA2::read_json_file(&file).unwrap();
+        for export in [history.last().unwrap(), &last] {
+            for (exported, ind) in export.individuals.iter().zip(&results.individuals) {
+                assert_eq!(exported.objective_values, ind.serialise().objective_values);
+                assert!(exported.objective_values["-(x-2)^2"] <= 0.0);
+            }
+        }
+
+        let problem = Arc::new(MaximisedSCHProblem::create());
+        let population = NSGA2::seed_population_from_file(problem, "NSGA2", 10, &file).unwrap();
+        for (seeded, ind) in population.individuals().iter().zip(&results.individuals) {
+            assert_eq!(
+                seeded.objective_values_slice(),
+                ind.objective_values_slice()
+            );
+        }
+
+        let reference_point = [1e7, -1e7];
+        let hv = HyperVolume::from_history_file(&file, &reference_point).unwrap();
+        let expected =
+            HyperVolume::from_individual(&mut results.individuals, &reference_point).unwrap();
+        assert_eq!(*hv.values().last().unwrap(), expected);
+    }
+}
@@ -0,0 +1,417 @@
+//! Timers and counters collected by the algorithms at each generation. The time spent in each
+//! phase of a generation (such as the evaluation or the non-dominated sorting) is measured with
+//! one [`Instant`] per phase, so the overhead is negligible compared to the phases themselves.
+//! The metrics of the last generation are included in the exported data and are sent to the
+//! observers registered with [`Instrumentation::add_observer`].
+use std::collections::HashMap;
+use std::fmt::{Debug, Formatter};
+use std::time::{Duration, Instant};
+
+use crate::core::DataValue;
+
+/// The number of phases in [`Phase`].
+const NUMBER_OF_PHASES: usize = 8;
+
+/// The phases of a generation measured by the algorithms.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Phase {
+    /// The generation of the offsprings with the selection, crossover and mutation operators.
+    /// These run in the same loop, and in parallel chunks, so they are measured together.
+    OffspringGeneration,
+    /// The evaluation of the objectives and constraints.
+    Evaluation,
+    /// The non-dominated sorting of the population into fronts.
+    NonDominatedSorting,
+    /// The calculation of the crowding distance (NSGA2).
+    CrowdingDistance,
+    /// The normalisation of the objectives (NSGA3).
+    Normalisation,
+    /// The association of the individuals to the reference points (NSGA3).
+    Association,
+    /// The selection of the individuals from the last front with the niching (NSGA3).
+    Niching,
+    /// The update of the reference points (adaptive NSGA3).
+    ReferencePointUpdate,
+}
+
+impl Phase {
+    /// All the phases.
+    pub const ALL: [Phase; NUMBER_OF_PHASES] = [
+        Phase::OffspringGeneration,
+        Phase::Evaluation,
+        Phase::NonDominatedSorting,
+        Phase::CrowdingDistance,
+        Phase::Normalisation,
+        Phase::Association,
+        Phase::Niching,
+        Phase::ReferencePointUpdate,
+    ];
+
+    /// Get the phase name used in the exported data.
+    ///
+    /// returns: `&'static str`
+    pub fn name(&self) -> &'static str {
+        match self {
+            Phase::OffspringGeneration => "offspring_generation",
+            Phase::Evaluation => "evaluation",
+            Phase::NonDominatedSorting => "non_dominated_sorting",
+            Phase::CrowdingDistance => "crowding_distance",
+            Phase::Normalisation => "normalisation",
+            Phase::Association => "association",
+            Phase::Niching => "niching",
+            Phase::ReferencePointUpdate => "reference_point_update",
+        }
+    }
+}
+
+/// The timers and counters collected during one generation.
+#[derive(Debug, Clone, Default)]
+pub struct GenerationMetrics {
+    /// The generation the metrics were collected at.
+    pub generation: usize,
+    /// The time took to evolve the generation.
+    pub wall_time: Duration,
+    /// The time spent in each phase, in the same order as [`Phase::ALL`].
+    phases: [Duration; NUMBER_OF_PHASES],
+    /// The number of function evaluations performed in the generation.
+    pub evaluations: usize,
+    /// The time spent waiting for the evaluations running in the workers. This is only measured
+    /// by the asynchronous algorithms (see [`crate::algorithms::NSGA2::run_async`]).
+    pub queue_wait: Duration,
+    /// The number of memory allocations made by all the threads during the generation. This is
+    /// only available when the crate is compiled with the `count-allocations` feature.
+    pub allocations: Option<u64>,
+}
+
+impl GenerationMetrics {
+    /// Get the time spent in a phase.
+    ///
+    /// # Arguments
+    ///
+    /// * `phase`: The phase.
+    ///
+    /// returns: `Duration`
+    pub fn phase(&self, phase: Phase) -> Duration {
+        self.phases[phase as usize]
+    }
+
+    /// Get the number of function evaluations per second of wall time.
+    ///
+    /// returns: `f64`. This is `0` when the wall time is zero.
+    pub fn evaluations_per_second(&self) -> f64 {
+        let seconds = self.wall_time.as_secs_f64();
+        if seconds > 0.0 {
+            self.evaluations as f64 / seconds
+        } else {
+            0.0
+        }
+    }
+
+    /// Convert the metrics to the data stored in the algorithm exports. The times are in seconds
+    /// and only the phases run by the algorithm are included.
+    ///
+    /// returns: `DataValue`
+    pub fn to_data(&self) -> DataValue {
+        let phases = Phase::ALL
+            .iter()
+            .filter(|phase| !self.phase(**phase).is_zero())
+            .map(|phase| {
+                (
+                    phase.name().to_string(),
+                    DataValue::Real(self.phase(*phase).as_secs_f64()),
+                )
+            })
+            .collect();
+
+        let mut data = HashMap::from([
+            ("generation".to_string(), DataValue::USize(self.generation)),
+            (
+                "wall_time".to_string(),
+                DataValue::Real(self.wall_time.as_secs_f64()),
+            ),
+            ("phases".to_string(), DataValue::Map(phases)),
+            (
+                "evaluations".to_string(),
+                DataValue::USize(self.evaluations),
+            ),
+            (
+                "evaluations_per_second".to_string(),
+                DataValue::Real(self.evaluations_per_second()),
+            ),
+            (
+                "queue_wait".to_string(),
+                DataValue::Real(self.queue_wait.as_secs_f64()),
+            ),
+        ]);
+        if let Some(allocations) = self.allocations {
+            data.insert(
+                "allocations".to_string(),
+                DataValue::USize(allocations as usize),
+            );
+        }
+        DataValue::Map(data)
+    }
+}
+
+/// An observer notified at the end of each generation, for example to publish the metrics to a
+/// monitoring system. This is implemented for closures too.
+pub trait GenerationObserver: Send {
+    /// Receive the metrics of the generation that was just evolved.
+    ///
+    /// # Arguments
+    ///
+    /// * `metrics`: The metrics.
+    ///
+    /// returns: `()`
+    fn on_generation(&mut self, metrics: &GenerationMetrics);
+}
+
+impl<F: FnMut(&GenerationMetrics) + Send> GenerationObserver for F {
+    fn on_generation(&mut self, metrics: &GenerationMetrics) {
+        self(metrics)
+    }
+}
+
+/// Collect the [`GenerationMetrics`] of an algorithm and notify the observers.
+#[derive(Default)]
+pub struct Instrumentation {
+    /// The metrics of the generation being evolved.
+    current: GenerationMetrics,
+    /// The time when the current generation started.
+    start: Option<Instant>,
+    /// The allocation counter when the current generation started.
+    allocations_at_start: Option<u64>,
+    /// The metrics of the last evolved generation.
+    last: Option<GenerationMetrics>,
+    /// The registered observers.
+    observers: Vec<Box<dyn GenerationObserver>>,
+}
+
+impl Debug for Instrumentation {
+    fn fmt(&self, f: &mut Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("Instrumentation")
+            .field("last", &self.last)
+            .field("observers", &self.observers.len())
+            .finish()
+    }
+}
+
+impl Instrumentation {
+    /// Register an observer notified at the end of each generation.
+    ///
+    /// # Arguments
+    ///
+    /// * `observer`: The observer or a closure receiving the [`GenerationMetrics`].
+    ///
+    /// returns: `()`
+    pub fn add_observer(&mut self, observer: impl GenerationObserver + 'static) {
+        self.observers.push(Box::new(observer));
+    }
+
+    /// Get the metrics of the last evolved generation.
+    ///
+    /// returns: `Option<&GenerationMetrics>`. `None` if no generation was evolved yet.
+    pub fn last_generation(&self) -> Option<&GenerationMetrics> {
+        self.last.as_ref()
+    }
+
+    /// Reset the timers and counters at the beginning of a generation.
+    pub(crate) fn start_generation(&mut self) {
+        self.current = GenerationMetrics::default();
+        self.start = Some(Instant::now());
+        self.allocations_at_start = allocations::count();
+    }
+
+    /// Add the time elapsed since `start` to a phase.
+    ///
+    /// # Arguments
+    ///
+    /// * `phase`: The phase.
+    /// * `start`: The time when the phase started.
+    ///
+    /// returns: `()`
+    pub(crate) fn record(&mut self, phase: Phase, start: Instant) {
+        self.current.phases[phase as usize] += start.elapsed();
+    }
+
+    /// Add the time elapsed since `start` to the time spent waiting for the workers.
+    ///
+    /// # Arguments
+    ///
+    /// * `start`: The time when the wait started.
+    ///
+    /// returns: `()`
+    pub(crate) fn record_queue_wait(&mut self, start: Instant) {
+        self.current.queue_wait += start.elapsed();
+    }
+
+    /// Increase the number of function evaluations of the current generation.
+    ///
+    /// # Arguments
+    ///
+    /// * `evaluations`: The number of new evaluations.
+    ///
+    /// returns: `()`
+    pub(crate) fn add_evaluations(&mut self, evaluations: usize) {
+        self.current.evaluations += evaluations;
+    }
+
+    /// Complete the metrics of the current generation and send them to the observers.
+    ///
+    /// # Arguments
+    ///
+    /// * `generation`: The evolved generation.
+    ///
+    /// returns: `()`
+    pub(crate) fn finish_generation(&mut self, generation: usize) {
+        let mut metrics = std::mem::take(&mut self.current);
+        metrics.generation = generation;
+        metrics.wall_time = self.start.take().map_or(Duration::ZERO, |s| s.elapsed());
+        metrics.allocations = allocations::count()
+            .zip(self.allocations_at_start)
+            .map(|(end, start)| end - start);
+
+        for observer in self.observers.iter_mut() {
+            observer.on_generation(&metrics);
+        }
+        self.last = Some(metrics);
+    }
+
+    /// Get the data with the metrics of the last generation to include in the algorithm exports.
+    ///
+    /// returns: `Option<DataValue>`
+    pub(crate) fn export_data(&self) -> Option<DataValue> {
+        self.last.as_ref().map(|m| m.to_data())
+    }
+}
+
+/// The allocation counter enabled with the `count-allocations` feature. This wraps the system
+/// allocator to count the calls to `alloc` and `realloc` made by all the threads.
+#[cfg(feature = "count-allocations")]
+mod allocations {
+    use std::alloc::{GlobalAlloc, Layout, System};
+    use std::sync::atomic::{AtomicU64, Ordering};
+
+    /// The number of allocations since the program started.
+    static ALLOCATIONS: AtomicU64 = AtomicU64::new(0);
+
+    /// The system allocator counting the allocations.
+    struct CountingAllocator;
+
+    unsafe impl GlobalAlloc for CountingAllocator {
+        unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+            ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+            System.alloc(layout)
+        }
+
+        unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+            System.dealloc(ptr, layout)
+        }
+
+        unsafe fn alloc_zeroed(&self, layout: Layout) -> *mut u8 {
+            ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+            System.alloc_zeroed(layout)
+        }
+
+        unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+            ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+            System.realloc(ptr, layout, new_size)
+        }
+    }
+
+    #[global_allocator]
+    static GLOBAL: CountingAllocator = CountingAllocator;
+
+    /// Get the number of allocations since the program started.
+    ///
+    /// returns: `Option<u64>`
+    pub(super) fn count() -> Option<u64> {
+        Some(ALLOCATIONS.load(Ordering::Relaxed))
+    }
+}
+
+/// The allocation counter when the `count-allocations` feature is disabled.
+#[cfg(not(feature = "count-allocations"))]
+mod allocations {
+    /// The allocations are not counted.
+    ///
+    /// returns: `Option<u64>`
+    pub(super) fn count() -> Option<u64> {
+        None
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use std::sync::{Arc, Mutex};
+
+    use crate::algorithms::{
+        Algorithm, GenerationMetrics, MaxGenerationValue, NSGA2Arg, NSGA3Arg,
+        Nsga3NumberOfIndividuals, Phase, StoppingConditionType, NSGA2, NSGA3,
+    };
+    use crate::core::builtin_problems::{DTLZ1Problem, SCHProblem};
+    use crate::core::DataValue;
+    use crate::utils::NumberOfPartitions;
+
+    #[test]
+    /// The observers receive the metrics of each generation and the last ones are exported.
+    fn test_nsga2_metrics() {
+        let args = NSGA2Arg {
+            number_of_individuals: 10,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(5)),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            parallel: Some(false),
+            export_history: None,
+            resume_from_file: None,
+            seed: Some(1),
+        };
+        let mut algo = NSGA2::new(SCHProblem::create().unwrap(), args).unwrap();
+        let received: Arc<Mutex<Vec<GenerationMetrics>>> = Arc::new(Mutex::new(vec![]));
+        let observer_data = received.clone();
+        algo.instrumentation_mut()
+            .add_observer(move |m: &GenerationMetrics| {
+                observer_data.lock().unwrap().push(m.clone())
+            });
+        algo.run().unwrap();
+
+        let received = received.lock().unwrap();
+        assert_eq!(received.len(), 4);
+        for (g, metrics) in received.iter().enumerate() {
+            assert_eq!(metrics.generation, g + 2);
+            assert_eq!(metrics.evaluations, 10);
+            assert!(metrics.phase(Phase::Evaluation) <= metrics.wall_time);
+            assert!(metrics.phase(Phase::Niching).is_zero());
+        }
+
+        let results = algo.get_results();
+        let DataValue::Map(data) = &results.additional_data["generation_metrics"] else {
+            panic!("the metrics are not a map");
+        };
+        assert_eq!(data["generation"], DataValue::USize(5));
+        assert_eq!(data["evaluations"], DataValue::USize(10));
+    }
+
+    #[test]
+    /// The NSGA3 phases are measured.
+    fn test_nsga3_metrics() {
+        let args = NSGA3Arg {
+            number_of_individuals: Nsga3NumberOfIndividuals::EqualToReferencePointCount,
+            number_of_partitions: NumberOfPartitions::OneLayer(4),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(3)),
+            parallel: Some(false),
+            export_history: None,
+            seed: Some(1),
+        };
+        let mut algo = NSGA3::new(DTLZ1Problem::create(7, 3, false).unwrap(), args, true).unwrap();
+        algo.run().unwrap();
+
+        let metrics = algo.instrumentation().last_generation().unwrap();
+        assert_eq!(metrics.generation, 3);
+        assert!(!metrics.phase(Phase::NonDominatedSorting).is_zero());
+        assert!(metrics.phase(Phase::CrowdingDistance).is_zero());
+        assert!(metrics.evaluations_per_second() > 0.0);
+    }
+}
@@ -0,0 +1,584 @@
+//! Island model running several algorithms in parallel, each on its own thread and with its own
+//! population, that periodically exchange their best individuals (see [`IslandModel`]).
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::mpsc::{channel, Receiver, Sender};
+use std::sync::Arc;
+use std::thread;
+use std::time::{Duration, Instant};
+
+use log::{debug, info};
+use rand::seq::SliceRandom;
+use rand::RngCore;
+use serde::{Deserialize, Serialize};
+
+use crate::algorithms::algorithm::Elapsed;
+use crate::algorithms::{
+    Algorithm, AlgorithmExport, NSGA2Arg, NSGA3Arg, StoppingConditionType, NSGA2, NSGA3,
+};
+use crate::core::utils::get_rng;
+use crate::core::{Individual, OError, Population, Problem};
+use crate::utils::non_dominated_sort_indexes;
+
+/// An algorithm that can be evolved in an [`IslandModel`]. This is implemented for [`NSGA2`] and
+/// [`NSGA3`] (including [`crate::algorithms::AdaptiveNSGA3`]), so that islands using different
+/// algorithms can be mixed in the same model.
+pub trait Island: Send {
+    /// Return the algorithm name.
+    ///
+    /// return: `String`.
+    fn name(&self) -> String;
+
+    /// Initialise the algorithm.
+    ///
+    /// return: `Result<(), OError>`
+    fn initialise(&mut self) -> Result<(), OError>;
+
+    /// Evolve the population by one generation.
+    ///
+    /// return: `Result<(), OError>`
+    fn evolve(&mut self) -> Result<(), OError>;
+
+    /// Return the current step of the algorithm evolution.
+    ///
+    /// return: `usize`.
+    fn generation(&self) -> usize;
+
+    /// Return the number of function evaluations.
+    ///
+    /// return: `usize`.
+    fn number_of_function_evaluations(&self) -> usize;
+
+    /// Return the evolved population.
+    ///
+    /// return: `&Population`.
+    fn population(&self) -> &Population;
+
+    /// Return the problem.
+    ///
+    /// return: `Arc<Problem>`.
+    fn problem(&self) -> Arc<Problem>;
+
+    /// Add the individuals received from another island to the population.
+    ///
+    /// # Arguments
+    ///
+    /// * `migrants`: The evaluated individuals. These already belong to [`Island::problem`].
+    ///
+    /// returns: `Result<(), OError>`
+    fn receive_migrants(&mut self, migrants: Vec<Individual>) -> Result<(), OError>;
+
+    /// Get the results of the island.
+    ///
+    /// return: `AlgorithmExport`.
+    fn get_results(&self) -> AlgorithmExport;
+}
+
+/// Implement the [`Island`] trait for an algorithm that also implements `add_migrants`.
+macro_rules! impl_island {
+    ($name: ident, $ArgType: ident) => {
+        impl Island for $name {
+            fn name(&self) -> String {
+                <Self as Algorithm<$ArgType>>::name(self)
+            }
+
+            fn initialise(&mut self) -> Result<(), OError> {
+                <Self as Algorithm<$ArgType>>::initialise(self)
+            }
+
+            fn evolve(&mut self) -> Result<(), OError> {
+                <Self as Algorithm<$ArgType>>::evolve(self)
+            }
+
+            fn generation(&self) -> usize {
+                <Self as Algorithm<$ArgType>>::generation(self)
+            }
+
+            fn number_of_function_evaluations(&self) -> usize {
+                <Self as Algorithm<$ArgType>>::number_of_function_evaluations(self)
+            }
+
+            fn population(&self) -> &Population {
+                <Self as Algorithm<$ArgType>>::population(self)
+            }
+
+            fn problem(&self) -> Arc<Problem> {
+                <Self as Algorithm<$ArgType>>::problem(self)
+            }
+
+            fn receive_migrants(&mut self, migrants: Vec<Individual>) -> Result<(), OError> {
+                self.add_migrants(migrants)
+            }
+
+            fn get_results(&self) -> AlgorithmExport {
+                <Self as Algorithm<$ArgType>>::get_results(self)
+            }
+        }
+    };
+}
+
+impl_island!(NSGA2, NSGA2Arg);
+impl_island!(NSGA3, NSGA3Arg);
+
+/// Input arguments for the [`IslandModel`].
+#[derive(Serialize, Deserialize, Clone)]
+pub struct IslandModelArgs {
+    /// The number of generations between two migrations. Each island sends its migrants after
+    /// evolving a generation that is a multiple of this number.
+    pub migration_interval: usize,
+    /// The maximum number of individuals sent by an island at each migration. These are picked
+    /// at random from the first non-dominated front of the island population. Set this to `0` to
+    /// evolve the islands independently.
+    pub number_of_migrants: usize,
+    /// The condition to stop all the islands. This is checked before each generation using the
+    /// smallest generation reached by the islands, the total number of function evaluations and
+    /// the time elapsed since the model started. The stopping conditions set on the algorithms are
+    /// not used.
+    pub stopping_condition: StoppingConditionType,
+    /// The seed used to pick the migrants. Island `i` uses the seed plus `i`.
+    pub seed: Option<u64>,
+}
+
+/// The island model evolves several algorithms (the islands), each with its own population, on
+/// separate threads. The islands are connected in a ring: every
+/// [`IslandModelArgs::migration_interval`] generations, an island sends some of its non-dominated
+/// individuals to the next island, and the migrants replace the worst individuals of the
+/// receiving population. This preserves the diversity of the populations, while the best
+/// solutions are still shared by all the islands.
+///
+/// **IMPLEMENTATION NOTES**:
+/// 1) The islands do not wait for each other: the migrants are sent through unbounded
+///    [`std::sync::mpsc`] channels and an island only takes the last batch of migrants available
+///    after each generation, so a slow island never blocks the faster ones.
+/// 2) The islands may use different algorithms (for example [`NSGA2`] and [`NSGA3`]), but they
+///    must solve the same problem. Because the algorithms take ownership of their problem, each
+///    island should be created with a new instance of the problem.
+/// 3) The algorithms are evolved with [`Island::evolve`] and the history export and stopping
+///    condition of each algorithm are not used.
+/// 4) The results of the model ([`IslandModel::get_results`]) contain the non-dominated
+///    individuals of all the islands; use [`IslandModel::islands`] to access the result of each
+///    island.
+pub struct IslandModel {
+    /// The islands.
+    islands: Vec<Box<dyn Island>>,
+    /// The model arguments.
+    args: IslandModelArgs,
+    /// The time the last run took.
+    took: Option<Duration>,
+}
+
+impl IslandModel {
+    /// Initialise the island model. This returns an error if there are no islands, the migration
+    /// interval is 0 or the islands do not solve the same problem.
+    ///
+    /// # Arguments
+    ///
+    /// * `islands`: The algorithms to evolve.
+    /// * `args`: The [`IslandModelArgs`] arguments to customise the model.
+    ///
+    /// returns: `Result<IslandModel, OError>`
+    pub fn new(islands: Vec<Box<dyn Island>>, args: IslandModelArgs) -> Result<Self, OError> {
+        let name = "the island model".to_string();
+        let Some(first) = islands.first() else {
+            return Err(OError::AlgorithmInit(
+                name,
+                "At least one island is needed".to_string(),
+            ));
+        };
+        if args.migration_interval == 0 {
+            return Err(OError::AlgorithmInit(
+                name,
+                "The migration interval must be at least 1".to_string(),
+            ));
+        }
+
+        let problem = first.problem();
+        for (index, island) in islands.iter().enumerate().skip(1) {
+            let other = island.problem();
+            let same_directions = problem.objective_names().iter().all(|objective| {
+                problem.is_objective_minimised(objective).ok()
+                    == other.is_objective_minimised(objective).ok()
+            });
+            if problem.objective_names() != other.objective_names()
+                || problem.variable_names() != other.variable_names()
+                || problem.constraint_names() != other.constraint_names()
+                || !same_directions
+            {
+                return Err(OError::AlgorithmInit(
+                    name,
+                    format!(
+                        "The problem of island #{} ({}) does not match the problem of the first island",
+                        index + 1,
+                        island.name()
+                    ),
+                ));
+            }
+        }
+
+        Ok(Self {
+            islands,
+            args,
+            took: None,
+        })
+    }
+
+    /// Get the islands.
+    ///
+    /// returns: `&[Box<dyn Island>]`
+    pub fn islands(&self) -> &[Box<dyn Island>] {
+        &self.islands
+    }
+
+    /// Initialise and evolve the islands on separate threads until the stopping condition is met.
+    /// When an island fails, all the islands are stopped and its error is returned.
+    ///
+    /// returns: `Result<(), OError>`
+    pub fn run(&mut self) -> Result<(), OError> {
+        let number_of_islands = self.islands.len();
+        info!(
+            "Starting the island model with {} islands",
+            number_of_islands
+        );
+        let start_time = Instant::now();
+
+        let generations: Vec<AtomicUsize> = (0..number_of_islands)
+            .map(|_| AtomicUsize::new(0))
+            .collect();
+        let evaluations: Vec<AtomicUsize> = (0..number_of_islands)
+            .map(|_| AtomicUsize::new(0))
+            .collect();
+        let stop = AtomicBool::new(false);
+        let state = SharedState {
+            args: &self.args,
+            start_time,
+            generations: &generations,
+            evaluations: &evaluations,
+            stop: &stop,
+            migrate: number_of_islands > 1 && self.args.number_of_migrants > 0,
+        };
+
+        // island i sends its migrants to island i + 1
+        let (senders, receivers): (Vec<_>, Vec<_>) =
+            (0..number_of_islands).map(|_| channel()).unzip();
+        let results: Vec<Result<(), OError>> = thread::scope(|scope| {
+            let handles: Vec<_> = self
+                .islands
+                .iter_mut()
+                .zip(receivers)
+                .enumerate()
+                .map(|(index, (island, receiver))| {
+                    let sender = senders[(index + 1) % number_of_islands].clone();
+                    let state = &state;
+                    scope.spawn(move || {
+                        let result = state.evolve(index, island.as_mut(), &sender, &receiver);
+                        if result.is_err() {
+                            state.stop.store(true, Ordering::Relaxed);
+                        }
+                        result
+                    })
+                })
+                .collect();
+            handles
+                .into_iter()
+                .map(|handle| {
+                    handle.join().unwrap_or_else(|_| {
+                        Err(OError::AlgorithmRun(
+                            "the island model".to_string(),
+                            "An island panicked".to_string(),
+                        ))
+                    })
+                })
+                .collect()
+        });
+        results.into_iter().collect::<Result<Vec<()>, OError>>()?;
+
+        let took = start_time.elapsed();
+        info!("The island model took {:?}", took);
+        self.took = Some(took);
+        Ok(())
+    }
+
+    /// Get the results of the run. The individuals are the non-dominated individuals from the
+    /// populations of all the islands (the same solution is only included once); the generation
+    /// is the smallest generation reached by the islands and the number of function evaluations
+    /// is the total for all the islands. This returns an error if the model has not been run.
+    ///
+    /// return: `Result<AlgorithmExport, OError>`.
+    pub fn get_results(&self) -> Result<AlgorithmExport, OError> {
+        let Some(took) = self.took else {
+            return Err(OError::AlgorithmRun(
+                "the island model".to_string(),
+                "The model must be run before collecting the results".to_string(),
+            ));
+        };
+
+        let problem = self.islands[0].problem();
+        let mut individuals: Vec<Individual> = self
+            .islands
+            .iter()
+            .flat_map(|island| island.population().individuals())
+            .map(|individual| individual.with_problem(problem.clone()))
+            .collect();
+        let mut front: Vec<Individual> = Vec::new();
+        let front_indexes = if individuals.len() < 2 {
+            (0..individuals.len()).collect()
+        } else {
+            non_dominated_sort_indexes(&mut individuals, true)?
+                .front_indexes
+                .swap_remove(0)
+        };
+        for index in front_indexes {
+            let individual = &individuals[index];
+            // a solution can be in more than one island after a migration
+            if !front
+                .iter()
+                .any(|f| f.variable_values_slice() == individual.variable_values_slice())
+            {
+                front.push(individual.clone());
+            }
+        }
+
+        let names: Vec<String> = self.islands.iter().map(|island| island.name()).collect();
+        let seconds = took.as_secs();
+        Ok(AlgorithmExport {
+            problem,
+            individuals: front,
+            generation: self.islands.iter().map(|i| i.generation()).min().unwrap(),
+            number_of_function_evaluations: self
+                .islands
+                .iter()
+                .map(|i| i.number_of_function_evaluations())
+                .sum(),
+            algorithm: format!("Islands({})", names.join(", ")),
+            took: Elapsed {
+                hours: seconds / 3600,
+                minutes: (seconds / 60) % 60,
+                seconds: seconds % 60,
+            },
+            additional_data: HashMap::new(),
+            evaluation_cache: None,
+        })
+    }
+}
+
+/// The state shared by the threads evolving the islands.
+struct SharedState<'a> {
+    /// The model arguments.
+    args: &'a IslandModelArgs,
+    /// The time when the model started.
+    start_time: Instant,
+    /// The generation reached by each island.
+    generations: &'a [AtomicUsize],
+    /// The number of function evaluations of each island.
+    evaluations: &'a [AtomicUsize],
+    /// Whether the islands must stop.
+    stop: &'a AtomicBool,
+    /// Whether the islands exchange individuals.
+    migrate: bool,
+}
+
+impl SharedState<'_> {
+    /// Initialise and evolve an island until the stopping condition is met or another island
+    /// requests to stop.
+    ///
+    /// # Arguments
+    ///
+    /// * `index`: The island index.
+    /// * `island`: The island.
+    /// * `sender`: The sender of the migrants to the next island.
+    /// * `receiver`: The receiver of the migrants from the previous island.
+    ///
+    /// returns: `Result<(), OError>`
+    fn evolve(
+        &self,
+        index: usize,
+        island: &mut dyn Island,
+        sender: &Sender<Vec<Individual>>,
+        receiver: &Receiver<Vec<Individual>>,
+    ) -> Result<(), OError> {
+        let mut rng = get_rng(self.args.seed.map(|s| s.wrapping_add(index as u64)));
+        island.initialise()?;
+        loop {
+            self.generations[index].store(island.generation(), Ordering::Relaxed);
+            self.evaluations[index]
+                .store(island.number_of_function_evaluations(), Ordering::Relaxed);
+            if self.stop.load(Ordering::Relaxed) {
+                break;
+            }
+
+            let generation = self
+                .generations
+                .iter()
+                .map(|g| g.load(Ordering::Relaxed))
+                .min()
+                .unwrap_or(0);
+            let nfe = self
+                .evaluations
+                .iter()
+                .map(|e| e.load(Ordering::Relaxed))
+                .sum();
+            let condition = &self.args.stopping_condition;
+            if condition
+                .is_met(generation, nfe, self.start_time.elapsed())
+                .map_err(|e| OError::AlgorithmRun("the island model".to_string(), e))?
+            {
+                info!(
+                    "Stopping island #{} because the {} was reached",
+                    index + 1,
+                    condition.name()
+                );
+                self.stop.store(true, Ordering::Relaxed);
+                break;
+            }
+
+            island.evolve()?;
+            if !self.migrate {
+                continue;
+            }
+            if island.generation() % self.args.migration_interval == 0 {
+                let migrants = select_migrants(
+                    island.population(),
+                    self.args.number_of_migrants,
+                    rng.as_mut(),
+                )?;
+                debug!("Island #{} sends {} migrants", index + 1, migrants.len());
+                // the next island may have already stopped
+                let _ = sender.send(migrants);
+            }
+            if let Some(migrants) = receiver.try_iter().last() {
+                debug!("Island #{} receives {} migrants", index + 1, migrants.len());
+                let problem = island.problem();
+                island.receive_migrants(
+                    migrants
+                        .iter()
+                        .map(|m| m.with_problem(problem.clone()))
+                        .collect(),
+                )?;
+            }
+        }
+        Ok(())
+    }
+}
+
+/// Pick at random the migrants from the first non-dominated front of a population.
+///
+/// # Arguments
+///
+/// * `population`: The population.
+/// * `number_of_migrants`: The maximum number of migrants.
+/// * `rng`: The random number generator.
+///
+/// returns: `Result<Vec<Individual>, OError>`
+fn select_migrants(
+    population: &Population,
+    number_of_migrants: usize,
+    rng: &mut dyn RngCore,
+) -> Result<Vec<Individual>, OError> {
+    let mut individuals = population.individuals().to_vec();
+    if individuals.len() < 2 {
+        return Ok(individuals);
+    }
+    let mut front = non_dominated_sort_indexes(&mut individuals, true)?
+        .front_indexes
+        .swap_remove(0);
+    front.shuffle(rng);
+    front.truncate(number_of_migrants);
+    Ok(front.into_iter().map(|i| individuals[i].clone()).collect())
+}
+
+#[cfg(test)]
+mod test {
+    use crate::algorithms::island::{Island, IslandModel, IslandModelArgs};
+    use crate::algorithms::{
+        MaxGenerationValue, NSGA2Arg, NSGA3Arg, Nsga3NumberOfIndividuals, StoppingConditionType,
+        NSGA2, NSGA3,
+    };
+    use crate::core::builtin_problems::{SCHProblem, ZTD1Problem};
+    use crate::core::{Individuals, OError, Problem};
+    use crate::utils::NumberOfPartitions;
+
+    /// Create an NSGA2 island.
+    fn nsga2(problem: Problem, seed: u64) -> Box<dyn Island> {
+        let args = NSGA2Arg {
+            number_of_individuals: 10,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(1)),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            parallel: Some(false),
+            export_history: None,
+            resume_from_file: None,
+            seed: Some(seed),
+        };
+        Box::new(NSGA2::new(problem, args).unwrap())
+    }
+
+    fn args(generations: usize) -> IslandModelArgs {
+        IslandModelArgs {
+            migration_interval: 5,
+            number_of_migrants: 2,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(
+                generations,
+            )),
+            seed: Some(1),
+        }
+    }
+
+    #[test]
+    /// Evolve NSGA2 and NSGA3 islands on the SCH problem.
+    fn test_mixed_islands() {
+        let nsga3_args = NSGA3Arg {
+            number_of_individuals: Nsga3NumberOfIndividuals::EqualToReferencePointCount,
+            number_of_partitions: NumberOfPartitions::OneLayer(10),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(1)),
+            parallel: Some(false),
+            export_history: None,
+            seed: Some(3),
+        };
+        let islands = vec![
+            nsga2(SCHProblem::create().unwrap(), 1),
+            nsga2(SCHProblem::create().unwrap(), 2),
+            Box::new(NSGA3::new(SCHProblem::create().unwrap(), nsga3_args, false).unwrap())
+                as Box<dyn Island>,
+        ];
+        let mut model = IslandModel::new(islands, args(30)).unwrap();
+        assert!(model.get_results().is_err());
+        model.run().unwrap();
+
+        // the model stops when all the islands reach the generation
+        let generations: Vec<usize> = model.islands().iter().map(|i| i.generation()).collect();
+        assert!(generations.iter().all(|g| *g >= 30), "{:?}", generations);
+
+        let results = model.get_results().unwrap();
+        assert_eq!(results.generation, *generations.iter().min().unwrap());
+        assert_eq!(
+            results.number_of_function_evaluations,
+            model
+                .islands()
+                .iter()
+                .map(|i| i.number_of_function_evaluations())
+                .sum::<usize>()
+        );
+        assert!(results.algorithm.starts_with("Islands(NSGA2, NSGA2, NSGA3"));
+
+        // the solutions of the SCH problem are between 0 and 2
+        assert!(!results.individuals.is_empty());
+        for x in results.individuals.to_real_vec("x").unwrap() {
+            assert!((-0.1..=2.1).contains(&x), "x = {x}");
+        }
+    }
+
+    #[test]
+    /// The islands must solve the same problem.
+    fn test_different_problems() {
+        let islands = vec![
+            nsga2(SCHProblem::create().unwrap(), 1),
+            nsga2(ZTD1Problem::create(30).unwrap(), 2),
+        ];
+        assert!(matches!(
+            IslandModel::new(islands, args(10)),
+            Err(OError::AlgorithmInit(_, _))
+        ));
+    }
+}
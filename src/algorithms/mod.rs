@@ -1,13 +1,25 @@
 pub use a_nsga3::AdaptiveNSGA3;
 pub use algorithm::{Algorithm, AlgorithmExport, AlgorithmSerialisedExport, ExportHistory};
+pub use asynchronous::AsyncEvaluationArgs;
+pub use history::{HistoryFormat, HISTORY_FILE_EXTENSION};
+pub use instrumentation::{GenerationMetrics, GenerationObserver, Instrumentation, Phase};
+pub use island::{Island, IslandModel, IslandModelArgs};
 pub use nsga2::{NSGA2Arg, NSGA2};
 pub use nsga3::{NSGA3Arg, Nsga3NumberOfIndividuals, NSGA3};
+pub use objectives::GenerationObjectives;
 pub use stopping_condition::{
-    MaxDurationValue, MaxGenerationValue, StoppingCondition, StoppingConditionType,
+    MaxDurationValue, MaxFunctionEvaluationValue, MaxGenerationValue, StoppingCondition,
+    StoppingConditionType,
 };
 
 mod a_nsga3;
 mod algorithm;
+mod asynchronous;
+pub(crate) mod history;
+mod instrumentation;
+mod island;
 mod nsga2;
-mod nsga3;
+pub(crate) mod nsga3;
+mod objectives;
+mod reproduction;
 mod stopping_condition;
@@ -1,20 +1,24 @@
 use std::fmt::{Display, Formatter};
 use std::ops::Rem;
 use std::path::PathBuf;
+use std::thread;
 
 use log::{debug, info};
 use rand::RngCore;
 
 use optirustic_macros::{as_algorithm, as_algorithm_args, impl_algorithm_trait_items};
 
-use crate::algorithms::Algorithm;
+use crate::algorithms::asynchronous::{AsyncEvaluationArgs, WorkerPool};
+use crate::algorithms::reproduction::generate_offsprings;
+use crate::algorithms::{Algorithm, Phase};
 use crate::core::utils::get_rng;
-use crate::core::{DataValue, Individual, Individuals, IndividualsMut, OError};
+use crate::core::{DataValue, Individual, Individuals, OError};
 use crate::operators::{
     Crossover, CrowdedComparison, Mutation, PolynomialMutation, PolynomialMutationArgs, Selector,
     SimulatedBinaryCrossover, SimulatedBinaryCrossoverArgs, TournamentSelector,
 };
-use crate::utils::{argsort, fast_non_dominated_sort, vector_max, vector_min, Sort};
+use crate::utils::fixed_objectives::with_fixed_objectives;
+use crate::utils::{non_dominated_sort_indexes, split_into_fronts};
 
 /// The data key where the crowding distance is stored for each [`Individual`].
 const CROWDING_DIST_KEY: &str = "crowding_distance";
@@ -76,7 +80,7 @@ pub struct NSGA2 {
     /// The PM operator to use to mutate the variables of an individual.
     mutation_operator: PolynomialMutation,
     /// The seed to use.
-    rng: Box<dyn RngCore>,
+    rng: Box<dyn RngCore + Send>,
 }
 
 impl NSGA2 {
@@ -149,6 +153,7 @@ impl NSGA2 {
             export_history: options.export_history,
             rng: get_rng(options.seed),
             args: nsga2_args,
+            instrumentation: Instrumentation::default(),
         })
     }
 
@@ -191,6 +196,257 @@ impl NSGA2 {
         log_opts
     }
 
+    /// Select two parents from the population with a binary tournament and generate two new
+    /// children with crossover and mutation.
+    ///
+    /// returns: `Result<[Individual; 2], OError>`
+    fn generate_offsprings(&mut self) -> Result<[Individual; 2], OError> {
+        let individuals = self.population.individuals();
+        let parent1 = self
+            .selector_operator
+            .select_fit_index(individuals, &mut self.rng)?;
+        let parent2 = self
+            .selector_operator
+            .select_fit_index(individuals, &mut self.rng)?;
+
+        // generate the 2 children with crossover
+        let children = self.crossover_operator.generate_offsprings(
+            &individuals[parent1],
+            &individuals[parent2],
+            &mut self.rng,
+        )?;
+
+        // mutate them
+        Ok([
+            self.mutation_operator
+                .mutate_offspring(&children.child1, &mut self.rng)?,
+            self.mutation_operator
+                .mutate_offspring(&children.child2, &mut self.rng)?,
+        ])
+    }
+
+    /// Run the steady-state (asynchronous) version of the algorithm. Instead of evaluating a
+    /// whole generation and waiting for its slowest individual, the individuals are sent to a
+    /// bounded queue processed by a pool of workers. As soon as one evaluation completes, the
+    /// individual is added to the population, the worst individual (in the last front and with
+    /// the smallest crowding distance) is discarded and a new offspring is generated and
+    /// submitted to the idle worker. This keeps all the workers busy when the evaluation time
+    /// changes between individuals (for example when each evaluation runs a simulation model).
+    ///
+    /// The generation counter increases each time `number_of_individuals` new individuals are
+    /// evaluated, so that the [`StoppingConditionType::MaxGeneration`] condition and the history
+    /// export in [`NSGA2Arg::export_history`] behave as in [`Algorithm::run`]. No new individual
+    /// is submitted once the evaluations already in the queue are enough to meet
+    /// [`StoppingConditionType::MaxFunctionEvaluations`]; when the stopping condition is met, the
+    /// individuals being evaluated are still collected before the algorithm terminates.
+    ///
+    /// # Arguments
+    ///
+    /// * `options`: The options with the number of workers and the size of the queue.
+    ///
+    /// returns: `Result<(), OError>`
+    pub fn run_async(&mut self, options: AsyncEvaluationArgs) -> Result<(), OError> {
+        info!(
+            "Starting asynchronous {} with {} workers",
+            self.name(),
+            options.number_of_workers()
+        );
+
+        // individuals loaded from a file may already be evaluated
+        let (evaluated, mut pending): (Vec<Individual>, Vec<Individual>) = self
+            .population
+            .drain(..)
+            .into_iter()
+            .partition(|i| i.is_evaluated());
+        self.population.add_new_individuals(evaluated);
+        pending.reverse();
+
+        thread::scope(|scope| -> Result<(), OError> {
+            let mut pool = WorkerPool::new(scope, &options, NSGA2::evaluate_individual)?;
+            let mut initialised = false;
+            let mut stopped = false;
+            let mut history_gen_step: usize = 0;
+            let mut generation_evaluations: usize = 0;
+
+            loop {
+                if !initialised && self.population.len() >= self.number_of_individuals {
+                    self.steady_state_survival()?;
+                    info!("Initial evaluation completed");
+                    initialised = true;
+                    self.generation += 1;
+                    self.instrumentation.start_generation();
+                    self.save_history(Some("Init"))?;
+                }
+
+                // stop submitting new individuals when the stopping condition is met, or the
+                // scheduled evaluations will meet it
+                if initialised && !stopped {
+                    let cond = self.stopping_condition();
+                    if self.is_stopping_condition_met(cond)? {
+                        info!("Stopping evolution because the {} was reached", cond.name());
+                        stopped = true;
+                    }
+                }
+                // the initial population is always fully evaluated, as in `initialise`
+                let remaining = if initialised {
+                    self.stopping_condition()
+                        .remaining_evaluations(self.nfe)
+                        .unwrap_or(usize::MAX)
+                } else {
+                    usize::MAX
+                };
+                while !stopped && pool.has_capacity() && pool.in_flight() < remaining {
+                    if pending.is_empty() {
+                        // the tournament needs at least two evaluated individuals
+                        if self.population.len() < 2 {
+                            break;
+                        }
+                        let phase_start = Instant::now();
+                        let mut children = self.generate_offsprings()?;
+                        self.instrumentation
+                            .record(Phase::OffspringGeneration, phase_start);
+                        children.reverse();
+                        pending.extend(children);
+                    }
+                    pool.submit(pending.pop().unwrap())?;
+                }
+
+                if pool.in_flight() == 0 {
+                    if !initialised {
+                        return Err(OError::AlgorithmRun(
+                            self.name(),
+                            "The initial population cannot be evaluated".to_string(),
+                        ));
+                    }
+                    break;
+                }
+
+                // wait for the next individual and add it to the population
+                let wait_start = Instant::now();
+                let individual = pool.receive()?;
+                self.instrumentation.record_queue_wait(wait_start);
+                self.nfe += 1;
+                self.instrumentation.add_evaluations(1);
+                self.population.add_individual(individual);
+                if !initialised {
+                    // rank the partial population to breed new offsprings from it. The sorting
+                    // needs at least two individuals, as the tournament
+                    if self.population.len() >= 2 {
+                        non_dominated_sort_indexes(self.population.individuals_as_mut(), false)?;
+                        NSGA2::set_crowding_distance(self.population.individuals_as_mut())?;
+                    }
+                    continue;
+                }
+                self.steady_state_survival()?;
+
+                generation_evaluations += 1;
+                if generation_evaluations == self.number_of_individuals {
+                    generation_evaluations = 0;
+                    info!(
+                        "Evolved generation #{} - Elapsed Time: {}",
+                        self.generation,
+                        self.elapsed_as_string()
+                    );
+                    self.generation += 1;
+                    self.instrumentation.finish_generation(self.generation);
+                    self.instrumentation.start_generation();
+
+                    // export history
+                    if let Some(export) = self.export_history() {
+                        if history_gen_step == export.generation_step() - 1 {
+                            self.save_history(None)?;
+                            self.save_evaluation_cache()?;
+                            history_gen_step = 0;
+                        } else {
+                            history_gen_step += 1;
+                        }
+                    }
+                }
+            }
+            Ok(())
+        })?;
+
+        // save last file
+        self.save_history(Some("Final"))?;
+        if let Some(export) = self.export_history() {
+            export.finish()?;
+        }
+        self.save_evaluation_cache()?;
+        info!("Took {}", self.elapsed_as_string());
+        Ok(())
+    }
+
+    /// Apply the survival selection of the steady-state algorithm. When the population is larger
+    /// than `number_of_individuals`, this removes the individuals in the last front with the
+    /// smallest crowding distance. The ranks and crowding distances are then updated for the
+    /// tournament selector.
+    ///
+    /// returns: `Result<(), OError>`
+    fn steady_state_survival(&mut self) -> Result<(), OError> {
+        let phase_start = Instant::now();
+        let sorting_results =
+            non_dominated_sort_indexes(self.population.individuals_as_mut(), false)?;
+        self.instrumentation
+            .record(Phase::NonDominatedSorting, phase_start);
+
+        let phase_start = Instant::now();
+        if self.population.len() > self.number_of_individuals {
+            let mut excess = self.population.len() - self.number_of_individuals;
+            let mut fronts =
+                split_into_fronts(self.population.drain(..), &sorting_results.front_indexes);
+            while excess > 0 {
+                let last_front = fronts.last_mut().unwrap();
+                NSGA2::set_crowding_distance(last_front)?;
+                // removing individuals from the last front does not change the other ranks
+                let worst = last_front
+                    .iter()
+                    .enumerate()
+                    .min_by(|(_, i), (_, o)| {
+                        i.get_data(CROWDING_DIST_KEY)
+                            .unwrap()
+                            .as_real()
+                            .unwrap()
+                            .total_cmp(&o.get_data(CROWDING_DIST_KEY).unwrap().as_real().unwrap())
+                    })
+                    .map(|(idx, _)| idx)
+                    .unwrap();
+                last_front.remove(worst);
+                if last_front.is_empty() {
+                    fronts.pop();
+                }
+                excess -= 1;
+            }
+            self.population
+                .add_new_individuals(fronts.into_iter().flatten().collect());
+        }
+        NSGA2::set_crowding_distance(self.population.individuals_as_mut())?;
+        self.instrumentation
+            .record(Phase::CrowdingDistance, phase_start);
+        Ok(())
+    }
+
+    /// Replace the last individuals in the population with individuals evolved by another
+    /// algorithm, and update the ranks and crowding distances used by the selection operator.
+    /// After an evolution, the population is sorted by front, so the worst individuals are
+    /// replaced. This is used to migrate individuals in the [`crate::algorithms::IslandModel`].
+    ///
+    /// # Arguments
+    ///
+    /// * `migrants`: The evaluated individuals to add. These must belong to the problem of the
+    ///   algorithm.
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn add_migrants(&mut self, mut migrants: Vec<Individual>) -> Result<(), OError> {
+        migrants.truncate(self.population.len());
+        let keep = self.population.len() - migrants.len();
+        self.population.drain(keep..);
+        self.population.add_new_individuals(migrants);
+
+        non_dominated_sort_indexes(self.population.individuals_as_mut(), false)?;
+        NSGA2::set_crowding_distance(self.population.individuals_as_mut())?;
+        Ok(())
+    }
+
     /// Calculate the crowding distance (with complexity $O(M * log(N))$, where `M` is the number of
     /// objectives and `N` the number of individuals). This set the distance on the individual's data,
     /// to retrieve it, use `Individual::set_data("crowding_distance").unwrap()`.
@@ -206,7 +462,7 @@ impl NSGA2 {
     /// * `individuals`: The individuals in a non-dominated front.
     ///
     /// returns: `Result<(), OError>`
-    fn set_crowding_distance(mut individuals: &mut [Individual]) -> Result<(), OError> {
+    pub(crate) fn set_crowding_distance(individuals: &mut [Individual]) -> Result<(), OError> {
         let inf = DataValue::Real(f64::MAX); // do not use INF because is not supported by serde
         let total_individuals = individuals.len();
 
@@ -220,55 +476,78 @@ impl NSGA2 {
             return Ok(());
         }
 
-        for individual in individuals.iter_mut() {
-            individual.set_data(CROWDING_DIST_KEY, DataValue::Real(0.0));
-        }
-
-        let problem = individuals.individual(0)?.problem();
-        for obj_name in problem.objective_names() {
-            let mut obj_values = individuals.objective_values(&obj_name)?;
-            let delta_range = vector_max(&obj_values)? - vector_min(&obj_values)?;
+        // copy the objectives once in a row-major matrix, instead of collecting them by name
+        let number_of_objectives = individuals.individual(0)?.objective_values_slice().len();
+        let values: Vec<f64> = individuals
+            .iter()
+            .flat_map(|individual| individual.objective_values_slice().iter().copied())
+            .collect();
+        let distances = with_fixed_objectives!(
+            number_of_objectives,
+            |M| crowding_distances(&values, M),
+            crowding_distances(&values, number_of_objectives)
+        );
 
-            // set all to infinite if distance is too small
-            if delta_range.abs() < f64::EPSILON {
-                for individual in &mut *individuals {
+        match distances {
+            Some(distances) => {
+                for (individual, distance) in individuals.iter_mut().zip(distances) {
+                    individual.set_data(CROWDING_DIST_KEY, DataValue::Real(distance));
+                }
+            }
+            None => {
+                // set all to infinite if distance is too small
+                for individual in individuals {
                     individual.set_data(CROWDING_DIST_KEY, inf.clone());
                 }
                 debug!("Setting crowding distance to Inf for all individuals. The min/max range is too small");
-                return Ok(());
             }
+        }
 
-            // sort objectives and get indexes to map individuals to sorted objectives
-            let sorted_idx = argsort(&obj_values, Sort::Ascending);
-            obj_values.sort_by(|a, b| a.total_cmp(b));
-
-            // assign infinite distance to the boundary points
-            individuals
-                .individual_as_mut(sorted_idx[0])?
-                .set_data(CROWDING_DIST_KEY, inf.clone());
-            individuals
-                .individual_as_mut(sorted_idx[total_individuals - 1])?
-                .set_data(CROWDING_DIST_KEY, inf.clone());
-
-            for obj_i in 1..(total_individuals - 1) {
-                // get the corresponding individual to sorted objective
-                let ind_i = sorted_idx[obj_i];
-                let current_distance = individuals
-                    .individual(ind_i)?
-                    .get_data(CROWDING_DIST_KEY)
-                    .unwrap_or(DataValue::Real(0.0));
+        Ok(())
+    }
+}
 
-                if let DataValue::Real(current_distance) = current_distance {
-                    let delta = (obj_values[obj_i + 1] - obj_values[obj_i - 1]) / delta_range;
-                    individuals
-                        .individual_as_mut(ind_i)?
-                        .set_data(CROWDING_DIST_KEY, DataValue::Real(current_distance + delta));
-                }
-            }
+/// Calculate the crowding distance of the individuals (see [`NSGA2::set_crowding_distance`]).
+/// This is always inlined, so that the loops are specialised when the number of objectives is a
+/// constant.
+///
+/// # Arguments
+///
+/// * `values`: The objective values of the individuals stored in a row-major matrix.
+/// * `number_of_objectives`: The number of objectives.
+///
+/// returns: `Option<Vec<f64>>`. The distance of each individual or `None` if the min/max range of
+/// an objective is too small.
+#[inline(always)]
+fn crowding_distances(values: &[f64], number_of_objectives: usize) -> Option<Vec<f64>> {
+    let total_individuals = values.len() / number_of_objectives;
+    let last = total_individuals - 1;
+    let mut distances = vec![0.0; total_individuals];
+    let mut sorted_idx: Vec<usize> = Vec::with_capacity(total_individuals);
+
+    for obj_idx in 0..number_of_objectives {
+        let value = |ind_idx: usize| values[ind_idx * number_of_objectives + obj_idx];
+
+        // sort objectives and get indexes to map individuals to sorted objectives
+        sorted_idx.clear();
+        sorted_idx.extend(0..total_individuals);
+        sorted_idx.sort_by(|a, b| value(*a).total_cmp(&value(*b)));
+
+        let delta_range = value(sorted_idx[last]) - value(sorted_idx[0]);
+        if delta_range.abs() < f64::EPSILON {
+            return None;
         }
 
-        Ok(())
+        // assign infinite distance to the boundary points
+        distances[sorted_idx[0]] = f64::MAX;
+        distances[sorted_idx[last]] = f64::MAX;
+        for obj_i in 1..last {
+            let delta = (value(sorted_idx[obj_i + 1]) - value(sorted_idx[obj_i - 1])) / delta_range;
+            distances[sorted_idx[obj_i]] += delta;
+        }
     }
+
+    Some(distances)
 }
 
 /// Implementation of Section IIIC of the paper.
@@ -287,7 +566,7 @@ impl Algorithm<NSGA2Arg> for NSGA2 {
         }
 
         debug!("Calculating rank");
-        fast_non_dominated_sort(self.population.individuals_as_mut(), false)?;
+        non_dominated_sort_indexes(self.population.individuals_as_mut(), false)?;
 
         debug!("Calculating crowding distance");
         NSGA2::set_crowding_distance(self.population.individuals_as_mut())?;
@@ -299,47 +578,49 @@ impl Algorithm<NSGA2Arg> for NSGA2 {
     }
 
     fn evolve(&mut self) -> Result<(), OError> {
+        self.instrumentation.start_generation();
+
         // Create the new population, based on the population at the previous time-step, of size
-        // self.number_of_individuals. The loop adds two individuals at the time.
+        // self.number_of_individuals. The offsprings are generated in parallel chunks, each with
+        // its own random number generator stream, when `parallel` is enabled.
         debug!("Generating new population (selection + crossover + mutation)");
-        let mut offsprings: Vec<Individual> = Vec::new();
-        for _ in 0..self.number_of_individuals / 2 {
-            let parents =
-                self.selector_operator
-                    .select(self.population.individuals(), 2, &mut self.rng)?;
-
-            // generate the 2 children with crossover
-            let children = self.crossover_operator.generate_offsprings(
-                &parents[0],
-                &parents[1],
-                &mut self.rng,
-            )?;
-
-            // mutate them
-            offsprings.push(
-                self.mutation_operator
-                    .mutate_offspring(&children.child1, &mut self.rng)?,
-            );
-            offsprings.push(
-                self.mutation_operator
-                    .mutate_offspring(&children.child2, &mut self.rng)?,
-            );
-        }
+        let phase_start = Instant::now();
+        let offsprings = generate_offsprings(
+            self.population.individuals(),
+            self.number_of_individuals,
+            &self.selector_operator,
+            &self.crossover_operator,
+            &self.mutation_operator,
+            &mut self.rng,
+            self.parallel,
+        )?;
         debug!("Combining parents and offsprings in new population");
         self.population.add_new_individuals(offsprings);
         debug!("New population size is {}", self.population.len());
+        self.instrumentation
+            .record(Phase::OffspringGeneration, phase_start);
 
         debug!("Evaluating population");
+        let phase_start = Instant::now();
+        let nfe = self.nfe;
         if self.parallel {
             NSGA2::do_parallel_evaluation(self.population.individuals_as_mut(), &mut self.nfe)?;
         } else {
             NSGA2::do_evaluation(self.population.individuals_as_mut(), &mut self.nfe)?;
         }
+        self.instrumentation.record(Phase::Evaluation, phase_start);
+        self.instrumentation.add_evaluations(self.nfe - nfe);
         debug!("Evaluation done");
 
         debug!("Calculating fronts and ranks for new population");
-        let sorting_results = fast_non_dominated_sort(self.population.individuals_as_mut(), false)?;
-        debug!("Collected {} fronts", sorting_results.fronts.len());
+        let phase_start = Instant::now();
+        let sorting_results =
+            non_dominated_sort_indexes(self.population.individuals_as_mut(), false)?;
+        debug!("Collected {} fronts", sorting_results.front_indexes.len());
+        // move the individuals into their fronts
+        let fronts = split_into_fronts(self.population.drain(..), &sorting_results.front_indexes);
+        self.instrumentation
+            .record(Phase::NonDominatedSorting, phase_start);
 
         debug!("Selecting best individuals");
         let mut new_population = Population::new();
@@ -352,7 +633,7 @@ impl Algorithm<NSGA2Arg> for NSGA2 {
         //
         // This implements the algorithm at the bottom of page 186 in Deb et al. (2002).
         let mut last_front: Option<Vec<Individual>> = None;
-        for (fi, front) in sorting_results.fronts.into_iter().enumerate() {
+        for (fi, front) in fronts.into_iter().enumerate() {
             if new_population.len() + front.len() <= self.number_of_individuals {
                 debug!("Adding front #{} (size: {})", fi + 1, front.len());
                 new_population.add_new_individuals(front);
@@ -364,12 +645,13 @@ impl Algorithm<NSGA2Arg> for NSGA2 {
                     "Population almost full ({} individuals)",
                     new_population.len()
                 );
-                last_front = Some(front.clone());
+                last_front = Some(front);
                 break;
             }
         }
 
         // Complete the population with the last front
+        let phase_start = Instant::now();
         if let Some(mut last_front) = last_front {
             NSGA2::set_crowding_distance(&mut last_front)?;
 
@@ -393,8 +675,11 @@ impl Algorithm<NSGA2Arg> for NSGA2 {
         // loop
         self.population = new_population;
         NSGA2::set_crowding_distance(self.population.individuals_as_mut())?;
+        self.instrumentation
+            .record(Phase::CrowdingDistance, phase_start);
 
         self.generation += 1;
+        self.instrumentation.finish_generation(self.generation);
         Ok(())
     }
 }
@@ -646,8 +931,10 @@ mod test_sorting {
 mod test_problems {
     use optirustic_macros::test_with_retries;
 
+    use crate::algorithms::nsga2::CROWDING_DIST_KEY;
     use crate::algorithms::{
-        Algorithm, MaxGenerationValue, NSGA2Arg, StoppingConditionType, NSGA2,
+        Algorithm, AsyncEvaluationArgs, MaxFunctionEvaluationValue, MaxGenerationValue, NSGA2Arg,
+        StoppingConditionType, NSGA2,
     };
     use crate::core::builtin_problems::{
         SCHProblem, ZTD1Problem, ZTD2Problem, ZTD3Problem, ZTD4Problem,
@@ -683,6 +970,48 @@ mod test_problems {
         }
     }
 
+    #[test_with_retries(10)]
+    /// Test problem 1 from Deb et al. (2002) with the steady-state algorithm. The algorithm must
+    /// stop at the exact number of function evaluations.
+    fn test_sch_problem_async() {
+        let problem = SCHProblem::create().unwrap();
+        let args = NSGA2Arg {
+            number_of_individuals: 10,
+            stopping_condition: StoppingConditionType::MaxFunctionEvaluations(
+                MaxFunctionEvaluationValue(2000),
+            ),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            parallel: None,
+            export_history: None,
+            resume_from_file: None,
+            seed: Some(10),
+        };
+        let mut algo = NSGA2::new(problem, args).unwrap();
+        algo.run_async(AsyncEvaluationArgs {
+            number_of_workers: Some(4),
+            queue_size: Some(1),
+        })
+        .unwrap();
+        let results = algo.get_results();
+
+        assert_eq!(results.number_of_function_evaluations, 2000);
+        assert_eq!(results.individuals.len(), 10);
+        assert_eq!(results.generation, 200);
+        assert!(results.individuals.iter().all(|i| i.is_evaluated()));
+        // the final population is fully ranked
+        assert!(results
+            .individuals
+            .iter()
+            .all(|i| i.get_data("rank").is_ok() && i.get_data(CROWDING_DIST_KEY).is_ok()));
+
+        let bounds = -0.1..2.1;
+        let invalid_x = check_value_in_range(&results.get_real_variables("x").unwrap(), &bounds);
+        if !invalid_x.is_empty() {
+            panic!("Some variables are outside the bounds: {:?}", invalid_x);
+        }
+    }
+
     #[test_with_retries(10)]
     /// Test the ZTD1 problem from Deb et al. (2002) with 30 variables. Solution x1 in [0; 1] and
     /// x2 to x30 = 0. The exact solutions are tested using a strict and loose bounds.
@@ -1,11 +1,14 @@
 use log::debug;
+use nalgebra::DMatrix;
+use rayon::prelude::*;
 
-use crate::algorithms::nsga3::{
-    MIN_DISTANCE, NORMALISED_OBJECTIVE_KEY, REF_POINT, REF_POINT_INDEX,
-};
+use crate::algorithms::nsga3::{MIN_DISTANCE, NORMALISED_OBJECTIVE_KEY, REF_POINT_INDEX};
 use crate::algorithms::NSGA3;
 use crate::core::{DataValue, Individual, OError};
-use crate::utils::{argmin, perpendicular_distance};
+
+/// The number of individuals whose objectives are projected onto the reference directions with
+/// one matrix product.
+const TILE_SIZE: usize = 256;
 
 /// This implements "Algorithm 3" in the paper which associates each individual's normalised
 /// objectives to a reference point.
@@ -42,39 +45,98 @@ impl<'a> AssociateToRefPoint<'a> {
     }
 
     /// Associate the individuals to a reference point. If an association is found, this function
-    /// stores the distance, the reference point coordinates and reference point index of
-    /// [`self.reference_points`] in the individual's data.
+    /// stores the distance and the reference point index of [`self.reference_points`] in the
+    /// individual's data.
+    ///
+    /// The perpendicular distance between a point `p` and the reference direction with unit
+    /// vector `u` is `sqrt(|p|^2 - (p · u)^2)`. The unit vectors are calculated once and the
+    /// projections `p · u` of a tile of individuals onto all the directions are calculated with
+    /// one matrix product. The tiles are processed in parallel and only the index of the closest
+    /// reference point is kept for each individual.
     ///
-    /// return `Result<(), OError>`
-    pub fn calculate(&mut self) -> Result<(), OError> {
+    /// return `Result<Vec<usize>, OError>`. The index of the reference point associated to each
+    /// individual.
+    pub fn calculate(&mut self) -> Result<Vec<usize>, OError> {
         // steps 1-3 are skipped because `reference_points` are already normalised
+        let number_of_objectives = match self.reference_points.first() {
+            Some(point) => point.len(),
+            None => {
+                return Err(OError::AlgorithmRun(
+                    "NSGA3-AssociateToRefPoint".to_string(),
+                    "There are no reference points to associate the individuals to".to_string(),
+                ))
+            }
+        };
+
+        // unit reference directions stored by row
+        let mut directions = Vec::with_capacity(self.reference_points.len() * number_of_objectives);
+        for point in self.reference_points {
+            if point.len() != number_of_objectives {
+                return Err(Self::size_error(point.len(), number_of_objectives));
+            }
+            let magnitude = point.iter().map(|v| v * v).sum::<f64>().sqrt();
+            directions.extend(point.iter().map(|v| v / magnitude));
+        }
+        let directions = DMatrix::from_row_slice(
+            self.reference_points.len(),
+            number_of_objectives,
+            &directions,
+        );
 
-        // step 4-7
-        for ind in self.individuals.iter_mut() {
-            // fetch the data
+        // normalised objectives stored by individual
+        let mut points = Vec::with_capacity(self.individuals.len() * number_of_objectives);
+        for ind in self.individuals.iter() {
             let data = NSGA3::get_normalised_objectives(ind)?;
             let obj_values = data.as_f64_vec()?;
-            // calculate the distances for all reference points
-            let d_per = self
-                .reference_points
-                .iter()
-                .map(|ref_point| {
-                    perpendicular_distance(ref_point, obj_values).map_err(|e| {
-                        OError::AlgorithmRun(
-                            "NSGA3-AssociateToRefPoint".to_string(),
-                            format!("Cannot calculate vector distance because: {}", e),
-                        )
+            if obj_values.len() != number_of_objectives {
+                return Err(Self::size_error(obj_values.len(), number_of_objectives));
+            }
+            points.extend(obj_values);
+        }
+
+        // step 4-8 - get the reference point with the lowest perpendicular distance
+        let closest: Vec<(usize, f64)> = points
+            .par_chunks(TILE_SIZE * number_of_objectives)
+            .flat_map_iter(|tile| {
+                let tile = DMatrix::from_column_slice(
+                    number_of_objectives,
+                    tile.len() / number_of_objectives,
+                    tile,
+                );
+                // each column contains the projections of an individual onto all the directions
+                let projections = &directions * &tile;
+                tile.column_iter()
+                    .zip(projections.column_iter())
+                    .map(|(point, projections)| {
+                        // |p|² - (p·u)² is cheap to pick the closest direction, but it loses
+                        // precision near the direction. The distance of the chosen direction is
+                        // calculated again as |p - (p·u)u|
+                        let squared_magnitude = point.norm_squared();
+                        let mut min_index = 0;
+                        let mut min_value = f64::INFINITY;
+                        for (ri, projection) in projections.iter().enumerate() {
+                            let squared_distance = squared_magnitude - projection * projection;
+                            if squared_distance < min_value {
+                                min_value = squared_distance;
+                                min_index = ri;
+                            }
+                        }
+                        let projection = projections[min_index];
+                        let distance = point
+                            .iter()
+                            .zip(directions.row(min_index).iter())
+                            .map(|(p, u)| (p - projection * u).powi(2))
+                            .sum::<f64>()
+                            .sqrt();
+                        (min_index, distance)
                     })
-                })
-                .collect::<Result<Vec<f64>, OError>>()?;
+                    .collect::<Vec<(usize, f64)>>()
+            })
+            .collect();
 
-            // step 8 - get the reference point with the lowest minimum distance
-            let (ri, min_d) = argmin(&d_per);
+        let mut reference_point_indexes = Vec::with_capacity(closest.len());
+        for (ind, (ri, min_d)) in self.individuals.iter_mut().zip(closest) {
             ind.set_data(MIN_DISTANCE, DataValue::Real(min_d));
-            ind.set_data(
-                REF_POINT,
-                DataValue::Vector(self.reference_points[ri].clone()),
-            );
             ind.set_data(REF_POINT_INDEX, DataValue::USize(ri));
             debug!(
                 "Associated objective point {:?} to reference point #{} {:?} - distance = {}",
@@ -83,9 +145,27 @@ impl<'a> AssociateToRefPoint<'a> {
                 self.reference_points[ri],
                 min_d
             );
+            reference_point_indexes.push(ri);
         }
 
-        Ok(())
+        Ok(reference_point_indexes)
+    }
+
+    /// The error returned when the size of a point does not match the number of objectives.
+    ///
+    /// # Arguments
+    ///
+    /// * `size`: The size of the point.
+    /// * `number_of_objectives`: The number of objectives.
+    ///
+    /// returns: `OError`
+    fn size_error(size: usize, number_of_objectives: usize) -> OError {
+        OError::AlgorithmRun(
+            "NSGA3-AssociateToRefPoint".to_string(),
+            format!(
+                "Cannot calculate vector distance because the point has {size} coordinates, but {number_of_objectives} are expected"
+            ),
+        )
     }
 
     /// Check that the values in a reference point are between 0 and 1 (i.e. all the values have
@@ -118,8 +198,7 @@ mod test {
     use float_cmp::{approx_eq, assert_approx_eq};
 
     use crate::algorithms::nsga3::{
-        AssociateToRefPoint, Normalise, MIN_DISTANCE, NORMALISED_OBJECTIVE_KEY, REF_POINT,
-        REF_POINT_INDEX,
+        AssociateToRefPoint, Normalise, MIN_DISTANCE, NORMALISED_OBJECTIVE_KEY, REF_POINT_INDEX,
     };
     use crate::core::test_utils::{
         assert_approx_array_eq, individuals_from_obj_values_dummy, read_csv_test_file,
@@ -151,15 +230,18 @@ mod test {
         );
 
         let mut ass = AssociateToRefPoint::new(&mut individuals, &ref_points).unwrap();
-        ass.calculate().unwrap();
+        let reference_point_indexes = ass.calculate().unwrap();
+        for (ind, ri) in individuals.iter().zip(reference_point_indexes) {
+            assert_eq!(ind.get_data(REF_POINT_INDEX).unwrap(), DataValue::USize(ri));
+        }
 
         // 1st individual
         assert_approx_array_eq(
-            individuals[0]
-                .get_data(REF_POINT)
+            &ref_points[individuals[0]
+                .get_data(REF_POINT_INDEX)
                 .unwrap()
-                .as_f64_vec()
-                .unwrap(),
+                .as_usize()
+                .unwrap()],
             &[1.0, 0.0, 0.0],
             None,
         );
@@ -176,11 +258,11 @@ mod test {
 
         // 2nd individual
         assert_approx_array_eq(
-            individuals[1]
-                .get_data(REF_POINT)
+            &ref_points[individuals[1]
+                .get_data(REF_POINT_INDEX)
                 .unwrap()
-                .as_f64_vec()
-                .unwrap(),
+                .as_usize()
+                .unwrap()],
             &[0.0, 1.0, 0.0],
             None,
         );
@@ -196,6 +278,34 @@ mod test {
         );
     }
 
+    #[test]
+    /// The distance of a point very close to a reference direction is not affected by the
+    /// cancellation in |p|² - (p·u)².
+    fn test_distance_near_reference_direction() {
+        let das_darren = DasDarren1998::new(3, &NumberOfPartitions::OneLayer(4)).unwrap();
+        let ref_points = das_darren.get_weights();
+
+        let mut individuals = individuals_from_obj_values_dummy(
+            &[vec![0.0, 0.0]],
+            &[ObjectiveDirection::Minimise, ObjectiveDirection::Minimise],
+            None,
+        );
+        individuals[0].set_data(
+            NORMALISED_OBJECTIVE_KEY,
+            DataValue::Vector(vec![0.7, 0.7 + 1e-9, 0.0]),
+        );
+
+        let mut ass = AssociateToRefPoint::new(&mut individuals, &ref_points).unwrap();
+        let ri = ass.calculate().unwrap()[0];
+        assert_approx_array_eq(&ref_points[ri], &[0.5, 0.5, 0.0], None);
+        let distance = individuals[0]
+            .get_data(MIN_DISTANCE)
+            .unwrap()
+            .as_real()
+            .unwrap();
+        assert!((distance - 1e-9 / 2.0_f64.sqrt()).abs() < 1e-14);
+    }
+
     #[test]
     /// Test association with DTLZ1 problem from randomly-generated objectives.
     fn test_dtlz1_problem() {
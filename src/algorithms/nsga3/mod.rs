@@ -11,19 +11,22 @@ use crate::algorithms::nsga3::adaptive_ref_points::AdaptiveReferencePoints;
 use crate::algorithms::nsga3::associate::AssociateToRefPoint;
 use crate::algorithms::nsga3::niching::Niching;
 use crate::algorithms::nsga3::normalise::Normalise;
-use crate::algorithms::{Algorithm, NSGA2};
+use crate::algorithms::reproduction::generate_offsprings;
+use crate::algorithms::{Algorithm, Phase, NSGA2};
 use crate::core::utils::get_rng;
 use crate::core::{DataValue, Individual, OError};
 use crate::operators::{
-    Crossover, Mutation, ParetoConstrainedDominance, PolynomialMutation, PolynomialMutationArgs,
-    Selector, SimulatedBinaryCrossover, SimulatedBinaryCrossoverArgs, TournamentSelector,
+    ParetoConstrainedDominance, PolynomialMutation, PolynomialMutationArgs,
+    SimulatedBinaryCrossover, SimulatedBinaryCrossoverArgs, TournamentSelector,
+};
+use crate::utils::{
+    non_dominated_sort_indexes, split_into_fronts, DasDarren1998, NumberOfPartitions,
 };
-use crate::utils::{fast_non_dominated_sort, DasDarren1998, NumberOfPartitions};
 
 mod adaptive_ref_points;
-mod associate;
-mod niching;
-mod normalise;
+pub(crate) mod associate;
+pub(crate) mod niching;
+pub(crate) mod normalise;
 
 /// The data key where the normalised objectives are stored for each [`Individual`].
 const NORMALISED_OBJECTIVE_KEY: &str = "normalised_objectives";
@@ -31,10 +34,8 @@ const NORMALISED_OBJECTIVE_KEY: &str = "normalised_objectives";
 /// The data key where the perpendicular distance to a reference point is stored for each [`Individual`].
 const MIN_DISTANCE: &str = "distance";
 
-/// The data key where the reference point with [`MIN_DISTANCE`] is stored for each [`Individual`].
-const REF_POINT: &str = "reference_point";
-
-/// The data key where the reference point index for [`REF_POINT`] is stored.
+/// The data key where the index of the reference point with [`MIN_DISTANCE`] is stored for each
+/// [`Individual`].
 const REF_POINT_INDEX: &str = "reference_point_index";
 
 /// The type for the number of individuals in the population.
@@ -109,7 +110,7 @@ pub struct NSGA3 {
     /// The PM operator to use to mutate the variables of an individual.
     mutation_operator: PolynomialMutation,
     /// The seed to use.
-    rng: Box<dyn RngCore>,
+    rng: Box<dyn RngCore + Send>,
     /// Whether to use the reference point adaptive approach and convert the algorithm from `NSGA3`
     /// to `A-NSGA3`.
     adaptive: bool,
@@ -234,6 +235,7 @@ impl NSGA3 {
             rng: get_rng(options.seed),
             args: nsga3_args,
             adaptive,
+            instrumentation: Instrumentation::default(),
         })
     }
 
@@ -254,32 +256,41 @@ impl NSGA3 {
     ///
     /// # Arguments
     ///
-    /// * `selected_individuals`: The individuals to use to count the association to the reference
-    ///    points.
-    /// * `reference_points`: The reference points.
+    /// * `reference_point_indexes`: The index of the reference point associated to each selected
+    ///    individual.
+    /// * `number_of_reference_points`: The number of reference points.
     ///
-    /// returns: `Result<HashMap<usize, usize>, OError>`
-    fn get_association_map(
-        selected_individuals: &Population,
-        reference_points: &[Vec<f64>],
-    ) -> Result<HashMap<usize, usize>, OError> {
-        let mut rho_j: HashMap<usize, usize> = HashMap::new();
-        for ind in selected_individuals.individuals() {
-            let ref_point_index = ind.get_data(REF_POINT_INDEX);
-            match ref_point_index {
-                Ok(index) => {
-                    let index = index.as_usize()?;
-                    rho_j.entry(index).and_modify(|v| *v += 1).or_insert(1);
-                }
-                Err(_) => continue,
-            }
-        }
-        // fill the rest
-        for ref_point_index in 0..reference_points.len() {
-            rho_j.entry(ref_point_index).or_insert(0);
+    /// returns: `HashMap<usize, usize>`
+    pub(crate) fn get_association_map(
+        reference_point_indexes: &[usize],
+        number_of_reference_points: usize,
+    ) -> HashMap<usize, usize> {
+        let mut rho_j: HashMap<usize, usize> = (0..number_of_reference_points)
+            .map(|ref_point_index| (ref_point_index, 0))
+            .collect();
+        for index in reference_point_indexes {
+            *rho_j.entry(*index).or_insert(0) += 1;
         }
+        rho_j
+    }
 
-        Ok(rho_j)
+    /// Replace the last individuals in the population with individuals evolved by another
+    /// algorithm. After an evolution, the population is sorted by front, so the worst individuals
+    /// are replaced. This is used to migrate individuals in the
+    /// [`crate::algorithms::IslandModel`].
+    ///
+    /// # Arguments
+    ///
+    /// * `migrants`: The evaluated individuals to add. These must belong to the problem of the
+    ///   algorithm.
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn add_migrants(&mut self, mut migrants: Vec<Individual>) -> Result<(), OError> {
+        migrants.truncate(self.population.len());
+        let keep = self.population.len() - migrants.len();
+        self.population.drain(keep..);
+        self.population.add_new_individuals(migrants);
+        Ok(())
     }
 
     /// Get the reference points used in the evolution.
@@ -313,47 +324,49 @@ impl Algorithm<NSGA3Arg> for NSGA3 {
     /// Evolve the population. The first part of this code comes from NSGA2::evolve(). NSGA3 mainly
     /// differs in the survival method.
     fn evolve(&mut self) -> Result<(), OError> {
+        self.instrumentation.start_generation();
+
         // Create the new population, based on the population at the previous time-step, of size
-        // self.number_of_individuals. The loop adds two individuals at the time.
+        // self.number_of_individuals. The offsprings are generated in parallel chunks, each with
+        // its own random number generator stream, when `parallel` is enabled.
         debug!("Generating new population (selection + crossover + mutation)");
-        let mut offsprings: Vec<Individual> = Vec::new();
-        for _ in 0..self.number_of_individuals / 2 {
-            let parents =
-                self.selector_operator
-                    .select(self.population.individuals(), 2, &mut self.rng)?;
-
-            // generate the 2 children with crossover
-            let children = self.crossover_operator.generate_offsprings(
-                &parents[0],
-                &parents[1],
-                &mut self.rng,
-            )?;
-
-            // mutate them
-            offsprings.push(
-                self.mutation_operator
-                    .mutate_offspring(&children.child1, &mut self.rng)?,
-            );
-            offsprings.push(
-                self.mutation_operator
-                    .mutate_offspring(&children.child2, &mut self.rng)?,
-            );
-        }
+        let phase_start = Instant::now();
+        let offsprings = generate_offsprings(
+            self.population.individuals(),
+            self.number_of_individuals,
+            &self.selector_operator,
+            &self.crossover_operator,
+            &self.mutation_operator,
+            &mut self.rng,
+            self.parallel,
+        )?;
         debug!("Combining parents and offsprings in new population");
         self.population.add_new_individuals(offsprings);
         debug!("New population size is {}", self.population.len());
+        self.instrumentation
+            .record(Phase::OffspringGeneration, phase_start);
 
         debug!("Evaluating population");
+        let phase_start = Instant::now();
+        let nfe = self.nfe;
         if self.parallel {
             NSGA3::do_parallel_evaluation(self.population.individuals_as_mut(), &mut self.nfe)?;
         } else {
             NSGA3::do_evaluation(self.population.individuals_as_mut(), &mut self.nfe)?;
         }
+        self.instrumentation.record(Phase::Evaluation, phase_start);
+        self.instrumentation.add_evaluations(self.nfe - nfe);
         debug!("Evaluation done");
 
         debug!("Calculating fronts and ranks for new population");
-        let sorting_results = fast_non_dominated_sort(self.population.individuals_as_mut(), false)?;
-        debug!("Collected {} fronts", sorting_results.fronts.len());
+        let phase_start = Instant::now();
+        let sorting_results =
+            non_dominated_sort_indexes(self.population.individuals_as_mut(), false)?;
+        debug!("Collected {} fronts", sorting_results.front_indexes.len());
+        // move the individuals into their fronts
+        let fronts = split_into_fronts(self.population.drain(..), &sorting_results.front_indexes);
+        self.instrumentation
+            .record(Phase::NonDominatedSorting, phase_start);
 
         debug!("Selecting best individuals");
         // this is S_t in the paper, the population with the last front
@@ -361,7 +374,7 @@ impl Algorithm<NSGA3Arg> for NSGA3 {
 
         // Algorithm 1 in paper, step 5-7 - Fill the new population up to the last front.
         let mut last_front: Option<Vec<Individual>> = None;
-        for (fi, front) in sorting_results.fronts.into_iter().enumerate() {
+        for (fi, front) in fronts.into_iter().enumerate() {
             if new_population.len() + front.len() <= self.number_of_individuals {
                 // population does not overflow with new front
                 debug!("Adding front #{} (size: {})", fi + 1, front.len());
@@ -393,17 +406,22 @@ impl Algorithm<NSGA3Arg> for NSGA3 {
 
             // Algorithm 1, step 14 - Calculate f_n
             debug!("Normalising all individuals");
+            let phase_start = Instant::now();
             let mut norm =
                 Normalise::new(&mut self.ideal_point, new_population.individuals_as_mut())?;
             norm.calculate()?;
+            self.instrumentation
+                .record(Phase::Normalisation, phase_start);
 
             // Algorithm 1, step 15
             debug!("Associating reference points to all individuals");
+            let phase_start = Instant::now();
             let mut assoc = AssociateToRefPoint::new(
                 new_population.individuals_as_mut(),
                 &self.reference_points,
             )?;
-            assoc.calculate()?;
+            let reference_point_indexes = assoc.calculate()?;
+            self.instrumentation.record(Phase::Association, phase_start);
 
             // Algorithm 1, step 16
             // re-split population in P_{t+1} (S_t without the last front) and individuals in front F_l
@@ -414,11 +432,14 @@ impl Algorithm<NSGA3Arg> for NSGA3 {
             // for each reference point count selected individuals in P_{t+1} associated with it.
             // rho_j is a lookup map mapping the reference point index to the number of linked
             // individuals
-            let mut rho_j =
-                NSGA3::get_association_map(&selected_individuals, &self.reference_points)?;
+            let mut rho_j = NSGA3::get_association_map(
+                &reference_point_indexes[..first_dom_index],
+                self.reference_points.len(),
+            );
 
             // Algorithm 4 - Niching
             debug!("Niching");
+            let phase_start = Instant::now();
             let mut n = Niching::new(
                 &mut selected_individuals,
                 &mut potential_individuals,
@@ -427,12 +448,14 @@ impl Algorithm<NSGA3Arg> for NSGA3 {
                 &mut self.rng,
             )?;
             n.calculate()?;
+            self.instrumentation.record(Phase::Niching, phase_start);
 
             // update the population
             self.population = selected_individuals;
 
             // add new refernece points
             if self.adaptive {
+                let phase_start = Instant::now();
                 let mut a = AdaptiveReferencePoints::new(
                     &mut self.reference_points,
                     &mut rho_j,
@@ -440,6 +463,8 @@ impl Algorithm<NSGA3Arg> for NSGA3 {
                     self.ref_point_gap,
                 )?;
                 a.calculate()?;
+                self.instrumentation
+                    .record(Phase::ReferencePointUpdate, phase_start);
             }
         } else {
             // update the population
@@ -447,6 +472,7 @@ impl Algorithm<NSGA3Arg> for NSGA3 {
         }
 
         self.generation += 1;
+        self.instrumentation.finish_generation(self.generation);
         Ok(())
     }
 
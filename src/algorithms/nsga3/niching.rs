@@ -4,9 +4,7 @@ use log::debug;
 use rand::prelude::SliceRandom;
 use rand::RngCore;
 
-use crate::algorithms::nsga3::{
-    MIN_DISTANCE, NORMALISED_OBJECTIVE_KEY, REF_POINT, REF_POINT_INDEX,
-};
+use crate::algorithms::nsga3::{MIN_DISTANCE, NORMALISED_OBJECTIVE_KEY, REF_POINT_INDEX};
 use crate::core::{DataValue, Individual, OError, Population};
 use crate::utils::{argmin_by, index_of};
 
@@ -25,7 +23,7 @@ pub(crate) struct Niching<'a> {
     /// [`self.selected_individuals`]
     rho_j: &'a mut HashMap<usize, usize>,
     /// The random number generator
-    rng: &'a mut Box<dyn RngCore>,
+    rng: &'a mut Box<dyn RngCore + Send>,
 }
 
 impl<'a> Niching<'a> {
@@ -48,7 +46,7 @@ impl<'a> Niching<'a> {
         potential_individuals: &'a mut Vec<Individual>,
         number_of_individuals_to_add: usize,
         rho_j: &'a mut HashMap<usize, usize>,
-        rng: &'a mut Box<dyn RngCore>,
+        rng: &'a mut Box<dyn RngCore + Send>,
     ) -> Result<Self, OError> {
         let name = "NSGA3-Niching".to_string();
         if rho_j.is_empty() {
@@ -177,9 +175,8 @@ impl<'a> Niching<'a> {
                     Some(index) => {
                         let ind = self.potential_individuals.remove(index);
                         debug!(
-                            "Added individual #{index} {:?} to population ({method}) - reference point #{j_hat} {:?}",
+                            "Added individual #{index} {:?} to population ({method}) - reference point #{j_hat}",
                             ind.get_data(NORMALISED_OBJECTIVE_KEY)?,
-                            ind.get_data(REF_POINT),
                         );
                         self.selected_individuals.add_individual(ind);
 
@@ -0,0 +1,332 @@
+use std::collections::HashMap;
+use std::fs;
+use std::fs::read_dir;
+use std::path::{Path, PathBuf};
+
+use chrono::{DateTime, Utc};
+use rayon::prelude::*;
+use serde::Deserialize;
+
+use crate::algorithms::history::{is_history_file, HistoryColumns, HistoryReader};
+use crate::core::{OError, Objective, ObjectiveDirection};
+
+/// The objective values of the individuals exported at a generation, stored in a flat row-major
+/// matrix. This is much lighter than [`crate::algorithms::AlgorithmSerialisedExport`] when only
+/// the objectives are needed, for example to track the convergence of an algorithm with the
+/// hyper-volume.
+#[derive(Debug, Clone)]
+pub struct GenerationObjectives {
+    /// The algorithm name.
+    pub algorithm: String,
+    /// The generation the export was collected at.
+    pub generation: usize,
+    /// The number of function evaluations.
+    pub number_of_function_evaluations: usize,
+    /// The date and time when the data was exported.
+    pub exported_on: DateTime<Utc>,
+    /// The objective names in the same order as the matrix columns.
+    pub objective_names: Vec<String>,
+    /// The objective directions in the same order as the matrix columns.
+    pub directions: Vec<ObjectiveDirection>,
+    /// The objective values. The values of the `i`-th individual are stored from `i * m` to
+    /// `(i + 1) * m` (excluded), where `m` is the number of objectives. As for
+    /// [`crate::core::Individual`], maximised objectives are stored with the opposite sign so
+    /// that all objectives are minimised.
+    pub values: Vec<f64>,
+}
+
+impl GenerationObjectives {
+    /// Get the number of objectives (i.e. the number of columns in the matrix).
+    ///
+    /// returns: `usize`
+    pub fn number_of_objectives(&self) -> usize {
+        self.objective_names.len()
+    }
+
+    /// Get the number of individuals (i.e. the number of rows in the matrix).
+    ///
+    /// returns: `usize`
+    pub fn number_of_individuals(&self) -> usize {
+        match self.number_of_objectives() {
+            0 => 0,
+            n => self.values.len() / n,
+        }
+    }
+
+    /// Get the objective values of an individual.
+    ///
+    /// # Arguments
+    ///
+    /// * `index`: The individual index.
+    ///
+    /// returns: `&[f64]`
+    pub fn individual(&self, index: usize) -> &[f64] {
+        let n = self.number_of_objectives();
+        &self.values[index * n..(index + 1) * n]
+    }
+}
+
+/// The fields of a JSON export needed to collect the objectives. The other fields (such as the
+/// variable values, constraints and individual's data) are skipped by the parser without being
+/// allocated.
+#[derive(Deserialize)]
+struct ObjectivesOnlyExport {
+    problem: ObjectivesOnlyProblem,
+    individuals: Vec<ObjectivesOnlyIndividual>,
+    generation: usize,
+    #[serde(default)]
+    number_of_function_evaluations: usize,
+    algorithm: String,
+    exported_on: DateTime<Utc>,
+}
+
+#[derive(Deserialize)]
+struct ObjectivesOnlyProblem {
+    objectives: HashMap<String, Objective>,
+    objective_names: Vec<String>,
+}
+
+#[derive(Deserialize)]
+struct ObjectivesOnlyIndividual {
+    objective_values: HashMap<String, f64>,
+}
+
+/// Get the files, in name order, exported in a folder with the algorithm history. These are the
+/// JSON files and the binary history files.
+///
+/// # Arguments
+///
+/// * `folder`: The folder with the exported files.
+///
+/// returns: `Result<Vec<PathBuf>, OError>`
+pub(crate) fn export_files(folder: &PathBuf) -> Result<Vec<PathBuf>, OError> {
+    let mut files: Vec<PathBuf> = read_dir(folder)
+        .map_err(|e| OError::Generic(format!("Cannot read folder because {e}")))?
+        .filter_map(|res| res.ok())
+        .map(|dir_entry| dir_entry.path())
+        .filter(|path| path.extension().map_or(false, |ext| ext == "json") || is_history_file(path))
+        .collect();
+    files.sort();
+    Ok(files)
+}
+
+/// Read the objective values from a JSON file exported with
+/// [`crate::algorithms::Algorithm::save_to_json`] or from a binary history file. Only the
+/// objectives are parsed from the file.
+///
+/// # Arguments
+///
+/// * `file`: The path to the file.
+///
+/// returns: `Result<Vec<GenerationObjectives>, OError>`. One item for a JSON file and one item
+/// for each generation stored in a binary history file.
+pub(crate) fn read_objectives_file(file: &Path) -> Result<Vec<GenerationObjectives>, OError> {
+    if is_history_file(file) {
+        let mut reader = HistoryReader::open(file)?;
+        let directions = reader.header().objective_directions()?;
+        let blocks = reader.read_blocks(HistoryColumns::OBJECTIVES)?;
+        let header = reader.header();
+        let names = &header.problem.objective_names;
+        let data = blocks
+            .into_iter()
+            .map(|block| GenerationObjectives {
+                algorithm: header.algorithm.clone(),
+                generation: block.metadata.generation,
+                number_of_function_evaluations: block.metadata.number_of_function_evaluations,
+                exported_on: block.metadata.exported_on,
+                objective_names: names.clone(),
+                directions: directions.clone(),
+                values: block.objectives,
+            })
+            .collect();
+        return Ok(data);
+    }
+
+    // read the whole file at once, which is much faster than parsing from the file stream
+    let content = fs::read(file).map_err(|e| {
+        OError::File(
+            file.to_path_buf(),
+            format!("cannot read the JSON file because: {e}"),
+        )
+    })?;
+    let export: ObjectivesOnlyExport = serde_json::from_slice(&content).map_err(|e| {
+        OError::File(
+            file.to_path_buf(),
+            format!("cannot parse the JSON file because: {e}"),
+        )
+    })?;
+
+    let names = export.problem.objective_names;
+    let directions = names
+        .iter()
+        .map(|name| {
+            export
+                .problem
+                .objectives
+                .get(name)
+                .map(|o| o.direction())
+                .ok_or_else(|| {
+                    OError::File(
+                        file.to_path_buf(),
+                        format!("the objective named '{name}' does not exist in the problem"),
+                    )
+                })
+        })
+        .collect::<Result<Vec<_>, OError>>()?;
+
+    let mut values = Vec::with_capacity(export.individuals.len() * names.len());
+    for individual in &export.individuals {
+        for (name, direction) in names.iter().zip(&directions) {
+            let value = individual.objective_values.get(name).ok_or_else(|| {
+                OError::File(
+                    file.to_path_buf(),
+                    format!("an individual does not have the value of the objective '{name}'"),
+                )
+            })?;
+            // invert sign of maximised objective values
+            values.push(match direction {
+                ObjectiveDirection::Minimise => *value,
+                ObjectiveDirection::Maximise => -value,
+            });
+        }
+    }
+
+    Ok(vec![GenerationObjectives {
+        algorithm: export.algorithm,
+        generation: export.generation,
+        number_of_function_evaluations: export.number_of_function_evaluations,
+        exported_on: export.exported_on,
+        objective_names: names,
+        directions,
+        values,
+    }])
+}
+
+/// Read the objective values from the files exported in a folder with the algorithm history.
+/// The files are parsed in parallel.
+///
+/// # Arguments
+///
+/// * `folder`: The folder with the exported files.
+///
+/// returns: `Result<Vec<GenerationObjectives>, OError>`. The data sorted by generation.
+pub(crate) fn read_objective_files(folder: &PathBuf) -> Result<Vec<GenerationObjectives>, OError> {
+    let mut data: Vec<GenerationObjectives> = export_files(folder)?
+        .par_iter()
+        .map(|file| read_objectives_file(file))
+        .collect::<Result<Vec<_>, OError>>()?
+        .into_iter()
+        .flatten()
+        .collect();
+    data.sort_by_key(|d| d.generation);
+    Ok(data)
+}
+
+#[cfg(test)]
+mod test {
+    use std::env;
+    use std::fs;
+
+    use float_cmp::assert_approx_eq;
+
+    use crate::algorithms::objectives::read_objectives_file;
+    use crate::algorithms::{
+        Algorithm, ExportHistory, HistoryFormat, MaxGenerationValue, NSGA2Arg,
+        StoppingConditionType, NSGA2,
+    };
+    use crate::core::builtin_problems::SCHProblem;
+    use crate::metrics::HyperVolume;
+
+    #[test]
+    /// The objective matrices match the objectives of the fully-parsed JSON files.
+    fn test_read_objective_files() {
+        let destination = env::temp_dir().join("optirustic_objective_files_test");
+        let _ = fs::remove_dir_all(&destination);
+        fs::create_dir_all(&destination).unwrap();
+
+        let args = NSGA2Arg {
+            number_of_individuals: 10,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(6)),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            parallel: Some(false),
+            export_history: Some(ExportHistory::new(2, &destination).unwrap()),
+            resume_from_file: None,
+            seed: Some(1),
+        };
+        let mut algo = NSGA2::new(SCHProblem::create().unwrap(), args).unwrap();
+        algo.run().unwrap();
+
+        let mut all_data = NSGA2::read_json_files(&destination).unwrap();
+        all_data.sort_by_key(|d| d.generation);
+        let objectives = NSGA2::read_objective_files(&destination).unwrap();
+        assert_eq!(objectives.len(), all_data.len());
+
+        for (g, data) in objectives.iter().zip(&all_data) {
+            assert_eq!(g.generation, data.generation);
+            assert_eq!(g.number_of_individuals(), data.individuals.len());
+            for (i, ind) in data.individuals.iter().enumerate() {
+                for (name, value) in g.objective_names.iter().zip(g.individual(i)) {
+                    assert_eq!(ind.objective_values[name], *value);
+                }
+            }
+        }
+
+        let ref_point =
+            HyperVolume::estimate_reference_point_from_objectives(&objectives, Some(vec![1.0; 2]))
+                .unwrap();
+        let expected =
+            HyperVolume::estimate_reference_point_from_files(&all_data, Some(vec![1.0; 2]))
+                .unwrap();
+        assert_eq!(ref_point, expected);
+
+        let hv = HyperVolume::from_objectives(&objectives, &ref_point).unwrap();
+        let expected = HyperVolume::from_files(&all_data, &ref_point).unwrap();
+        assert_eq!(hv.generations(), expected.generations());
+        for (value, expected) in hv.values().iter().zip(expected.values()) {
+            assert_approx_eq!(f64, *value, expected, epsilon = 1e-9);
+        }
+    }
+
+    #[test]
+    /// An objective name in the header of a history file that is not in the problem returns an
+    /// error.
+    fn test_read_history_file_wrong_objective() {
+        let destination = env::temp_dir().join("optirustic_objective_files_wrong_test");
+        let _ = fs::remove_dir_all(&destination);
+        fs::create_dir_all(&destination).unwrap();
+
+        let args = NSGA2Arg {
+            number_of_individuals: 10,
+            stopping_condition: StoppingConditionType::MaxGeneration(MaxGenerationValue(2)),
+            crossover_operator_options: None,
+            mutation_operator_options: None,
+            parallel: Some(false),
+            export_history: Some(
+                ExportHistory::new_with_format(1, &destination, HistoryFormat::Binary).unwrap(),
+            ),
+            resume_from_file: None,
+            seed: Some(1),
+        };
+        let mut algo = NSGA2::new(SCHProblem::create().unwrap(), args).unwrap();
+        algo.run().unwrap();
+
+        // rename the first objective in the header (after the magic string, version and size)
+        let file = destination.join("History_NSGA2.history");
+        let content = fs::read(&file).unwrap();
+        let header_size = u64::from_le_bytes(content[12..20].try_into().unwrap()) as usize;
+        let mut header: serde_json::Value =
+            serde_json::from_slice(&content[20..20 + header_size]).unwrap();
+        header["problem"]["objective_names"][0] = "missing".into();
+        let header = serde_json::to_vec(&header).unwrap();
+
+        let mut corrupted = content[0..12].to_vec();
+        corrupted.extend((header.len() as u64).to_le_bytes());
+        corrupted.extend(header);
+        corrupted.extend(&content[20 + header_size..]);
+        fs::write(&file, corrupted).unwrap();
+
+        let error = read_objectives_file(&file).unwrap_err().to_string();
+        assert!(error.contains("The objective 'missing' is missing from the history header"));
+    }
+}
@@ -0,0 +1,140 @@
+use rand::{RngCore, SeedableRng};
+use rand_chacha::ChaCha8Rng;
+use rayon::prelude::*;
+
+use crate::core::{Individual, OError};
+use crate::operators::{Crossover, Mutation, Selector};
+
+/// The number of pairs of offsprings generated with the same random number generator stream.
+/// The streams do not depend on the number of threads, so that the offsprings are the same
+/// for a given seed when the population is generated in parallel or serially.
+const PAIRS_PER_STREAM: usize = 16;
+
+/// Generate new offsprings from the population using selection, crossover and mutation. The
+/// pairs of offsprings are split into chunks of [`PAIRS_PER_STREAM`] items and each chunk uses a
+/// [`ChaCha8Rng`] seeded with a value drawn from `rng` and its own stream, set with
+/// [`ChaCha8Rng::set_stream`]. The chunks can then be generated in parallel, while the results
+/// are reproducible regardless of the number of threads. The parents are selected by index and
+/// are not cloned.
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals of the current population used as parents.
+/// * `number_of_offsprings`: The number of offsprings to generate. This must be a multiple of 2.
+/// * `selector`: The operator to select the parents.
+/// * `crossover`: The operator to recombine the parents.
+/// * `mutation`: The operator to mutate the children.
+/// * `rng`: The random number generator of the algorithm used to seed the streams.
+/// * `parallel`: Whether to generate the chunks in parallel.
+///
+/// returns: `Result<Vec<Individual>, OError>`
+pub(crate) fn generate_offsprings<S, C, M>(
+    individuals: &[Individual],
+    number_of_offsprings: usize,
+    selector: &S,
+    crossover: &C,
+    mutation: &M,
+    rng: &mut dyn RngCore,
+    parallel: bool,
+) -> Result<Vec<Individual>, OError>
+where
+    S: Selector + Sync,
+    C: Crossover + Sync,
+    M: Mutation + Sync,
+{
+    let number_of_pairs = number_of_offsprings / 2;
+    let number_of_streams = number_of_pairs.div_ceil(PAIRS_PER_STREAM);
+    let seed = rng.next_u64();
+
+    let generate_chunk = |stream: usize| -> Result<Vec<Individual>, OError> {
+        let mut rng = ChaCha8Rng::seed_from_u64(seed);
+        rng.set_stream(stream as u64);
+
+        let pairs = PAIRS_PER_STREAM.min(number_of_pairs - stream * PAIRS_PER_STREAM);
+        let mut offsprings = Vec::with_capacity(2 * pairs);
+        for _ in 0..pairs {
+            let parent1 = selector.select_fit_index(individuals, &mut rng)?;
+            let parent2 = selector.select_fit_index(individuals, &mut rng)?;
+
+            // generate the 2 children with crossover
+            let children = crossover.generate_offsprings(
+                &individuals[parent1],
+                &individuals[parent2],
+                &mut rng,
+            )?;
+
+            // mutate them
+            offsprings.push(mutation.mutate_offspring(&children.child1, &mut rng)?);
+            offsprings.push(mutation.mutate_offspring(&children.child2, &mut rng)?);
+        }
+        Ok(offsprings)
+    };
+
+    let chunks: Vec<Vec<Individual>> = if parallel {
+        (0..number_of_streams)
+            .into_par_iter()
+            .map(generate_chunk)
+            .collect::<Result<_, _>>()?
+    } else {
+        (0..number_of_streams)
+            .map(generate_chunk)
+            .collect::<Result<_, _>>()?
+    };
+    Ok(chunks.into_iter().flatten().collect())
+}
+
+#[cfg(test)]
+mod test {
+    use std::sync::Arc;
+
+    use crate::algorithms::reproduction::generate_offsprings;
+    use crate::core::builtin_problems::ZTD1Problem;
+    use crate::core::utils::get_rng;
+    use crate::core::{DataValue, Individual, Population};
+    use crate::operators::{
+        CrowdedComparison, PolynomialMutation, PolynomialMutationArgs, SimulatedBinaryCrossover,
+        SimulatedBinaryCrossoverArgs, TournamentSelector,
+    };
+
+    #[test]
+    /// The offsprings generated in parallel and serially are the same.
+    fn test_reproducible_offsprings() {
+        let problem = Arc::new(ZTD1Problem::create(10).unwrap());
+        let mut population = Population::init(problem.clone(), 50);
+        for (i, individual) in population.individuals_as_mut().iter_mut().enumerate() {
+            individual.set_data("rank", DataValue::Integer((i % 3) as i64));
+            individual.set_data("crowding_distance", DataValue::Real(i as f64));
+        }
+        let selector = TournamentSelector::<CrowdedComparison>::new(2);
+        let crossover =
+            SimulatedBinaryCrossover::new(SimulatedBinaryCrossoverArgs::default()).unwrap();
+        let mutation =
+            PolynomialMutation::new(PolynomialMutationArgs::default(problem.as_ref())).unwrap();
+
+        let offsprings: Vec<Vec<Individual>> = [false, true]
+            .into_iter()
+            .map(|parallel| {
+                let mut rng = get_rng(Some(1));
+                generate_offsprings(
+                    population.individuals(),
+                    50,
+                    &selector,
+                    &crossover,
+                    &mutation,
+                    &mut rng,
+                    parallel,
+                )
+                .unwrap()
+            })
+            .collect();
+
+        assert_eq!(offsprings[0].len(), 50);
+        for (serial, parallel) in offsprings[0].iter().zip(&offsprings[1]) {
+            assert_eq!(
+                serial.variable_values_slice(),
+                parallel.variable_values_slice()
+            );
+            assert!(!parallel.is_evaluated());
+        }
+    }
+}
@@ -2,6 +2,9 @@ use std::time::Duration;
 
 use serde::{Deserialize, Serialize};
 
+/// The error returned when an `Any` or `All` stopping condition contains another vector.
+const NESTED_VECTOR_ERROR: &str = "A vector of stopping condition vector is not allowed";
+
 /// Trait to define a condition that causes an algorithm to terminate.
 pub trait StoppingCondition<T: PartialOrd> {
     /// The target value of the stopping condition.
@@ -109,4 +112,72 @@ impl StoppingConditionType {
             _ => false,
         })
     }
+
+    /// Check whether the stopping condition is met. This returns an error if an `Any` or `All`
+    /// condition contains another vector of conditions.
+    ///
+    /// # Arguments
+    ///
+    /// * `generation`: The current generation.
+    /// * `nfe`: The current number of function evaluations.
+    /// * `elapsed`: The time elapsed since the algorithm started.
+    ///
+    /// returns: `Result<bool, String>`
+    pub(crate) fn is_met(
+        &self,
+        generation: usize,
+        nfe: usize,
+        elapsed: Duration,
+    ) -> Result<bool, String> {
+        let is_met = match self {
+            StoppingConditionType::MaxDuration(cond) => cond.is_met(elapsed),
+            StoppingConditionType::MaxGeneration(cond) => cond.is_met(generation),
+            StoppingConditionType::MaxFunctionEvaluations(cond) => cond.is_met(nfe),
+            StoppingConditionType::Any(conditions) => {
+                if StoppingConditionType::has_nested_vector(conditions) {
+                    return Err(NESTED_VECTOR_ERROR.to_string());
+                }
+                conditions
+                    .iter()
+                    .any(|c| c.is_met(generation, nfe, elapsed).unwrap())
+            }
+            StoppingConditionType::All(conditions) => {
+                if StoppingConditionType::has_nested_vector(conditions) {
+                    return Err(NESTED_VECTOR_ERROR.to_string());
+                }
+                conditions
+                    .iter()
+                    .all(|c| c.is_met(generation, nfe, elapsed).unwrap())
+            }
+        };
+        Ok(is_met)
+    }
+
+    /// Get the number of function evaluations that can still be run before the stopping condition
+    /// is met. This is used to stop submitting new individuals when the evaluations already
+    /// scheduled are enough to meet the condition.
+    ///
+    /// # Arguments
+    ///
+    /// * `nfe`: The current number of function evaluations.
+    ///
+    /// returns: `Option<usize>`. `None` if the condition does not limit the number of function
+    /// evaluations.
+    pub(crate) fn remaining_evaluations(&self, nfe: usize) -> Option<usize> {
+        match self {
+            StoppingConditionType::MaxFunctionEvaluations(cond) => {
+                Some(cond.target().saturating_sub(nfe))
+            }
+            StoppingConditionType::Any(conditions) => conditions
+                .iter()
+                .filter_map(|c| c.remaining_evaluations(nfe))
+                .min(),
+            StoppingConditionType::All(conditions) => conditions
+                .iter()
+                .map(|c| c.remaining_evaluations(nfe))
+                .collect::<Option<Vec<usize>>>()
+                .and_then(|r| r.into_iter().max()),
+            _ => None,
+        }
+    }
 }
@@ -0,0 +1,102 @@
+//! Expose the internal routines measured by the benchmarks in the `benches` folder. This module
+//! is only compiled with the `bench` feature and is not part of the public API.
+use rand::RngCore;
+
+use crate::algorithms::nsga3::associate::AssociateToRefPoint;
+use crate::algorithms::nsga3::niching::Niching;
+use crate::algorithms::nsga3::normalise::Normalise;
+use crate::algorithms::{NSGA2, NSGA3};
+use crate::core::{Individual, OError, Population};
+use crate::metrics::hv_wfg::engine;
+pub use crate::metrics::hv_wfg::wfg::{Optimisation, Wfg};
+
+/// Calculate the crowding distance of a non-dominated front using the NSGA2 algorithm.
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals in a non-dominated front.
+///
+/// returns: `Result<(), OError>`
+pub fn set_crowding_distance(individuals: &mut [Individual]) -> Result<(), OError> {
+    NSGA2::set_crowding_distance(individuals)
+}
+
+/// Normalise the objectives of the individuals with the NSGA3 normalisation ("Algorithm 2").
+///
+/// # Arguments
+///
+/// * `ideal_point`: The coordinate of the ideal point from the previous evolution.
+/// * `individuals`: The individuals to normalise.
+///
+/// returns: `Result<(), OError>`
+pub fn nsga3_normalise(
+    ideal_point: &mut Vec<f64>,
+    individuals: &mut [Individual],
+) -> Result<(), OError> {
+    Normalise::new(ideal_point, individuals)?.calculate()?;
+    Ok(())
+}
+
+/// Associate the normalised individuals to the NSGA3 reference points ("Algorithm 3").
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals normalised with [`nsga3_normalise`].
+/// * `reference_points`: The reference points.
+///
+/// returns: `Result<Vec<usize>, OError>`. The index of the reference point associated to each
+/// individual.
+pub fn nsga3_associate(
+    individuals: &mut [Individual],
+    reference_points: &[Vec<f64>],
+) -> Result<Vec<usize>, OError> {
+    AssociateToRefPoint::new(individuals, reference_points)?.calculate()
+}
+
+/// Add the individuals from the last front to the new population with the NSGA3 niching
+/// ("Algorithm 4").
+///
+/// # Arguments
+///
+/// * `selected_individuals`: The population without the last front.
+/// * `potential_individuals`: The individuals in the last front associated with
+///    [`nsga3_associate`].
+/// * `number_of_individuals_to_add`: The number of individuals to add from the last front.
+/// * `reference_point_indexes`: The index of the reference point associated to each individual
+///    in `selected_individuals`.
+/// * `number_of_reference_points`: The number of reference points.
+/// * `rng`: The random number generator.
+///
+/// returns: `Result<(), OError>`
+pub fn nsga3_niching(
+    selected_individuals: &mut Population,
+    potential_individuals: &mut Vec<Individual>,
+    number_of_individuals_to_add: usize,
+    reference_point_indexes: &[usize],
+    number_of_reference_points: usize,
+    rng: &mut Box<dyn RngCore + Send>,
+) -> Result<(), OError> {
+    let mut rho_j = NSGA3::get_association_map(reference_point_indexes, number_of_reference_points);
+    Niching::new(
+        selected_individuals,
+        potential_individuals,
+        number_of_individuals_to_add,
+        &mut rho_j,
+        rng,
+    )?
+    .calculate()
+}
+
+/// Calculate the hyper-volume of a non-dominated front with the flat-buffer WFG engine used by
+/// [`crate::metrics::HyperVolumeWhile2012`].
+///
+/// # Arguments
+///
+/// * `front`: The objective values of the points stored by row.
+/// * `reference_point`: The reference point.
+/// * `parallel`: Whether to calculate the contribution of each point in parallel.
+///
+/// returns: `f64`
+pub fn wfg_hyper_volume(front: &[f64], reference_point: &[f64], parallel: bool) -> f64 {
+    engine::hyper_volume(front, reference_point, parallel)
+}
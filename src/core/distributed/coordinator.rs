@@ -0,0 +1,601 @@
+use std::collections::{HashMap, VecDeque};
+use std::error::Error;
+use std::fmt::{Debug, Formatter};
+use std::io::BufReader;
+use std::net::{Shutdown, SocketAddr, TcpListener, TcpStream, ToSocketAddrs};
+use std::sync::mpsc::{channel, Receiver, RecvTimeoutError, Sender};
+use std::sync::{Arc, Mutex};
+use std::thread;
+use std::time::{Duration, Instant};
+
+use log::{debug, info, warn};
+
+use crate::core::distributed::protocol::{
+    read_message, write_message, CoordinatorMessage, WorkerMessage,
+};
+use crate::core::{BatchEvaluationResult, BatchEvaluator, Individual, OError, VariableValue};
+
+/// How often the coordinator checks for lost workers while waiting for results.
+const POLL_INTERVAL: Duration = Duration::from_millis(100);
+
+/// Options to configure the [`DistributedEvaluator`].
+#[derive(Clone, Debug)]
+pub struct DistributedEvaluatorArgs {
+    /// A worker is considered lost when no message is received from it for this duration. Its
+    /// task is then sent to another worker. This must be larger than the heartbeat interval of
+    /// the workers (see [`crate::core::DistributedWorker::new`]).
+    pub heartbeat_timeout: Duration,
+    /// Return an error when no worker is connected for this duration while individuals are
+    /// waiting to be evaluated. When `None`, the coordinator waits for new workers indefinitely.
+    pub worker_wait_timeout: Option<Duration>,
+}
+
+impl Default for DistributedEvaluatorArgs {
+    /// Create the options with a heartbeat timeout of 30 seconds, waiting for the workers
+    /// indefinitely.
+    ///
+    /// returns: `DistributedEvaluatorArgs`
+    fn default() -> Self {
+        Self {
+            heartbeat_timeout: Duration::from_secs(30),
+            worker_wait_timeout: None,
+        }
+    }
+}
+
+/// The statistics of a worker connected to the [`DistributedEvaluator`].
+#[derive(Clone, Debug)]
+pub struct WorkerStats {
+    /// The name the worker sent when it connected.
+    pub name: String,
+    /// The address of the worker.
+    pub address: SocketAddr,
+    /// Whether the worker is still connected.
+    pub connected: bool,
+    /// The number of evaluated individuals.
+    pub completed_tasks: usize,
+    /// The number of tasks that were sent to another worker, because the connection was lost or
+    /// no heartbeat was received.
+    pub lost_tasks: usize,
+    /// The total time spent by the worker on the completed tasks, including the network
+    /// transfer.
+    pub busy_time: Duration,
+}
+
+impl WorkerStats {
+    /// The number of evaluated individuals per second spent evaluating.
+    ///
+    /// returns: `f64`
+    pub fn throughput(&self) -> f64 {
+        if self.busy_time.is_zero() {
+            return 0.0;
+        }
+        self.completed_tasks as f64 / self.busy_time.as_secs_f64()
+    }
+}
+
+/// An event received by the coordinator from the connection threads.
+enum Event {
+    /// A new worker connected.
+    Connected(usize, SocketAddr, TcpStream),
+    /// A message was received from a worker at the given instant.
+    Message(usize, WorkerMessage, Instant),
+    /// The connection with a worker was closed.
+    Disconnected(usize),
+}
+
+/// A connected worker.
+struct WorkerConnection {
+    /// The stream used to send the tasks.
+    stream: TcpStream,
+    /// When the last message was received.
+    last_seen: Instant,
+    /// The identifier of the task being evaluated and when it was sent.
+    task: Option<(u64, Instant)>,
+    /// The worker statistics.
+    stats: WorkerStats,
+}
+
+/// The state of the coordinator shared between the batches.
+struct CoordinatorState {
+    /// The workers by identifier.
+    workers: HashMap<usize, WorkerConnection>,
+    /// The events from the connection threads.
+    events: Receiver<Event>,
+    /// The identifier of the next task.
+    next_task_id: u64,
+}
+
+/// The data of the batch being evaluated.
+struct Batch {
+    /// The variable values of each individual.
+    variables: Vec<Vec<VariableValue>>,
+    /// The index of the individuals to send to the workers.
+    queue: VecDeque<usize>,
+    /// The index in the batch of each sent task.
+    tasks: HashMap<u64, usize>,
+    /// The objective and constraint values of the evaluated individuals.
+    results: Vec<Option<(Vec<f64>, Vec<f64>)>>,
+    /// The number of individuals without results.
+    remaining: usize,
+}
+
+impl Batch {
+    /// Put a task back in the queue, unless its individual was already evaluated.
+    ///
+    /// # Arguments
+    ///
+    /// * `task_id`: The task identifier.
+    ///
+    /// returns: `()`
+    fn requeue(&mut self, task_id: u64) {
+        if let Some(&index) = self.tasks.get(&task_id) {
+            if self.results[index].is_none() {
+                self.queue.push_front(index);
+            }
+        }
+    }
+}
+
+impl CoordinatorState {
+    /// Update the workers and the batch with an event. This returns an error if a worker
+    /// failed to evaluate an individual of the batch.
+    ///
+    /// # Arguments
+    ///
+    /// * `event`: The event.
+    /// * `batch`: The batch being evaluated.
+    ///
+    /// returns: `Result<(), OError>`
+    fn handle_event(&mut self, event: Event, batch: &mut Batch) -> Result<(), OError> {
+        match event {
+            Event::Connected(worker_id, address, stream) => {
+                info!("Worker #{worker_id} connected from {address}");
+                self.workers.insert(
+                    worker_id,
+                    WorkerConnection {
+                        stream,
+                        last_seen: Instant::now(),
+                        task: None,
+                        stats: WorkerStats {
+                            name: address.to_string(),
+                            address,
+                            connected: true,
+                            completed_tasks: 0,
+                            lost_tasks: 0,
+                            busy_time: Duration::ZERO,
+                        },
+                    },
+                );
+            }
+            Event::Message(worker_id, message, received_on) => {
+                let Some(worker) = self.workers.get_mut(&worker_id) else {
+                    return Ok(());
+                };
+                if !worker.stats.connected {
+                    return Ok(());
+                }
+                worker.last_seen = received_on;
+                match message {
+                    WorkerMessage::Hello { name } => {
+                        debug!("Worker #{worker_id} is named '{name}'");
+                        worker.stats.name = name;
+                    }
+                    WorkerMessage::Heartbeat => {}
+                    WorkerMessage::Result {
+                        id,
+                        objectives,
+                        constraints,
+                    } => {
+                        if let Some((task_id, sent_on)) = worker.task {
+                            if task_id == id {
+                                worker.task = None;
+                                worker.stats.completed_tasks += 1;
+                                worker.stats.busy_time += received_on.duration_since(sent_on);
+                            }
+                        }
+                        // ignore the tasks of the previous batches
+                        if let Some(&index) = batch.tasks.get(&id) {
+                            if batch.results[index].is_none() {
+                                batch.results[index] = Some((objectives, constraints));
+                                batch.remaining -= 1;
+                            }
+                        }
+                    }
+                    WorkerMessage::Error { id, message } => {
+                        if worker.task.is_some_and(|(task_id, _)| task_id == id) {
+                            worker.task = None;
+                        }
+                        if batch.tasks.contains_key(&id) {
+                            return Err(OError::DistributedEvaluation(format!(
+                                "the worker '{}' failed to evaluate an individual: {message}",
+                                worker.stats.name
+                            )));
+                        }
+                    }
+                }
+            }
+            Event::Disconnected(worker_id) => {
+                if let Some(worker) = self.workers.get_mut(&worker_id) {
+                    if worker.stats.connected {
+                        warn!("Worker '{}' disconnected", worker.stats.name);
+                    }
+                    Self::drop_worker(worker, batch);
+                }
+            }
+        }
+        Ok(())
+    }
+
+    /// Mark a worker as lost and put its task back in the queue.
+    ///
+    /// # Arguments
+    ///
+    /// * `worker`: The worker.
+    /// * `batch`: The batch being evaluated.
+    ///
+    /// returns: `()`
+    fn drop_worker(worker: &mut WorkerConnection, batch: &mut Batch) {
+        if !worker.stats.connected {
+            return;
+        }
+        worker.stats.connected = false;
+        let _ = worker.stream.shutdown(Shutdown::Both);
+        if let Some((task_id, _)) = worker.task.take() {
+            worker.stats.lost_tasks += 1;
+            batch.requeue(task_id);
+        }
+    }
+
+    /// Drop the workers which did not send any message within the heartbeat timeout.
+    ///
+    /// # Arguments
+    ///
+    /// * `heartbeat_timeout`: The heartbeat timeout.
+    /// * `batch`: The batch being evaluated.
+    ///
+    /// returns: `()`
+    fn drop_silent_workers(&mut self, heartbeat_timeout: Duration, batch: &mut Batch) {
+        for worker in self.workers.values_mut() {
+            if worker.stats.connected && worker.last_seen.elapsed() > heartbeat_timeout {
+                warn!(
+                    "No heartbeat received from worker '{}' in {:?}",
+                    worker.stats.name, heartbeat_timeout
+                );
+                Self::drop_worker(worker, batch);
+            }
+        }
+    }
+
+    /// Send the individuals in the queue to the idle workers.
+    ///
+    /// # Arguments
+    ///
+    /// * `batch`: The batch being evaluated.
+    ///
+    /// returns: `()`
+    fn dispatch(&mut self, batch: &mut Batch) {
+        for (worker_id, worker) in self.workers.iter_mut() {
+            if !worker.stats.connected || worker.task.is_some() {
+                continue;
+            }
+            let Some(index) = batch.queue.pop_front() else {
+                break;
+            };
+
+            let id = self.next_task_id;
+            self.next_task_id += 1;
+            batch.tasks.insert(id, index);
+            let message = CoordinatorMessage::Task {
+                id,
+                variables: batch.variables[index].clone(),
+            };
+            worker.task = Some((id, Instant::now()));
+            debug!("Sending task #{id} to worker #{worker_id}");
+            if let Err(e) = write_message(&mut worker.stream, &message) {
+                warn!(
+                    "Cannot send the task to worker '{}' because: {e}",
+                    worker.stats.name
+                );
+                Self::drop_worker(worker, batch);
+            }
+        }
+    }
+
+    /// Get the statistics of the workers sorted by identifier.
+    ///
+    /// returns: `Vec<(usize, WorkerStats)>`
+    fn stats(&self) -> Vec<(usize, WorkerStats)> {
+        let mut stats: Vec<(usize, WorkerStats)> = self
+            .workers
+            .iter()
+            .map(|(id, w)| (*id, w.stats.clone()))
+            .collect();
+        stats.sort_by_key(|(id, _)| *id);
+        stats
+    }
+
+    /// Whether at least one worker is connected.
+    ///
+    /// returns: `bool`
+    fn has_workers(&self) -> bool {
+        self.workers.values().any(|w| w.stats.connected)
+    }
+}
+
+/// The data shared by the clones of a [`DistributedEvaluator`].
+struct Coordinator {
+    /// The address the coordinator listens on.
+    address: SocketAddr,
+    /// The coordinator options.
+    options: DistributedEvaluatorArgs,
+    /// The state of the workers. The lock is held for the whole evaluation of a batch.
+    state: Mutex<CoordinatorState>,
+    /// The statistics of the workers by identifier, updated while a batch is evaluated.
+    stats: Mutex<Vec<(usize, WorkerStats)>>,
+}
+
+impl Drop for Coordinator {
+    fn drop(&mut self) {
+        // stop the remote workers
+        if let Ok(state) = self.state.get_mut() {
+            for worker in state.workers.values_mut() {
+                if worker.stats.connected {
+                    let _ = write_message(&mut worker.stream, &CoordinatorMessage::Shutdown);
+                    let _ = worker.stream.shutdown(Shutdown::Both);
+                }
+            }
+        }
+    }
+}
+
+/// A batch evaluator sending the individuals to remote worker processes over TCP. The
+/// coordinator listens for connections from the workers (see [`crate::core::DistributedWorker`]),
+/// which may join or leave at any time. When a batch is evaluated, the variable values of each
+/// individual are sent to an idle worker in a compact binary message and the objective and
+/// constraint values are collected as soon as they are sent back.
+///
+/// The workers send a heartbeat periodically. A worker is dropped when its connection is closed
+/// or no heartbeat is received within [`DistributedEvaluatorArgs::heartbeat_timeout`], and its
+/// task is sent to another worker. The number of evaluated and lost tasks and the throughput of
+/// each worker are available with [`DistributedEvaluator::worker_stats`].
+///
+/// Use this with [`crate::core::Problem::new_with_batch_evaluator`], with a batch size equal to
+/// the population size so that all the new individuals of a generation are dispatched at once.
+/// The evaluator is cheap to clone; keep a clone to access the statistics. The workers are
+/// stopped when all the clones are dropped.
+///
+/// # Example
+/// ```no_run
+/// use optirustic::core::{
+///     BoundedNumber, DistributedEvaluator, DistributedEvaluatorArgs, Objective,
+///     ObjectiveDirection, Problem, VariableType,
+/// };
+///
+/// let evaluator =
+///     DistributedEvaluator::bind("0.0.0.0:9000", DistributedEvaluatorArgs::default()).unwrap();
+/// let objectives = vec![
+///     Objective::new("x^2", ObjectiveDirection::Minimise),
+///     Objective::new("(x-2)^2", ObjectiveDirection::Minimise),
+/// ];
+/// let variables = vec![VariableType::Real(
+///     BoundedNumber::new("x", -1000.0, 1000.0).unwrap(),
+/// )];
+/// let problem = Problem::new_with_batch_evaluator(
+///     objectives,
+///     variables,
+///     None,
+///     Box::new(evaluator.clone()),
+///     100,
+/// )
+/// .unwrap();
+///
+/// // run the algorithm with the problem, while the workers are started on the other nodes
+/// // with `DistributedWorker::new(SCHProblem::create().unwrap(), ...).run("coordinator:9000")`
+/// for worker in evaluator.worker_stats() {
+///     println!("{}: {:.3} evaluations/s", worker.name, worker.throughput());
+/// }
+/// ```
+#[derive(Clone)]
+pub struct DistributedEvaluator {
+    /// The shared coordinator.
+    inner: Arc<Coordinator>,
+}
+
+impl DistributedEvaluator {
+    /// Start listening for the workers on the given address. This returns an error if the
+    /// address cannot be bound.
+    ///
+    /// # Arguments
+    ///
+    /// * `address`: The address to listen on. Use port `0` to pick a free port.
+    /// * `options`: The options with the heartbeat timeout.
+    ///
+    /// returns: `Result<DistributedEvaluator, OError>`
+    pub fn bind(
+        address: impl ToSocketAddrs,
+        options: DistributedEvaluatorArgs,
+    ) -> Result<Self, OError> {
+        let listener = TcpListener::bind(address).map_err(|e| {
+            OError::DistributedEvaluation(format!("cannot bind the coordinator address: {e}"))
+        })?;
+        let address = listener.local_addr().map_err(|e| {
+            OError::DistributedEvaluation(format!("cannot get the coordinator address: {e}"))
+        })?;
+        info!("Waiting for workers on {address}");
+
+        let (sender, events) = channel();
+        thread::spawn(move || Self::accept_workers(listener, sender));
+
+        Ok(Self {
+            inner: Arc::new(Coordinator {
+                address,
+                options,
+                state: Mutex::new(CoordinatorState {
+                    workers: HashMap::new(),
+                    events,
+                    next_task_id: 0,
+                }),
+                stats: Mutex::new(vec![]),
+            }),
+        })
+    }
+
+    /// Get the address the coordinator listens on.
+    ///
+    /// returns: `SocketAddr`
+    pub fn local_addr(&self) -> SocketAddr {
+        self.inner.address
+    }
+
+    /// Get the statistics of all the workers that connected to the coordinator, sorted by
+    /// connection time. The statistics are also updated while a batch is evaluated.
+    ///
+    /// returns: `Vec<WorkerStats>`
+    pub fn worker_stats(&self) -> Vec<WorkerStats> {
+        if let Ok(state) = self.inner.state.try_lock() {
+            *self.inner.stats.lock().unwrap() = state.stats();
+        }
+        self.inner
+            .stats
+            .lock()
+            .unwrap()
+            .iter()
+            .map(|(_, stats)| stats.clone())
+            .collect()
+    }
+
+    /// Accept the connections from the workers and spawn a thread reading the messages of each
+    /// worker. This stops at the first connection after the coordinator is dropped.
+    ///
+    /// # Arguments
+    ///
+    /// * `listener`: The listener.
+    /// * `sender`: The sender of the events.
+    ///
+    /// returns: `()`
+    fn accept_workers(listener: TcpListener, sender: Sender<Event>) {
+        for (worker_id, stream) in listener.incoming().enumerate() {
+            let stream = match stream {
+                Ok(stream) => stream,
+                Err(e) => {
+                    warn!("Cannot accept the worker connection because: {e}");
+                    continue;
+                }
+            };
+            let _ = stream.set_nodelay(true);
+            let (Ok(address), Ok(reader)) = (stream.peer_addr(), stream.try_clone()) else {
+                continue;
+            };
+            if sender
+                .send(Event::Connected(worker_id, address, stream))
+                .is_err()
+            {
+                break;
+            }
+
+            let sender = sender.clone();
+            thread::spawn(move || {
+                let mut reader = BufReader::new(reader);
+                loop {
+                    match read_message::<WorkerMessage>(&mut reader) {
+                        Ok(Some(message)) => {
+                            let event = Event::Message(worker_id, message, Instant::now());
+                            if sender.send(event).is_err() {
+                                break;
+                            }
+                        }
+                        Ok(None) => break,
+                        Err(e) => {
+                            warn!("Cannot read the message from worker #{worker_id}: {e}");
+                            break;
+                        }
+                    }
+                }
+                let _ = sender.send(Event::Disconnected(worker_id));
+            });
+        }
+    }
+}
+
+impl Debug for DistributedEvaluator {
+    fn fmt(&self, f: &mut Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("DistributedEvaluator")
+            .field("address", &self.inner.address)
+            .field("options", &self.inner.options)
+            .finish()
+    }
+}
+
+impl BatchEvaluator for DistributedEvaluator {
+    fn evaluate_batch(
+        &self,
+        individuals: &[&Individual],
+    ) -> Result<BatchEvaluationResult, Box<dyn Error>> {
+        // batches evaluated from different threads are dispatched one at the time
+        let mut state = self.inner.state.lock().unwrap();
+        let options = &self.inner.options;
+        let mut batch = Batch {
+            variables: individuals
+                .iter()
+                .map(|i| i.variable_values_slice().to_vec())
+                .collect(),
+            queue: (0..individuals.len()).collect(),
+            tasks: HashMap::new(),
+            results: vec![None; individuals.len()],
+            remaining: individuals.len(),
+        };
+
+        let start = Instant::now();
+        let mut no_workers_since: Option<Instant> = None;
+        while batch.remaining > 0 {
+            // handle the events and wait for the next one
+            while let Ok(event) = state.events.try_recv() {
+                state.handle_event(event, &mut batch)?;
+            }
+            state.drop_silent_workers(options.heartbeat_timeout, &mut batch);
+            state.dispatch(&mut batch);
+            *self.inner.stats.lock().unwrap() = state.stats();
+
+            if state.has_workers() {
+                no_workers_since = None;
+            } else {
+                let since = *no_workers_since.get_or_insert_with(Instant::now);
+                if let Some(timeout) = options.worker_wait_timeout {
+                    if since.elapsed() > timeout {
+                        return Err(Box::new(OError::DistributedEvaluation(format!(
+                            "no worker connected in {timeout:?}"
+                        ))));
+                    }
+                }
+            }
+
+            match state.events.recv_timeout(POLL_INTERVAL) {
+                Ok(event) => state.handle_event(event, &mut batch)?,
+                Err(RecvTimeoutError::Timeout) => {}
+                Err(RecvTimeoutError::Disconnected) => {
+                    return Err(Box::new(OError::DistributedEvaluation(
+                        "the coordinator stopped listening for workers".to_string(),
+                    )));
+                }
+            }
+        }
+        debug!(
+            "Evaluated {} individuals on {} workers in {:?}",
+            individuals.len(),
+            state.workers.values().filter(|w| w.stats.connected).count(),
+            start.elapsed()
+        );
+
+        let mut objectives = vec![];
+        let mut constraints = vec![];
+        for (o, c) in batch.results.into_iter().flatten() {
+            objectives.extend(o);
+            constraints.extend(c);
+        }
+        Ok(BatchEvaluationResult {
+            objectives,
+            constraints,
+        })
+    }
+}
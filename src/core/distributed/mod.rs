@@ -0,0 +1,142 @@
+//! Evaluate the individuals on remote worker processes. A coordinator ([`DistributedEvaluator`])
+//! is used as the [`crate::core::BatchEvaluator`] of the problem and dispatches the individuals
+//! over TCP to the workers ([`DistributedWorker`]) running on the other nodes.
+pub use coordinator::{DistributedEvaluator, DistributedEvaluatorArgs, WorkerStats};
+pub use worker::DistributedWorker;
+
+mod coordinator;
+mod protocol;
+mod worker;
+
+#[cfg(test)]
+mod test {
+    use std::io::BufReader;
+    use std::net::TcpStream;
+    use std::sync::Arc;
+    use std::thread;
+    use std::time::Duration;
+
+    use crate::core::builtin_problems::SCHProblem;
+    use crate::core::distributed::protocol::{
+        read_message, write_message, CoordinatorMessage, WorkerMessage,
+    };
+    use crate::core::{
+        BatchEvaluator, DistributedEvaluator, DistributedEvaluatorArgs, DistributedWorker,
+        Individual, VariableValue,
+    };
+
+    /// Create the SCH individuals with x from 0 to `n - 1` and the expected objectives.
+    fn individuals(n: usize) -> (Vec<Individual>, Vec<f64>) {
+        let problem = Arc::new(SCHProblem::create().unwrap());
+        let mut expected = vec![];
+        let individuals = (0..n)
+            .map(|x| {
+                let x = x as f64;
+                let mut ind = Individual::new(problem.clone());
+                ind.update_variable("x", VariableValue::Real(x)).unwrap();
+                expected.extend([x.powi(2), (x - 2.0).powi(2)]);
+                ind
+            })
+            .collect();
+        (individuals, expected)
+    }
+
+    /// Start a worker solving the SCH problem in a new thread.
+    fn spawn_worker(
+        evaluator: &DistributedEvaluator,
+        name: &str,
+    ) -> thread::JoinHandle<Result<usize, crate::core::OError>> {
+        let address = evaluator.local_addr();
+        let worker = DistributedWorker::new(
+            SCHProblem::create().unwrap(),
+            name,
+            Duration::from_millis(50),
+        );
+        thread::spawn(move || worker.run(address))
+    }
+
+    #[test]
+    /// The individuals are evaluated by the workers, which stop when the coordinator is dropped.
+    fn test_distributed_evaluation() {
+        let evaluator =
+            DistributedEvaluator::bind("127.0.0.1:0", DistributedEvaluatorArgs::default()).unwrap();
+        let workers = vec![
+            spawn_worker(&evaluator, "worker1"),
+            spawn_worker(&evaluator, "worker2"),
+        ];
+
+        let (individuals, expected) = individuals(20);
+        let batch: Vec<&Individual> = individuals.iter().collect();
+        let results = evaluator.evaluate_batch(&batch).unwrap();
+        assert_eq!(results.objectives, expected);
+        assert!(results.constraints.is_empty());
+
+        let stats = evaluator.worker_stats();
+        assert_eq!(stats.iter().map(|s| s.completed_tasks).sum::<usize>(), 20);
+        assert!(stats.iter().all(|s| s.lost_tasks == 0 && s.connected));
+
+        drop(evaluator);
+        let evaluated: usize = workers
+            .into_iter()
+            .map(|w| w.join().unwrap().unwrap())
+            .sum();
+        assert_eq!(evaluated, 20);
+    }
+
+    #[test]
+    /// The tasks of a worker that disconnects and of a worker that stops sending heartbeats are
+    /// evaluated by another worker.
+    fn test_lost_workers() {
+        let options = DistributedEvaluatorArgs {
+            heartbeat_timeout: Duration::from_millis(500),
+            worker_wait_timeout: Some(Duration::from_secs(10)),
+        };
+        let evaluator = DistributedEvaluator::bind("127.0.0.1:0", options).unwrap();
+
+        // these workers receive one task each and never return the results
+        let mut fake_workers = vec![];
+        for (name, disconnect) in [("disconnected", true), ("silent", false)] {
+            let mut stream = TcpStream::connect(evaluator.local_addr()).unwrap();
+            write_message(
+                &mut stream,
+                &WorkerMessage::Hello {
+                    name: name.to_string(),
+                },
+            )
+            .unwrap();
+            fake_workers.push(thread::spawn(move || {
+                let mut reader = BufReader::new(stream);
+                let task = read_message::<CoordinatorMessage>(&mut reader).unwrap();
+                assert!(matches!(task, Some(CoordinatorMessage::Task { .. })));
+                if !disconnect {
+                    // wait until the coordinator closes the connection
+                    while let Ok(Some(_)) = read_message::<CoordinatorMessage>(&mut reader) {}
+                }
+            }));
+        }
+        thread::sleep(Duration::from_millis(200));
+        let worker = spawn_worker(&evaluator, "worker");
+
+        let (individuals, expected) = individuals(6);
+        let batch: Vec<&Individual> = individuals.iter().collect();
+        let results = evaluator.evaluate_batch(&batch).unwrap();
+        assert_eq!(results.objectives, expected);
+        for fake_worker in fake_workers {
+            fake_worker.join().unwrap();
+        }
+
+        let stats = evaluator.worker_stats();
+        assert_eq!(stats.len(), 3);
+        for s in &stats[..2] {
+            assert!(!s.connected);
+            assert_eq!(s.lost_tasks, 1);
+            assert_eq!(s.completed_tasks, 0);
+        }
+        assert_eq!(stats[2].name, "worker");
+        assert_eq!(stats[2].completed_tasks, 6);
+        assert!(stats[2].throughput() > 0.0);
+
+        drop(evaluator);
+        assert_eq!(worker.join().unwrap().unwrap(), 6);
+    }
+}
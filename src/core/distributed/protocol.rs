@@ -0,0 +1,397 @@
+//! The binary messages exchanged between the coordinator and the workers. Each message is sent as
+//! a frame made of the payload length (`u32`, little-endian) followed by the payload. The first
+//! byte of the payload is the message tag; numbers are encoded in little-endian, while strings and
+//! vectors are prefixed by their length (`u32`).
+use std::io;
+use std::io::{ErrorKind, Read, Write};
+
+use crate::core::VariableValue;
+
+/// The maximum size of a frame. Larger frames are rejected to prevent allocating memory for a
+/// corrupted length.
+const MAX_FRAME_SIZE: usize = 64 * 1024 * 1024;
+
+/// A message sent by the coordinator to a worker.
+#[derive(Debug, PartialEq)]
+pub(crate) enum CoordinatorMessage {
+    /// Evaluate the individual with the given variable values, in the same order as the problem
+    /// variables.
+    Task {
+        /// The task identifier.
+        id: u64,
+        /// The variable values.
+        variables: Vec<VariableValue>,
+    },
+    /// Stop the worker.
+    Shutdown,
+}
+
+/// A message sent by a worker to the coordinator.
+#[derive(Debug, PartialEq)]
+pub(crate) enum WorkerMessage {
+    /// The first message sent after the connection with the worker name.
+    Hello {
+        /// The worker name.
+        name: String,
+    },
+    /// The worker is alive. This is sent periodically, also while evaluating a task.
+    Heartbeat,
+    /// The objective and constraint values of an evaluated task, in the same order as the problem
+    /// objectives and constraints.
+    Result {
+        /// The task identifier.
+        id: u64,
+        /// The objective values.
+        objectives: Vec<f64>,
+        /// The constraint values.
+        constraints: Vec<f64>,
+    },
+    /// The evaluation of a task failed.
+    Error {
+        /// The task identifier.
+        id: u64,
+        /// The error message.
+        message: String,
+    },
+}
+
+/// A message that can be sent in a frame.
+pub(crate) trait Message: Sized {
+    /// Append the message payload to the buffer.
+    ///
+    /// # Arguments
+    ///
+    /// * `buffer`: The buffer.
+    ///
+    /// returns: `()`
+    fn encode(&self, buffer: &mut Vec<u8>);
+
+    /// Decode the message from a payload.
+    ///
+    /// # Arguments
+    ///
+    /// * `decoder`: The decoder with the payload.
+    ///
+    /// returns: `io::Result<Self>`
+    fn decode(decoder: &mut Decoder) -> io::Result<Self>;
+}
+
+/// Append a string prefixed by its length.
+fn put_str(buffer: &mut Vec<u8>, value: &str) {
+    buffer.extend((value.len() as u32).to_le_bytes());
+    buffer.extend(value.as_bytes());
+}
+
+/// Append a vector of numbers prefixed by its length.
+fn put_f64s(buffer: &mut Vec<u8>, values: &[f64]) {
+    buffer.extend((values.len() as u32).to_le_bytes());
+    for value in values {
+        buffer.extend(value.to_le_bytes());
+    }
+}
+
+/// Read the values from a message payload.
+pub(crate) struct Decoder<'a> {
+    /// The payload.
+    payload: &'a [u8],
+}
+
+impl<'a> Decoder<'a> {
+    /// Take the next `n` bytes. This returns an error if the payload is too short.
+    fn take(&mut self, n: usize) -> io::Result<&'a [u8]> {
+        if self.payload.len() < n {
+            return Err(io::Error::new(
+                ErrorKind::InvalidData,
+                "The message is truncated",
+            ));
+        }
+        let (value, rest) = self.payload.split_at(n);
+        self.payload = rest;
+        Ok(value)
+    }
+
+    fn u8(&mut self) -> io::Result<u8> {
+        Ok(self.take(1)?[0])
+    }
+
+    fn u32(&mut self) -> io::Result<u32> {
+        Ok(u32::from_le_bytes(self.take(4)?.try_into().unwrap()))
+    }
+
+    fn u64(&mut self) -> io::Result<u64> {
+        Ok(u64::from_le_bytes(self.take(8)?.try_into().unwrap()))
+    }
+
+    fn f64(&mut self) -> io::Result<f64> {
+        Ok(f64::from_le_bytes(self.take(8)?.try_into().unwrap()))
+    }
+
+    fn str(&mut self) -> io::Result<String> {
+        let len = self.u32()? as usize;
+        String::from_utf8(self.take(len)?.to_vec())
+            .map_err(|e| io::Error::new(ErrorKind::InvalidData, e))
+    }
+
+    fn f64s(&mut self) -> io::Result<Vec<f64>> {
+        let len = self.u32()? as usize;
+        // prevent large allocations from a corrupted length
+        if len * 8 > self.payload.len() {
+            return Err(io::Error::new(
+                ErrorKind::InvalidData,
+                "The message is truncated",
+            ));
+        }
+        (0..len).map(|_| self.f64()).collect()
+    }
+}
+
+/// Create the error for an unknown message tag.
+fn unknown_tag(tag: u8) -> io::Error {
+    io::Error::new(
+        ErrorKind::InvalidData,
+        format!("The message tag {tag} is not valid"),
+    )
+}
+
+impl Message for CoordinatorMessage {
+    fn encode(&self, buffer: &mut Vec<u8>) {
+        match self {
+            CoordinatorMessage::Task { id, variables } => {
+                buffer.push(0);
+                buffer.extend(id.to_le_bytes());
+                buffer.extend((variables.len() as u32).to_le_bytes());
+                for value in variables {
+                    match value {
+                        VariableValue::Real(v) => {
+                            buffer.push(0);
+                            buffer.extend(v.to_le_bytes());
+                        }
+                        VariableValue::Integer(v) => {
+                            buffer.push(1);
+                            buffer.extend(v.to_le_bytes());
+                        }
+                        VariableValue::Boolean(v) => {
+                            buffer.push(2);
+                            buffer.push(*v as u8);
+                        }
+                        VariableValue::Choice(v) => {
+                            buffer.push(3);
+                            put_str(buffer, v);
+                        }
+                    }
+                }
+            }
+            CoordinatorMessage::Shutdown => buffer.push(1),
+        }
+    }
+
+    fn decode(decoder: &mut Decoder) -> io::Result<Self> {
+        match decoder.u8()? {
+            0 => {
+                let id = decoder.u64()?;
+                let len = decoder.u32()? as usize;
+                let mut variables = Vec::with_capacity(len.min(decoder.payload.len()));
+                for _ in 0..len {
+                    let value = match decoder.u8()? {
+                        0 => VariableValue::Real(decoder.f64()?),
+                        1 => VariableValue::Integer(decoder.u64()? as i64),
+                        2 => VariableValue::Boolean(decoder.u8()? != 0),
+                        3 => VariableValue::Choice(decoder.str()?),
+                        tag => return Err(unknown_tag(tag)),
+                    };
+                    variables.push(value);
+                }
+                Ok(CoordinatorMessage::Task { id, variables })
+            }
+            1 => Ok(CoordinatorMessage::Shutdown),
+            tag => Err(unknown_tag(tag)),
+        }
+    }
+}
+
+impl Message for WorkerMessage {
+    fn encode(&self, buffer: &mut Vec<u8>) {
+        match self {
+            WorkerMessage::Hello { name } => {
+                buffer.push(0);
+                put_str(buffer, name);
+            }
+            WorkerMessage::Heartbeat => buffer.push(1),
+            WorkerMessage::Result {
+                id,
+                objectives,
+                constraints,
+            } => {
+                buffer.push(2);
+                buffer.extend(id.to_le_bytes());
+                put_f64s(buffer, objectives);
+                put_f64s(buffer, constraints);
+            }
+            WorkerMessage::Error { id, message } => {
+                buffer.push(3);
+                buffer.extend(id.to_le_bytes());
+                put_str(buffer, message);
+            }
+        }
+    }
+
+    fn decode(decoder: &mut Decoder) -> io::Result<Self> {
+        match decoder.u8()? {
+            0 => Ok(WorkerMessage::Hello {
+                name: decoder.str()?,
+            }),
+            1 => Ok(WorkerMessage::Heartbeat),
+            2 => Ok(WorkerMessage::Result {
+                id: decoder.u64()?,
+                objectives: decoder.f64s()?,
+                constraints: decoder.f64s()?,
+            }),
+            3 => Ok(WorkerMessage::Error {
+                id: decoder.u64()?,
+                message: decoder.str()?,
+            }),
+            tag => Err(unknown_tag(tag)),
+        }
+    }
+}
+
+/// Send a message in a frame.
+///
+/// # Arguments
+///
+/// * `writer`: The stream to write to.
+/// * `message`: The message.
+///
+/// returns: `io::Result<()>`
+pub(crate) fn write_message<M: Message>(writer: &mut impl Write, message: &M) -> io::Result<()> {
+    // reserve the space for the length
+    let mut buffer = vec![0; 4];
+    message.encode(&mut buffer);
+    let len = (buffer.len() - 4) as u32;
+    buffer[..4].copy_from_slice(&len.to_le_bytes());
+    writer.write_all(&buffer)?;
+    writer.flush()
+}
+
+/// Read the next message. This blocks until a whole frame is received.
+///
+/// # Arguments
+///
+/// * `reader`: The stream to read from.
+///
+/// returns: `io::Result<Option<M>>`. `None` when the stream is closed before a new frame.
+pub(crate) fn read_message<M: Message>(reader: &mut impl Read) -> io::Result<Option<M>> {
+    let mut len = [0; 4];
+    match reader.read_exact(&mut len) {
+        Ok(()) => {}
+        Err(e) if e.kind() == ErrorKind::UnexpectedEof => return Ok(None),
+        Err(e) => return Err(e),
+    }
+    let len = u32::from_le_bytes(len) as usize;
+    if len > MAX_FRAME_SIZE {
+        return Err(io::Error::new(
+            ErrorKind::InvalidData,
+            format!("The frame size ({len} bytes) exceeds the maximum size"),
+        ));
+    }
+    let mut payload = vec![0; len];
+    reader.read_exact(&mut payload)?;
+
+    let mut decoder = Decoder { payload: &payload };
+    let message = M::decode(&mut decoder)?;
+    if !decoder.payload.is_empty() {
+        return Err(io::Error::new(
+            ErrorKind::InvalidData,
+            "The message has trailing bytes",
+        ));
+    }
+    Ok(Some(message))
+}
+
+#[cfg(test)]
+mod test {
+    use std::io::Cursor;
+
+    use crate::core::distributed::protocol::{
+        read_message, write_message, CoordinatorMessage, WorkerMessage,
+    };
+    use crate::core::VariableValue;
+
+    #[test]
+    /// The messages are decoded to the sent values.
+    fn test_round_trip() {
+        let mut stream: Vec<u8> = vec![];
+        let task = CoordinatorMessage::Task {
+            id: 7,
+            variables: vec![
+                VariableValue::Real(-0.5),
+                VariableValue::Integer(-3),
+                VariableValue::Boolean(true),
+                VariableValue::Choice("green".to_string()),
+            ],
+        };
+        write_message(&mut stream, &task).unwrap();
+        write_message(&mut stream, &CoordinatorMessage::Shutdown).unwrap();
+
+        let mut reader = Cursor::new(stream);
+        assert_eq!(
+            read_message::<CoordinatorMessage>(&mut reader).unwrap(),
+            Some(task)
+        );
+        assert_eq!(
+            read_message::<CoordinatorMessage>(&mut reader).unwrap(),
+            Some(CoordinatorMessage::Shutdown)
+        );
+        assert_eq!(
+            read_message::<CoordinatorMessage>(&mut reader).unwrap(),
+            None
+        );
+
+        let messages = vec![
+            WorkerMessage::Hello {
+                name: "node-1".to_string(),
+            },
+            WorkerMessage::Heartbeat,
+            WorkerMessage::Result {
+                id: 7,
+                objectives: vec![1.0, 2.5],
+                constraints: vec![],
+            },
+            WorkerMessage::Error {
+                id: 8,
+                message: "failed".to_string(),
+            },
+        ];
+        let mut stream: Vec<u8> = vec![];
+        for message in &messages {
+            write_message(&mut stream, message).unwrap();
+        }
+        let mut reader = Cursor::new(stream);
+        for message in messages {
+            assert_eq!(
+                read_message::<WorkerMessage>(&mut reader).unwrap(),
+                Some(message)
+            );
+        }
+    }
+
+    #[test]
+    /// Truncated and invalid frames return an error.
+    fn test_invalid_frames() {
+        let mut stream: Vec<u8> = vec![];
+        write_message(
+            &mut stream,
+            &WorkerMessage::Result {
+                id: 1,
+                objectives: vec![1.0],
+                constraints: vec![],
+            },
+        )
+        .unwrap();
+        stream.truncate(stream.len() - 2);
+        assert!(read_message::<WorkerMessage>(&mut Cursor::new(stream)).is_err());
+
+        let stream: Vec<u8> = vec![1, 0, 0, 0, 9];
+        assert!(read_message::<WorkerMessage>(&mut Cursor::new(stream)).is_err());
+    }
+}
@@ -0,0 +1,195 @@
+use std::io::BufReader;
+use std::net::{TcpStream, ToSocketAddrs};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Mutex};
+use std::thread;
+use std::time::Duration;
+
+use log::{debug, info, warn};
+
+use crate::core::distributed::protocol::{
+    read_message, write_message, CoordinatorMessage, WorkerMessage,
+};
+use crate::core::{Individual, OError, Problem, VariableValue};
+
+/// A worker process evaluating the individuals sent by a [`crate::core::DistributedEvaluator`].
+/// The worker must be created with the same problem (variables, objectives and constraints)
+/// used by the coordinator, and with the evaluator to run on the node. Each worker evaluates one
+/// individual at a time; start more workers on a node to run more evaluations at once.
+pub struct DistributedWorker {
+    /// The problem with the evaluator.
+    problem: Arc<Problem>,
+    /// The name of the worker sent to the coordinator.
+    name: String,
+    /// How often a heartbeat is sent to the coordinator.
+    heartbeat_interval: Duration,
+}
+
+impl DistributedWorker {
+    /// Create a new worker.
+    ///
+    /// # Arguments
+    ///
+    /// * `problem`: The problem to evaluate.
+    /// * `name`: The name of the worker used in the coordinator statistics (for example, the
+    ///    node name).
+    /// * `heartbeat_interval`: How often the worker tells the coordinator that it is alive. This
+    ///    must be shorter than [`crate::core::DistributedEvaluatorArgs::heartbeat_timeout`].
+    ///
+    /// returns: `DistributedWorker`
+    pub fn new(problem: Problem, name: &str, heartbeat_interval: Duration) -> Self {
+        Self {
+            problem: Arc::new(problem),
+            name: name.to_string(),
+            heartbeat_interval,
+        }
+    }
+
+    /// Connect to the coordinator and evaluate the received individuals until the coordinator
+    /// shuts down or closes the connection. This returns an error if the connection fails.
+    ///
+    /// # Arguments
+    ///
+    /// * `coordinator`: The address of the coordinator.
+    ///
+    /// returns: `Result<usize, OError>`. The number of evaluated individuals.
+    pub fn run(&self, coordinator: impl ToSocketAddrs) -> Result<usize, OError> {
+        let to_error = |e: std::io::Error| {
+            OError::DistributedEvaluation(format!(
+                "the connection with the coordinator failed: {e}"
+            ))
+        };
+        let stream = TcpStream::connect(coordinator).map_err(to_error)?;
+        let _ = stream.set_nodelay(true);
+        let mut reader = BufReader::new(stream.try_clone().map_err(to_error)?);
+        let writer = Arc::new(Mutex::new(stream));
+        write_message(
+            &mut *writer.lock().unwrap(),
+            &WorkerMessage::Hello {
+                name: self.name.clone(),
+            },
+        )
+        .map_err(to_error)?;
+        info!("Worker '{}' connected to the coordinator", self.name);
+
+        // send the heartbeats while the individuals are evaluated
+        let running = Arc::new(AtomicBool::new(true));
+        let heartbeat = {
+            let writer = writer.clone();
+            let running = running.clone();
+            let interval = self.heartbeat_interval;
+            thread::spawn(move || {
+                while running.load(Ordering::Relaxed) {
+                    thread::park_timeout(interval);
+                    if !running.load(Ordering::Relaxed) {
+                        break;
+                    }
+                    if write_message(&mut *writer.lock().unwrap(), &WorkerMessage::Heartbeat)
+                        .is_err()
+                    {
+                        break;
+                    }
+                }
+            })
+        };
+
+        let mut completed = 0;
+        let result = loop {
+            match read_message::<CoordinatorMessage>(&mut reader) {
+                Ok(Some(CoordinatorMessage::Task { id, variables })) => {
+                    debug!("Evaluating task #{id}");
+                    let message = match self.evaluate(&variables) {
+                        Ok((objectives, constraints)) => WorkerMessage::Result {
+                            id,
+                            objectives,
+                            constraints,
+                        },
+                        Err(e) => {
+                            warn!("The evaluation of task #{id} failed: {e}");
+                            WorkerMessage::Error {
+                                id,
+                                message: e.to_string(),
+                            }
+                        }
+                    };
+                    if let Err(e) = write_message(&mut *writer.lock().unwrap(), &message) {
+                        break Err(to_error(e));
+                    }
+                    completed += 1;
+                }
+                Ok(Some(CoordinatorMessage::Shutdown)) | Ok(None) => break Ok(completed),
+                Err(e) => break Err(to_error(e)),
+            }
+        };
+
+        running.store(false, Ordering::Relaxed);
+        heartbeat.thread().unpark();
+        let _ = heartbeat.join();
+        info!(
+            "Worker '{}' stopped after evaluating {} individuals",
+            self.name, completed
+        );
+        result
+    }
+
+    /// Evaluate an individual with the given variable values. This returns an error if the
+    /// values do not match the problem variables or the evaluation fails.
+    ///
+    /// # Arguments
+    ///
+    /// * `variables`: The variable values in the same order as the problem variables.
+    ///
+    /// returns: `Result<(Vec<f64>, Vec<f64>), OError>`. The objective and constraint values in
+    /// the same order as the problem objectives and constraints.
+    fn evaluate(&self, variables: &[VariableValue]) -> Result<(Vec<f64>, Vec<f64>), OError> {
+        let variable_names = self.problem.variable_names();
+        if variables.len() != variable_names.len() {
+            return Err(OError::Evaluation(format!(
+                "{} variables were received, but the problem has {} variables",
+                variables.len(),
+                variable_names.len()
+            )));
+        }
+        let mut individual = Individual::new(self.problem.clone());
+        for (name, value) in variable_names.iter().zip(variables) {
+            individual.update_variable(name, value.clone())?;
+        }
+
+        let results = self
+            .problem
+            .evaluator()
+            .evaluate(&individual)
+            .map_err(|e| OError::Evaluation(e.to_string()))?;
+        let objectives = self
+            .problem
+            .objective_list()
+            .iter()
+            .map(|o| {
+                results.objectives.get(o.name_ref()).copied().ok_or_else(|| {
+                    OError::Evaluation(format!(
+                        "The evaluation function did non return the value for the objective named '{}'",
+                        o.name_ref()
+                    ))
+                })
+            })
+            .collect::<Result<Vec<f64>, OError>>()?;
+        let constraints = self
+            .problem
+            .constraint_list()
+            .iter()
+            .map(|c| {
+                results
+                    .constraints
+                    .as_ref()
+                    .and_then(|values| values.get(c.name_ref()).copied())
+                    .ok_or_else(|| {
+                        OError::Evaluation(format!(
+                            "The evaluation function did non return the value for the constraints named '{}'",
+                            c.name_ref()
+                        ))
+                    })
+            })
+            .collect::<Result<Vec<f64>, OError>>()?;
+        Ok((objectives, constraints))
+    }
+}
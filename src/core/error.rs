@@ -41,6 +41,8 @@ pub enum OError {
     SurvivalOperator(String, String),
     #[error("An error occurred when evaluating a solution: {0}")]
     Evaluation(String),
+    #[error("An error occurred in the distributed evaluation: {0}")]
+    DistributedEvaluation(String),
     #[error("An error occurred in the calculation of the '{0}' metric: {1}")]
     Metric(String, String),
     #[error("An error occurred when initialising {0}: {1}")]
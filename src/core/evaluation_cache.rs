@@ -0,0 +1,526 @@
+use std::collections::{BTreeMap, HashMap};
+use std::fmt::{Debug, Formatter};
+use std::fs;
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::io::{BufReader, BufWriter, ErrorKind, Read, Write};
+use std::path::PathBuf;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+use std::sync::Mutex;
+
+use log::{debug, info};
+use serde::{Deserialize, Serialize};
+
+use crate::core::{Individual, OError, ObjectiveDirection, VariableValue};
+
+/// The maximum number of shards. Each shard has its own lock, so that the individuals can be
+/// looked up from multiple threads at the same time.
+const MAX_SHARDS: usize = 16;
+
+/// The identifier written at the beginning of the cache file.
+const FILE_MAGIC: &[u8; 8] = b"OPTCACHE";
+
+/// The version of the cache file format.
+const FILE_VERSION: u32 = 1;
+
+/// Options to configure the evaluation cache of a problem (see
+/// [`crate::core::Problem::set_evaluation_cache`]).
+#[derive(Serialize, Deserialize, Clone, Debug)]
+pub struct EvaluationCacheArgs {
+    /// The maximum number of evaluated solutions to store. The capacity is split between the
+    /// shards of the cache, and when a shard is full its least recently used solution is removed.
+    pub capacity: usize,
+    /// The optional file where the cache is stored, so that the evaluated solutions can be
+    /// reused when the algorithm is restarted. The cache is loaded from the file, if it exists,
+    /// and is saved when the history is exported and when the algorithm terminates.
+    pub file: Option<PathBuf>,
+}
+
+/// The counters of the evaluation cache.
+#[derive(Serialize, Deserialize, Clone, Debug, Default, PartialEq)]
+pub struct EvaluationCacheStats {
+    /// The number of individuals whose objectives and constraints were taken from the cache.
+    pub hits: usize,
+    /// The number of individuals that were not in the cache and were evaluated.
+    pub misses: usize,
+    /// The number of solutions removed because the cache was full.
+    pub evictions: usize,
+    /// The number of solutions in the cache.
+    pub size: usize,
+}
+
+/// The objective and constraint values of a cached solution.
+struct CacheEntry {
+    /// The objective values returned by the evaluator.
+    objectives: Vec<f64>,
+    /// The constraint values returned by the evaluator.
+    constraints: Vec<f64>,
+    /// When the entry was last used.
+    last_used: u64,
+}
+
+/// A part of the cache with its own lock.
+#[derive(Default)]
+struct Shard {
+    /// The entries by key.
+    entries: HashMap<Vec<u8>, CacheEntry>,
+    /// The keys sorted by the last time they were used.
+    usage: BTreeMap<u64, Vec<u8>>,
+}
+
+/// A cache with the objective and constraint values of the evaluated solutions, keyed on the
+/// decision variables. When an offspring has the same variables as a solution evaluated before
+/// (which is common with integer, boolean and choice variables or when the mutation probability
+/// is low), it gets the cached values and the evaluator is not called. The cache has a maximum
+/// size and removes the least recently used solutions first.
+///
+/// The variables are compared exactly (`-0.0` and `0.0` are considered equal). Individuals
+/// taken from the cache still count as function evaluations in the algorithms, so that the
+/// stopping conditions do not depend on the cache; the number of calls to the evaluator is the
+/// number of cache misses in [`EvaluationCacheStats`].
+pub struct EvaluationCache {
+    /// The shards.
+    shards: Vec<Mutex<Shard>>,
+    /// The maximum number of entries in each shard.
+    shard_capacity: usize,
+    /// The counter used to track when an entry is used.
+    clock: AtomicU64,
+    /// The number of hits.
+    hits: AtomicUsize,
+    /// The number of misses.
+    misses: AtomicUsize,
+    /// The number of evictions.
+    evictions: AtomicUsize,
+    /// The file where the cache is saved.
+    file: Option<PathBuf>,
+    /// The number of objectives and constraints of each entry.
+    sizes: (usize, usize),
+}
+
+impl EvaluationCache {
+    /// Create a new cache. When a file is given and exists, the cache is loaded from it. This
+    /// returns an error if the capacity is 0 or the file cannot be read or was created for a
+    /// problem with a different number of objectives or constraints.
+    ///
+    /// # Arguments
+    ///
+    /// * `options`: The cache options.
+    /// * `number_of_objectives`: The number of problem objectives.
+    /// * `number_of_constraints`: The number of problem constraints.
+    ///
+    /// returns: `Result<EvaluationCache, OError>`
+    pub(crate) fn new(
+        options: EvaluationCacheArgs,
+        number_of_objectives: usize,
+        number_of_constraints: usize,
+    ) -> Result<Self, OError> {
+        if options.capacity == 0 {
+            return Err(OError::Generic(
+                "The capacity of the evaluation cache must be at least 1".to_string(),
+            ));
+        }
+        let number_of_shards = options.capacity.min(MAX_SHARDS);
+        let cache = Self {
+            shards: (0..number_of_shards)
+                .map(|_| Mutex::new(Shard::default()))
+                .collect(),
+            shard_capacity: options.capacity.div_ceil(number_of_shards),
+            clock: AtomicU64::new(0),
+            hits: AtomicUsize::new(0),
+            misses: AtomicUsize::new(0),
+            evictions: AtomicUsize::new(0),
+            file: options.file,
+            sizes: (number_of_objectives, number_of_constraints),
+        };
+        if let Some(file) = &cache.file {
+            if file.exists() {
+                cache.load(file)?;
+            }
+        }
+        Ok(cache)
+    }
+
+    /// Build the key of a solution from its variable values. Each value is encoded with a tag
+    /// and its bytes, so that different types never produce the same key.
+    ///
+    /// # Arguments
+    ///
+    /// * `values`: The variable values.
+    ///
+    /// returns: `Vec<u8>`
+    pub(crate) fn key(values: &[VariableValue]) -> Vec<u8> {
+        let mut key = Vec::with_capacity(values.len() * 9);
+        for value in values {
+            match value {
+                VariableValue::Real(v) => {
+                    key.push(0);
+                    // use the same bits for 0.0 and -0.0
+                    let v = if *v == 0.0 { 0.0 } else { *v };
+                    key.extend(v.to_bits().to_le_bytes());
+                }
+                VariableValue::Integer(v) => {
+                    key.push(1);
+                    key.extend(v.to_le_bytes());
+                }
+                VariableValue::Boolean(v) => {
+                    key.push(2);
+                    key.push(*v as u8);
+                }
+                VariableValue::Choice(v) => {
+                    key.push(3);
+                    key.extend((v.len() as u32).to_le_bytes());
+                    key.extend(v.as_bytes());
+                }
+            }
+        }
+        key
+    }
+
+    /// Get the shard where a key is stored.
+    ///
+    /// # Arguments
+    ///
+    /// * `key`: The key.
+    ///
+    /// returns: `&Mutex<Shard>`
+    fn shard(&self, key: &[u8]) -> &Mutex<Shard> {
+        let mut hasher = DefaultHasher::new();
+        key.hash(&mut hasher);
+        &self.shards[hasher.finish() as usize % self.shards.len()]
+    }
+
+    /// Get the objective and constraint values of a solution and mark it as recently used. This
+    /// updates the hit and miss counters.
+    ///
+    /// # Arguments
+    ///
+    /// * `key`: The solution key from [`EvaluationCache::key`].
+    ///
+    /// returns: `Option<(Vec<f64>, Vec<f64>)>`. The objective and constraint values, as returned
+    /// by the evaluator.
+    pub(crate) fn get(&self, key: &[u8]) -> Option<(Vec<f64>, Vec<f64>)> {
+        let mut shard = self.shard(key).lock().unwrap();
+        let shard = &mut *shard;
+        let Some(entry) = shard.entries.get_mut(key) else {
+            self.misses.fetch_add(1, Ordering::Relaxed);
+            return None;
+        };
+        self.hits.fetch_add(1, Ordering::Relaxed);
+
+        let now = self.clock.fetch_add(1, Ordering::Relaxed);
+        if let Some(key) = shard.usage.remove(&entry.last_used) {
+            shard.usage.insert(now, key);
+        }
+        entry.last_used = now;
+        Some((entry.objectives.clone(), entry.constraints.clone()))
+    }
+
+    /// Store the objective and constraint values of a solution. When the cache is full, the
+    /// least recently used solution is removed.
+    ///
+    /// # Arguments
+    ///
+    /// * `key`: The solution key from [`EvaluationCache::key`].
+    /// * `objectives`: The objective values returned by the evaluator.
+    /// * `constraints`: The constraint values returned by the evaluator.
+    ///
+    /// returns: `()`
+    pub(crate) fn insert(&self, key: Vec<u8>, objectives: Vec<f64>, constraints: Vec<f64>) {
+        let mut shard = self.shard(&key).lock().unwrap();
+        let now = self.clock.fetch_add(1, Ordering::Relaxed);
+        if let Some(old) = shard.entries.remove(&key) {
+            shard.usage.remove(&old.last_used);
+        } else if shard.entries.len() >= self.shard_capacity {
+            if let Some((_, oldest)) = shard.usage.pop_first() {
+                shard.entries.remove(&oldest);
+                self.evictions.fetch_add(1, Ordering::Relaxed);
+            }
+        }
+        shard.usage.insert(now, key.clone());
+        shard.entries.insert(
+            key,
+            CacheEntry {
+                objectives,
+                constraints,
+                last_used: now,
+            },
+        );
+    }
+
+    /// Store the objective and constraint values of an evaluated individual.
+    ///
+    /// # Arguments
+    ///
+    /// * `individual`: The individual.
+    ///
+    /// returns: `()`
+    pub(crate) fn insert_individual(&self, individual: &Individual) {
+        let problem = individual.problem();
+        // the individual stores the maximised objectives with the opposite sign
+        let objectives = problem
+            .objective_list()
+            .iter()
+            .zip(individual.objective_values_slice())
+            .map(|(o, v)| match o.direction() {
+                ObjectiveDirection::Minimise => *v,
+                ObjectiveDirection::Maximise => -v,
+            })
+            .collect();
+        self.insert(
+            Self::key(individual.variable_values_slice()),
+            objectives,
+            individual.constraint_values_slice().to_vec(),
+        );
+    }
+
+    /// Get the number of solutions in the cache.
+    ///
+    /// returns: `usize`
+    pub fn len(&self) -> usize {
+        self.shards
+            .iter()
+            .map(|s| s.lock().unwrap().entries.len())
+            .sum()
+    }
+
+    /// Whether the cache is empty.
+    ///
+    /// returns: `bool`
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Get the cache counters.
+    ///
+    /// returns: `EvaluationCacheStats`
+    pub fn stats(&self) -> EvaluationCacheStats {
+        EvaluationCacheStats {
+            hits: self.hits.load(Ordering::Relaxed),
+            misses: self.misses.load(Ordering::Relaxed),
+            evictions: self.evictions.load(Ordering::Relaxed),
+            size: self.len(),
+        }
+    }
+
+    /// Save the cache to the file given in [`EvaluationCacheArgs::file`]. The solutions are
+    /// written from the least to the most recently used, so that the order is preserved when the
+    /// file is loaded. This does nothing if no file was given.
+    ///
+    /// returns: `Result<(), OError>`
+    pub fn save(&self) -> Result<(), OError> {
+        let Some(file) = &self.file else {
+            return Ok(());
+        };
+        let to_error = |e: std::io::Error| OError::File(file.clone(), e.to_string());
+
+        // collect the entries in order of use
+        let mut entries: Vec<(u64, Vec<u8>, Vec<f64>, Vec<f64>)> = vec![];
+        for shard in &self.shards {
+            let shard = shard.lock().unwrap();
+            entries.extend(shard.entries.iter().map(|(key, entry)| {
+                (
+                    entry.last_used,
+                    key.clone(),
+                    entry.objectives.clone(),
+                    entry.constraints.clone(),
+                )
+            }));
+        }
+        entries.sort_by_key(|(last_used, ..)| *last_used);
+
+        // write to a temporary file first, to keep the previous file if the export fails
+        let mut temp_file = file.clone().into_os_string();
+        temp_file.push(".tmp");
+        let temp_file = PathBuf::from(temp_file);
+        let mut writer = BufWriter::new(fs::File::create(&temp_file).map_err(to_error)?);
+        writer.write_all(FILE_MAGIC).map_err(to_error)?;
+        for number in [
+            FILE_VERSION,
+            self.sizes.0 as u32,
+            self.sizes.1 as u32,
+            entries.len() as u32,
+        ] {
+            writer.write_all(&number.to_le_bytes()).map_err(to_error)?;
+        }
+        for (_, key, objectives, constraints) in &entries {
+            writer
+                .write_all(&(key.len() as u32).to_le_bytes())
+                .map_err(to_error)?;
+            writer.write_all(key).map_err(to_error)?;
+            for value in objectives.iter().chain(constraints) {
+                writer.write_all(&value.to_le_bytes()).map_err(to_error)?;
+            }
+        }
+        writer.flush().map_err(to_error)?;
+        drop(writer);
+        fs::rename(&temp_file, file).map_err(to_error)?;
+
+        info!("Saved {} evaluated solutions to {:?}", entries.len(), file);
+        Ok(())
+    }
+
+    /// Load the solutions from a file exported with [`EvaluationCache::save`].
+    ///
+    /// # Arguments
+    ///
+    /// * `file`: The file.
+    ///
+    /// returns: `Result<(), OError>`
+    fn load(&self, file: &PathBuf) -> Result<(), OError> {
+        let to_error = |e: std::io::Error| {
+            let message = match e.kind() {
+                ErrorKind::UnexpectedEof => "the evaluation cache file is truncated".to_string(),
+                _ => e.to_string(),
+            };
+            OError::File(file.clone(), message)
+        };
+        let mut reader = BufReader::new(fs::File::open(file).map_err(to_error)?);
+
+        let read_u32 = |reader: &mut BufReader<fs::File>| -> Result<u32, OError> {
+            let mut bytes = [0; 4];
+            reader.read_exact(&mut bytes).map_err(to_error)?;
+            Ok(u32::from_le_bytes(bytes))
+        };
+
+        let mut magic = [0; 8];
+        reader.read_exact(&mut magic).map_err(to_error)?;
+        let mut header = [0; 4];
+        for value in header.iter_mut() {
+            *value = read_u32(&mut reader)?;
+        }
+        if &magic != FILE_MAGIC || header[0] != FILE_VERSION {
+            return Err(OError::File(
+                file.clone(),
+                "the file is not a valid evaluation cache".to_string(),
+            ));
+        }
+        if (header[1] as usize, header[2] as usize) != self.sizes {
+            return Err(OError::File(
+                file.clone(),
+                format!(
+                    "the evaluation cache has {} objectives and {} constraints, but the problem \
+                    has {} objectives and {} constraints",
+                    header[1], header[2], self.sizes.0, self.sizes.1
+                ),
+            ));
+        }
+
+        for _ in 0..header[3] {
+            let key_len = read_u32(&mut reader)? as usize;
+            let mut key = vec![0; key_len];
+            reader.read_exact(&mut key).map_err(to_error)?;
+            let mut values = vec![0.0; self.sizes.0 + self.sizes.1];
+            for value in values.iter_mut() {
+                let mut bytes = [0; 8];
+                reader.read_exact(&mut bytes).map_err(to_error)?;
+                *value = f64::from_le_bytes(bytes);
+            }
+            let constraints = values.split_off(self.sizes.0);
+            self.insert(key, values, constraints);
+        }
+        debug!("Loaded {} evaluated solutions from {:?}", header[3], file);
+        Ok(())
+    }
+}
+
+impl Debug for EvaluationCache {
+    fn fmt(&self, f: &mut Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("EvaluationCache")
+            .field("file", &self.file)
+            .field("stats", &self.stats())
+            .finish()
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use std::env;
+
+    use crate::core::evaluation_cache::{EvaluationCache, EvaluationCacheArgs};
+    use crate::core::VariableValue;
+
+    #[test]
+    /// The values with different types or signed zeros give the expected keys.
+    fn test_key() {
+        let key = |values: &[VariableValue]| EvaluationCache::key(values);
+        assert_eq!(
+            key(&[VariableValue::Real(0.0)]),
+            key(&[VariableValue::Real(-0.0)])
+        );
+        assert_ne!(
+            key(&[VariableValue::Real(1.0)]),
+            key(&[VariableValue::Integer(1.0_f64.to_bits() as i64)])
+        );
+        assert_ne!(
+            key(&[
+                VariableValue::Choice("ab".to_string()),
+                VariableValue::Choice("c".to_string())
+            ]),
+            key(&[
+                VariableValue::Choice("a".to_string()),
+                VariableValue::Choice("bc".to_string())
+            ])
+        );
+    }
+
+    #[test]
+    /// The least recently used solution is removed and the counters are updated.
+    fn test_lru() {
+        let options = EvaluationCacheArgs {
+            capacity: 1,
+            file: None,
+        };
+        let cache = EvaluationCache::new(options, 1, 0).unwrap();
+        let a = EvaluationCache::key(&[VariableValue::Integer(1)]);
+        let b = EvaluationCache::key(&[VariableValue::Integer(2)]);
+
+        assert_eq!(cache.get(&a), None);
+        cache.insert(a.clone(), vec![1.0], vec![]);
+        assert_eq!(cache.get(&a), Some((vec![1.0], vec![])));
+        cache.insert(b.clone(), vec![2.0], vec![]);
+        assert_eq!(cache.get(&a), None);
+        assert_eq!(cache.get(&b), Some((vec![2.0], vec![])));
+
+        let stats = cache.stats();
+        assert_eq!(stats.hits, 2);
+        assert_eq!(stats.misses, 2);
+        assert_eq!(stats.evictions, 1);
+        assert_eq!(stats.size, 1);
+    }
+
+    #[test]
+    /// The solutions are loaded from the saved file.
+    fn test_persistence() {
+        let file = env::temp_dir().join("optirustic_evaluation_cache_test.bin");
+        let _ = std::fs::remove_file(&file);
+        let options = EvaluationCacheArgs {
+            capacity: 100,
+            file: Some(file.clone()),
+        };
+        let keys: Vec<Vec<u8>> = (0..50)
+            .map(|i| EvaluationCache::key(&[VariableValue::Integer(i)]))
+            .collect();
+
+        let cache = EvaluationCache::new(options.clone(), 2, 1).unwrap();
+        for (i, key) in keys.iter().enumerate() {
+            cache.insert(key.clone(), vec![i as f64, -(i as f64)], vec![0.5]);
+        }
+        cache.save().unwrap();
+
+        let loaded = EvaluationCache::new(options, 2, 1).unwrap();
+        assert_eq!(loaded.len(), 50);
+        for (i, key) in keys.iter().enumerate() {
+            assert_eq!(
+                loaded.get(key),
+                Some((vec![i as f64, -(i as f64)], vec![0.5]))
+            );
+        }
+
+        // the problem must match
+        let options = EvaluationCacheArgs {
+            capacity: 100,
+            file: Some(file.clone()),
+        };
+        assert!(EvaluationCache::new(options, 2, 0).is_err());
+        std::fs::remove_file(&file).unwrap();
+    }
+}
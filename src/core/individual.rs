@@ -5,12 +5,19 @@ use std::sync::Arc;
 
 use serde::{Deserialize, Serialize};
 
-use crate::core::{DataValue, OError, Problem, VariableValue};
-use crate::utils::hasmap_eq_with_nans;
+use crate::core::{DataValue, OError, ObjectiveDirection, Problem, VariableValue};
+use crate::utils::vector_eq_with_nans;
 
 /// An individual in the population containing the problem solution, and the objective and
 /// constraint values.
 ///
+/// The variable, objective and constraint values are stored in contiguous vectors, in the same
+/// order as the names returned by [`Problem::variable_names`], [`Problem::objective_names`] and
+/// [`Problem::constraint_names`]. Values can be accessed by name, which is resolved to its index
+/// using the problem, or directly with the slices returned by
+/// [`Individual::variable_values_slice`], [`Individual::objective_values_slice`] and
+/// [`Individual::constraint_values_slice`], which do not require any lookup.
+///
 /// # Example
 /// ```
 /// use std::error::Error;
@@ -48,19 +55,21 @@ use crate::utils::hasmap_eq_with_nans;
 pub struct Individual {
     /// The problem being solved
     problem: Arc<Problem>,
-    /// The value of the problem variables for the individual.
-    variable_values: HashMap<String, VariableValue>,
-    /// The value of the constraints.
-    constraint_values: HashMap<String, f64>,
-    /// The values of the objectives.
-    objective_values: HashMap<String, f64>,
+    /// The value of the problem variables for the individual, ordered as the problem variables.
+    variable_values: Vec<VariableValue>,
+    /// The value of the constraints, ordered as the problem constraints.
+    constraint_values: Vec<f64>,
+    /// The values of the objectives, ordered as the problem objectives.
+    objective_values: Vec<f64>,
     /// Whether the individual has been evaluated and the problem constraint and objective values
     /// are available. When an individual is created with some variables after the population
     /// evolves, constraints and objectives need to be evaluated using a user-defined function.
     evaluated: bool,
     /// Additional numeric data to store for the individuals (such as crowding distance or rank)
-    /// depending on the algorithm the individuals are derived from.
-    data: HashMap<String, DataValue>,
+    /// depending on the algorithm the individuals are derived from. Because only a few items are
+    /// stored, these are kept in a vector of name and value pairs, which is faster to search than
+    /// a hash map.
+    data: Vec<(String, DataValue)>,
 }
 
 impl PartialEq for Individual {
@@ -73,9 +82,13 @@ impl PartialEq for Individual {
     /// returns: `bool`
     fn eq(&self, other: &Self) -> bool {
         self.variable_values == other.variable_values
-            && hasmap_eq_with_nans(&self.constraint_values, &other.constraint_values)
-            && hasmap_eq_with_nans(&self.objective_values, &other.objective_values)
-            && self.data == other.data
+            && vector_eq_with_nans(&self.constraint_values, &other.constraint_values)
+            && vector_eq_with_nans(&self.objective_values, &other.objective_values)
+            && self.data.len() == other.data.len()
+            && self
+                .data
+                .iter()
+                .all(|(name, value)| other.data.iter().any(|(n, v)| n == name && v == value))
     }
 }
 
@@ -104,7 +117,9 @@ impl Display for Individual {
         write!(
             f,
             "Individual(variables={:?}, objectives={:?},constraints={:?})",
-            self.variable_values, self.objective_values, self.constraint_values,
+            self.variables(),
+            self.objectives(),
+            self.constraints(),
         )
     }
 }
@@ -118,20 +133,13 @@ impl Individual {
     ///
     /// returns: `Individual`
     pub fn new(problem: Arc<Problem>) -> Self {
-        let mut variable_values: HashMap<String, VariableValue> = HashMap::new();
-        for (variable_name, var_type) in problem.variables() {
-            variable_values.insert(variable_name, var_type.generate_random_value());
-        }
-
-        let mut objective_values: HashMap<String, f64> = HashMap::new();
-        for objective_name in problem.objective_names() {
-            objective_values.insert(objective_name, f64::NAN);
-        }
-
-        let mut constraint_values: HashMap<String, f64> = HashMap::new();
-        for constraint_name in problem.constraint_names() {
-            constraint_values.insert(constraint_name, f64::NAN);
-        }
+        let variable_values = problem
+            .variable_list()
+            .iter()
+            .map(|var_type| var_type.generate_random_value())
+            .collect();
+        let objective_values = vec![f64::NAN; problem.number_of_objectives()];
+        let constraint_values = vec![f64::NAN; problem.number_of_constraints()];
 
         Self {
             problem,
@@ -139,7 +147,7 @@ impl Individual {
             constraint_values,
             objective_values,
             evaluated: false,
-            data: HashMap::new(),
+            data: Vec::new(),
         }
     }
 
@@ -155,12 +163,31 @@ impl Individual {
     /// return: `Individual`
     pub(crate) fn clone_variables(&self) -> Self {
         let mut i = Self::new(self.problem.clone());
-        for (var_name, var_value) in self.variable_values.iter() {
-            i.update_variable(var_name, var_value.clone()).unwrap()
-        }
+        // the values were already validated against the variable types
+        i.variable_values.clone_from(&self.variable_values);
         i
     }
 
+    /// Clone an individual and assign it to another problem with the same variables, objectives
+    /// and constraints. This is used to move an individual between two algorithms solving the same
+    /// problem, for example in the [`crate::algorithms::IslandModel`].
+    ///
+    /// # Arguments
+    ///
+    /// * `problem`: The problem the new individual belongs to.
+    ///
+    /// return: `Individual`
+    pub(crate) fn with_problem(&self, problem: Arc<Problem>) -> Self {
+        Self {
+            problem,
+            variable_values: self.variable_values.clone(),
+            constraint_values: self.constraint_values.clone(),
+            objective_values: self.objective_values.clone(),
+            evaluated: self.evaluated,
+            data: self.data.clone(),
+        }
+    }
+
     /// Update the variable for a solution. This returns an error if the variable name does not
     /// exist or the variable value does not match the variable type set on the problem (for
     /// example [`VariableValue::Integer`] is provided but the type is [`crate::core::VariableType::Real`]).
@@ -172,18 +199,11 @@ impl Individual {
     ///
     /// returns: `Result<(), OError>`
     pub fn update_variable(&mut self, name: &str, value: VariableValue) -> Result<(), OError> {
-        if !self.variable_values.contains_key(name) {
-            return Err(OError::NonExistingName(
-                "variable".to_string(),
-                name.to_string(),
-            ));
-        }
-        if !value.match_type(name, self.problem.clone())? {
+        let index = self.problem.variable_index(name)?;
+        if !value.match_variable_type(&self.problem.variable_list()[index]) {
             return Err(OError::NonMatchingVariableType(name.to_string()));
         }
-        if let Some(x) = self.variable_values.get_mut(name) {
-            *x = value;
-        }
+        self.variable_values[index] = value;
         Ok(())
     }
 
@@ -197,24 +217,17 @@ impl Individual {
     ///
     /// returns: `Result<(), OError>`
     pub fn update_objective(&mut self, name: &str, value: f64) -> Result<(), OError> {
-        if !self.objective_values.contains_key(name) {
-            return Err(OError::NonExistingName(
-                "objective".to_string(),
-                name.to_string(),
-            ));
-        }
+        let index = self.problem.objective_index(name)?;
         if value.is_nan() {
             return Err(OError::NaN("objective".to_string(), name.to_string()));
         }
 
         // invert the sign for maximisation problems
-        let sign = match self.problem.is_objective_minimised(name)? {
-            true => 1.0,
-            false => -1.0,
+        let sign = match self.problem.objective_list()[index].direction() {
+            ObjectiveDirection::Minimise => 1.0,
+            ObjectiveDirection::Maximise => -1.0,
         };
-        if let Some(x) = self.objective_values.get_mut(name) {
-            *x = sign * value;
-        }
+        self.objective_values[index] = sign * value;
         Ok(())
     }
 
@@ -227,74 +240,154 @@ impl Individual {
     ///
     /// returns: `Result<(), OError>`
     pub(crate) fn update_constraint(&mut self, name: &str, value: f64) -> Result<(), OError> {
-        if !self.constraint_values.contains_key(name) {
-            return Err(OError::NonExistingName(
-                "constrain".to_string(),
-                name.to_string(),
-            ));
-        }
+        let index = self.problem.constraint_index(name)?;
         if value.is_nan() {
             return Err(OError::NaN("constraint".to_string(), name.to_string()));
         }
-        if let Some(x) = self.constraint_values.get_mut(name) {
-            *x = value;
+        self.constraint_values[index] = value;
+        Ok(())
+    }
+
+    /// Update all the objectives for a solution. The values are saved as negative for the
+    /// objectives being maximised. This returns an error if the number of values does not match
+    /// the number of objectives or a value is NaN.
+    ///
+    /// # Arguments
+    ///
+    /// * `values`: The values to set, in the same order as [`Problem::objective_names`].
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn update_objective_values(&mut self, values: &[f64]) -> Result<(), OError> {
+        if values.len() != self.objective_values.len() {
+            return Err(OError::Evaluation(format!(
+                "{} objective values were given, but the problem has {} objectives",
+                values.len(),
+                self.objective_values.len()
+            )));
+        }
+        for ((objective, stored), value) in self
+            .problem
+            .objective_list()
+            .iter()
+            .zip(self.objective_values.iter_mut())
+            .zip(values)
+        {
+            if value.is_nan() {
+                return Err(OError::NaN("objective".to_string(), objective.name()));
+            }
+            *stored = match objective.direction() {
+                ObjectiveDirection::Minimise => *value,
+                ObjectiveDirection::Maximise => -value,
+            };
         }
         Ok(())
     }
 
+    /// Update all the constraints for a solution. This returns an error if the number of values
+    /// does not match the number of constraints or a value is NaN.
+    ///
+    /// # Arguments
+    ///
+    /// * `values`: The values to set, in the same order as [`Problem::constraint_names`].
+    ///
+    /// returns: `Result<(), OError>`
+    pub(crate) fn update_constraint_values(&mut self, values: &[f64]) -> Result<(), OError> {
+        if values.len() != self.constraint_values.len() {
+            return Err(OError::Evaluation(format!(
+                "{} constraint values were given, but the problem has {} constraints",
+                values.len(),
+                self.constraint_values.len()
+            )));
+        }
+        if let Some(i) = values.iter().position(|v| v.is_nan()) {
+            return Err(OError::NaN(
+                "constraint".to_string(),
+                self.problem.constraint_list()[i].name(),
+            ));
+        }
+        self.constraint_values.copy_from_slice(values);
+        Ok(())
+    }
+
     /// Calculate the overall amount of violation of the solution constraints. This is a measure
     /// about how close (or far) the individual meets the constraints. If the solution is feasible,
     /// then the violation is 0.0. Otherwise, a positive number is returned.
     ///
     /// return: `f64`
     pub fn constraint_violation(&self) -> f64 {
-        return self
-            .problem
-            .constraints()
+        self.problem
+            .constraint_list()
             .iter()
-            .map(|(name, c)| c.constraint_violation(self.constraint_values[name]))
-            .sum();
+            .zip(self.constraint_values.iter())
+            .map(|(c, value)| c.constraint_violation(*value))
+            .sum()
     }
 
     /// Return whether the solution meets all the problem constraints.
     ///
     /// return: `bool`
     pub fn is_feasible(&self) -> bool {
-        for (name, constraint_value) in self.constraint_values.iter() {
-            if !self.problem.constraint_names().contains(name) {
-                continue;
-            }
-            if !self
-                .problem
-                .get_constraint(name)
-                .unwrap()
-                .is_met(*constraint_value)
-            {
-                return false;
-            }
-        }
-        true
+        self.problem
+            .constraint_list()
+            .iter()
+            .zip(self.constraint_values.iter())
+            .all(|(c, value)| c.is_met(*value))
     }
 
     /// Ge all the variables.
     ///
     /// returns: `HashMap<String, VariableValue>`
     pub fn variables(&self) -> HashMap<String, VariableValue> {
-        self.variable_values.clone()
+        self.problem
+            .variable_names()
+            .into_iter()
+            .zip(self.variable_values.iter().cloned())
+            .collect()
     }
 
     /// Get all the constraints.
     ///
     /// returns: `HashMap<String, f64>`
     pub fn constraints(&self) -> HashMap<String, f64> {
-        self.constraint_values.clone()
+        self.problem
+            .constraint_names()
+            .into_iter()
+            .zip(self.constraint_values.iter().copied())
+            .collect()
     }
 
     /// Get all the objectives.
     ///
     /// returns: `HashMap<String, f64>`
     pub fn objectives(&self) -> HashMap<String, f64> {
-        self.objective_values.clone()
+        self.problem
+            .objective_names()
+            .into_iter()
+            .zip(self.objective_values.iter().copied())
+            .collect()
+    }
+
+    /// Get the variable values, in the same order as [`Problem::variable_names`].
+    ///
+    /// returns: `&[VariableValue]`
+    pub fn variable_values_slice(&self) -> &[VariableValue] {
+        &self.variable_values
+    }
+
+    /// Get the constraint values, in the same order as [`Problem::constraint_names`].
+    ///
+    /// returns: `&[f64]`
+    pub fn constraint_values_slice(&self) -> &[f64] {
+        &self.constraint_values
+    }
+
+    /// Get the objective values, in the same order as [`Problem::objective_names`]. As for
+    /// [`Individual::get_objective_value`], the values of maximised objectives are stored with
+    /// the opposite sign.
+    ///
+    /// returns: `&[f64]`
+    pub fn objective_values_slice(&self) -> &[f64] {
+        &self.objective_values
     }
 
     /// Ge the variable value by name. This return an error if the variable name does not exist.
@@ -305,25 +398,15 @@ impl Individual {
     ///
     /// returns: `Result<&VariableValue, OError>`
     pub fn get_variable_value(&self, name: &str) -> Result<&VariableValue, OError> {
-        if !self.variable_values.contains_key(name) {
-            return Err(OError::NonExistingName(
-                "variable".to_string(),
-                name.to_string(),
-            ));
-        }
-
-        Ok(&self.variable_values[name])
+        let index = self.problem.variable_index(name)?;
+        Ok(&self.variable_values[index])
     }
 
     /// Get the vector with the variable values for the individual.
     ///
     /// returns: `Result<Vec<&VariableValue>, OError>`
     pub fn get_variable_values(&self) -> Result<Vec<&VariableValue>, OError> {
-        self.problem
-            .variable_names()
-            .iter()
-            .map(|var_name| self.get_variable_value(var_name))
-            .collect()
+        Ok(self.variable_values.iter().collect())
     }
 
     /// Get the constraint value by name. This return an error if the constraint name does not exist.
@@ -334,14 +417,8 @@ impl Individual {
     ///
     /// returns: `Result<f64, OError>`
     pub fn get_constraint_value(&self, name: &str) -> Result<f64, OError> {
-        if !self.constraint_values.contains_key(name) {
-            return Err(OError::NonExistingName(
-                "constraint".to_string(),
-                name.to_string(),
-            ));
-        }
-
-        Ok(self.constraint_values[name])
+        let index = self.problem.constraint_index(name)?;
+        Ok(self.constraint_values[index])
     }
 
     /// Get the number stored in a real variable by name. This returns an error if the variable
@@ -380,14 +457,8 @@ impl Individual {
     ///
     /// returns: `Result<f64, OError>`
     pub fn get_objective_value(&self, name: &str) -> Result<f64, OError> {
-        if !self.objective_values.contains_key(name) {
-            return Err(OError::NonExistingName(
-                "objective".to_string(),
-                name.to_string(),
-            ));
-        }
-
-        Ok(self.objective_values[name])
+        let index = self.problem.objective_index(name)?;
+        Ok(self.objective_values[index])
     }
 
     /// Ge the vector with the objective values for the individual. The size of the vector will
@@ -395,11 +466,7 @@ impl Individual {
     ///
     /// returns: `Result<Vec<f64>, OError>`
     pub fn get_objective_values(&self) -> Result<Vec<f64>, OError> {
-        self.problem
-            .objective_names()
-            .iter()
-            .map(|obj_name| self.get_objective_value(obj_name))
-            .collect()
+        Ok(self.objective_values.clone())
     }
 
     /// Ge the vector with the objective values for the individual and transform their value using
@@ -417,11 +484,9 @@ impl Individual {
     ) -> Result<Vec<f64>, OError> {
         self.problem
             .objective_names()
-            .iter()
-            .map(|obj_name| {
-                let val = self.get_objective_value(obj_name)?;
-                transform(val, obj_name.clone())
-            })
+            .into_iter()
+            .zip(self.objective_values.iter())
+            .map(|(obj_name, val)| transform(*val, obj_name))
             .collect()
     }
 
@@ -442,7 +507,7 @@ impl Individual {
     ///
     /// returns: `HashMap<String, DataValue>`
     pub fn data(&self) -> HashMap<String, DataValue> {
-        self.data.clone()
+        self.data.iter().cloned().collect()
     }
 
     /// Store custom data on the individual.
@@ -454,7 +519,10 @@ impl Individual {
     ///
     /// returns: `()`.
     pub fn set_data(&mut self, name: &str, value: DataValue) {
-        self.data.insert(name.to_string(), value);
+        match self.data.iter_mut().find(|(n, _)| n.as_str() == name) {
+            Some((_, v)) => *v = value,
+            None => self.data.push((name.to_string(), value)),
+        }
     }
 
     /// Get a copy of the custom data set on the individual. This returns an error if no custom
@@ -467,8 +535,9 @@ impl Individual {
     /// returns: `Result<DataValue, OError>`
     pub fn get_data(&self, name: &str) -> Result<DataValue, OError> {
         self.data
-            .get(name)
-            .cloned()
+            .iter()
+            .find(|(n, _)| n.as_str() == name)
+            .map(|(_, v)| v.clone())
             .ok_or(OError::WrongDataName(name.to_string()))
     }
 
@@ -478,26 +547,25 @@ impl Individual {
     /// return: `IndividualExport`
     pub fn serialise(&self) -> IndividualExport {
         // invert maximised objective for user
-        let mut objective_values = self.objective_values.clone();
-        for name in self.problem.objective_names() {
-            match self.problem.is_objective_minimised(&name) {
-                Ok(is_minimised) => {
-                    if !is_minimised {
-                        *objective_values.get_mut(&name).unwrap() *= -1.0;
-                    }
-                }
-                Err(_) => continue,
-            }
-        }
+        let objective_values = self
+            .problem
+            .objective_list()
+            .iter()
+            .zip(self.objective_values.iter())
+            .map(|(objective, value)| match objective.direction() {
+                ObjectiveDirection::Minimise => (objective.name(), *value),
+                ObjectiveDirection::Maximise => (objective.name(), -value),
+            })
+            .collect();
 
         IndividualExport {
-            constraint_values: self.constraint_values.clone(),
+            constraint_values: self.constraints(),
             objective_values,
             constraint_violation: self.constraint_violation(),
-            variable_values: self.variable_values.clone(),
+            variable_values: self.variables(),
             is_feasible: self.is_feasible(),
             evaluated: self.evaluated,
-            data: self.data.clone(),
+            data: self.data(),
         }
     }
 
@@ -638,6 +706,18 @@ impl Population {
         Self(population)
     }
 
+    /// Get the objective values of all individuals as a row-major matrix. The value of the `j`-th
+    /// objective (in the same order as [`Problem::objective_names`]) of the `i`-th individual is
+    /// stored at index `i * M + j`, where `M` is the number of objectives.
+    ///
+    /// return: `Vec<f64>`
+    pub fn objective_matrix(&self) -> Vec<f64> {
+        self.0
+            .iter()
+            .flat_map(|i| i.objective_values_slice().iter().copied())
+            .collect()
+    }
+
     /// Serialise the individuals for export.
     ///
     /// return: `Vec<IndividualExport>`
@@ -746,8 +826,8 @@ mod test {
 
     use crate::core::utils::dummy_evaluator;
     use crate::core::{
-        BoundedNumber, Constraint, Individual, Objective, ObjectiveDirection, Problem,
-        RelationalOperator, VariableType,
+        BoundedNumber, Constraint, DataValue, Individual, Objective, ObjectiveDirection,
+        Population, Problem, RelationalOperator, VariableType, VariableValue,
     };
 
     #[test]
@@ -797,4 +877,55 @@ mod test {
         solution1.update_constraint("c2", 600.0).unwrap();
         assert_eq!(solution1.constraint_violation(), 2.0);
     }
+
+    #[test]
+    /// The values are stored in the order of the problem names and the data can be replaced
+    fn test_indexed_values() {
+        let objectives = vec![
+            Objective::new("obj1", ObjectiveDirection::Minimise),
+            Objective::new("obj2", ObjectiveDirection::Maximise),
+        ];
+        let variables = vec![
+            VariableType::Real(BoundedNumber::new("X1", 0.0, 2.0).unwrap()),
+            VariableType::Real(BoundedNumber::new("X2", 0.0, 2.0).unwrap()),
+        ];
+        let e = dummy_evaluator();
+        let problem = Arc::new(Problem::new(objectives, variables, None, e).unwrap());
+
+        let mut solution1 = Individual::new(problem.clone());
+        solution1.update_objective("obj2", 3.0).unwrap();
+        solution1.update_objective("obj1", 1.0).unwrap();
+        solution1
+            .update_variable("X2", VariableValue::Real(1.5))
+            .unwrap();
+        assert_eq!(solution1.objective_values_slice(), &[1.0, -3.0]);
+        assert_eq!(solution1.get_objective_value("obj2").unwrap(), -3.0);
+        assert_eq!(solution1.objectives()["obj2"], -3.0);
+        assert_eq!(
+            solution1.variable_values_slice()[1],
+            VariableValue::Real(1.5)
+        );
+        assert!(solution1
+            .update_variable("X1", VariableValue::Integer(1))
+            .is_err());
+        assert!(solution1.constraint_values_slice().is_empty());
+        assert_eq!(solution1.serialise().objective_values["obj2"], 3.0);
+
+        solution1.set_data("rank", DataValue::Real(1.0));
+        solution1.set_data("rank", DataValue::Real(2.0));
+        assert_eq!(solution1.data().len(), 1);
+        assert_eq!(solution1.get_data("rank").unwrap(), DataValue::Real(2.0));
+        assert!(solution1.get_data("distance").is_err());
+
+        let mut solution2 = solution1.clone();
+        assert_eq!(solution1, solution2);
+        solution2.set_data("distance", DataValue::Real(0.0));
+        assert_ne!(solution1, solution2);
+
+        let mut solution3 = Individual::new(problem);
+        solution3.update_objective("obj1", 5.0).unwrap();
+        solution3.update_objective("obj2", 6.0).unwrap();
+        let population = Population::new_with(vec![solution1, solution3]);
+        assert_eq!(population.objective_matrix(), vec![1.0, -3.0, 5.0, -6.0]);
+    }
 }
@@ -1,14 +1,23 @@
 pub use constraint::{Constraint, RelationalOperator};
 pub use data::DataValue;
+pub use distributed::{
+    DistributedEvaluator, DistributedEvaluatorArgs, DistributedWorker, WorkerStats,
+};
 pub use error::OError;
+pub use evaluation_cache::{EvaluationCache, EvaluationCacheArgs, EvaluationCacheStats};
 pub use individual::{Individual, IndividualExport, Individuals, IndividualsMut, Population};
 pub use objective::{Objective, ObjectiveDirection};
-pub use problem::{builtin_problems, EvaluationResult, Evaluator, Problem, ProblemExport};
+pub use problem::{
+    builtin_problems, BatchEvaluationResult, BatchEvaluator, EvaluationResult, Evaluator, Problem,
+    ProblemExport,
+};
 pub use variable::{Boolean, BoundedNumber, Choice, Variable, VariableType, VariableValue};
 
 mod constraint;
 mod data;
+mod distributed;
 mod error;
+mod evaluation_cache;
 mod individual;
 mod objective;
 mod problem;
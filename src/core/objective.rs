@@ -61,6 +61,13 @@ impl Objective {
         self.name.clone()
     }
 
+    /// Get the objective name without copying it.
+    ///
+    /// return: `&str`
+    pub(crate) fn name_ref(&self) -> &str {
+        &self.name
+    }
+
     /// Get the objective direction.
     ///
     /// return: `ObjectiveDirection`
@@ -1,11 +1,15 @@
 use std::collections::HashMap;
 use std::error::Error;
 use std::fmt::{Debug, Display, Formatter};
+use std::sync::Arc;
 
 use serde::{Deserialize, Serialize};
 
 use crate::core::utils::dummy_evaluator;
-use crate::core::{Constraint, Individual, OError, Objective, ObjectiveDirection, VariableType};
+use crate::core::{
+    Constraint, EvaluationCache, EvaluationCacheArgs, Individual, OError, Objective,
+    ObjectiveDirection, VariableType,
+};
 use crate::utils::has_unique_elements_by_key;
 
 /// The struct containing the results of the evaluation function. This is the output of
@@ -64,6 +68,104 @@ pub trait Evaluator: Sync + Send + Debug {
     fn evaluate(&self, individual: &Individual) -> Result<EvaluationResult, Box<dyn Error>>;
 }
 
+/// The results of [`BatchEvaluator::evaluate_batch`] for a batch of individuals.
+#[derive(Debug)]
+pub struct BatchEvaluationResult {
+    /// The objective values stored in a row-major matrix. The `j`-th objective (in the same order
+    /// as [`Problem::objective_names`]) of the `i`-th individual in the batch is at index
+    /// `i * M + j`, where `M` is the number of objectives.
+    pub objectives: Vec<f64>,
+    /// The constraint values stored in a row-major matrix, in the same order as
+    /// [`Problem::constraint_names`]. This is empty for unconstrained problems.
+    pub constraints: Vec<f64>,
+}
+
+/// The trait to use to evaluate the objective and constraint values of many individuals at once.
+/// This can be used instead of [`Evaluator`] when the evaluation of a batch is cheaper than the
+/// evaluation of each individual, for example with vectorised functions, surrogate models running
+/// on a GPU or external simulators with a long start-up time.
+pub trait BatchEvaluator: Sync + Send + Debug {
+    /// A custom-defined function to use to assess the constraints and objectives for a batch of
+    /// individuals. This function must return the values for all the objectives and constraints
+    /// set on the problem for all the individuals, in the same order as the individuals. An
+    /// algorithm will return an error if the function fails to do so.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`: The individuals to evaluate.
+    ///
+    /// returns: `Result<BatchEvaluationResult, Box<dyn Error>>`
+    ///
+    /// ## Example
+    /// ```
+    /// use std::error::Error;
+    /// use optirustic::core::{BatchEvaluationResult, BatchEvaluator, Individual};
+    ///
+    /// // solve a SCH problem with two objectives to minimise: x^2 and (x-2)^2. The problem has
+    /// // one variable named "x" and two objectives named "x^2" and "(x-2)^2".
+    /// #[derive(Debug)]
+    /// struct UserEvaluator;
+    /// impl BatchEvaluator for UserEvaluator {
+    ///     fn evaluate_batch(
+    ///         &self,
+    ///         individuals: &[&Individual],
+    ///     ) -> Result<BatchEvaluationResult, Box<dyn Error>> {
+    ///         let mut objectives = Vec::with_capacity(individuals.len() * 2);
+    ///         for i in individuals {
+    ///             let x = i.get_variable_value("x")?.as_real()?;
+    ///             objectives.push(x.powi(2));
+    ///             objectives.push((x - 2.0).powi(2));
+    ///         }
+    ///         Ok(BatchEvaluationResult {
+    ///             objectives,
+    ///             constraints: vec![],
+    ///         })
+    ///     }
+    /// }
+    /// ```
+    fn evaluate_batch(
+        &self,
+        individuals: &[&Individual],
+    ) -> Result<BatchEvaluationResult, Box<dyn Error>>;
+}
+
+/// Use a [`BatchEvaluator`] to evaluate one individual at the time.
+#[derive(Debug)]
+struct SingleBatchEvaluator {
+    /// The batch evaluator.
+    evaluator: Arc<dyn BatchEvaluator>,
+    /// The objective names.
+    objective_names: Vec<String>,
+    /// The constraint names.
+    constraint_names: Vec<String>,
+}
+
+impl Evaluator for SingleBatchEvaluator {
+    fn evaluate(&self, individual: &Individual) -> Result<EvaluationResult, Box<dyn Error>> {
+        let results = self.evaluator.evaluate_batch(&[individual])?;
+        let constraints = if self.constraint_names.is_empty() {
+            None
+        } else {
+            Some(
+                self.constraint_names
+                    .iter()
+                    .cloned()
+                    .zip(results.constraints)
+                    .collect(),
+            )
+        };
+        Ok(EvaluationResult {
+            constraints,
+            objectives: self
+                .objective_names
+                .iter()
+                .cloned()
+                .zip(results.objectives)
+                .collect(),
+        })
+    }
+}
+
 #[derive(Serialize, Deserialize, Debug, Clone)]
 /// Serialised data of a problem.
 pub struct ProblemExport {
@@ -153,6 +255,10 @@ pub struct Problem {
     /// The trait with the function to use to evaluate the objective and constraint values of
     /// new offsprings.
     evaluator: Box<dyn Evaluator>,
+    /// The optional trait to use to evaluate the new offsprings in batches and the batch size.
+    batch_evaluator: Option<(Arc<dyn BatchEvaluator>, usize)>,
+    /// The optional cache with the objective and constraint values of the evaluated solutions.
+    evaluation_cache: Option<EvaluationCache>,
 }
 
 impl Display for Problem {
@@ -211,9 +317,49 @@ impl Problem {
             objectives,
             constraints,
             evaluator,
+            batch_evaluator: None,
+            evaluation_cache: None,
         })
     }
 
+    /// Initialise a problem whose individuals are evaluated in batches. The algorithms split the
+    /// unevaluated individuals into batches of `batch_size` items and call
+    /// [`BatchEvaluator::evaluate_batch`] once per batch. [`Problem::evaluator`] evaluates one
+    /// individual at the time with the batch evaluator.
+    ///
+    /// # Arguments
+    ///
+    /// * `objectives`: The vector of objective to set on the problem.
+    /// * `variable_types`: The vector of variable types to set on the problem.
+    /// * `constraints`: The optional vector of constraints.
+    /// * `evaluator`: The trait with the function to use to evaluate the objective and constraint
+    ///    values of a batch of individuals.
+    /// * `batch_size`: The maximum number of individuals in a batch.
+    ///
+    /// returns: `Result<Problem, OError>`
+    pub fn new_with_batch_evaluator(
+        objectives: Vec<Objective>,
+        variable_types: Vec<VariableType>,
+        constraints: Option<Vec<Constraint>>,
+        evaluator: Box<dyn BatchEvaluator>,
+        batch_size: usize,
+    ) -> Result<Self, OError> {
+        if batch_size == 0 {
+            return Err(OError::Generic(
+                "The batch size must be at least 1".to_string(),
+            ));
+        }
+        let evaluator: Arc<dyn BatchEvaluator> = Arc::from(evaluator);
+        let mut problem = Self::new(objectives, variable_types, constraints, dummy_evaluator())?;
+        problem.evaluator = Box::new(SingleBatchEvaluator {
+            evaluator: evaluator.clone(),
+            objective_names: problem.objective_names(),
+            constraint_names: problem.constraint_names(),
+        });
+        problem.batch_evaluator = Some((evaluator, batch_size));
+        Ok(problem)
+    }
+
     /// Whether a problem objective is being minimised. This returns an error if the objective does
     /// not exist.
     ///
@@ -275,6 +421,84 @@ impl Problem {
         self.constraints.iter().map(|o| o.name()).collect()
     }
 
+    /// Get the index of a variable in the list of the problem variables. This is the position of
+    /// the variable in [`Problem::variable_names`] and returns an error if the variable does not
+    /// exist.
+    ///
+    /// # Arguments
+    ///
+    /// * `name`: The variable name.
+    ///
+    /// return `Result<usize, OError>`
+    pub fn variable_index(&self, name: &str) -> Result<usize, OError> {
+        self.variables
+            .iter()
+            .position(|v| v.name_ref() == name)
+            .ok_or(OError::NonExistingName(
+                "variable".to_string(),
+                name.to_string(),
+            ))
+    }
+
+    /// Get the index of an objective in the list of the problem objectives. This is the position
+    /// of the objective in [`Problem::objective_names`] and returns an error if the objective does
+    /// not exist.
+    ///
+    /// # Arguments
+    ///
+    /// * `name`: The objective name.
+    ///
+    /// return `Result<usize, OError>`
+    pub fn objective_index(&self, name: &str) -> Result<usize, OError> {
+        self.objectives
+            .iter()
+            .position(|o| o.name_ref() == name)
+            .ok_or(OError::NonExistingName(
+                "objective".to_string(),
+                name.to_string(),
+            ))
+    }
+
+    /// Get the index of a constraint in the list of the problem constraints. This is the position
+    /// of the constraint in [`Problem::constraint_names`] and returns an error if the constraint
+    /// does not exist.
+    ///
+    /// # Arguments
+    ///
+    /// * `name`: The constraint name.
+    ///
+    /// return `Result<usize, OError>`
+    pub fn constraint_index(&self, name: &str) -> Result<usize, OError> {
+        self.constraints
+            .iter()
+            .position(|c| c.name_ref() == name)
+            .ok_or(OError::NonExistingName(
+                "constraint".to_string(),
+                name.to_string(),
+            ))
+    }
+
+    /// Get the variable types without copying them.
+    ///
+    /// return `&[VariableType]`
+    pub(crate) fn variable_list(&self) -> &[VariableType] {
+        &self.variables
+    }
+
+    /// Get the objectives without copying them.
+    ///
+    /// return `&[Objective]`
+    pub(crate) fn objective_list(&self) -> &[Objective] {
+        &self.objectives
+    }
+
+    /// Get the constraints without copying them.
+    ///
+    /// return `&[Constraint]`
+    pub(crate) fn constraint_list(&self) -> &[Constraint] {
+        &self.constraints
+    }
+
     /// Get the map of variables.
     ///
     /// return `Vec<(String, VariableType)>`
@@ -357,6 +581,45 @@ impl Problem {
         self.evaluator.as_ref()
     }
 
+    /// The function used to evaluate the constraint and objective values for batches of new
+    /// offsprings and the batch size, when the problem was created with
+    /// [`Problem::new_with_batch_evaluator`].
+    ///
+    /// return `Option<(&dyn BatchEvaluator, usize)>`
+    pub fn batch_evaluator(&self) -> Option<(&dyn BatchEvaluator, usize)> {
+        self.batch_evaluator
+            .as_ref()
+            .map(|(evaluator, batch_size)| (evaluator.as_ref(), *batch_size))
+    }
+
+    /// Enable the cache of the evaluated solutions. When an individual has the same variables as
+    /// an individual evaluated before, its objectives and constraints are taken from the cache and
+    /// the evaluator is not called. This returns an error if the capacity is 0 or the cache file
+    /// cannot be loaded. See [`EvaluationCache`] for the details.
+    ///
+    /// # Arguments
+    ///
+    /// * `options`: The cache options with the capacity and the optional file where the cache is
+    ///    persisted.
+    ///
+    /// returns: `Result<(), OError>`
+    pub fn set_evaluation_cache(&mut self, options: EvaluationCacheArgs) -> Result<(), OError> {
+        self.evaluation_cache = Some(EvaluationCache::new(
+            options,
+            self.number_of_objectives(),
+            self.number_of_constraints(),
+        )?);
+        Ok(())
+    }
+
+    /// The cache with the evaluated solutions, when enabled with
+    /// [`Problem::set_evaluation_cache`].
+    ///
+    /// return `Option<&EvaluationCache>`
+    pub fn evaluation_cache(&self) -> Option<&EvaluationCache> {
+        self.evaluation_cache.as_ref()
+    }
+
     /// Serialise the problem data.
     ///
     /// return: `ProblemExport`
@@ -11,8 +11,8 @@ use crate::core::{EvaluationResult, Evaluator, Individual};
 ///
 /// * `seed`: The optional seed number.
 ///
-/// returns: `Box<dyn RngCore>`
-pub(crate) fn get_rng(seed: Option<u64>) -> Box<dyn RngCore> {
+/// returns: `Box<dyn RngCore + Send>`
+pub(crate) fn get_rng(seed: Option<u64>) -> Box<dyn RngCore + Send> {
     let rng = match seed {
         None => ChaCha8Rng::from_seed(Default::default()),
         Some(s) => ChaCha8Rng::seed_from_u64(s),
@@ -216,11 +216,18 @@ impl VariableType {
     ///
     /// return: `String`
     pub fn name(&self) -> String {
+        self.name_ref().to_string()
+    }
+
+    /// Get the variable name without copying it.
+    ///
+    /// return: `&str`
+    pub(crate) fn name_ref(&self) -> &str {
         match self {
-            VariableType::Real(t) => t.name.clone(),
-            VariableType::Integer(t) => t.name.clone(),
-            VariableType::Boolean(t) => t.name.clone(),
-            VariableType::Choice(t) => t.name.clone(),
+            VariableType::Real(t) => &t.name,
+            VariableType::Integer(t) => &t.name,
+            VariableType::Boolean(t) => &t.name,
+            VariableType::Choice(t) => &t.name,
         }
     }
 
@@ -300,13 +307,24 @@ impl VariableValue {
     ///
     /// returns: `Result<bool, OError>`
     pub fn match_type(&self, name: &str, problem: Arc<Problem>) -> Result<bool, OError> {
-        let value = match problem.get_variable(name)? {
+        let index = problem.variable_index(name)?;
+        Ok(self.match_variable_type(&problem.variable_list()[index]))
+    }
+
+    /// Check if the variable value matches a variable type.
+    ///
+    /// # Arguments
+    ///
+    /// * `variable_type`: The variable type.
+    ///
+    /// returns: `bool`
+    pub(crate) fn match_variable_type(&self, variable_type: &VariableType) -> bool {
+        match variable_type {
             VariableType::Real(_) => matches!(self, VariableValue::Real(_)),
             VariableType::Integer(_) => matches!(self, VariableValue::Integer(_)),
             VariableType::Boolean(_) => matches!(self, VariableValue::Boolean(_)),
             VariableType::Choice(_) => matches!(self, VariableValue::Choice(_)),
-        };
-        Ok(value)
+        }
     }
 
     /// Get the value if the variable is of real type. This returns an error if the variable is not
@@ -1,4 +1,7 @@
 pub mod algorithms;
+#[cfg(feature = "bench")]
+#[doc(hidden)]
+pub mod bench;
 pub mod core;
 pub mod metrics;
 pub mod operators;
@@ -1,8 +1,18 @@
-use crate::core::{Individual, OError};
-use crate::utils::vector_min;
+use std::borrow::Cow;
+
+use rayon::prelude::*;
+
+use crate::core::{Individual, OError, ObjectiveDirection, Problem};
+use crate::metrics::kd_tree::KdTree;
 
 static DISTANCE_NAME: &str = "Distance";
 
+/// The minimum number of points processed by each thread.
+const MIN_POINTS_PER_THREAD: usize = 64;
+
+/// The number of points compared at once in the GD+ and IGD+ metrics.
+const PLUS_BLOCK_SIZE: usize = 64;
+
 /// This struct allows calculation of the following distance metrics to assess the performance of a
 /// genetic algorithm:
 /// 1) Generational Distance (GD)
@@ -50,11 +60,11 @@ static DISTANCE_NAME: &str = "Distance";
 ///   quality of a Pareto front (i.e. the metrics may give low distance for a non-optional front);
 /// - the IGD+ is weakly Pareto compliant.
 pub struct Distance<'a> {
-    /// The vector of individuals.
-    individuals: &'a [Individual],
+    /// The objective values of the individuals stored as a flat row-major matrix.
+    objectives: Vec<f64>,
     /// The reference points to use to calculate the distance. This should be either the true Pareto
     /// front or its good approximation.
-    reference_front: Vec<Individual>,
+    reference_front: Cow<'a, ReferenceFront>,
 }
 
 impl<'a> Distance<'a> {
@@ -78,36 +88,61 @@ impl<'a> Distance<'a> {
                 "The vector of individuals is empty".to_string(),
             ));
         }
-        if reference_front.is_empty() {
+        let reference_front = ReferenceFront::new(reference_front, &individuals[0].problem())?;
+        Self::build(individuals, Cow::Owned(reference_front))
+    }
+
+    /// Create the distance metric using a reference front initialised with
+    /// [`ReferenceFront::new`]. Use this to calculate the metrics at different generations
+    /// without rebuilding the reference front and its index. This returns an error if the
+    /// number of objectives of the reference front does not match the problem.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`: The vector of individuals.
+    /// * `reference_front`: The reference front.
+    ///
+    /// returns: `Distance`
+    pub fn with_reference_front(
+        individuals: &[Individual],
+        reference_front: &'a ReferenceFront,
+    ) -> Result<Self, OError> {
+        if individuals.is_empty() {
             return Err(OError::Metric(
                 DISTANCE_NAME.to_string(),
-                "The vector of reference points is empty".to_string(),
+                "The vector of individuals is empty".to_string(),
             ));
         }
-        let problem = individuals[0].problem();
-        if reference_front[0].len() != problem.number_of_objectives() {
+        Self::build(individuals, Cow::Borrowed(reference_front))
+    }
+
+    /// Collect the objective values of the individuals in a matrix.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`: The vector of individuals.
+    /// * `reference_front`: The reference front.
+    ///
+    /// returns: `Distance`
+    fn build(
+        individuals: &[Individual],
+        reference_front: Cow<'a, ReferenceFront>,
+    ) -> Result<Self, OError> {
+        let number_of_objectives = individuals[0].problem().number_of_objectives();
+        if reference_front.number_of_objectives != number_of_objectives {
             return Err(OError::Metric(
                 DISTANCE_NAME.to_string(),
                 "Each reference point must have a size equal to the number of objectives"
                     .to_string(),
             ));
         }
-
-        let reference_front = reference_front
+        let objectives = individuals
             .iter()
-            .map(|values| {
-                let mut ind = Individual::new(problem.clone());
-                problem
-                    .objective_names()
-                    .iter()
-                    .zip(values)
-                    .for_each(|(name, value)| ind.update_objective(name, *value).unwrap());
-                ind
-            })
+            .flat_map(|ind| ind.objective_values_slice().iter().copied())
             .collect();
 
         Ok(Self {
-            individuals,
+            objectives,
             reference_front,
         })
     }
@@ -121,14 +156,13 @@ impl<'a> Distance<'a> {
     ///
     /// returns: `Result<f64, OError>`
     pub fn generational_distance(&self) -> Result<f64, OError> {
-        Self::_generational_distance(
-            self.individuals,
-            &self.reference_front,
-            Distance::euclidian_distance,
-            false,
+        let tree = &self.reference_front.tree;
+        Ok(self._generational_distance(
+            &self.objectives,
+            |a| tree.nearest_distance(a),
             false,
             Some(1),
-        )
+        ))
     }
 
     /// Calculate the inverted generational distance (IGD).
@@ -141,28 +175,25 @@ impl<'a> Distance<'a> {
     ///
     /// returns: `Result<f64, OError>`
     pub fn inverted_generational_distance(&self) -> Result<f64, OError> {
-        Self::_generational_distance(
-            &self.reference_front,
-            self.individuals,
-            Distance::euclidian_distance,
-            true,
+        let tree = KdTree::new(&self.objectives, self.reference_front.number_of_objectives);
+        Ok(self._generational_distance(
+            &self.reference_front.points,
+            |r| tree.nearest_distance(r),
             false,
             Some(1),
-        )
+        ))
     }
 
     /// Calculate the generational distance plus (GD+).
     ///
     /// returns: `Result<f64, OError>`
     pub fn generational_distance_plus(&self) -> Result<f64, OError> {
-        Self::_generational_distance(
-            self.individuals,
-            &self.reference_front,
-            Distance::distance_plus,
-            false,
+        Ok(self._generational_distance(
+            &self.objectives,
+            |a| nearest_distance_plus(a, &self.reference_front.points, false),
             false,
             Some(1),
-        )
+        ))
     }
 
     /// Calculate the inverted generational distance plus (IGD+).
@@ -176,14 +207,12 @@ impl<'a> Distance<'a> {
     ///
     /// returns: `Result<f64, OError>`
     pub fn inverted_generational_distance_plus(&self) -> Result<f64, OError> {
-        Self::_generational_distance(
-            &self.reference_front,
-            self.individuals,
-            Distance::distance_plus,
-            true,
+        Ok(self._generational_distance(
+            &self.reference_front.points,
+            |r| nearest_distance_plus(r, &self.objectives, true),
             false,
             Some(1),
-        )
+        ))
     }
 
     /// Calculate the averaged Hausdorff distance ($\Delta_P$).
@@ -195,141 +224,208 @@ impl<'a> Distance<'a> {
     ///
     /// returns: `Result<f64, OError>`
     pub fn hausdorff_distance(&self) -> Result<f64, OError> {
+        let reference_tree = &self.reference_front.tree;
+        let tree = KdTree::new(&self.objectives, self.reference_front.number_of_objectives);
         Ok(f64::max(
-            Distance::_generational_distance(
-                self.individuals,
-                &self.reference_front,
-                Distance::euclidian_distance,
-                false,
+            self._generational_distance(
+                &self.objectives,
+                |a| reference_tree.nearest_distance(a),
                 true,
                 None,
-            )?,
-            Distance::_generational_distance(
-                &self.reference_front,
-                self.individuals,
-                Distance::euclidian_distance,
-                false,
+            ),
+            self._generational_distance(
+                &self.reference_front.points,
+                |r| tree.nearest_distance(r),
                 true,
                 None,
-            )?,
+            ),
         ))
     }
 
-    /// Squared distance between two points used in the GD and IGD metrics.
-    ///
-    /// # Arguments
-    ///
-    /// * `a`: The first individual.
-    /// * `r`: The reference individual.
-    /// * `is_inverse`: Whether the distance is for the inverse metric.
-    ///
-    /// returns: `Result<f64, OError>`
-    fn euclidian_distance(
-        a: &Individual,
-        r: &Individual,
-        _is_inverse: bool,
-    ) -> Result<f64, OError> {
-        Ok(a.get_objective_values()?
-            .iter()
-            .zip(r.get_objective_values()?)
-            .map(|(a_k, r_k)| (a_k - r_k).powi(2))
-            .sum::<f64>()
-            .sqrt())
-    }
-
-    /// Max (plus) distance between two points used in the GD+ and IGD+ metrics.
-    ///
-    /// # Arguments
-    ///
-    /// * `a`: The first individual.
-    /// * `r`: The reference individual.
-    /// * `is_inverse`: Whether the distance is for the inverse metric.
-    ///
-    /// returns: `Result<f64, OError>`
-    fn distance_plus(a: &Individual, r: &Individual, is_inverse: bool) -> Result<f64, OError> {
-        let problem = a.problem();
-        let distance = problem
-            .objective_names()
-            .iter()
-            .map(|name| {
-                // Eq. 18
-                let mut delta =
-                    a.get_objective_value(name).unwrap() - r.get_objective_value(name).unwrap();
-                if is_inverse {
-                    delta *= -1.0;
-                }
-                if !problem.is_objective_minimised(name).unwrap() {
-                    delta *= -1.0; // Eq. 19
-                }
-                delta.max(0.0).powi(2)
-            })
-            .sum::<f64>()
-            .sqrt();
-
-        Ok(distance)
-    }
-
     /// Calculate the generational distance of `a` as the distance between each point in the set
-    /// and the closest point in the `r` set, averaged over the size of `a`.
+    /// and the closest point in the other set, averaged over the size of `a`. The points in `a`
+    /// are processed in parallel.
     ///
     /// # Arguments
     ///
-    /// * `a`: The vector of objectives.
-    /// * `r`: The reference points to use to calculate the distance.
-    /// * `distance_function`: The function to use to calculate the distance between the points.
-    /// * `p`: The exponent to use in the calculation. Default to 1.
-    /// * `is_inverse`: Whether the distance is for the inverse metric.
+    /// * `a`: The points stored as a flat row-major matrix.
+    /// * `nearest_distance`: The function returning the distance between a point in `a` and the
+    ///    closest point in the other set.
     /// * `is_hausdorff`: Whether to elevate the inverse of the counter $1/|A|$ to $1/p$. This must
     ///    be `true` when calculating the Hausdorff distance, `false` otherwise.
+    /// * `p`: The exponent to use in the calculation. Default to 1.
     ///
-    /// returns: `Result<f64, OError>`
+    /// returns: `f64`
     fn _generational_distance<F>(
-        a: &[Individual],
-        r: &[Individual],
-        distance_function: F,
-        is_inverse: bool,
+        &self,
+        a: &[f64],
+        nearest_distance: F,
         is_hausdorff: bool,
         p: Option<u8>,
-    ) -> Result<f64, OError>
+    ) -> f64
     where
-        F: Fn(&Individual, &Individual, bool) -> Result<f64, OError>,
+        F: Fn(&[f64]) -> f64 + Sync,
     {
         let p = p.unwrap_or(1);
+        let number_of_objectives = self.reference_front.number_of_objectives;
+        let size = a.len() / number_of_objectives;
 
-        let distance_sum = a
-            .iter()
-            .map(|a| {
-                // distances from each ref point
-                let distances: Vec<f64> = r
-                    .iter()
-                    .map(|r| distance_function(a, r, is_inverse))
-                    .collect::<Result<Vec<f64>, OError>>()?;
-                // distances
-                let distances: Vec<f64> = distances.iter().map(|d| d.powi(p as i32)).collect();
-                vector_min(&distances)
-            })
-            .sum::<Result<f64, OError>>()?;
+        let distance_sum: f64 = a
+            .par_chunks_exact(number_of_objectives)
+            .with_min_len(MIN_POINTS_PER_THREAD)
+            .map(|a| nearest_distance(a).powi(p as i32))
+            .sum();
 
         let exponent = 1.0 / (p as f64);
         if is_hausdorff {
             // for Hausdorff distance
-            Ok((distance_sum / a.len() as f64).powf(exponent))
+            (distance_sum / size as f64).powf(exponent)
         } else {
             // for GD, GD+, IGD and IGD+
-            Ok(distance_sum.powf(exponent) / a.len() as f64)
+            distance_sum.powf(exponent) / size as f64
         }
     }
 }
 
+/// The reference front used to calculate the [`Distance`] metrics. The points are stored in a
+/// flat matrix with a k-d tree to find the nearest reference point of each individual. Create
+/// this once and use [`Distance::with_reference_front`] to reuse the index when the metrics are
+/// tracked over many generations.
+#[derive(Clone, Debug)]
+pub struct ReferenceFront {
+    /// The points stored as a flat row-major matrix. As for [`Individual`], the values of
+    /// maximised objectives are stored with the opposite sign.
+    points: Vec<f64>,
+    /// The number of objectives.
+    number_of_objectives: usize,
+    /// The index of the points.
+    tree: KdTree,
+}
+
+impl ReferenceFront {
+    /// Create the reference front. This returns an error if the front is empty or the size of a
+    /// point does not equal the number of objectives.
+    ///
+    /// # Arguments
+    ///
+    /// * `reference_front`: The reference points. This should be either the true Pareto front or
+    ///    its good approximation. The length of each point must be `M`.
+    /// * `problem`: The problem the points refer to.
+    ///
+    /// returns: `Result<ReferenceFront, OError>`
+    pub fn new(reference_front: &[Vec<f64>], problem: &Problem) -> Result<Self, OError> {
+        if reference_front.is_empty() {
+            return Err(OError::Metric(
+                DISTANCE_NAME.to_string(),
+                "The vector of reference points is empty".to_string(),
+            ));
+        }
+        let number_of_objectives = problem.number_of_objectives();
+        if reference_front
+            .iter()
+            .any(|point| point.len() != number_of_objectives)
+        {
+            return Err(OError::Metric(
+                DISTANCE_NAME.to_string(),
+                "Each reference point must have a size equal to the number of objectives"
+                    .to_string(),
+            ));
+        }
+
+        let signs: Vec<f64> = problem
+            .objective_list()
+            .iter()
+            .map(|objective| match objective.direction() {
+                ObjectiveDirection::Minimise => 1.0,
+                ObjectiveDirection::Maximise => -1.0,
+            })
+            .collect();
+        let points: Vec<f64> = reference_front
+            .iter()
+            .flat_map(|point| point.iter().zip(&signs).map(|(value, sign)| sign * value))
+            .collect();
+        let tree = KdTree::new(&points, number_of_objectives);
+
+        Ok(Self {
+            points,
+            number_of_objectives,
+            tree,
+        })
+    }
+
+    /// Get the number of reference points.
+    ///
+    /// returns: `usize`
+    pub fn len(&self) -> usize {
+        self.tree.len()
+    }
+
+    /// Whether the front has no points.
+    ///
+    /// returns: `bool`
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Get the number of objectives.
+    ///
+    /// returns: `usize`
+    pub fn number_of_objectives(&self) -> usize {
+        self.number_of_objectives
+    }
+}
+
+/// Get the max (plus) distance used in the GD+ and IGD+ metrics between a point and the closest
+/// point in a set. As all objectives are stored as minimised, the difference for maximised
+/// objectives (Eq. 19 in Ishibuchi et al. (2015)) does not need to be inverted. The modified
+/// distance is not a metric and cannot be used to prune a k-d tree, therefore all the points are
+/// compared. The points are processed in blocks, so that the compiler can vectorise the
+/// calculation of the distances in a block.
+///
+/// # Arguments
+///
+/// * `query`: The point coordinates.
+/// * `points`: The points in the set stored as a flat row-major matrix.
+/// * `is_inverse`: Whether the distance is for the inverse metric. When `false`, the query is
+///    an individual and the points are the reference front; when `true`, the query is a reference
+///    point and the points are the individuals.
+///
+/// returns: `f64`
+fn nearest_distance_plus(query: &[f64], points: &[f64], is_inverse: bool) -> f64 {
+    let number_of_objectives = query.len();
+    // Eq. 18: the difference between the individual and the reference point
+    let factor = if is_inverse { -1.0 } else { 1.0 };
+    let mut best = f64::INFINITY;
+    let mut distances = [0.0; PLUS_BLOCK_SIZE];
+    for block in points.chunks(PLUS_BLOCK_SIZE * number_of_objectives) {
+        let distances = &mut distances[..block.len() / number_of_objectives];
+        distances.fill(0.0);
+        for (distance, point) in distances
+            .iter_mut()
+            .zip(block.chunks_exact(number_of_objectives))
+        {
+            for (q, p) in query.iter().zip(point) {
+                let delta = (factor * (q - p)).max(0.0);
+                *distance += delta * delta;
+            }
+        }
+        best = distances.iter().fold(best, |best, d| best.min(*d));
+    }
+    best.sqrt()
+}
+
 #[cfg(test)]
 mod test {
     use std::collections::HashMap;
 
     use float_cmp::assert_approx_eq;
 
+    use rand::Rng;
+
     use crate::core::test_utils::individuals_from_obj_values_dummy;
+    use crate::core::utils::get_rng;
     use crate::core::ObjectiveDirection;
-    use crate::metrics::Distance;
+    use crate::metrics::{Distance, ReferenceFront};
 
     #[test]
     /// Test data from Ishibuchi et al. (2015), Table 4.
@@ -468,4 +564,74 @@ mod test {
             );
         }
     }
+
+    #[test]
+    /// The metrics calculated with a shared reference front match the brute-force calculation,
+    /// also when an objective is maximised.
+    fn test_distance_with_reference_front() {
+        let mut rng = get_rng(Some(1));
+        let directions = [ObjectiveDirection::Minimise, ObjectiveDirection::Maximise];
+        let ref_points: Vec<Vec<f64>> = (0..500)
+            .map(|_| vec![rng.gen_range(0.0..1.0), rng.gen_range(0.0..1.0)])
+            .collect();
+        let individuals = individuals_from_obj_values_dummy(&ref_points[..1], &directions, None);
+        let reference_front = ReferenceFront::new(&ref_points, &individuals[0].problem()).unwrap();
+        assert_eq!(reference_front.len(), 500);
+
+        // the mean of the distances between the points in a and their closest point in b
+        let mean_min = |a: &[Vec<f64>], b: &[Vec<f64>], d: &dyn Fn(&[f64], &[f64]) -> f64| {
+            a.iter()
+                .map(|p| b.iter().map(|q| d(p, q)).fold(f64::INFINITY, f64::min))
+                .sum::<f64>()
+                / a.len() as f64
+        };
+        let euclidean =
+            |a: &[f64], r: &[f64]| ((a[0] - r[0]).powi(2) + (a[1] - r[1]).powi(2)).sqrt();
+        // the second objective is maximised
+        let plus = |a: &[f64], r: &[f64]| {
+            ((a[0] - r[0]).max(0.0).powi(2) + (r[1] - a[1]).max(0.0).powi(2)).sqrt()
+        };
+        let plus_inverse = |r: &[f64], a: &[f64]| plus(a, r);
+
+        for _ in 0..2 {
+            let objectives: Vec<Vec<f64>> = (0..40)
+                .map(|_| vec![rng.gen_range(0.0..1.2), rng.gen_range(-0.2..1.0)])
+                .collect();
+            let individuals = individuals_from_obj_values_dummy(&objectives, &directions, None);
+            let metric = Distance::with_reference_front(&individuals, &reference_front).unwrap();
+
+            let gd = mean_min(&objectives, &ref_points, &euclidean);
+            let igd = mean_min(&ref_points, &objectives, &euclidean);
+            assert_approx_eq!(
+                f64,
+                metric.generational_distance().unwrap(),
+                gd,
+                epsilon = 1e-9
+            );
+            assert_approx_eq!(
+                f64,
+                metric.inverted_generational_distance().unwrap(),
+                igd,
+                epsilon = 1e-9
+            );
+            assert_approx_eq!(
+                f64,
+                metric.generational_distance_plus().unwrap(),
+                mean_min(&objectives, &ref_points, &plus),
+                epsilon = 1e-9
+            );
+            assert_approx_eq!(
+                f64,
+                metric.inverted_generational_distance_plus().unwrap(),
+                mean_min(&ref_points, &objectives, &plus_inverse),
+                epsilon = 1e-9
+            );
+            assert_approx_eq!(
+                f64,
+                metric.hausdorff_distance().unwrap(),
+                gd.max(igd),
+                epsilon = 1e-9
+            );
+        }
+    }
 }
@@ -0,0 +1,405 @@
+use std::cmp::Ordering;
+use std::mem;
+
+use rayon::prelude::*;
+
+/// The points of a front at one recursion depth of the WFG algorithm. The buffers are allocated
+/// once, with enough room for all the points in the front, and are reused by all the limit sets
+/// built at the same depth.
+#[derive(Debug)]
+struct Level {
+    /// The number of objectives of the points at this depth.
+    dims: usize,
+    /// The objective values stored by row.
+    points: Vec<f64>,
+    /// The buffer used to reorder the rows when the points are sorted.
+    scratch: Vec<f64>,
+    /// The row order used when the points are sorted.
+    order: Vec<usize>,
+}
+
+impl Level {
+    /// Allocate the buffers for a depth.
+    ///
+    /// # Arguments
+    ///
+    /// * `number_of_points`: The maximum number of points at the depth.
+    /// * `dims`: The number of objectives of the points.
+    ///
+    /// returns: `Level`
+    fn new(number_of_points: usize, dims: usize) -> Self {
+        Self {
+            dims,
+            points: vec![0.0; number_of_points * dims],
+            scratch: vec![0.0; number_of_points * dims],
+            order: Vec::with_capacity(number_of_points),
+        }
+    }
+
+    /// Sort the first `count` points by decreasing objective values, starting from the last
+    /// objective. This does not allocate.
+    ///
+    /// # Arguments
+    ///
+    /// * `count`: The number of points to sort.
+    ///
+    /// returns: `()`
+    fn sort(&mut self, count: usize) {
+        sort_rows(
+            &mut self.points,
+            &mut self.scratch,
+            &mut self.order,
+            count,
+            self.dims,
+        );
+    }
+}
+
+/// The buffers needed by one thread to calculate the exclusive hyper-volume of the points. There
+/// is one [`Level`] for each recursion depth; the depth `k` holds the limit sets with
+/// `number_of_objectives - 1 - k` objectives.
+#[derive(Debug)]
+struct Workspace {
+    levels: Vec<Level>,
+}
+
+impl Workspace {
+    /// Allocate the buffers for a front.
+    ///
+    /// # Arguments
+    ///
+    /// * `number_of_points`: The number of points in the front.
+    /// * `number_of_objectives`: The number of objectives.
+    ///
+    /// returns: `Workspace`
+    fn new(number_of_points: usize, number_of_objectives: usize) -> Self {
+        // limit sets are built for 2 up to `number_of_objectives - 1` objectives
+        let levels = (2..number_of_objectives)
+            .rev()
+            .map(|dims| Level::new(number_of_points, dims))
+            .collect();
+        Self { levels }
+    }
+}
+
+/// Calculate the hyper-volume with the WFG algorithm by [While et al. (2012)](http://dx.doi.org/10.1109/TEVC.2010.2077298)
+/// using the slicing of the last objective and the sorting of the points at each depth (the
+/// `O2` optimisation of [`crate::metrics::hv_wfg::wfg::Wfg`]).
+///
+/// Differently from [`crate::metrics::hv_wfg::wfg::Wfg`], the points are stored in one flat
+/// buffer per recursion depth, which is allocated once and reused by all the limit sets, so that
+/// the recursion does not allocate. The exclusive hyper-volume of the points in the front can also
+/// be calculated in parallel, with one set of buffers per thread; the contributions are summed in
+/// the same order in both cases, so that the result does not depend on `parallel`.
+///
+/// # Arguments
+///
+/// * `front`: The objective values of the points stored by row. All objectives are minimised,
+///    the points must not be dominated by each other and must dominate the reference point.
+/// * `reference_point`: The reference point.
+/// * `parallel`: Whether to calculate the contribution of each point in parallel.
+///
+/// returns: `f64`
+pub(crate) fn hyper_volume(front: &[f64], reference_point: &[f64], parallel: bool) -> f64 {
+    let dims = reference_point.len();
+    if dims == 0 || front.is_empty() {
+        return 0.0;
+    }
+    let count = front.len() / dims;
+    if dims == 1 {
+        let best = front.iter().copied().fold(f64::INFINITY, f64::min);
+        return reference_point[0] - best;
+    }
+
+    let mut points = front[..count * dims].to_vec();
+    let mut scratch = vec![0.0; points.len()];
+    let mut order = Vec::with_capacity(count);
+    sort_rows(&mut points, &mut scratch, &mut order, count, dims);
+    if dims == 2 {
+        return volume_2d(&points, reference_point);
+    }
+
+    let contribution = |workspace: &mut Workspace, i: usize| {
+        (reference_point[dims - 1] - points[i * dims + dims - 1])
+            * exclusive_hv(&points, dims, i, &mut workspace.levels, reference_point)
+    };
+    let contributions: Vec<f64> = if parallel {
+        (0..count)
+            .into_par_iter()
+            .map_init(|| Workspace::new(count, dims), contribution)
+            .collect()
+    } else {
+        let mut workspace = Workspace::new(count, dims);
+        (0..count)
+            .map(|i| contribution(&mut workspace, i))
+            .collect()
+    };
+    contributions.iter().rev().sum()
+}
+
+/// Sort the first `count` rows of a buffer by decreasing objective values, starting from the
+/// last objective. The rows are reordered through `scratch`, which must have the same size as
+/// `points`.
+///
+/// # Arguments
+///
+/// * `points`: The points stored by row.
+/// * `scratch`: The buffer used to reorder the rows.
+/// * `order`: The buffer with the row order.
+/// * `count`: The number of rows to sort.
+/// * `dims`: The number of objectives.
+///
+/// returns: `()`
+fn sort_rows(
+    points: &mut Vec<f64>,
+    scratch: &mut Vec<f64>,
+    order: &mut Vec<usize>,
+    count: usize,
+    dims: usize,
+) {
+    order.clear();
+    order.extend(0..count);
+    order.sort_unstable_by(|a, b| {
+        let a = &points[a * dims..(a + 1) * dims];
+        let b = &points[b * dims..(b + 1) * dims];
+        a.iter()
+            .rev()
+            .zip(b.iter().rev())
+            .map(|(x, y)| y.total_cmp(x))
+            .find(|o| *o != Ordering::Equal)
+            .unwrap_or(Ordering::Equal)
+    });
+    for (row, source) in scratch.chunks_exact_mut(dims).zip(order.iter()) {
+        row.copy_from_slice(&points[source * dims..(source + 1) * dims]);
+    }
+    mem::swap(points, scratch);
+}
+
+/// Calculate the hyper-volume of the first `count` points in the first level. The other levels
+/// are used to store the limit sets of the following depths.
+///
+/// # Arguments
+///
+/// * `levels`: The buffers from the current depth.
+/// * `count`: The number of points in the current level.
+/// * `reference_point`: The reference point.
+///
+/// returns: `f64`
+fn volume(levels: &mut [Level], count: usize, reference_point: &[f64]) -> f64 {
+    let (level, children) = levels
+        .split_first_mut()
+        .expect("the workspace has one level per depth");
+    let dims = level.dims;
+    if count == 1 {
+        return level.points[..dims]
+            .iter()
+            .zip(reference_point)
+            .map(|(v, r)| r - v)
+            .product();
+    }
+    level.sort(count);
+    let points = &level.points[..count * dims];
+    if dims == 2 {
+        return volume_2d(points, reference_point);
+    }
+
+    let last = dims - 1;
+    let mut volume = 0.0;
+    for i in (0..count).rev() {
+        volume += (reference_point[last] - points[i * dims + last])
+            * exclusive_hv(points, dims, i, children, reference_point);
+    }
+    volume
+}
+
+/// Calculate the hyper-volume of a front with two objectives sorted with [`sort_rows`].
+///
+/// # Arguments
+///
+/// * `points`: The points stored by row.
+/// * `reference_point`: The reference point.
+///
+/// returns: `f64`
+fn volume_2d(points: &[f64], reference_point: &[f64]) -> f64 {
+    let mut volume = 0.0;
+    let mut previous_y = reference_point[1];
+    for p in points.chunks_exact(2) {
+        volume += (reference_point[0] - p[0]) * (previous_y - p[1]);
+        previous_y = p[1];
+    }
+    volume
+}
+
+/// Calculate the exclusive hyper-volume of the point `index`, using its first
+/// `parent_dims - 1` objectives, relative to the points that follow it in the front.
+///
+/// # Arguments
+///
+/// * `points`: The points of the front stored by row.
+/// * `parent_dims`: The number of objectives of the points in `points`.
+/// * `index`: The index of the point.
+/// * `levels`: The buffers for the limit sets of the following depths.
+/// * `reference_point`: The reference point.
+///
+/// returns: `f64`
+fn exclusive_hv(
+    points: &[f64],
+    parent_dims: usize,
+    index: usize,
+    levels: &mut [Level],
+    reference_point: &[f64],
+) -> f64 {
+    let dims = parent_dims - 1;
+    let start = index * parent_dims;
+    let point = &points[start..start + dims];
+    let mut exclusive: f64 = point
+        .iter()
+        .zip(reference_point)
+        .map(|(v, r)| r - v)
+        .product();
+
+    if start + parent_dims < points.len() {
+        let count = limit_set(points, parent_dims, index, &mut levels[0]);
+        exclusive -= volume(levels, count, reference_point);
+    }
+    exclusive
+}
+
+/// Build the limit set of the point `index` in the buffer of `level`: each point after `index`
+/// is replaced with the worst objective values between the two points, using the first
+/// `level.dims` objectives, and the dominated points are removed.
+///
+/// # Arguments
+///
+/// * `points`: The points of the front stored by row.
+/// * `parent_dims`: The number of objectives of the points in `points`.
+/// * `index`: The index of the point.
+/// * `level`: The level where the limit set is stored.
+///
+/// returns: `usize`: The number of points in the limit set.
+fn limit_set(points: &[f64], parent_dims: usize, index: usize, level: &mut Level) -> usize {
+    let dims = level.dims;
+    let buffer = &mut level.points;
+    let point = &points[index * parent_dims..index * parent_dims + dims];
+
+    let mut count = 0;
+    for other in points[(index + 1) * parent_dims..].chunks_exact(parent_dims) {
+        // the candidate is written after the points kept so far
+        let candidate = count;
+        for ((c, p), o) in buffer[candidate * dims..(candidate + 1) * dims]
+            .iter_mut()
+            .zip(point)
+            .zip(other)
+        {
+            *c = p.max(*o);
+        }
+
+        let mut keep = true;
+        let mut k = 0;
+        while k < count {
+            let (kept, rest) = buffer.split_at(candidate * dims);
+            match compare(&kept[k * dims..(k + 1) * dims], &rest[..dims]) {
+                Ordering::Less => {
+                    keep = false;
+                    break;
+                }
+                Ordering::Greater => {
+                    // the kept point is dominated: replace it with the last kept point
+                    count -= 1;
+                    buffer.copy_within(count * dims..(count + 1) * dims, k * dims);
+                }
+                Ordering::Equal => k += 1,
+            }
+        }
+        if keep {
+            buffer.copy_within(candidate * dims..(candidate + 1) * dims, count * dims);
+            count += 1;
+        }
+    }
+    count
+}
+
+/// Compare two points.
+///
+/// # Arguments
+///
+/// * `a`: The first point.
+/// * `b`: The second point.
+///
+/// returns: `Ordering`: [`Ordering::Less`] if `a` weakly dominates `b` (including when the points
+/// are equal), [`Ordering::Greater`] if `b` dominates `a` and [`Ordering::Equal`] if the points
+/// are not dominated by each other.
+fn compare(a: &[f64], b: &[f64]) -> Ordering {
+    let mut a_better = true;
+    let mut b_better = true;
+    for (x, y) in a.iter().zip(b) {
+        a_better &= x <= y;
+        b_better &= y <= x;
+        if !a_better && !b_better {
+            return Ordering::Equal;
+        }
+    }
+    if a_better {
+        Ordering::Less
+    } else {
+        Ordering::Greater
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use float_cmp::assert_approx_eq;
+    use rand::{Rng, SeedableRng};
+    use rand_chacha::ChaCha8Rng;
+
+    use crate::metrics::hv_wfg::engine::hyper_volume;
+    use crate::metrics::hv_wfg::wfg::{Optimisation, Wfg};
+    use crate::metrics::hypervolume::non_dominated_points;
+
+    #[test]
+    fn test_3d() {
+        let ref_point = vec![10.0; 3];
+        let data = [
+            0.500999867734,
+            0.501000000033,
+            0.500999987997,
+            9.84167759049e-09,
+            2.36154644108e-09,
+            0.499999987997,
+            0.499999867734,
+            1.32416636196e-07,
+            3.33066907488e-16,
+            2.52520317534e-18,
+            2.01754168497e-08,
+            0.499999979974,
+            3.06183729901e-12,
+            0.500000000033,
+            0.0,
+        ];
+        assert_approx_eq!(
+            f64,
+            hyper_volume(&data, &ref_point, false),
+            999.874999,
+            epsilon = 0.0001
+        );
+    }
+
+    #[test]
+    /// Compare the engine with the original implementation on random fronts.
+    fn test_random_fronts() {
+        let mut rng = ChaCha8Rng::seed_from_u64(1);
+        for dims in 2..=6 {
+            let reference_point = vec![1.0; dims];
+            let points: Vec<f64> = (0..60 * dims).map(|_| rng.gen_range(0.0..1.0)).collect();
+            let front = non_dominated_points(&points, &reference_point);
+            let expected = Wfg::new(&front, &reference_point, Optimisation::O2)
+                .calculate()
+                .unwrap();
+
+            let front = front.concat();
+            let serial = hyper_volume(&front, &reference_point, false);
+            assert_approx_eq!(f64, serial, expected, epsilon = 1e-9);
+            assert_eq!(hyper_volume(&front, &reference_point, true), serial);
+        }
+    }
+}
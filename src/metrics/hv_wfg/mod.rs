@@ -3,11 +3,13 @@ use std::mem;
 use log::{debug, warn};
 
 use crate::core::{Individual, Individuals, OError};
-use crate::metrics::hv_wfg::wfg::{Optimisation, Wfg};
 use crate::metrics::hypervolume::{check_args, check_ref_point_coordinate};
 use crate::utils::fast_non_dominated_sort;
 
-mod wfg;
+pub(crate) mod engine;
+/// The original implementation, kept as a reference for the tests and the benchmarks.
+#[cfg_attr(not(any(test, feature = "bench")), allow(dead_code))]
+pub(crate) mod wfg;
 
 /// Calculate the hyper-volume using the WFG algorithm proposed by [While et al. (2012)](http://dx.doi.org/10.1109/TEVC.2010.2077298)
 /// for a problem with `d` objectives and `n` individuals.
@@ -18,15 +20,16 @@ mod wfg;
 ///    not contribute do the metric.
 /// 2) The coordinates of maximised objectives of the reference point are multiplied by -1 as the
 ///    algorithm assumes all objectives are maximised.
+/// 3) The points are stored in flat buffers, one for each recursion depth, that are allocated
+///    once, and the exclusive hyper-volumes of the points in the front are calculated in
+///    parallel.
 #[derive(Debug)]
 pub struct HyperVolumeWhile2012 {
-    /// The individuals to use. The size of this vector corresponds to the individual size and the
-    /// size of the nested vector corresponds to the number of problem objectives.
-    individuals: Vec<Vec<f64>>,
+    /// The objective values of the individuals stored by row. Each row has a size equal to the
+    /// number of problem objectives.
+    objective_values: Vec<f64>,
     /// The reference point.
     reference_point: Vec<f64>,
-    /// The name of this metric
-    metric_name: String,
 }
 
 impl HyperVolumeWhile2012 {
@@ -67,10 +70,10 @@ impl HyperVolumeWhile2012 {
         }
 
         // Collect objective values - invert the sign of minimised objectives
-        let objective_values = individuals
+        let objective_values: Vec<f64> = individuals
             .iter()
-            .map(|ind| ind.get_objective_values())
-            .collect::<Result<Vec<Vec<f64>>, _>>()?;
+            .flat_map(|ind| ind.objective_values_slice().iter().copied())
+            .collect();
 
         // flip sign of maximised coordinates for the reference point
         let mut ref_point = reference_point.to_vec();
@@ -84,9 +87,8 @@ impl HyperVolumeWhile2012 {
         debug!("Reference point is {:?}", ref_point);
 
         Ok(Self {
-            individuals: objective_values,
+            objective_values,
             reference_point: ref_point,
-            metric_name,
         })
     }
 
@@ -94,9 +96,11 @@ impl HyperVolumeWhile2012 {
     ///
     /// return: `Result<f64, OError>`
     pub fn compute(&mut self) -> Result<f64, OError> {
-        let wfg = Wfg::new(&self.individuals, &self.reference_point, Optimisation::O2);
-        wfg.calculate()
-            .map_err(|e| OError::Metric(self.metric_name.clone(), e))
+        Ok(engine::hyper_volume(
+            &self.objective_values,
+            &self.reference_point,
+            true,
+        ))
     }
 }
 
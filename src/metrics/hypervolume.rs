@@ -1,12 +1,18 @@
 use std::collections::HashMap;
+use std::path::Path;
 use std::sync::Arc;
 
 use chrono::{DateTime, Utc};
+use rayon::prelude::*;
 use serde::de::DeserializeOwned;
 use serde::Serialize;
 
-use crate::algorithms::AlgorithmSerialisedExport;
+use crate::algorithms::history::{HistoryColumns, HistoryReader};
+use crate::algorithms::{AlgorithmSerialisedExport, GenerationObjectives};
+use hv_fonseca_et_al_2006_sys::{calculate_hv_matrix_ordered, ObjectiveMatrix};
+
 use crate::core::{Individual, Individuals, OError, Objective, ObjectiveDirection, Problem};
+use crate::metrics::hv_wfg::engine;
 use crate::metrics::hypervolume_2d::HyperVolume2D;
 use crate::metrics::{HyperVolumeFonseca2006, HyperVolumeWhile2012};
 use crate::utils::vector_max;
@@ -88,7 +94,26 @@ pub(crate) fn check_ref_point_coordinate(
 ) -> Result<(), String> {
     // the reference point must dominate all objectives
     let max_obj = vector_max(objective_values).map_err(|e| e.to_string())?;
+    check_ref_point_bound(max_obj, objective, ref_point_coordinate, coordinate_idx)
+}
 
+/// Same as [`check_ref_point_coordinate`], but with the maximum value of the objective already
+/// calculated.
+///
+/// # Arguments
+///
+/// * `max_obj`: The maximum value of the objective from the individuals.
+/// * `objective`: The objective being checked.
+/// * `ref_point_coordinate`: The coordinate of the reference point.
+/// * `coordinate_idx`: The index or position of the coordinate (for example 3 for z-coordinate).
+///
+/// returns: `Result<(), String>`
+pub(crate) fn check_ref_point_bound(
+    max_obj: f64,
+    objective: &Objective,
+    ref_point_coordinate: f64,
+    coordinate_idx: usize,
+) -> Result<(), String> {
     if (objective.direction() == ObjectiveDirection::Minimise) & (ref_point_coordinate <= max_obj) {
         return Err(
             format!(
@@ -113,16 +138,49 @@ pub(crate) fn check_ref_point_coordinate(
     Ok(())
 }
 
+/// Get the points of a set, stored in a flat row-major buffer, which strictly dominate the
+/// reference point and are not dominated by any other point in the set. Duplicated points are
+/// only returned once. All objectives are assumed to be minimised.
+///
+/// # Arguments
+///
+/// * `points`: The objective values of the points.
+/// * `reference_point`: The reference point.
+///
+/// returns: `Vec<Vec<f64>>`: The non-dominated points.
+pub(crate) fn non_dominated_points(points: &[f64], reference_point: &[f64]) -> Vec<Vec<f64>> {
+    let candidates: Vec<&[f64]> = points
+        .chunks_exact(reference_point.len())
+        .filter(|p| p.iter().zip(reference_point).all(|(v, r)| v < r))
+        .collect();
+
+    candidates
+        .iter()
+        .enumerate()
+        .filter(|(i, p)| {
+            !candidates.iter().enumerate().any(|(j, q)| {
+                j != *i && q.iter().zip(p.iter()).all(|(qv, pv)| qv <= pv) && (j < *i || q != *p)
+            })
+        })
+        .map(|(_, p)| p.to_vec())
+        .collect()
+}
+
 /// Struct with methods to calculate the exact hyper-volume metric. Depending on the number of problem
 /// objectives `n`, a different method is used to ensure a correct and fast calculation:
 ///
 /// - with `2` objectives: by calculating the rectangle areas between each objective point and
 ///   the reference point.
-/// - with `3` objectives: by using the algorithm proposed by [Fonseca et al. (2006)](http://dx.doi.org/10.1109/CEC.2006.1688440)
-///   in [`HyperVolumeFonseca2006`].
-/// - with `4` or more objectives:  by using the algorithm proposed by [While et al. (2012)](http://dx.doi.org/10.1109/TEVC.2010.2077298)
+/// - with `3` to `6` objectives: by using the algorithm proposed by [Fonseca et al. (2006)](http://dx.doi.org/10.1109/CEC.2006.1688440)
+///   in [`HyperVolumeFonseca2006`]. With more than 3 objectives, the objectives are reordered
+///   first to speed up the calculation.
+/// - with `7` or more objectives:  by using the algorithm proposed by [While et al. (2012)](http://dx.doi.org/10.1109/TEVC.2010.2077298)
 ///   in [`HyperVolumeWhile2012`].
 ///
+/// With many objectives (for example more than 8), the exact calculation may be too slow; the
+/// metric can then be estimated with [`crate::metrics::HyperVolumeMonteCarlo`], which also
+/// returns a confidence interval of the estimate.
+///
 /// The hyper-volume can be calculated from the following sources:
 /// - an array of [`Individual`] using [`HyperVolume::from_individual`]
 /// - an array of objectives given as `f64` using [`HyperVolume::from_values`]
@@ -206,7 +264,7 @@ impl HyperVolume {
                 let hv = HyperVolume2D::new(individuals, reference_point)?;
                 hv.compute()
             }
-            3 => {
+            3..=6 => {
                 let hv = HyperVolumeFonseca2006::new(individuals, reference_point)?;
                 hv.compute()
             }
@@ -284,7 +342,8 @@ impl HyperVolume {
     }
 
     /// Calculate the hyper-volume using the serialised objective values (i.e. exported in a JSON
-    /// file using [`crate::algorithms::Algorithm::save_to_json`]).
+    /// file using [`crate::algorithms::Algorithm::save_to_json`]). The metric for each file is
+    /// calculated in parallel.
     ///
     /// # Arguments
     ///
@@ -295,12 +354,12 @@ impl HyperVolume {
     ///
     /// returns: `Result<AllHyperVolumeFileData, OError>`: the hyper-volume values and the file
     /// information.
-    pub fn from_files<AlgorithmOptions: Serialize + DeserializeOwned>(
+    pub fn from_files<AlgorithmOptions: Serialize + DeserializeOwned + Sync>(
         data: &[AlgorithmSerialisedExport<AlgorithmOptions>],
         reference_point: &[f64],
     ) -> Result<AllHyperVolumeFileData, OError> {
         let mut results = data
-            .iter()
+            .par_iter()
             .map(|p| HyperVolume::from_file::<AlgorithmOptions>(p, reference_point))
             .collect::<Result<Vec<HyperVolumeFileData>, OError>>()?;
 
@@ -308,6 +367,212 @@ impl HyperVolume {
         Ok(AllHyperVolumeFileData(results))
     }
 
+    /// Calculate the hyper-volume of each generation stored in a binary history file (exported
+    /// with [`crate::algorithms::HistoryFormat::Binary`]). Only the objective values are read
+    /// from the file and the metric for each generation is calculated in parallel.
+    ///
+    /// # Arguments
+    ///
+    /// * `file`: The path to the history file.
+    /// * `reference_point`: The reference or anti-optimal point to use in the calculation.
+    ///
+    /// returns: `Result<AllHyperVolumeFileData, OError>`: the hyper-volume values and the
+    /// generation information.
+    pub fn from_history_file(
+        file: &Path,
+        reference_point: &[f64],
+    ) -> Result<AllHyperVolumeFileData, OError> {
+        let mut reader = HistoryReader::open(file)?;
+        let blocks = reader.read_blocks(HistoryColumns::OBJECTIVES)?;
+        let header = reader.header();
+        let problem: Problem = header.problem.clone().try_into()?;
+        let problem = Arc::new(problem);
+        let names = &header.problem.objective_names;
+        // the stored values are minimised, restore the sign of maximised objectives since
+        // `update_objective` inverts it again
+        let signs = names
+            .iter()
+            .map(|name| {
+                Ok(if problem.is_objective_minimised(name)? {
+                    1.0
+                } else {
+                    -1.0
+                })
+            })
+            .collect::<Result<Vec<f64>, OError>>()?;
+
+        let mut results = blocks
+            .par_iter()
+            .map(|block| {
+                let mut individuals = block
+                    .objectives
+                    .chunks_exact(names.len())
+                    .map(|values| {
+                        let mut ind = Individual::new(problem.clone());
+                        for ((name, value), sign) in names.iter().zip(values).zip(&signs) {
+                            ind.update_objective(name, sign * value)?;
+                        }
+                        Ok(ind)
+                    })
+                    .collect::<Result<Vec<Individual>, OError>>()?;
+                Ok(HyperVolumeFileData {
+                    generation: block.metadata.generation,
+                    time: block.metadata.exported_on,
+                    value: HyperVolume::from_individual(&mut individuals, reference_point)?,
+                })
+            })
+            .collect::<Result<Vec<HyperVolumeFileData>, OError>>()?;
+
+        results.sort_by_key(|r| r.generation);
+        Ok(AllHyperVolumeFileData(results))
+    }
+
+    /// Calculate the hyper-volume of each generation from the objective values read with
+    /// [`crate::algorithms::Algorithm::read_objective_files`]. The metric is calculated with
+    /// [`HyperVolume::from_batch`] directly on the objective matrices, without building the
+    /// individuals, and the metric for each generation is calculated in parallel. Points that do
+    /// not strictly dominate the reference point are excluded from the calculation.
+    ///
+    /// # Arguments
+    ///
+    /// * `data`: The objective values of each generation.
+    /// * `reference_point`: The reference or anti-optimal point to use in the calculation. The
+    ///    coordinates of maximised objectives are given with their original sign, as in
+    ///    [`HyperVolume::from_individual`].
+    ///
+    /// returns: `Result<AllHyperVolumeFileData, OError>`: the hyper-volume values and the
+    /// generation information.
+    pub fn from_objectives(
+        data: &[GenerationObjectives],
+        reference_point: &[f64],
+    ) -> Result<AllHyperVolumeFileData, OError> {
+        let mut results = data
+            .par_iter()
+            .map(|g| {
+                if g.number_of_objectives() != reference_point.len() {
+                    return Err(OError::Metric(
+                        "Hyper-volume".to_string(),
+                        format!(
+                            "The reference point size ({}) must match the number of objectives ({})",
+                            reference_point.len(),
+                            g.number_of_objectives()
+                        ),
+                    ));
+                }
+                // all objectives are minimised in the matrix
+                let reference_point: Vec<f64> = reference_point
+                    .iter()
+                    .zip(&g.directions)
+                    .map(|(coordinate, direction)| match direction {
+                        ObjectiveDirection::Minimise => *coordinate,
+                        ObjectiveDirection::Maximise => -coordinate,
+                    })
+                    .collect();
+                let value = HyperVolume::from_batch(
+                    &g.values,
+                    &[g.number_of_individuals()],
+                    &reference_point,
+                )?[0];
+                Ok(HyperVolumeFileData {
+                    generation: g.generation,
+                    time: g.exported_on,
+                    value,
+                })
+            })
+            .collect::<Result<Vec<HyperVolumeFileData>, OError>>()?;
+
+        results.sort_by_key(|r| r.generation);
+        Ok(AllHyperVolumeFileData(results))
+    }
+
+    /// Calculate the exact hyper-volume metric of many sets of points sharing the same reference
+    /// point. The objective values of all sets are stored in one flat row-major buffer and the
+    /// size of each set is given with the cumulative sizes, using the same layout of the files read
+    /// by the `hv` program by Fonseca et al. (2006). This avoids building an [`Individual`] for
+    /// each point and the metric of each set is calculated in parallel.
+    ///
+    /// **IMPLEMENTATION NOTES**:
+    /// 1) All objectives are assumed to be minimised. The values of maximised objectives must be
+    ///    multiplied by -1 (as well as the reference point coordinates).
+    /// 2) Points that do not strictly dominate the reference point are excluded from the
+    ///    calculation. An empty set has a hyper-volume of 0.
+    /// 3) Sets with 2 to 6 objectives use [`HyperVolumeFonseca2006`] (with reordered objectives
+    ///    when there are more than 3); for more objectives, dominated points are removed and
+    ///    [`HyperVolumeWhile2012`] is used.
+    ///
+    /// # Arguments
+    ///
+    /// * `data`: The objective values of all points. The values of the `i`-th point are stored
+    ///    from index `i * d` to `(i + 1) * d` (excluded), where `d` is the size of `reference_point`.
+    /// * `cumsizes`: The cumulative number of points. The `k`-th set contains the points from
+    ///    `cumsizes[k-1]` (or 0 for the first set) to `cumsizes[k]` (excluded).
+    /// * `reference_point`: The reference or anti-optimal point to use in the calculation.
+    ///
+    /// returns: `Result<Vec<f64>, OError>`: The hyper-volume of each set.
+    pub fn from_batch(
+        data: &[f64],
+        cumsizes: &[usize],
+        reference_point: &[f64],
+    ) -> Result<Vec<f64>, OError> {
+        let metric_name = "Hyper-volume".to_string();
+        let number_of_objectives = reference_point.len();
+        if number_of_objectives < 2 {
+            return Err(OError::Metric(
+                metric_name,
+                "The reference point must have at least 2 coordinates".to_string(),
+            ));
+        }
+        if data.len() % number_of_objectives != 0 {
+            return Err(OError::Metric(
+                metric_name,
+                format!(
+                    "The data size ({}) is not a multiple of the number of objectives ({})",
+                    data.len(),
+                    number_of_objectives
+                ),
+            ));
+        }
+        if cumsizes.windows(2).any(|w| w[0] > w[1]) {
+            return Err(OError::Metric(
+                metric_name,
+                "The cumulative sizes must be non-decreasing".to_string(),
+            ));
+        }
+        let total_points = data.len() / number_of_objectives;
+        if cumsizes.last().copied().unwrap_or(0) != total_points {
+            return Err(OError::Metric(
+                metric_name,
+                format!(
+                    "The last cumulative size ({}) must match the number of points ({})",
+                    cumsizes.last().copied().unwrap_or(0),
+                    total_points
+                ),
+            ));
+        }
+
+        (0..cumsizes.len())
+            .into_par_iter()
+            .map(|k| {
+                let start = if k == 0 { 0 } else { cumsizes[k - 1] };
+                let points =
+                    &data[start * number_of_objectives..cumsizes[k] * number_of_objectives];
+                if points.is_empty() {
+                    return Ok(0.0);
+                }
+
+                if number_of_objectives <= 6 {
+                    let matrix =
+                        ObjectiveMatrix::new(points, cumsizes[k] - start, number_of_objectives)
+                            .map_err(|e| OError::Metric(metric_name.clone(), e))?;
+                    Ok(calculate_hv_matrix_ordered(&matrix, reference_point))
+                } else {
+                    let front = non_dominated_points(points, reference_point).concat();
+                    Ok(engine::hyper_volume(&front, reference_point, true))
+                }
+            })
+            .collect()
+    }
+
     /// Add or remove the offset from the reference point.
     ///
     /// # Arguments
@@ -459,6 +724,70 @@ impl HyperVolume {
         let ref_point = HyperVolume::add_offset(&ref_point, offset, &problem)?;
         Ok(ref_point)
     }
+
+    /// Calculates a reference point by taking the maximum of each objective (or minimum if the
+    /// objective is maximised) from the objective values read with
+    /// [`crate::algorithms::Algorithm::read_objective_files`]. This is equivalent to
+    /// [`HyperVolume::estimate_reference_point_from_files`] but does not build the individuals.
+    ///
+    /// # Arguments
+    ///
+    /// * `data`: The objective values of each generation.
+    /// * `offset`: The offset to add to each objective coordinate of the calculated reference
+    ///    point. This must have a size equal to the number of objectives.
+    ///
+    /// returns: `Result<Vec<f64>, OError>` The reference point. This returns an error if there are
+    /// no individuals or the size of the offset does not match the number of objectives.
+    pub fn estimate_reference_point_from_objectives(
+        data: &[GenerationObjectives],
+        offset: Option<Vec<f64>>,
+    ) -> Result<Vec<f64>, OError> {
+        let metric_name = "reference_point".to_string();
+        let Some(first) = data.iter().find(|g| g.number_of_individuals() > 0) else {
+            return Err(OError::Metric(
+                metric_name,
+                "There are no individuals in the array".to_string(),
+            ));
+        };
+        let number_of_objectives = first.number_of_objectives();
+        if let Some(ref offset) = offset {
+            if offset.len() != number_of_objectives {
+                return Err(OError::Metric(
+                    metric_name,
+                    format!(
+                        "The offset size ({}) must match the number of problem objectives ({})",
+                        offset.len(),
+                        number_of_objectives
+                    ),
+                ));
+            }
+        }
+
+        // the worst value of each objective is the maximum as all objectives are minimised
+        let mut worst = vec![f64::NEG_INFINITY; number_of_objectives];
+        for g in data {
+            for values in g.values.chunks_exact(number_of_objectives) {
+                for (w, v) in worst.iter_mut().zip(values) {
+                    *w = w.max(*v);
+                }
+            }
+        }
+
+        // invert coordinate when maximised to return original value and add the offset
+        let ref_point = worst
+            .iter()
+            .zip(&first.directions)
+            .enumerate()
+            .map(|(idx, (coordinate, direction))| {
+                let sign = match direction {
+                    ObjectiveDirection::Minimise => 1.0,
+                    ObjectiveDirection::Maximise => -1.0,
+                };
+                sign * coordinate + offset.as_ref().map_or(0.0, |o| sign * o[idx])
+            })
+            .collect();
+        Ok(ref_point)
+    }
 }
 
 #[cfg(test)]
@@ -470,12 +799,14 @@ mod test {
     use float_cmp::assert_approx_eq;
 
     use crate::algorithms::{Algorithm, NSGA2};
+    use crate::core::test_utils::individuals_from_obj_values_dummy;
     use crate::core::test_utils::{assert_approx_array_eq, individuals_from_obj_values_ztd1};
     use crate::core::utils::dummy_evaluator;
     use crate::core::{
         BoundedNumber, Individual, Objective, ObjectiveDirection, Problem, VariableType,
     };
-    use crate::metrics::hypervolume::HyperVolume;
+    use crate::metrics::hypervolume::{non_dominated_points, HyperVolume};
+    use crate::metrics::test_utils::parse_pagmo_test_data_file;
 
     #[test]
     /// Test when the estimate_reference_point function panics
@@ -572,4 +903,111 @@ mod test {
         let expected = [0.9999, 1.0000];
         assert_approx_array_eq(&found, &expected, Some(0.001));
     }
+
+    /// Compare the batched hyper-volume against the value calculated for each set of individuals.
+    /// All sets use the same reference point, which is the worst point of all Pagmo tests.
+    ///
+    /// # Arguments
+    ///
+    /// * `file`: The file name in the `test_data` folder.
+    ///
+    /// returns: ()
+    fn assert_batch_test_file(file: &str) {
+        let all_test_data = parse_pagmo_test_data_file(file).unwrap();
+        let obj_count = all_test_data.first().unwrap().reference_point.len();
+        let objective_direction = vec![ObjectiveDirection::Minimise; obj_count];
+
+        let mut ref_point = vec![f64::NEG_INFINITY; obj_count];
+        let mut data: Vec<f64> = vec![];
+        let mut cumsizes: Vec<usize> = vec![];
+        for test_data in all_test_data.iter() {
+            for (j, r) in test_data.reference_point.iter().enumerate() {
+                ref_point[j] = ref_point[j].max(*r);
+            }
+            data.extend(test_data.objective_values.iter().flatten());
+            cumsizes.push(cumsizes.last().copied().unwrap_or(0) + test_data.objective_values.len());
+        }
+
+        let calculated = HyperVolume::from_batch(&data, &cumsizes, &ref_point).unwrap();
+        assert_eq!(calculated.len(), all_test_data.len());
+        for (test_data, value) in all_test_data.iter().zip(calculated) {
+            let mut individuals = individuals_from_obj_values_dummy(
+                &test_data.objective_values,
+                &objective_direction,
+                None,
+            );
+            let expected = HyperVolume::from_individual(&mut individuals, &ref_point).unwrap();
+            assert_approx_eq!(f64, value, expected, epsilon = 0.00001);
+        }
+    }
+
+    #[test]
+    /// Test the batched hyper-volume using Pagmo c_max_t100_d2_n128 test data.
+    fn test_from_batch_d2() {
+        assert_batch_test_file("c_max_t100_d2_n128");
+    }
+
+    #[test]
+    /// Test the batched hyper-volume using Pagmo c_max_t100_d3_n128 test data.
+    fn test_from_batch_d3() {
+        assert_batch_test_file("c_max_t100_d3_n128");
+    }
+
+    #[test]
+    /// Test the batched hyper-volume with 5 objectives using Pagmo c_max_t1_d5_n1024 test data.
+    fn test_from_batch_d5() {
+        let all_test_data = parse_pagmo_test_data_file("c_max_t1_d5_n1024").unwrap();
+        let test_data = all_test_data.first().unwrap();
+        let data: Vec<f64> = test_data
+            .objective_values
+            .iter()
+            .flatten()
+            .cloned()
+            .collect();
+        let cumsizes = [0, test_data.objective_values.len()];
+
+        let calculated =
+            HyperVolume::from_batch(&data, &cumsizes, &test_data.reference_point).unwrap();
+        assert_eq!(calculated[0], 0.0);
+        assert_approx_eq!(f64, calculated[1], test_data.hyper_volume, epsilon = 0.001);
+    }
+
+    #[test]
+    /// Test the errors of the batched hyper-volume.
+    fn test_from_batch_errors() {
+        let data = [1.0, 2.0, 2.0, 1.0];
+        let err = HyperVolume::from_batch(&data, &[2], &[3.0, 3.0, 3.0])
+            .unwrap_err()
+            .to_string();
+        assert!(err.contains("is not a multiple of the number of objectives"));
+
+        let err = HyperVolume::from_batch(&data, &[2, 1], &[3.0, 3.0])
+            .unwrap_err()
+            .to_string();
+        assert!(err.contains("must be non-decreasing"));
+
+        let err = HyperVolume::from_batch(&data, &[1], &[3.0, 3.0])
+            .unwrap_err()
+            .to_string();
+        assert!(err.contains("must match the number of points (2)"));
+
+        assert_eq!(
+            HyperVolume::from_batch(&data, &[1, 2], &[3.0, 3.0]).unwrap(),
+            vec![2.0, 2.0]
+        );
+    }
+
+    #[test]
+    /// Test the non-dominated filter used by the batched hyper-volume.
+    fn test_non_dominated_points() {
+        let data = [
+            1.0, 2.0, // non-dominated
+            2.0, 1.0, // non-dominated
+            2.0, 2.0, // dominated
+            1.0, 2.0, // duplicated
+            0.5, 4.0, // does not dominate the reference point
+        ];
+        let points = non_dominated_points(&data, &[3.0, 3.0]);
+        assert_eq!(points, vec![vec![1.0, 2.0], vec![2.0, 1.0]]);
+    }
 }
@@ -1,19 +1,17 @@
-use std::mem;
-
-use crate::core::{Individual, Individuals, OError, ObjectiveDirection};
-use crate::metrics::hypervolume::{check_args, check_ref_point_coordinate};
-use crate::utils::fast_non_dominated_sort;
+use crate::core::{Individual, OError, ObjectiveDirection};
+use crate::metrics::hypervolume::{check_args, check_ref_point_bound};
+use crate::utils::fixed_objectives::row;
+use crate::utils::non_dominated_sort_indexes;
 
 /// Calculate the hyper-volume for a two-objective problem by summing the areas rectangle of the
 /// rectangles between the Pareto front and the chosen `reference_point`.
 #[derive(Debug)]
 pub struct HyperVolume2D {
-    /// The objective to use. The size of this vector corresponds to th number of problem
-    /// objectives (2) and he size of the nested vector corresponds to the number of individuals in
-    /// the first Pareto front (of rank 1).
-    objective_values: Vec<Vec<f64>>,
+    /// The objective values of the individuals in the first Pareto front (of rank 1), sorted in
+    /// descending order by the first objective.
+    points: Vec<[f64; 2]>,
     /// The reference point.
-    reference_point: Vec<f64>,
+    reference_point: [f64; 2],
 }
 
 impl HyperVolume2D {
@@ -32,6 +30,8 @@ impl HyperVolume2D {
     ///    the calculation.
     /// 4) If `individuals` or the resulting Pareto front does not contain more than 2 points, a
     ///    zero hyper-volume is returned.
+    /// 5) The objective values of the front are copied into `[f64; 2]` rows and sorted once, so
+    ///    that [`HyperVolume2D::compute`] is a single sweep over the points.
     ///
     /// # Arguments
     ///
@@ -67,27 +67,46 @@ impl HyperVolume2D {
 
         // get non-dominated front
         let problem = individuals[0].problem();
-        let mut front_data = fast_non_dominated_sort(individuals, true)?;
-        let individuals = mem::take(&mut front_data.fronts[0]);
+        let front = non_dominated_sort_indexes(individuals, true)?
+            .front_indexes
+            .swap_remove(0);
+        let mut points: Vec<[f64; 2]> = front
+            .iter()
+            .map(|idx| *row::<2>(individuals[*idx].objective_values_slice(), 0))
+            .collect();
+
+        // the maximum of both objectives is calculated in one pass
+        let mut max_values = points[0];
+        for point in &points {
+            for (max_value, value) in max_values.iter_mut().zip(point) {
+                if value.total_cmp(max_value).is_gt() {
+                    *max_value = *value;
+                }
+            }
+        }
 
         // change sign for reference point coordinate. All methods below assume that objectives are minimised.
-        let mut ref_point = reference_point.to_vec();
-        let mut objective_values: Vec<Vec<f64>> = Vec::new();
-        for (obj_idx, (obj_name, obj)) in problem.objectives().iter().enumerate() {
+        let mut ref_point = [reference_point[0], reference_point[1]];
+        for (obj_idx, (_, obj)) in problem.objectives().iter().enumerate() {
             if obj.direction() == ObjectiveDirection::Maximise {
                 ref_point[obj_idx] *= -1.0;
             };
-            let objectives = individuals.objective_values(obj_name)?;
 
             // the reference point must dominate all objectives
-            check_ref_point_coordinate(&objectives, obj, reference_point[obj_idx], obj_idx + 1)
-                .map_err(|e| OError::Metric(metric_name.clone(), e))?;
-
-            objective_values.push(objectives);
+            check_ref_point_bound(
+                max_values[obj_idx],
+                obj,
+                reference_point[obj_idx],
+                obj_idx + 1,
+            )
+            .map_err(|e| OError::Metric(metric_name.clone(), e))?;
         }
 
+        // Sort points in descending order by objective 1
+        points.sort_by(|a, b| b[0].total_cmp(&a[0]));
+
         Ok(Self {
-            objective_values,
+            points,
             reference_point: ref_point,
         })
     }
@@ -96,34 +115,18 @@ impl HyperVolume2D {
     ///
     /// return: `f64`
     pub fn compute(&self) -> f64 {
-        // no points in the front
-        if self.objective_values.first().is_none() {
-            return 0.0;
-        }
-
-        // HyperVolume2D::new ensures that there are always 2 objectives and therefore unwrap never
-        // panics
-        let obj1 = self.objective_values.first().unwrap();
-        let obj2 = self.objective_values.last().unwrap();
-
-        // Sort points in descending order by objective 1
-        let mut zipped: Vec<_> = obj1.iter().zip(obj2).collect();
-        zipped.sort_by(|(a, _), (b, _)| b.total_cmp(a));
-        let (obj1_sorted, obj2_sorted): (Vec<f64>, Vec<f64>) = zipped.into_iter().unzip();
-
-        // rectangle heights (last rectangle is between max y point and reference point)
-        let mut y_rectangles = obj2_sorted.clone();
-        y_rectangles.push(self.reference_point[1]);
-        let heights: Vec<f64> = y_rectangles
-            .windows(2)
-            .map(|y| f64::abs(y[0] - y[1]))
-            .collect();
+        let [ref_x, ref_y] = self.reference_point;
 
-        // get rectangle areas (x is always between objective 1 and reference point)
-        obj1_sorted
+        // the rectangle height is between the point and the next one (the last rectangle is
+        // between max y point and reference point), while x is always between objective 1 and
+        // reference point
+        self.points
             .iter()
-            .zip(heights)
-            .map(|(x_o1, h)| (self.reference_point[0] - x_o1).abs() * h.abs())
+            .enumerate()
+            .map(|(idx, [x, y])| {
+                let next_y = self.points.get(idx + 1).map_or(ref_y, |next| next[1]);
+                (ref_x - x).abs() * (y - next_y).abs()
+            })
             .sum()
     }
 }
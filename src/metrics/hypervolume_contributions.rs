@@ -0,0 +1,787 @@
+use std::cmp::Ordering;
+use std::collections::BTreeMap;
+use std::ops::Bound::{Excluded, Unbounded};
+
+use rayon::prelude::*;
+
+use crate::core::{DataValue, Individual, OError};
+use crate::metrics::hv_wfg::engine;
+use crate::metrics::hypervolume::non_dominated_points;
+
+/// The name of the data stored on the individuals by [`HyperVolumeContributions::set_data`].
+pub const HV_CONTRIBUTION_KEY: &str = "hv_contribution";
+
+/// Calculate the exclusive hyper-volume contribution of each point in a set, i.e. the volume that
+/// is only dominated by the point and that is lost when the point is removed from the set. All
+/// objectives are assumed to be minimised.
+///
+/// Depending on the number of objectives `d`, a different method is used:
+///
+/// - with `2` objectives: the points are sorted and the contribution of each point on the
+///   staircase is the rectangle between its two neighbours. The complexity is O(`n log n`).
+/// - with `3` objectives: all contributions are calculated with a single sweep along the last
+///   objective, as proposed by [Emmerich and Fonseca (2011)](http://dx.doi.org/10.1007/978-3-642-19893-9_9).
+///   The sweep keeps the non-dominated staircase of the first two objectives and, for each point
+///   on it, the area that it exclusively dominates in the current slice. The complexity is
+///   O(`n log n`).
+/// - with `4` or more objectives: the contribution of a point `p` is the volume of the box between
+///   `p` and the reference point minus the hyper-volume of all other points `q` projected onto
+///   the box (with coordinates `max(q, p)`). The hyper-volume of the projected non-dominated
+///   points is calculated with the algorithm by
+///   [While et al. (2012)](http://dx.doi.org/10.1109/TEVC.2010.2077298), therefore the
+///   complexity is `n` times the one of the hyper-volume.
+///
+/// With `4` or more objectives, the contributions of the points are calculated in parallel.
+/// Dominated, duplicated points and points that do not strictly dominate the reference point have
+/// a contribution of `0`.
+///
+/// # Arguments
+///
+/// * `front`: The objective values of the points. Each item must have a size equal to the
+///   number of objectives.
+/// * `reference_point`: The reference or anti-optimal point.
+///
+/// returns: `Result<Vec<f64>, OError>`: The contribution of each point in the same order as
+/// `front`.
+pub fn hypervolume_contributions(
+    front: &[Vec<f64>],
+    reference_point: &[f64],
+) -> Result<Vec<f64>, OError> {
+    let metric_name = "Hyper-volume contributions".to_string();
+    let number_of_objectives = reference_point.len();
+    if number_of_objectives < 2 {
+        return Err(OError::Metric(
+            metric_name,
+            "The reference point must have at least 2 coordinates".to_string(),
+        ));
+    }
+    if let Some(idx) = front.iter().position(|p| p.len() != number_of_objectives) {
+        return Err(OError::Metric(
+            metric_name,
+            format!(
+                "The size of point #{} ({}) does not match the number of objectives ({})",
+                idx,
+                front[idx].len(),
+                number_of_objectives
+            ),
+        ));
+    }
+
+    let points: Vec<f64> = front.iter().flatten().copied().collect();
+    match number_of_objectives {
+        2 => Ok(contributions_2d(&points, reference_point)),
+        3 => Ok(contributions_3d(&points, reference_point)),
+        _ => contributions_nd(&points, reference_point).map_err(|e| OError::Metric(metric_name, e)),
+    }
+}
+
+/// Calculate the hyper-volume contributions of a 2D set with a sweep along the first objective.
+/// The contribution of a point on the non-dominated staircase is the rectangle bounded by its two
+/// neighbours minus the area covered, inside the rectangle, by the points it dominates.
+///
+/// # Arguments
+///
+/// * `points`: The points stored in a row-major matrix.
+/// * `reference_point`: The reference point.
+///
+/// returns: `Vec<f64>`
+fn contributions_2d(points: &[f64], reference_point: &[f64]) -> Vec<f64> {
+    let number_of_points = points.len() / 2;
+    let mut contributions = vec![0.0; number_of_points];
+    let x = |i: usize| points[2 * i];
+    let y = |i: usize| points[2 * i + 1];
+
+    // sort the points dominating the reference point by increasing x and then y
+    let mut order: Vec<usize> = (0..number_of_points)
+        .filter(|i| x(*i) < reference_point[0] && y(*i) < reference_point[1])
+        .collect();
+    order.sort_by(|a, b| x(*a).total_cmp(&x(*b)).then(y(*a).total_cmp(&y(*b))));
+
+    // split the non-dominated staircase from the (weakly) dominated points. Both are sorted by x
+    let mut staircase: Vec<usize> = Vec::with_capacity(order.len());
+    let mut dominated: Vec<usize> = Vec::new();
+    for i in order {
+        match staircase.last() {
+            Some(last) if y(i) >= y(*last) => dominated.push(i),
+            _ => staircase.push(i),
+        }
+    }
+
+    // the exclusive rectangle of the staircase point k
+    let right = |k: usize| staircase.get(k + 1).map_or(reference_point[0], |j| x(*j));
+    let top = |k: usize| {
+        if k == 0 {
+            reference_point[1]
+        } else {
+            y(staircase[k - 1])
+        }
+    };
+    for (k, i) in staircase.iter().enumerate() {
+        contributions[*i] = (right(k) - x(*i)) * (top(k) - y(*i));
+    }
+
+    // a dominated point can only fall in the rectangle of the last staircase point on its left.
+    // As the points are sorted, the area of each rectangle they cover is calculated with a sweep.
+    let mut current: Option<(usize, f64)> = None;
+    for q in dominated {
+        let k = staircase.partition_point(|j| x(*j) <= x(q)) - 1;
+        if y(q) >= top(k) {
+            continue;
+        }
+        let min_y = match current {
+            Some((ck, min_y)) if ck == k => min_y,
+            _ => top(k),
+        };
+        if y(q) < min_y {
+            contributions[staircase[k]] -= (right(k) - x(q)) * (min_y - y(q));
+            current = Some((k, y(q)));
+        } else {
+            current = Some((k, min_y));
+        }
+    }
+    contributions.into_iter().map(|c| c.max(0.0)).collect()
+}
+
+/// Calculate the hyper-volume contributions of a set with 3 or more objectives. Each
+/// contribution is calculated in parallel by projecting the other points onto the box dominated
+/// by the point.
+///
+/// # Arguments
+///
+/// * `points`: The points stored in a row-major matrix.
+/// * `reference_point`: The reference point.
+///
+/// returns: `Result<Vec<f64>, String>`
+fn contributions_nd(points: &[f64], reference_point: &[f64]) -> Result<Vec<f64>, String> {
+    let number_of_objectives = reference_point.len();
+    let number_of_points = points.len() / number_of_objectives;
+
+    (0..number_of_points)
+        .into_par_iter()
+        .map_init(Vec::new, |projected: &mut Vec<f64>, i| {
+            let point = &points[i * number_of_objectives..(i + 1) * number_of_objectives];
+            if point.iter().zip(reference_point).any(|(p, r)| p >= r) {
+                return Ok(0.0);
+            }
+            let box_volume: f64 = point
+                .iter()
+                .zip(reference_point)
+                .map(|(p, r)| r - p)
+                .product();
+
+            projected.clear();
+            for (j, q) in points.chunks_exact(number_of_objectives).enumerate() {
+                if j != i {
+                    projected.extend(q.iter().zip(point).map(|(qv, pv)| qv.max(*pv)));
+                }
+            }
+            if projected.is_empty() {
+                return Ok(box_volume);
+            }
+
+            // the contributions are already calculated in parallel
+            let projected_front = non_dominated_points(projected, reference_point).concat();
+            let covered = engine::hyper_volume(&projected_front, reference_point, false);
+            Ok((box_volume - covered).max(0.0))
+        })
+        .collect()
+}
+
+/// A coordinate used as key of the sorted structures of the 3D sweep.
+#[derive(Clone, Copy, Debug)]
+struct Coordinate(f64);
+
+impl Coordinate {
+    /// Create the key. A negative zero is stored as zero to compare equal to it.
+    ///
+    /// # Arguments
+    ///
+    /// * `value`: The coordinate.
+    ///
+    /// returns: `Coordinate`
+    fn new(value: f64) -> Self {
+        Self(value + 0.0)
+    }
+}
+
+impl PartialEq for Coordinate {
+    fn eq(&self, other: &Self) -> bool {
+        self.cmp(other) == Ordering::Equal
+    }
+}
+
+impl Eq for Coordinate {}
+
+impl PartialOrd for Coordinate {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for Coordinate {
+    fn cmp(&self, other: &Self) -> Ordering {
+        self.0.total_cmp(&other.0)
+    }
+}
+
+/// A 2D staircase of non-dominated points sorted by the first coordinate, with the area they
+/// dominate inside a rectangle updated at each insertion or removal.
+#[derive(Debug, Default)]
+struct Staircase2D {
+    /// The second coordinate of the points keyed by their first coordinate.
+    points: BTreeMap<Coordinate, f64>,
+    /// The sum of `(x_next - x) * y` over the consecutive pairs of points.
+    inner: f64,
+}
+
+impl Staircase2D {
+    /// Add the term of two consecutive points to `inner`.
+    ///
+    /// # Arguments
+    ///
+    /// * `left`: The point on the left.
+    /// * `right`: The point on the right.
+    /// * `sign`: `1` to add the term or `-1` to remove it.
+    fn update_inner(&mut self, left: Option<(f64, f64)>, right: Option<(f64, f64)>, sign: f64) {
+        if let (Some((x, y)), Some((x_next, _))) = (left, right) {
+            self.inner += sign * (x_next - x) * y;
+        }
+    }
+
+    /// Get the neighbours of a first coordinate.
+    ///
+    /// # Arguments
+    ///
+    /// * `x`: The first coordinate.
+    ///
+    /// returns: `(Option<(f64, f64)>, Option<(f64, f64)>)`. The points on the left and right.
+    fn neighbours(&self, x: Coordinate) -> (Option<(f64, f64)>, Option<(f64, f64)>) {
+        let left = self.points.range(..x).next_back().map(|(k, y)| (k.0, *y));
+        let right = self
+            .points
+            .range((Excluded(x), Unbounded))
+            .next()
+            .map(|(k, y)| (k.0, *y));
+        (left, right)
+    }
+
+    /// Insert a point, unless it is weakly dominated, and remove the points it dominates.
+    ///
+    /// # Arguments
+    ///
+    /// * `x`: The first coordinate.
+    /// * `y`: The second coordinate.
+    fn insert(&mut self, x: f64, y: f64) {
+        let key = Coordinate::new(x);
+        if let Some((_, py)) = self.points.range(..=key).next_back() {
+            if *py <= y {
+                return;
+            }
+        }
+        while let Some((k, sy)) = self.points.range(key..).next() {
+            if *sy < y {
+                break;
+            }
+            let k = *k;
+            self.remove(k);
+        }
+
+        let (left, right) = self.neighbours(key);
+        let point = Some((key.0, y));
+        self.update_inner(left, right, -1.0);
+        self.update_inner(left, point, 1.0);
+        self.update_inner(point, right, 1.0);
+        self.points.insert(key, y);
+    }
+
+    /// Remove a point.
+    ///
+    /// # Arguments
+    ///
+    /// * `key`: The first coordinate of the point.
+    fn remove(&mut self, key: Coordinate) {
+        let y = self.points.remove(&key).unwrap();
+        let (left, right) = self.neighbours(key);
+        let point = Some((key.0, y));
+        self.update_inner(left, point, -1.0);
+        self.update_inner(point, right, -1.0);
+        self.update_inner(left, right, 1.0);
+    }
+
+    /// Remove the points whose first coordinate is at least `x`.
+    ///
+    /// # Arguments
+    ///
+    /// * `x`: The first coordinate.
+    fn retain_left_of(&mut self, x: f64) {
+        while let Some((k, _)) = self.points.last_key_value() {
+            if k.0 < x {
+                break;
+            }
+            let k = *k;
+            self.remove(k);
+        }
+    }
+
+    /// Remove the points whose second coordinate is at least `y`.
+    ///
+    /// # Arguments
+    ///
+    /// * `y`: The second coordinate.
+    fn retain_below(&mut self, y: f64) {
+        while let Some((k, py)) = self.points.first_key_value() {
+            if *py < y {
+                break;
+            }
+            let k = *k;
+            self.remove(k);
+        }
+    }
+
+    /// Get the area dominated by the points inside the rectangle between the points and
+    /// `(right, top)`. All points must be inside the rectangle.
+    ///
+    /// # Arguments
+    ///
+    /// * `right`: The first coordinate of the upper corner of the rectangle.
+    /// * `top`: The second coordinate of the upper corner of the rectangle.
+    ///
+    /// returns: `f64`
+    fn covered(&self, right: f64, top: f64) -> f64 {
+        match (self.points.first_key_value(), self.points.last_key_value()) {
+            (Some((first_x, _)), Some((last_x, last_y))) => {
+                (right - first_x.0) * top - self.inner - (right - last_x.0) * last_y
+            }
+            _ => 0.0,
+        }
+    }
+}
+
+/// A point on the non-dominated staircase of the 3D sweep.
+#[derive(Debug)]
+struct SweepPoint {
+    /// The index of the point in the set.
+    index: usize,
+    /// The second coordinate.
+    y: f64,
+    /// The points, already swept, that are dominated by this point only in the first two
+    /// objectives and that lie within its exclusive rectangle.
+    dominated: Staircase2D,
+    /// The area exclusively dominated by the point in the current slice.
+    area: f64,
+    /// The third coordinate where the area last changed.
+    z: f64,
+}
+
+/// The sweep along the last objective used to calculate the hyper-volume contributions of a 3D
+/// set.
+#[derive(Debug)]
+struct Sweep3D<'a> {
+    /// The non-dominated points of the current slice keyed by their first coordinate.
+    staircase: BTreeMap<Coordinate, SweepPoint>,
+    /// The reference point.
+    reference_point: &'a [f64],
+    /// The contribution of each point.
+    contributions: Vec<f64>,
+}
+
+impl Sweep3D<'_> {
+    /// Get the upper corner of the exclusive rectangle of a point on the staircase. This is
+    /// bounded by the first coordinate of the next point and the second coordinate of the
+    /// previous point.
+    ///
+    /// # Arguments
+    ///
+    /// * `key`: The first coordinate of the point on the staircase.
+    ///
+    /// returns: `(f64, f64)`
+    fn upper_corner(&self, key: Coordinate) -> (f64, f64) {
+        let right = self
+            .staircase
+            .range((Excluded(key), Unbounded))
+            .next()
+            .map_or(self.reference_point[0], |(k, _)| k.0);
+        let top = self
+            .staircase
+            .range(..key)
+            .next_back()
+            .map_or(self.reference_point[1], |(_, p)| p.y);
+        (right, top)
+    }
+
+    /// Accumulate the volume exclusively dominated by a point on the staircase up to `z`.
+    ///
+    /// # Arguments
+    ///
+    /// * `key`: The first coordinate of the point on the staircase.
+    /// * `z`: The third coordinate.
+    fn advance(&mut self, key: Coordinate, z: f64) {
+        let point = self.staircase.get_mut(&key).unwrap();
+        self.contributions[point.index] += point.area * (z - point.z);
+        point.z = z;
+    }
+
+    /// Update the exclusive area of a point on the staircase.
+    ///
+    /// # Arguments
+    ///
+    /// * `key`: The first coordinate of the point on the staircase.
+    fn update_area(&mut self, key: Coordinate) {
+        let (right, top) = self.upper_corner(key);
+        let point = self.staircase.get_mut(&key).unwrap();
+        point.area = (right - key.0) * (top - point.y) - point.dominated.covered(right, top);
+    }
+
+    /// Add a point to the slice.
+    ///
+    /// # Arguments
+    ///
+    /// * `index`: The index of the point in the set.
+    /// * `point`: The coordinates of the point. The third coordinate must not be smaller than
+    ///   the one of the points already added.
+    fn add(&mut self, index: usize, point: &[f64]) {
+        let (x, y, z) = (point[0], point[1], point[2]);
+        let key = Coordinate::new(x);
+
+        // a point dominated in the first two objectives only reduces the area of the point on the
+        // staircase dominating it, when this is the only one
+        if let Some((&owner, owner_y)) = self
+            .staircase
+            .range(..=key)
+            .next_back()
+            .map(|(k, p)| (k, p.y))
+        {
+            if owner_y <= y {
+                if y < self.upper_corner(owner).1 {
+                    self.advance(owner, z);
+                    let owner_point = self.staircase.get_mut(&owner).unwrap();
+                    owner_point.dominated.insert(x, y);
+                    self.update_area(owner);
+                }
+                return;
+            }
+        }
+
+        // the points dominated by the new point no longer contribute but reduce its area
+        let mut dominated = Staircase2D::default();
+        while let Some((&k, p)) = self.staircase.range(key..).next() {
+            if p.y < y {
+                break;
+            }
+            self.advance(k, z);
+            let removed = self.staircase.remove(&k).unwrap();
+            dominated.insert(k.0, removed.y);
+        }
+        self.staircase.insert(
+            key,
+            SweepPoint {
+                index,
+                y,
+                dominated,
+                area: 0.0,
+                z,
+            },
+        );
+        self.update_area(key);
+
+        // the exclusive rectangles of the neighbours shrink
+        if let Some(&left) = self.staircase.range(..key).next_back().map(|(k, _)| k) {
+            self.advance(left, z);
+            let left_point = self.staircase.get_mut(&left).unwrap();
+            left_point.dominated.retain_left_of(x);
+            self.update_area(left);
+        }
+        if let Some(&right) = self
+            .staircase
+            .range((Excluded(key), Unbounded))
+            .next()
+            .map(|(k, _)| k)
+        {
+            self.advance(right, z);
+            let right_point = self.staircase.get_mut(&right).unwrap();
+            right_point.dominated.retain_below(y);
+            self.update_area(right);
+        }
+    }
+}
+
+/// Calculate the hyper-volume contributions of a 3D set with a sweep along the last objective.
+/// The points are added to the slice in order of the last objective. The area exclusively
+/// dominated by a point is the rectangle bounded by its neighbours on the staircase, minus the
+/// area of the swept points dominated only by it; its contribution is the integral of this area
+/// along the sweep. Each point is inserted in and removed from the sorted structures at most
+/// twice, therefore the complexity is O(`n log n`).
+///
+/// # Arguments
+///
+/// * `points`: The points stored in a row-major matrix.
+/// * `reference_point`: The reference point.
+///
+/// returns: `Vec<f64>`
+fn contributions_3d(points: &[f64], reference_point: &[f64]) -> Vec<f64> {
+    let number_of_points = points.len() / 3;
+    let point = |i: usize| &points[3 * i..3 * (i + 1)];
+
+    // sort the points dominating the reference point by increasing z
+    let mut order: Vec<usize> = (0..number_of_points)
+        .filter(|i| point(*i).iter().zip(reference_point).all(|(p, r)| p < r))
+        .collect();
+    order.sort_by(|a, b| point(*a)[2].total_cmp(&point(*b)[2]));
+
+    let mut sweep = Sweep3D {
+        staircase: BTreeMap::new(),
+        reference_point,
+        contributions: vec![0.0; number_of_points],
+    };
+    for i in order {
+        sweep.add(i, point(i));
+    }
+    for p in sweep.staircase.values() {
+        sweep.contributions[p.index] += p.area * (reference_point[2] - p.z);
+    }
+    sweep
+        .contributions
+        .into_iter()
+        .map(|c| c.max(0.0))
+        .collect()
+}
+
+/// Calculate the exclusive hyper-volume contribution of each individual in a set. This can be
+/// used in an environmental selection based on the hyper-volume (such as in SMS-EMOA), where the
+/// individuals with the smallest contribution are discarded first. See
+/// [`hypervolume_contributions`] for the algorithms being used.
+///
+/// **IMPLEMENTATION NOTES**:
+/// 1) Individuals are not filtered: dominated individuals and individuals that do not dominate
+///    the reference point have a contribution of `0`.
+/// 2) The coordinates of maximised objectives of the reference point are multiplied by -1 as the
+///    algorithms assume all objectives are minimised.
+#[derive(Debug)]
+pub struct HyperVolumeContributions {
+    /// The objective values of the individuals.
+    objective_values: Vec<Vec<f64>>,
+    /// The reference point.
+    reference_point: Vec<f64>,
+}
+
+impl HyperVolumeContributions {
+    /// Collect the data to calculate the hyper-volume contributions of a set of individuals.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`: The individuals.
+    /// * `reference_point`: The reference or anti-optimal point to use in the calculation.
+    ///
+    /// returns: `Result<HyperVolumeContributions, OError>`
+    pub fn new(individuals: &[Individual], reference_point: &[f64]) -> Result<Self, OError> {
+        let metric_name = "Hyper-volume contributions".to_string();
+        let problem = individuals
+            .first()
+            .ok_or(OError::Metric(
+                metric_name.clone(),
+                "There are no individuals in the array".to_string(),
+            ))?
+            .problem();
+        if reference_point.len() != problem.number_of_objectives() {
+            return Err(OError::Metric(
+                metric_name,
+                format!(
+                    "The reference point size ({}) must equal the number of objectives ({})",
+                    reference_point.len(),
+                    problem.number_of_objectives()
+                ),
+            ));
+        }
+
+        let objective_values = individuals
+            .iter()
+            .map(|ind| ind.get_objective_values())
+            .collect::<Result<Vec<_>, _>>()?;
+
+        // flip sign of maximised coordinates for the reference point
+        let mut ref_point = reference_point.to_vec();
+        for (obj_idx, obj_name) in problem.objective_names().iter().enumerate() {
+            if !problem.is_objective_minimised(obj_name)? {
+                ref_point[obj_idx] *= -1.0;
+            }
+        }
+
+        Ok(Self {
+            objective_values,
+            reference_point: ref_point,
+        })
+    }
+
+    /// Calculate the contributions.
+    ///
+    /// returns: `Result<Vec<f64>, OError>`: The contribution of each individual in the same order
+    /// as the individuals given in [`HyperVolumeContributions::new`].
+    pub fn compute(&self) -> Result<Vec<f64>, OError> {
+        hypervolume_contributions(&self.objective_values, &self.reference_point)
+    }
+
+    /// Calculate the contributions and store them on each individual as real data with name
+    /// [`HV_CONTRIBUTION_KEY`]. This is the data used by the
+    /// [`crate::operators::HyperVolumeContributionComparison`] operator.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`: The individuals.
+    /// * `reference_point`: The reference or anti-optimal point to use in the calculation.
+    ///
+    /// returns: `Result<(), OError>`
+    pub fn set_data(individuals: &mut [Individual], reference_point: &[f64]) -> Result<(), OError> {
+        let contributions = Self::new(individuals, reference_point)?.compute()?;
+        for (individual, contribution) in individuals.iter_mut().zip(contributions) {
+            individual.set_data(HV_CONTRIBUTION_KEY, DataValue::Real(contribution));
+        }
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use float_cmp::assert_approx_eq;
+
+    use crate::core::test_utils::individuals_from_obj_values_dummy;
+    use crate::core::ObjectiveDirection;
+    use crate::metrics::hv_wfg::wfg::{Optimisation, Wfg};
+    use crate::metrics::hypervolume::non_dominated_points;
+    use crate::metrics::test_utils::parse_pagmo_test_data_file;
+    use crate::metrics::{
+        hypervolume_contributions, HyperVolumeContributions, HV_CONTRIBUTION_KEY,
+    };
+
+    /// Calculate the contributions as the difference between the hyper-volume of the set with and
+    /// without each point.
+    fn brute_force(front: &[Vec<f64>], reference_point: &[f64]) -> Vec<f64> {
+        let hv = |points: &[Vec<f64>]| {
+            let flat: Vec<f64> = points.iter().flatten().copied().collect();
+            let nd = non_dominated_points(&flat, reference_point);
+            if nd.is_empty() {
+                0.0
+            } else {
+                Wfg::new(&nd, reference_point, Optimisation::O2)
+                    .calculate()
+                    .unwrap()
+            }
+        };
+        let total = hv(front);
+        (0..front.len())
+            .map(|i| {
+                let mut others = front.to_vec();
+                others.remove(i);
+                total - hv(&others)
+            })
+            .collect()
+    }
+
+    /// Compare the contributions against the brute force calculation for Pagmo's test data.
+    ///
+    /// # Arguments
+    ///
+    /// * `name`: The name of the test file.
+    /// * `max_sets`: The number of sets to test.
+    /// * `max_points`: The number of points to take from each set.
+    fn assert_test_file(name: &str, max_sets: usize, max_points: usize) {
+        let all_test_data = parse_pagmo_test_data_file(name).unwrap();
+        for test_data in all_test_data.iter().take(max_sets) {
+            let front: Vec<Vec<f64>> = test_data
+                .objective_values
+                .iter()
+                .take(max_points)
+                .cloned()
+                .collect();
+            let ref_point = &test_data.reference_point;
+            let contributions = hypervolume_contributions(&front, ref_point).unwrap();
+            let expected = brute_force(&front, ref_point);
+            for (c, e) in contributions.iter().zip(expected) {
+                assert_approx_eq!(f64, *c, e, epsilon = 0.00001);
+            }
+        }
+    }
+
+    #[test]
+    fn test_c_max_t100_d2_n128() {
+        assert_test_file("c_max_t100_d2_n128", 5, 128);
+    }
+
+    #[test]
+    fn test_c_max_t100_d3_n128() {
+        assert_test_file("c_max_t100_d3_n128", 3, 128);
+    }
+
+    #[test]
+    fn test_c_max_t1_d5_n1024() {
+        assert_test_file("c_max_t1_d5_n1024", 1, 50);
+    }
+
+    #[test]
+    /// Test the 3D sweep with ties in all the objectives. The first 25 points lie on a plane and
+    /// the others, weakly dominated by them, reduce their contributions.
+    fn test_3d_ties() {
+        let ref_point = [10.0, 10.0, 10.0];
+        let front: Vec<Vec<f64>> = (0..40_usize)
+            .map(|i| {
+                let (x, y) = (i % 5, (i / 5) % 5);
+                vec![x as f64, y as f64, (8 + i / 25 - x - y) as f64]
+            })
+            .collect();
+        let contributions = hypervolume_contributions(&front, &ref_point).unwrap();
+        let expected = brute_force(&front, &ref_point);
+        for (c, e) in contributions.iter().zip(expected) {
+            assert_approx_eq!(f64, *c, e, epsilon = 0.00001);
+        }
+    }
+
+    #[test]
+    /// Dominated, duplicated points and points outside the reference point do not contribute.
+    fn test_special_points() {
+        let ref_point = [3.0, 3.0];
+        let front = vec![
+            vec![1.0, 2.0],
+            vec![2.0, 1.0],
+            vec![2.0, 2.0],
+            vec![0.5, 2.5],
+            vec![0.5, 2.5],
+            vec![0.0, 4.0],
+        ];
+        let contributions = hypervolume_contributions(&front, &ref_point).unwrap();
+        assert_eq!(contributions, vec![0.5, 1.0, 0.0, 0.0, 0.0, 0.0]);
+
+        let ref_point = [3.0, 3.0, 3.0];
+        let front = vec![
+            vec![1.0, 1.0, 1.0],
+            vec![2.0, 2.0, 0.5],
+            vec![2.0, 2.0, 2.0],
+            vec![2.0, 0.5, 0.5],
+            vec![2.0, 0.5, 0.5],
+        ];
+        let contributions = hypervolume_contributions(&front, &ref_point).unwrap();
+        assert_eq!(contributions, vec![4.0, 0.0, 0.0, 0.0, 0.0]);
+
+        assert!(
+            hypervolume_contributions(&[vec![1.0, 2.0]], &[3.0, 3.0, 3.0])
+                .unwrap_err()
+                .to_string()
+                .contains("The size of point #0 (2) does not match")
+        );
+    }
+
+    #[test]
+    /// Store the contributions on individuals with a maximised objective.
+    fn test_set_data() {
+        let objective_values = vec![vec![1.0, -2.0], vec![2.0, -1.0], vec![2.0, -2.0]];
+        let mut individuals = individuals_from_obj_values_dummy(
+            &objective_values,
+            &[ObjectiveDirection::Minimise, ObjectiveDirection::Maximise],
+            None,
+        );
+        HyperVolumeContributions::set_data(&mut individuals, &[3.0, -3.0]).unwrap();
+        let contributions: Vec<f64> = individuals
+            .iter()
+            .map(|i| i.get_data(HV_CONTRIBUTION_KEY).unwrap().as_real().unwrap())
+            .collect();
+        assert_eq!(contributions, vec![1.0, 1.0, 0.0]);
+    }
+}
@@ -1,16 +1,27 @@
 use std::mem;
+use std::sync::atomic::{AtomicUsize, Ordering};
 
 use log::{debug, warn};
+use rayon::prelude::*;
 
-use hv_fonseca_et_al_2006_sys::calculate_hv;
+use hv_fonseca_et_al_2006_sys::{
+    calculate_hv_matrix, calculate_hv_matrix_ordered, HvSlices, ObjectiveMatrix,
+};
 
 use crate::core::{Individual, Individuals, OError};
 use crate::metrics::hypervolume::{check_args, check_ref_point_coordinate};
 use crate::utils::fast_non_dominated_sort;
 
+/// The minimum number of objectives to split the calculation across threads in
+/// [`HyperVolumeFonseca2006::compute_with_workers`]. With less objectives, each slice is solved
+/// with the 3D sweep and the sequential algorithm is faster.
+const PARALLEL_MIN_OBJECTIVES: usize = 5;
+
 /// Calculate the hyper-volume using the algorithm proposed by [Fonseca et al. (2006)](http://dx.doi.org/10.1109/CEC.2006.1688440)
 /// for a problem with `d` objectives and `n` individuals. The function calls version 4 of the
-/// algorithm, therefore its complexity is O(`n^(d-2)*log n`).
+/// algorithm, therefore its complexity is O(`n^(d-2)*log n`). With more than 3 objectives, the
+/// objectives are reordered before the calculation using the heuristic by [While et al. (2005)](http://dx.doi.org/10.1109/CEC.2005.1554971),
+/// which can considerably reduce the runtime.
 ///
 /// **IMPLEMENTATION NOTES**:
 /// 1) Points dominated by the reference point are removed from the calculation.
@@ -21,9 +32,12 @@ use crate::utils::fast_non_dominated_sort;
 ///    algorithm assumes all objectives are maximised.
 #[derive(Debug)]
 pub struct HyperVolumeFonseca2006 {
-    /// The individuals to use. The size of this vector corresponds to the individual size and the
-    /// size of the nested vector corresponds to the number of problem objectives.
-    individuals: Vec<Vec<f64>>,
+    /// The objective values of the individuals to use, stored as a row-major matrix. The number of
+    /// rows corresponds to the individual size and the number of columns to the number of problem
+    /// objectives.
+    individuals: Vec<f64>,
+    /// The number of individuals.
+    number_of_individuals: usize,
     /// The reference point.
     reference_point: Vec<f64>,
 }
@@ -45,10 +59,10 @@ impl HyperVolumeFonseca2006 {
         check_args(individuals, reference_point)
             .map_err(|e| OError::Metric(metric_name.clone(), e))?;
 
-        if reference_point.len() != 3 {
+        if reference_point.len() < 3 {
             return Err(OError::Metric(
                 metric_name,
-                "This can only be used on a 3-objective problem.".to_string(),
+                "This can only be used on a problem with at least 3 objectives.".to_string(),
             ));
         }
 
@@ -73,11 +87,15 @@ impl HyperVolumeFonseca2006 {
             warn!("{} individuals were removed from the given data because they are dominated by all the other points", num_individuals - individuals.len());
         }
 
-        // Collect objective values - invert the sign of minimised objectives
-        let objective_values = individuals
-            .iter()
-            .map(|ind| ind.get_objective_values())
-            .collect::<Result<Vec<Vec<f64>>, _>>()?;
+        // Collect objective values in a flat matrix
+        let objective_names = problem.objective_names();
+        let mut objective_values =
+            Vec::with_capacity(individuals.len() * problem.number_of_objectives());
+        for ind in individuals.iter() {
+            for obj_name in objective_names.iter() {
+                objective_values.push(ind.get_objective_value(obj_name)?);
+            }
+        }
 
         // flip sign of maximised coordinates for the reference point
         let mut ref_point = reference_point.to_vec();
@@ -92,15 +110,95 @@ impl HyperVolumeFonseca2006 {
 
         Ok(Self {
             individuals: objective_values,
+            number_of_individuals: individuals.len(),
             reference_point: ref_point,
         })
     }
 
-    /// Calculate the hyper-volume.
+    /// Calculate the hyper-volume. This is thread-safe and can be called concurrently on different
+    /// instances.
     ///
     /// return: `f64`
     pub fn compute(&self) -> f64 {
-        calculate_hv(&self.individuals, &self.reference_point)
+        // sizes are always consistent
+        let matrix = ObjectiveMatrix::new(
+            &self.individuals,
+            self.number_of_individuals,
+            self.reference_point.len(),
+        )
+        .unwrap();
+        if self.reference_point.len() > 3 {
+            calculate_hv_matrix_ordered(&matrix, &self.reference_point)
+        } else {
+            calculate_hv_matrix(&matrix, &self.reference_point)
+        }
+    }
+
+    /// Calculate the hyper-volume using more threads. With 5 or more objectives, the slices of
+    /// the outermost level of the recursion of the algorithm are split across `workers` tasks
+    /// running on the rayon thread pool; each task uses the context of its thread (with its own
+    /// linked lists and AVL tree), which is kept and reused by the following calculations. This
+    /// can reduce the runtime of a single expensive calculation (for example with many
+    /// objectives), but the total work is larger than with [`HyperVolumeFonseca2006::compute`].
+    /// With less objectives or one worker, this is the same as
+    /// [`HyperVolumeFonseca2006::compute`]. See [`HvSlices`] for more details.
+    ///
+    /// # Arguments
+    ///
+    /// * `workers`: The number of tasks to use.
+    ///
+    /// return: `Result<f64, OError>`
+    pub fn compute_with_workers(&self, workers: usize) -> Result<f64, OError> {
+        if workers == 0 {
+            return Err(OError::Metric(
+                "Hyper-volume Fonseca et al. (2006)".to_string(),
+                "The number of workers must be at least 1".to_string(),
+            ));
+        }
+        let number_of_objectives = self.reference_point.len();
+        if workers == 1 || number_of_objectives < PARALLEL_MIN_OBJECTIVES {
+            return Ok(self.compute());
+        }
+
+        // sizes are always consistent
+        let matrix = ObjectiveMatrix::new(
+            &self.individuals,
+            self.number_of_individuals,
+            number_of_objectives,
+        )
+        .unwrap();
+        let slices = HvSlices::new(&matrix, &self.reference_point);
+        let total_slices = slices.len();
+        let next_slice = AtomicUsize::new(0);
+        let slice_volumes: Vec<(usize, f64)> = (0..workers.min(total_slices))
+            .into_par_iter()
+            .flat_map_iter(|_| {
+                let mut worker_volumes = vec![];
+                loop {
+                    let j = next_slice.fetch_add(1, Ordering::Relaxed);
+                    if j >= total_slices {
+                        break;
+                    }
+                    // start from the slice with the most points
+                    let k = total_slices - 1 - j;
+                    // ties in the last objective give empty slices
+                    if slices.height(k) <= 0.0 {
+                        continue;
+                    }
+                    let area =
+                        calculate_hv_matrix_ordered(&slices.points(k), slices.reference_point());
+                    worker_volumes.push((k, area * slices.height(k)));
+                }
+                worker_volumes
+            })
+            .collect();
+
+        // sum in order so that the result does not depend on the scheduling
+        let mut volumes = vec![0.0; total_slices];
+        for (k, volume) in slice_volumes {
+            volumes[k] = volume;
+        }
+        Ok(volumes.iter().sum())
     }
 }
 
@@ -191,4 +289,72 @@ mod test {
     fn test_c_max_t1_d3_n2048() {
         assert_test_file("c_max_t1_d3_n2048");
     }
+
+    #[test]
+    /// Test the `HyperVolumeFonseca2006` struct with reordered objectives using Pagmo
+    /// c_max_t1_d5_n1024 test data.
+    /// See https://github.com/esa/pagmo2/tree/master/tests/hypervolume_test_data
+    fn test_c_max_t1_d5_n1024() {
+        assert_test_file("c_max_t1_d5_n1024");
+    }
+
+    #[test]
+    /// Test the hyper-volume calculated with more threads using Pagmo c_max_t1_d5_n1024 test data.
+    fn test_compute_with_workers() {
+        let test_data = parse_pagmo_test_data_file("c_max_t1_d5_n1024").unwrap();
+        let test_data = test_data.first().unwrap();
+        let objective_direction = vec![ObjectiveDirection::Minimise; 5];
+        let mut individuals = individuals_from_obj_values_dummy(
+            &test_data.objective_values,
+            &objective_direction,
+            None,
+        );
+        let hv = HyperVolumeFonseca2006::new(&mut individuals, &test_data.reference_point).unwrap();
+
+        assert!(approx_eq!(
+            f64,
+            hv.compute_with_workers(4).unwrap(),
+            test_data.hyper_volume,
+            epsilon = 0.001
+        ));
+        for workers in [2, 3, 8] {
+            let calculated = hv.compute_with_workers(workers).unwrap();
+            assert!(approx_eq!(f64, calculated, hv.compute(), epsilon = 1e-9));
+        }
+        assert!(hv
+            .compute_with_workers(0)
+            .unwrap_err()
+            .to_string()
+            .contains("The number of workers must be at least 1"));
+    }
+
+    #[test]
+    /// Test the hyper-volume calculated with more threads with 6 objectives, where the outermost
+    /// slices are split across the tasks, and with ties in the last objective.
+    fn test_compute_with_workers_d6() {
+        let objective_values: Vec<Vec<f64>> = (0..60_usize)
+            .map(|i| {
+                (0..6_usize)
+                    .map(|j| ((i * (2 * j + 3) + 7 * j) % 31) as f64 / 31.0)
+                    .collect()
+            })
+            .collect();
+        let objective_direction = vec![ObjectiveDirection::Minimise; 6];
+        let mut individuals =
+            individuals_from_obj_values_dummy(&objective_values, &objective_direction, None);
+        let hv = HyperVolumeFonseca2006::new(&mut individuals, &[1.5; 6]).unwrap();
+
+        let expected = hv.compute();
+        assert!(expected > 0.0);
+        for workers in [1, 2, 3, 8] {
+            let calculated = hv.compute_with_workers(workers).unwrap();
+            assert!(
+                approx_eq!(f64, calculated, expected, epsilon = 1e-9 * expected),
+                "{} workers: {} != {}",
+                workers,
+                calculated,
+                expected
+            );
+        }
+    }
 }
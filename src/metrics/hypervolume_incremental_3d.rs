@@ -0,0 +1,223 @@
+use std::sync::Arc;
+
+use hv_fonseca_et_al_2006_sys::IncrementalHv3D;
+
+use crate::core::{Individual, OError, Problem};
+
+/// Track the hyper-volume of a set of individuals for a 3-objective problem, when individuals
+/// enter or leave the set one at a time (for example when tracking the archive or the Pareto
+/// front of an algorithm at each generation). Instead of calculating the metric from scratch, the
+/// value is updated with the exclusive contribution of the individual being added or removed.
+/// This is calculated with a sweep over the non-dominated individuals, which are kept sorted by
+/// the third objective, and that stops once the individual is dominated on the other two
+/// objectives (see [`IncrementalHv3D`]).
+///
+/// **IMPLEMENTATION NOTES**:
+/// 1) Individuals are not filtered: dominated individuals and individuals that do not dominate
+///    the reference point do not contribute to the metric but are stored in the set. The caller
+///    is responsible for excluding unfeasible individuals if needed.
+/// 2) The coordinates of maximised objectives of the reference point are multiplied by -1 as the
+///    algorithm assumes all objectives are minimised.
+/// 3) Rounding errors may accumulate after many updates. Use [`HyperVolumeIncremental3D::recompute`]
+///    to reset the value to the exact hyper-volume of the set.
+#[derive(Debug)]
+pub struct HyperVolumeIncremental3D {
+    /// The incremental calculator.
+    hv: IncrementalHv3D,
+    /// The problem being solved.
+    problem: Arc<Problem>,
+    /// The name of this metric
+    metric_name: String,
+}
+
+impl HyperVolumeIncremental3D {
+    /// Create an empty set of individuals.
+    ///
+    /// # Arguments
+    ///
+    /// * `problem`: The problem being solved. This must have 3 objectives.
+    /// * `reference_point`: The reference or anti-optimal point to use in the calculation.
+    ///
+    /// returns: `Result<HyperVolumeIncremental3D, OError>`
+    pub fn new(problem: Arc<Problem>, reference_point: &[f64]) -> Result<Self, OError> {
+        let metric_name = "Incremental 3D hyper-volume".to_string();
+        if problem.number_of_objectives() != 3 {
+            return Err(OError::Metric(
+                metric_name,
+                "This can only be used on a 3-objective problem.".to_string(),
+            ));
+        }
+        if reference_point.len() != 3 {
+            return Err(OError::Metric(
+                metric_name,
+                format!(
+                    "The reference point size ({}) must equal the number of objectives (3)",
+                    reference_point.len()
+                ),
+            ));
+        }
+
+        // flip sign of maximised coordinates for the reference point
+        let mut ref_point = [0.0; 3];
+        for (obj_idx, obj_name) in problem.objective_names().iter().enumerate() {
+            ref_point[obj_idx] = if problem.is_objective_minimised(obj_name)? {
+                reference_point[obj_idx]
+            } else {
+                -reference_point[obj_idx]
+            };
+        }
+
+        Ok(Self {
+            hv: IncrementalHv3D::new(ref_point),
+            problem,
+            metric_name,
+        })
+    }
+
+    /// Add an individual to the set and update the hyper-volume.
+    ///
+    /// # Arguments
+    ///
+    /// * `individual`: The individual to add.
+    ///
+    /// returns: `Result<f64, OError>`: The exclusive contribution of the individual.
+    pub fn insert(&mut self, individual: &Individual) -> Result<f64, OError> {
+        let point = self.point(individual)?;
+        Ok(self.hv.insert(point))
+    }
+
+    /// Remove an individual from the set and update the hyper-volume.
+    ///
+    /// # Arguments
+    ///
+    /// * `individual`: The individual to remove. This is matched using its objective values.
+    ///
+    /// returns: `Result<f64, OError>`: The exclusive contribution of the individual. An error is
+    /// returned if the individual is not in the set.
+    pub fn remove(&mut self, individual: &Individual) -> Result<f64, OError> {
+        let point = self.point(individual)?;
+        self.hv.remove(&point).ok_or(OError::Metric(
+            self.metric_name.clone(),
+            format!(
+                "The individual with objectives {:?} is not in the set",
+                point
+            ),
+        ))
+    }
+
+    /// Get the hyper-volume of the set.
+    ///
+    /// returns: `f64`
+    pub fn value(&self) -> f64 {
+        self.hv.value()
+    }
+
+    /// Calculate the exact hyper-volume of the set from scratch and use it as the new value.
+    ///
+    /// returns: `f64`
+    pub fn recompute(&mut self) -> f64 {
+        self.hv.recompute()
+    }
+
+    /// Get the number of individuals in the set.
+    ///
+    /// returns: `usize`
+    pub fn len(&self) -> usize {
+        self.hv.len()
+    }
+
+    /// Whether the set is empty.
+    ///
+    /// returns: `bool`
+    pub fn is_empty(&self) -> bool {
+        self.hv.is_empty()
+    }
+
+    /// Get the objective values of an individual.
+    ///
+    /// # Arguments
+    ///
+    /// * `individual`: The individual.
+    ///
+    /// returns: `Result<[f64; 3], OError>`
+    fn point(&self, individual: &Individual) -> Result<[f64; 3], OError> {
+        let mut point = [0.0; 3];
+        for (obj_idx, obj_name) in self.problem.objective_names().iter().enumerate() {
+            point[obj_idx] = individual.get_objective_value(obj_name)?;
+        }
+        Ok(point)
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use float_cmp::assert_approx_eq;
+
+    use crate::core::test_utils::individuals_from_obj_values_dummy;
+    use crate::core::ObjectiveDirection;
+    use crate::metrics::test_utils::parse_pagmo_test_data_file;
+    use crate::metrics::{HyperVolumeFonseca2006, HyperVolumeIncremental3D};
+
+    #[test]
+    /// Insert and remove the points of the Pagmo c_max_t100_d3_n128 test data.
+    fn test_c_max_t100_d3_n128() {
+        let all_test_data = parse_pagmo_test_data_file("c_max_t100_d3_n128").unwrap();
+        let objective_direction = vec![ObjectiveDirection::Minimise; 3];
+
+        for test_data in all_test_data.iter().take(10) {
+            let mut individuals = individuals_from_obj_values_dummy(
+                &test_data.objective_values,
+                &objective_direction,
+                None,
+            );
+            let mut hv =
+                HyperVolumeIncremental3D::new(individuals[0].problem(), &test_data.reference_point)
+                    .unwrap();
+            for individual in individuals.iter() {
+                hv.insert(individual).unwrap();
+            }
+            assert_approx_eq!(f64, hv.value(), test_data.hyper_volume, epsilon = 0.001);
+
+            // remove half of the points
+            for individual in individuals.iter().step_by(2) {
+                hv.remove(individual).unwrap();
+            }
+            let mut remaining: Vec<_> = individuals.drain(..).skip(1).step_by(2).collect();
+            let expected = HyperVolumeFonseca2006::new(&mut remaining, &test_data.reference_point)
+                .unwrap()
+                .compute();
+            assert_eq!(hv.len(), remaining.len());
+            assert_approx_eq!(f64, hv.value(), expected, epsilon = 0.00001);
+        }
+    }
+
+    #[test]
+    /// Test the errors and a problem with a maximised objective.
+    fn test_errors_and_maximised_objective() {
+        let objective_values = vec![vec![1.0, 1.0, -1.0], vec![2.0, 2.0, -2.0]];
+        let objective_direction = [
+            ObjectiveDirection::Minimise,
+            ObjectiveDirection::Minimise,
+            ObjectiveDirection::Maximise,
+        ];
+        let individuals =
+            individuals_from_obj_values_dummy(&objective_values, &objective_direction, None);
+        let problem = individuals[0].problem();
+
+        let err = HyperVolumeIncremental3D::new(problem.clone(), &[3.0, 3.0])
+            .unwrap_err()
+            .to_string();
+        assert!(err.contains("The reference point size (2) must equal"));
+
+        let mut hv = HyperVolumeIncremental3D::new(problem, &[3.0, 3.0, -3.0]).unwrap();
+        assert_eq!(hv.insert(&individuals[0]).unwrap(), 8.0);
+        assert_eq!(hv.insert(&individuals[1]).unwrap(), 0.0);
+        assert_eq!(hv.value(), 8.0);
+        assert_eq!(hv.remove(&individuals[0]).unwrap(), 7.0);
+        assert!(hv
+            .remove(&individuals[0])
+            .unwrap_err()
+            .to_string()
+            .contains("is not in the set"));
+    }
+}
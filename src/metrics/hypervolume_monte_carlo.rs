@@ -0,0 +1,515 @@
+use std::mem;
+
+use log::{debug, warn};
+use rand::{Rng, SeedableRng};
+use rand_chacha::ChaCha8Rng;
+use rayon::prelude::*;
+
+use crate::core::{Individual, Individuals, OError};
+use crate::metrics::hypervolume::{check_args, check_ref_point_coordinate};
+use crate::utils::fast_non_dominated_sort;
+
+/// The number of samples checked at once against each point of the front. The coordinates of the
+/// samples in a block are stored by objective, so that each objective of a point is compared with
+/// all the samples in one loop.
+const SAMPLE_BLOCK: usize = 64;
+
+/// The number of samples drawn by one parallel task from its own random stream.
+const SAMPLES_PER_TASK: usize = 64 * SAMPLE_BLOCK;
+
+/// The options of [`HyperVolumeMonteCarlo`].
+#[derive(Debug, Clone)]
+pub struct HyperVolumeMonteCarloArgs {
+    /// The relative error of the estimate at which the sampling stops. This is the half-width of
+    /// the confidence interval divided by the estimate. Default to `0.01`.
+    pub relative_error: f64,
+    /// The confidence level of the interval (for example `0.95` for a 95% interval). Default to
+    /// `0.95`.
+    pub confidence_level: f64,
+    /// The number of samples drawn before checking the relative error. Default to `100_000`.
+    pub batch_size: usize,
+    /// The maximum number of samples. The sampling stops when this is reached even if the
+    /// relative error is larger than [`HyperVolumeMonteCarloArgs::relative_error`]. Default to
+    /// `10_000_000`.
+    pub max_samples: usize,
+    /// The seed of the random number generator. The estimate only depends on the seed and not on
+    /// the number of threads. Default to `None`.
+    pub seed: Option<u64>,
+}
+
+impl Default for HyperVolumeMonteCarloArgs {
+    fn default() -> Self {
+        Self {
+            relative_error: 0.01,
+            confidence_level: 0.95,
+            batch_size: 100_000,
+            max_samples: 10_000_000,
+            seed: None,
+        }
+    }
+}
+
+/// The hyper-volume estimated by [`HyperVolumeMonteCarlo`].
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct HyperVolumeEstimate {
+    /// The estimated hyper-volume.
+    pub value: f64,
+    /// The lower bound of the confidence interval.
+    pub lower_bound: f64,
+    /// The upper bound of the confidence interval.
+    pub upper_bound: f64,
+    /// The half-width of the confidence interval divided by the estimate. This is infinite if no
+    /// sample is dominated.
+    pub relative_error: f64,
+    /// The number of samples used.
+    pub samples: usize,
+}
+
+/// Estimate the hyper-volume using Monte-Carlo sampling. The exact algorithms become
+/// impractical with many objectives (their complexity grows exponentially with the number of
+/// objectives), whereas the cost of this estimator only grows linearly with the number of
+/// objectives and points.
+///
+/// Points are sampled uniformly in the box between the ideal point of the front (the best value
+/// of each objective) and the reference point. The hyper-volume is the box volume times the
+/// fraction of samples dominated by at least one point of the front. Samples are drawn in
+/// batches of [`HyperVolumeMonteCarloArgs::batch_size`] points, which are checked in parallel,
+/// until the relative error of the estimate is below [`HyperVolumeMonteCarloArgs::relative_error`]
+/// or [`HyperVolumeMonteCarloArgs::max_samples`] points have been drawn. The confidence interval is
+/// calculated with the Wilson score interval of the dominated fraction.
+///
+/// **IMPLEMENTATION NOTES**:
+/// 1) Dominated and unfeasible solutions are excluded using the NSGA2 [`crate::utils::fast_non_dominated_sort()`]
+///    algorithm in order to get the Pareto front.
+/// 2) The coordinates of maximised objectives of the reference point are multiplied by -1 as the
+///    algorithm assumes all objectives are minimised.
+/// 3) Each parallel task draws its samples from a [`ChaCha8Rng`] stream identified by the task
+///    index, therefore the estimate is reproducible for a given seed.
+#[derive(Debug)]
+pub struct HyperVolumeMonteCarlo {
+    /// The objective values of the individuals to use, stored as a row-major matrix. The points
+    /// are sorted by decreasing volume of the box they dominate, so that the points dominating
+    /// most samples are checked first.
+    individuals: Vec<f64>,
+    /// The reference point.
+    reference_point: Vec<f64>,
+    /// The ideal point of the front.
+    ideal_point: Vec<f64>,
+    /// The estimator options.
+    args: HyperVolumeMonteCarloArgs,
+}
+
+impl HyperVolumeMonteCarlo {
+    /// Initialise the Monte-Carlo estimator of the hyper-volume.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`: The list of individuals.
+    /// * `reference_point`: The reference point.
+    /// * `args`: The estimator options.
+    ///
+    /// returns: `Result<HyperVolumeMonteCarlo, OError>`
+    pub fn new(
+        individuals: &mut [Individual],
+        reference_point: &[f64],
+        args: HyperVolumeMonteCarloArgs,
+    ) -> Result<Self, OError> {
+        let metric_name = "Monte-Carlo hyper-volume".to_string();
+        // check sizes
+        check_args(individuals, reference_point)
+            .map_err(|e| OError::Metric(metric_name.clone(), e))?;
+
+        if args.relative_error <= 0.0 || args.relative_error.is_nan() {
+            return Err(OError::Metric(
+                metric_name,
+                format!(
+                    "The relative error ({}) must be strictly positive",
+                    args.relative_error
+                ),
+            ));
+        }
+        if !(args.confidence_level > 0.0 && args.confidence_level < 1.0) {
+            return Err(OError::Metric(
+                metric_name,
+                format!(
+                    "The confidence level ({}) must be between 0 and 1",
+                    args.confidence_level
+                ),
+            ));
+        }
+        if args.batch_size == 0 || args.max_samples < args.batch_size {
+            return Err(OError::Metric(
+                metric_name,
+                format!(
+                    "The batch size ({}) must be strictly positive and not larger than the maximum number of samples ({})",
+                    args.batch_size, args.max_samples
+                ),
+            ));
+        }
+
+        // the reference point must dominate all objectives
+        let problem = individuals[0].problem();
+        for (obj_idx, (obj_name, obj)) in problem.objectives().iter().enumerate() {
+            check_ref_point_coordinate(
+                &individuals.objective_values(obj_name)?,
+                obj,
+                reference_point[obj_idx],
+                obj_idx + 1,
+            )
+            .map_err(|e| OError::Metric(metric_name.clone(), e))?;
+        }
+
+        // get non-dominated front with feasible solutions only
+        let num_individuals = individuals.len();
+        let mut front_data = fast_non_dominated_sort(individuals, true)?;
+        let individuals = mem::take(&mut front_data.fronts[0]);
+
+        if num_individuals != individuals.len() {
+            warn!("{} individuals were removed from the given data because they are dominated by all the other points", num_individuals - individuals.len());
+        }
+
+        // flip sign of maximised coordinates for the reference point
+        let mut ref_point = reference_point.to_vec();
+        for (obj_idx, obj_name) in problem.objective_names().iter().enumerate() {
+            if !problem.is_objective_minimised(obj_name)? {
+                ref_point[obj_idx] *= -1.0;
+            }
+        }
+
+        // sort the points by decreasing volume of their box
+        let mut points = individuals
+            .iter()
+            .map(|ind| ind.get_objective_values())
+            .collect::<Result<Vec<Vec<f64>>, _>>()?;
+        let box_volume =
+            |p: &Vec<f64>| -> f64 { p.iter().zip(ref_point.iter()).map(|(v, r)| r - v).product() };
+        points.sort_by(|a, b| box_volume(b).total_cmp(&box_volume(a)));
+
+        let mut ideal_point = ref_point.clone();
+        for point in points.iter() {
+            for (ideal, value) in ideal_point.iter_mut().zip(point) {
+                *ideal = ideal.min(*value);
+            }
+        }
+
+        debug!("Using non-dominated front {:?}", points);
+        debug!("Reference point is {:?}", ref_point);
+
+        Ok(Self {
+            individuals: points.into_iter().flatten().collect(),
+            reference_point: ref_point,
+            ideal_point,
+            args,
+        })
+    }
+
+    /// Estimate the hyper-volume.
+    ///
+    /// return: `HyperVolumeEstimate`
+    pub fn compute(&self) -> HyperVolumeEstimate {
+        let widths: Vec<f64> = self
+            .reference_point
+            .iter()
+            .zip(self.ideal_point.iter())
+            .map(|(r, i)| r - i)
+            .collect();
+        let box_volume: f64 = widths.iter().product();
+        let z = normal_quantile(0.5 + self.args.confidence_level / 2.0);
+
+        let base_rng = match self.args.seed {
+            None => ChaCha8Rng::from_seed(Default::default()),
+            Some(s) => ChaCha8Rng::seed_from_u64(s),
+        };
+
+        let mut samples: usize = 0;
+        let mut dominated: u64 = 0;
+        let mut next_task: u64 = 0;
+        loop {
+            // split the batch into tasks with their own random stream
+            let batch = self.args.batch_size.min(self.args.max_samples - samples);
+            let total_tasks = batch.div_ceil(SAMPLES_PER_TASK);
+            dominated += (0..total_tasks)
+                .into_par_iter()
+                .map(|t| {
+                    let mut rng = base_rng.clone();
+                    rng.set_stream(next_task + t as u64);
+                    let task_samples = SAMPLES_PER_TASK.min(batch - t * SAMPLES_PER_TASK);
+                    self.count_dominated(&mut rng, &widths, task_samples)
+                })
+                .sum::<u64>();
+            samples += batch;
+            next_task += total_tasks as u64;
+
+            let estimate = wilson_estimate(dominated, samples, z, box_volume);
+            debug!(
+                "Hyper-volume estimate {} with relative error {} after {} samples",
+                estimate.value, estimate.relative_error, samples
+            );
+            if estimate.relative_error <= self.args.relative_error
+                || samples >= self.args.max_samples
+            {
+                return estimate;
+            }
+        }
+    }
+
+    /// Draw samples in the box between the ideal and reference point and count how many are
+    /// dominated by at least one point of the front.
+    ///
+    /// # Arguments
+    ///
+    /// * `rng`: The random number generator.
+    /// * `widths`: The size of the box along each objective.
+    /// * `total_samples`: The number of samples to draw.
+    ///
+    /// returns: `u64`
+    fn count_dominated(&self, rng: &mut ChaCha8Rng, widths: &[f64], total_samples: usize) -> u64 {
+        let d = self.reference_point.len();
+        // the sample coordinates stored by objective
+        let mut block = vec![0.0; d * SAMPLE_BLOCK];
+        let mut dominated: u64 = 0;
+
+        let mut remaining = total_samples;
+        while remaining > 0 {
+            let size = remaining.min(SAMPLE_BLOCK);
+            for k in 0..size {
+                for j in 0..d {
+                    block[j * SAMPLE_BLOCK + k] =
+                        self.ideal_point[j] + rng.gen::<f64>() * widths[j];
+                }
+            }
+
+            let mut covered = [false; SAMPLE_BLOCK];
+            for point in self.individuals.chunks_exact(d) {
+                let mut inside = [true; SAMPLE_BLOCK];
+                for (j, value) in point.iter().enumerate() {
+                    let column = &block[j * SAMPLE_BLOCK..(j + 1) * SAMPLE_BLOCK];
+                    for (is_inside, sample) in inside.iter_mut().zip(column) {
+                        *is_inside &= value <= sample;
+                    }
+                }
+                for (is_covered, is_inside) in covered.iter_mut().zip(inside) {
+                    *is_covered |= is_inside;
+                }
+                if covered[0..size].iter().all(|c| *c) {
+                    break;
+                }
+            }
+
+            dominated += covered[0..size].iter().filter(|c| **c).count() as u64;
+            remaining -= size;
+        }
+        dominated
+    }
+}
+
+/// Calculate the hyper-volume estimate and its confidence interval from the fraction of dominated
+/// samples, using the Wilson score interval.
+///
+/// # Arguments
+///
+/// * `dominated`: The number of dominated samples.
+/// * `samples`: The number of samples.
+/// * `z`: The quantile of the standard normal distribution for the confidence level.
+/// * `box_volume`: The volume of the sampled box.
+///
+/// returns: `HyperVolumeEstimate`
+fn wilson_estimate(dominated: u64, samples: usize, z: f64, box_volume: f64) -> HyperVolumeEstimate {
+    let n = samples as f64;
+    let p = dominated as f64 / n;
+    let z2 = z * z;
+    let denominator = 1.0 + z2 / n;
+    let centre = (p + z2 / (2.0 * n)) / denominator;
+    let half_width = z * (p * (1.0 - p) / n + z2 / (4.0 * n * n)).sqrt() / denominator;
+
+    HyperVolumeEstimate {
+        value: p * box_volume,
+        lower_bound: (centre - half_width).max(0.0) * box_volume,
+        upper_bound: (centre + half_width).min(1.0) * box_volume,
+        relative_error: if dominated == 0 {
+            f64::INFINITY
+        } else {
+            half_width / p
+        },
+        samples,
+    }
+}
+
+/// Calculate the quantile of the standard normal distribution using the rational approximation
+/// by Acklam, whose relative error is less than `1.15e-9`.
+///
+/// # Arguments
+///
+/// * `p`: The probability. This must be between 0 and 1.
+///
+/// returns: `f64`
+fn normal_quantile(p: f64) -> f64 {
+    const A: [f64; 6] = [
+        -3.969683028665376e+01,
+        2.209460984245205e+02,
+        -2.759285104469687e+02,
+        1.383577518672690e+02,
+        -3.066479806614716e+01,
+        2.506628277459239e+00,
+    ];
+    const B: [f64; 5] = [
+        -5.447609879822406e+01,
+        1.615858368580409e+02,
+        -1.556989798598866e+02,
+        6.680131188771972e+01,
+        -1.328068155288572e+01,
+    ];
+    const C: [f64; 6] = [
+        -7.784894002430293e-03,
+        -3.223964580411365e-01,
+        -2.400758277161838e+00,
+        -2.549732539343734e+00,
+        4.374664141464968e+00,
+        2.938163982698783e+00,
+    ];
+    const D: [f64; 4] = [
+        7.784695709041462e-03,
+        3.224671290700398e-01,
+        2.445134137142996e+00,
+        3.754408661907416e+00,
+    ];
+    const P_LOW: f64 = 0.02425;
+
+    let tail = |q: f64| -> f64 {
+        (((((C[0] * q + C[1]) * q + C[2]) * q + C[3]) * q + C[4]) * q + C[5])
+            / ((((D[0] * q + D[1]) * q + D[2]) * q + D[3]) * q + 1.0)
+    };
+    if p < P_LOW {
+        tail((-2.0 * p.ln()).sqrt())
+    } else if p > 1.0 - P_LOW {
+        -tail((-2.0 * (1.0 - p).ln()).sqrt())
+    } else {
+        let q = p - 0.5;
+        let r = q * q;
+        (((((A[0] * r + A[1]) * r + A[2]) * r + A[3]) * r + A[4]) * r + A[5]) * q
+            / (((((B[0] * r + B[1]) * r + B[2]) * r + B[3]) * r + B[4]) * r + 1.0)
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use float_cmp::assert_approx_eq;
+
+    use crate::core::test_utils::individuals_from_obj_values_dummy;
+    use crate::core::ObjectiveDirection;
+    use crate::metrics::hypervolume_monte_carlo::normal_quantile;
+    use crate::metrics::test_utils::parse_pagmo_test_data_file;
+    use crate::metrics::{HyperVolumeMonteCarlo, HyperVolumeMonteCarloArgs};
+
+    #[test]
+    fn test_normal_quantile() {
+        assert_approx_eq!(f64, normal_quantile(0.975), 1.959963985, epsilon = 1e-8);
+        assert_approx_eq!(f64, normal_quantile(0.5), 0.0, epsilon = 1e-12);
+        assert_approx_eq!(f64, normal_quantile(0.995), 2.575829304, epsilon = 1e-8);
+        assert_approx_eq!(f64, normal_quantile(0.01), -2.326347874, epsilon = 1e-8);
+    }
+
+    #[test]
+    /// Test the estimate against the exact value of the Pagmo c_max_t1_d5_n1024 test data.
+    fn test_c_max_t1_d5_n1024() {
+        let all_test_data = parse_pagmo_test_data_file("c_max_t1_d5_n1024").unwrap();
+        let test_data = all_test_data.first().unwrap();
+        let objective_direction = vec![ObjectiveDirection::Minimise; 5];
+        let mut individuals = individuals_from_obj_values_dummy(
+            &test_data.objective_values,
+            &objective_direction,
+            None,
+        );
+
+        let args = HyperVolumeMonteCarloArgs {
+            relative_error: 0.002,
+            seed: Some(1),
+            ..HyperVolumeMonteCarloArgs::default()
+        };
+        let hv =
+            HyperVolumeMonteCarlo::new(&mut individuals, &test_data.reference_point, args).unwrap();
+        let estimate = hv.compute();
+
+        assert!(estimate.relative_error <= 0.002);
+        assert!(estimate.lower_bound <= estimate.value && estimate.value <= estimate.upper_bound);
+        assert!((estimate.value - test_data.hyper_volume).abs() / test_data.hyper_volume < 0.006);
+        // the estimate is reproducible
+        assert_eq!(hv.compute(), estimate);
+    }
+
+    #[test]
+    /// Test a front with 10 objectives whose hyper-volume is known.
+    fn test_10_objectives() {
+        // the union of two boxes of volume 2^9 * 3 and 3 * 2^9 intersecting in a box of volume 2^10
+        let mut first = vec![1.0; 10];
+        first[0] = 0.0;
+        let mut second = vec![1.0; 10];
+        second[1] = 0.0;
+        let objective_direction = vec![ObjectiveDirection::Minimise; 10];
+        let mut individuals =
+            individuals_from_obj_values_dummy(&[first, second], &objective_direction, None);
+
+        let args = HyperVolumeMonteCarloArgs {
+            relative_error: 0.001,
+            seed: Some(10),
+            ..HyperVolumeMonteCarloArgs::default()
+        };
+        let hv = HyperVolumeMonteCarlo::new(&mut individuals, &[3.0; 10], args).unwrap();
+        let estimate = hv.compute();
+        let expected = 2.0 * 3.0 * 512.0 - 1024.0;
+
+        // more than one batch is needed to reach the relative error
+        assert!(estimate.relative_error <= 0.001);
+        assert!(estimate.samples > 100_000 && estimate.samples < 10_000_000);
+        assert!((estimate.value - expected).abs() / expected < 0.004);
+    }
+
+    #[test]
+    /// Test a simple front with a maximised objective and the option errors.
+    fn test_simple_front_and_errors() {
+        let objective_values = vec![vec![1.0, 1.0, -1.0], vec![2.0, 2.0, -2.0]];
+        let objective_direction = [
+            ObjectiveDirection::Minimise,
+            ObjectiveDirection::Minimise,
+            ObjectiveDirection::Maximise,
+        ];
+        let mut individuals =
+            individuals_from_obj_values_dummy(&objective_values, &objective_direction, None);
+
+        // a single non-dominated point fills the sampled box
+        let hv = HyperVolumeMonteCarlo::new(
+            &mut individuals,
+            &[3.0, 3.0, -3.0],
+            HyperVolumeMonteCarloArgs::default(),
+        )
+        .unwrap();
+        let estimate = hv.compute();
+        assert_eq!(estimate.value, 8.0);
+        assert_eq!(estimate.samples, 100_000);
+
+        let args = HyperVolumeMonteCarloArgs {
+            relative_error: 0.0,
+            ..HyperVolumeMonteCarloArgs::default()
+        };
+        let err = HyperVolumeMonteCarlo::new(&mut individuals, &[3.0, 3.0, -3.0], args)
+            .unwrap_err()
+            .to_string();
+        assert!(err.contains("The relative error (0) must be strictly positive"));
+
+        let args = HyperVolumeMonteCarloArgs {
+            confidence_level: 1.0,
+            ..HyperVolumeMonteCarloArgs::default()
+        };
+        let err = HyperVolumeMonteCarlo::new(&mut individuals, &[3.0, 3.0, -3.0], args)
+            .unwrap_err()
+            .to_string();
+        assert!(err.contains("The confidence level (1) must be between 0 and 1"));
+
+        let args = HyperVolumeMonteCarloArgs {
+            batch_size: 10,
+            max_samples: 5,
+            ..HyperVolumeMonteCarloArgs::default()
+        };
+        assert!(HyperVolumeMonteCarlo::new(&mut individuals, &[3.0, 3.0, -3.0], args).is_err());
+    }
+}
@@ -0,0 +1,205 @@
+/// The maximum number of points in a leaf of the tree. The points in a leaf are searched with
+/// brute force, which is faster than descending the tree for few points.
+const LEAF_SIZE: usize = 16;
+
+/// A k-d tree to find the Euclidean distance between a point and its nearest neighbour in a set
+/// of points. The tree is stored implicitly in the point matrix: the points are reordered so that
+/// the point splitting the range `[start, end)` is in the middle of the range, and the points on
+/// its left (or right) have a smaller (or larger) coordinate along the split dimension. Ranges
+/// with at most [`LEAF_SIZE`] points are leaves.
+#[derive(Clone, Debug)]
+pub(crate) struct KdTree {
+    /// The reordered points stored as a flat row-major matrix.
+    points: Vec<f64>,
+    /// The number of coordinates of each point.
+    dimensions: usize,
+    /// The dimension split by each point in the middle of a range. The values for the points
+    /// in the leaves are not used.
+    split_dimensions: Vec<usize>,
+}
+
+impl KdTree {
+    /// Build the tree.
+    ///
+    /// # Arguments
+    ///
+    /// * `points`: The points stored as a flat row-major matrix. The coordinates of the `i`-th
+    ///    point are stored from `i * dimensions` to `(i + 1) * dimensions` (excluded).
+    /// * `dimensions`: The number of coordinates of each point. This must be larger than 0.
+    ///
+    /// returns: `KdTree`
+    pub(crate) fn new(points: &[f64], dimensions: usize) -> Self {
+        let number_of_points = points.len() / dimensions;
+        let mut order: Vec<usize> = (0..number_of_points).collect();
+        let mut split_dimensions = vec![0; number_of_points];
+        Self::build(points, dimensions, &mut order, 0, &mut split_dimensions);
+
+        let points = order
+            .iter()
+            .flat_map(|i| points[i * dimensions..(i + 1) * dimensions].iter().copied())
+            .collect();
+        Self {
+            points,
+            dimensions,
+            split_dimensions,
+        }
+    }
+
+    /// Get the number of points in the tree.
+    ///
+    /// returns: `usize`
+    pub(crate) fn len(&self) -> usize {
+        self.split_dimensions.len()
+    }
+
+    /// Get the Euclidean distance between a point and the nearest point in the tree.
+    ///
+    /// # Arguments
+    ///
+    /// * `query`: The point coordinates.
+    ///
+    /// returns: `f64`. This is infinite when the tree is empty.
+    pub(crate) fn nearest_distance(&self, query: &[f64]) -> f64 {
+        let mut best = f64::INFINITY;
+        self.search(0, self.len(), query, &mut best);
+        best.sqrt()
+    }
+
+    /// Reorder the indexes of the points in a range so that the median point along the
+    /// dimension with the largest spread is in the middle, and build the sub-trees on its left
+    /// and right.
+    ///
+    /// # Arguments
+    ///
+    /// * `points`: The points matrix.
+    /// * `dimensions`: The number of coordinates of each point.
+    /// * `order`: The indexes of the points in the range.
+    /// * `offset`: The position of the first point of the range in the tree.
+    /// * `split_dimensions`: The split dimension of each point in the tree.
+    ///
+    /// returns: `()`
+    fn build(
+        points: &[f64],
+        dimensions: usize,
+        order: &mut [usize],
+        offset: usize,
+        split_dimensions: &mut [usize],
+    ) {
+        if order.len() <= LEAF_SIZE {
+            return;
+        }
+
+        // split along the dimension with the largest spread
+        let mut min = vec![f64::INFINITY; dimensions];
+        let mut max = vec![f64::NEG_INFINITY; dimensions];
+        for i in order.iter() {
+            for (k, value) in points[i * dimensions..(i + 1) * dimensions]
+                .iter()
+                .enumerate()
+            {
+                min[k] = min[k].min(*value);
+                max[k] = max[k].max(*value);
+            }
+        }
+        let dim = (0..dimensions)
+            .max_by(|a, b| (max[*a] - min[*a]).total_cmp(&(max[*b] - min[*b])))
+            .unwrap_or(0);
+
+        let mid = order.len() / 2;
+        order.select_nth_unstable_by(mid, |a, b| {
+            points[a * dimensions + dim].total_cmp(&points[b * dimensions + dim])
+        });
+        split_dimensions[offset + mid] = dim;
+
+        let (left, right) = order.split_at_mut(mid);
+        Self::build(points, dimensions, left, offset, split_dimensions);
+        Self::build(
+            points,
+            dimensions,
+            &mut right[1..],
+            offset + mid + 1,
+            split_dimensions,
+        );
+    }
+
+    /// Get the squared Euclidean distance between a point in the tree and another point.
+    fn distance_squared(&self, index: usize, query: &[f64]) -> f64 {
+        self.points[index * self.dimensions..(index + 1) * self.dimensions]
+            .iter()
+            .zip(query)
+            .map(|(p, q)| (p - q) * (p - q))
+            .sum()
+    }
+
+    /// Search the nearest point in a range of the tree and update the squared distance.
+    ///
+    /// # Arguments
+    ///
+    /// * `start`: The first point in the range.
+    /// * `end`: The point after the last point in the range.
+    /// * `query`: The point coordinates.
+    /// * `best`: The smallest squared distance found so far.
+    ///
+    /// returns: `()`
+    fn search(&self, start: usize, end: usize, query: &[f64], best: &mut f64) {
+        if end - start <= LEAF_SIZE {
+            for index in start..end {
+                *best = best.min(self.distance_squared(index, query));
+            }
+            return;
+        }
+
+        let mid = start + (end - start) / 2;
+        let dim = self.split_dimensions[mid];
+        let delta = query[dim] - self.points[mid * self.dimensions + dim];
+        *best = best.min(self.distance_squared(mid, query));
+
+        // search the side with the query first, then the other side only if it may contain
+        // a closer point
+        let (near, far) = if delta < 0.0 {
+            ((start, mid), (mid + 1, end))
+        } else {
+            ((mid + 1, end), (start, mid))
+        };
+        self.search(near.0, near.1, query, best);
+        if delta * delta < *best {
+            self.search(far.0, far.1, query, best);
+        }
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use rand::Rng;
+
+    use crate::core::utils::get_rng;
+    use crate::metrics::kd_tree::KdTree;
+
+    #[test]
+    /// The distance to the nearest point matches the distance found with brute force.
+    fn test_nearest_distance() {
+        let mut rng = get_rng(Some(1));
+        for dimensions in [2, 3, 5] {
+            let points: Vec<f64> = (0..1000 * dimensions)
+                .map(|_| rng.gen_range(0.0..10.0))
+                .collect();
+            let tree = KdTree::new(&points, dimensions);
+            assert_eq!(tree.len(), 1000);
+
+            for _ in 0..100 {
+                let query: Vec<f64> = (0..dimensions).map(|_| rng.gen_range(-1.0..11.0)).collect();
+                let expected = points
+                    .chunks_exact(dimensions)
+                    .map(|p| {
+                        p.iter()
+                            .zip(&query)
+                            .map(|(a, b)| (a - b) * (a - b))
+                            .sum::<f64>()
+                            .sqrt()
+                    })
+                    .fold(f64::INFINITY, f64::min);
+                assert_eq!(tree.nearest_distance(&query), expected);
+            }
+        }
+    }
+}
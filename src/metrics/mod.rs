@@ -1,14 +1,25 @@
-pub use distance::Distance;
+pub use distance::{Distance, ReferenceFront};
 pub use hv_wfg::HyperVolumeWhile2012;
 pub use hypervolume::{AllHyperVolumeFileData, HyperVolume, HyperVolumeFileData};
 pub use hypervolume_2d::HyperVolume2D;
+pub use hypervolume_contributions::{
+    hypervolume_contributions, HyperVolumeContributions, HV_CONTRIBUTION_KEY,
+};
 pub use hypervolume_fonseca_2006::HyperVolumeFonseca2006;
+pub use hypervolume_incremental_3d::HyperVolumeIncremental3D;
+pub use hypervolume_monte_carlo::{
+    HyperVolumeEstimate, HyperVolumeMonteCarlo, HyperVolumeMonteCarloArgs,
+};
 
 mod distance;
-mod hv_wfg;
+pub(crate) mod hv_wfg;
 mod hypervolume;
 mod hypervolume_2d;
+mod hypervolume_contributions;
 mod hypervolume_fonseca_2006;
+mod hypervolume_incremental_3d;
+mod hypervolume_monte_carlo;
+mod kd_tree;
 
 #[cfg(test)]
 pub(crate) mod test_utils {
@@ -1,6 +1,10 @@
 use std::cmp::Ordering;
 
 use crate::core::{Individual, OError};
+use crate::metrics::HV_CONTRIBUTION_KEY;
+use crate::utils::fixed_objectives::{
+    pareto_flags, pareto_flags_fixed, row, with_fixed_objectives,
+};
 
 /// The preferred solution with the `BinaryComparisonOperator`.
 #[derive(Debug, PartialOrd, PartialEq)]
@@ -60,12 +64,11 @@ impl BinaryComparisonOperator for ParetoConstrainedDominance {
         first_solution: &Individual,
         second_solution: &Individual,
     ) -> Result<PreferredSolution, OError> {
-        let problem = first_solution.problem();
         let cv1 = first_solution.constraint_violation();
         let cv2 = second_solution.constraint_violation();
 
         // at least one solution is not feasible (step 1-2)
-        if problem.number_of_constraints() > 0 && cv1 != cv2 {
+        if !first_solution.constraint_values_slice().is_empty() && cv1 != cv2 {
             if first_solution.is_feasible() {
                 // solution 1 dominates
                 return Ok(PreferredSolution::First);
@@ -81,30 +84,24 @@ impl BinaryComparisonOperator for ParetoConstrainedDominance {
             }
         }
 
-        // check pareto dominance using all the objectives (step 2)
-        let mut relation = PreferredSolution::MutuallyPreferred;
-        for objective_name in problem.objective_names() {
-            let obj_sol1 = first_solution.get_objective_value(objective_name.as_str())?;
-            let obj_sol2 = second_solution.get_objective_value(objective_name.as_str())?;
-
-            if obj_sol1 < obj_sol2 {
-                // previous objective favours 2nd solution
-                if relation == PreferredSolution::Second {
-                    // mutually dominated
-                    return Ok(PreferredSolution::MutuallyPreferred);
-                }
-                relation = PreferredSolution::First;
-            } else if obj_sol1 > obj_sol2 {
-                // previous objective favours 1st solution
-                if relation == PreferredSolution::First {
-                    // mutually dominated
-                    return Ok(PreferredSolution::MutuallyPreferred);
-                }
-                relation = PreferredSolution::Second;
-            }
-        }
+        // check pareto dominance using all the objectives (step 2). With 2 to 4 objectives, the
+        // values are compared without branches
+        let obj_sol1 = first_solution.objective_values_slice();
+        let obj_sol2 = second_solution.objective_values_slice();
+        let same_size = obj_sol1.len() == obj_sol2.len();
+        let flags = with_fixed_objectives!(
+            if same_size { obj_sol1.len() } else { 0 },
+            |M| pareto_flags_fixed::<M>(row(obj_sol1, 0), row(obj_sol2, 0)),
+            pareto_flags(obj_sol1, obj_sol2)
+        );
 
-        Ok(relation)
+        match flags {
+            // at least one objective favours the 1st solution and none the 2nd one
+            (true, false) => Ok(PreferredSolution::First),
+            (false, true) => Ok(PreferredSolution::Second),
+            // mutually dominated
+            _ => Ok(PreferredSolution::MutuallyPreferred),
+        }
     }
 }
 
@@ -202,6 +199,101 @@ impl BinaryComparisonOperator for CrowdedComparison {
     }
 }
 
+/// This implements a comparison operator based on the hyper-volume contribution, used in the
+/// environmental selection of SMS-EMOA. A solution $S_i$ dominates a solution $S_j$ if:
+///
+///    - $rank_i < rank_j$
+///
+/// or when $rank_i =rank_j$
+///
+///    - ${contribution}_i > {contribution}_j$
+///
+/// where $rank_x$ is the rank from the fast non-dominated sort algorithm (see
+/// [`crate::utils::fast_non_dominated_sort()`]) and $contribution_x$ is the exclusive
+/// hyper-volume contribution of the solution to its front, stored in the individual's data with
+/// [`crate::metrics::HyperVolumeContributions::set_data`].
+///
+/// Implemented based on:
+/// > Nicola Beume, Boris Naujoks, Michael Emmerich, "SMS-EMOA: Multiobjective selection based on
+/// > dominated hypervolume," in European Journal of Operational Research, vol. 181, no. 3, pp.
+/// > 1653-1669, 2007, doi: 10.1016/j.ejor.2006.08.008.
+///
+pub struct HyperVolumeContributionComparison;
+
+impl BinaryComparisonOperator for HyperVolumeContributionComparison {
+    /// Get the relation between two solutions with rank and hyper-volume contribution data. This
+    /// returns an error if the data does not exist on either solutions.
+    ///
+    /// # Arguments
+    ///
+    /// * `first_solution`: The first solution to compare.
+    /// * `second_solution`: The second solution to compare.
+    ///
+    /// returns: `Result<PreferredSolution, OError>` The dominance relation between solution 1
+    /// and 2.
+    fn compare(
+        first_solution: &Individual,
+        second_solution: &Individual,
+    ) -> Result<PreferredSolution, OError> {
+        let name = "HyperVolumeContributionComparison".to_string();
+        let rank1 = match first_solution.get_data("rank") {
+            Err(_) => {
+                return Err(OError::ComparisonOperator(
+                    name,
+                    "The rank on the first individual does not exist".to_string(),
+                ))
+            }
+            Ok(r) => r.as_integer()?,
+        };
+        let rank2 = match second_solution.get_data("rank") {
+            Err(_) => {
+                return Err(OError::ComparisonOperator(
+                    name,
+                    "The rank on the second individual does not exist".to_string(),
+                ))
+            }
+            Ok(r) => r.as_integer()?,
+        };
+
+        match rank1.cmp(&rank2) {
+            Ordering::Less => Ok(PreferredSolution::First),
+            Ordering::Equal => {
+                let c1 = match first_solution.get_data(HV_CONTRIBUTION_KEY) {
+                    Err(_) => {
+                        return Err(OError::ComparisonOperator(
+                            name,
+                            format!(
+                                "The hyper-volume contribution on the first individual {:?} does not exist",
+                                first_solution.variables()
+                            ),
+                        ))
+                    }
+                    Ok(r) => r.as_real()?,
+                };
+                let c2 = match second_solution.get_data(HV_CONTRIBUTION_KEY) {
+                    Err(_) => {
+                        return Err(OError::ComparisonOperator(
+                            name,
+                            format!(
+                                "The hyper-volume contribution on the second individual {:?} does not exist",
+                                second_solution.variables()
+                            ),
+                        ))
+                    }
+                    Ok(r) => r.as_real()?,
+                };
+
+                if c1 > c2 {
+                    Ok(PreferredSolution::First)
+                } else {
+                    Ok(PreferredSolution::Second)
+                }
+            }
+            Ordering::Greater => Ok(PreferredSolution::Second),
+        }
+    }
+}
+
 #[cfg(test)]
 mod test_pareto_constrained_dominance {
     use std::sync::Arc;
@@ -548,3 +640,50 @@ mod test_crowded_comparison {
         );
     }
 }
+
+#[cfg(test)]
+mod test_hv_contribution_comparison {
+    use crate::core::test_utils::individuals_from_obj_values_dummy;
+    use crate::core::{DataValue, ObjectiveDirection};
+    use crate::metrics::HyperVolumeContributions;
+    use crate::operators::{
+        BinaryComparisonOperator, HyperVolumeContributionComparison, PreferredSolution,
+    };
+
+    #[test]
+    fn test_compare() {
+        let objective_values = vec![vec![1.0, 2.0], vec![2.0, 0.5], vec![1.5, 1.5]];
+        let mut individuals = individuals_from_obj_values_dummy(
+            &objective_values,
+            &[ObjectiveDirection::Minimise, ObjectiveDirection::Minimise],
+            None,
+        );
+        for individual in individuals.iter_mut() {
+            individual.set_data("rank", DataValue::Integer(1));
+        }
+        assert!(
+            HyperVolumeContributionComparison::compare(&individuals[0], &individuals[1])
+                .unwrap_err()
+                .to_string()
+                .contains("The hyper-volume contribution on the first individual")
+        );
+
+        // contributions are 0.5, 1.0 and 0.25
+        HyperVolumeContributions::set_data(&mut individuals, &[3.0, 3.0]).unwrap();
+        assert_eq!(
+            HyperVolumeContributionComparison::compare(&individuals[0], &individuals[1]).unwrap(),
+            PreferredSolution::Second
+        );
+        assert_eq!(
+            HyperVolumeContributionComparison::compare(&individuals[0], &individuals[2]).unwrap(),
+            PreferredSolution::First
+        );
+
+        // rank has priority
+        individuals[1].set_data("rank", DataValue::Integer(2));
+        assert_eq!(
+            HyperVolumeContributionComparison::compare(&individuals[0], &individuals[1]).unwrap(),
+            PreferredSolution::First
+        );
+    }
+}
@@ -1,5 +1,6 @@
 pub use comparison::{
-    BinaryComparisonOperator, CrowdedComparison, ParetoConstrainedDominance, PreferredSolution,
+    BinaryComparisonOperator, CrowdedComparison, HyperVolumeContributionComparison,
+    ParetoConstrainedDominance, PreferredSolution,
 };
 pub use crossover::{Crossover, SimulatedBinaryCrossover, SimulatedBinaryCrossoverArgs};
 pub use mutation::{Mutation, PolynomialMutation, PolynomialMutationArgs};
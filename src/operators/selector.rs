@@ -1,7 +1,7 @@
 use std::marker::PhantomData;
 
 use rand::prelude::SliceRandom;
-use rand::RngCore;
+use rand::{Rng, RngCore};
 
 use crate::core::{Individual, OError};
 use crate::operators::{BinaryComparisonOperator, PreferredSolution};
@@ -43,6 +43,33 @@ pub trait Selector {
         individuals: &[Individual],
         rng: &mut dyn RngCore,
     ) -> Result<Individual, OError>;
+
+    /// Select the fittest individual from the population and return its index. Use this instead
+    /// of [`Selector::select_fit_individual`] to access the individual without cloning it. The
+    /// default implementation selects one individual with [`Selector::select`] and returns the
+    /// index of the first individual equal to it; override this to avoid the copy and the search.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`: The list of individuals.
+    /// * `rng`: The random number generator.
+    ///
+    /// returns: `Result<usize, OError>`
+    fn select_fit_index(
+        &self,
+        individuals: &[Individual],
+        rng: &mut dyn RngCore,
+    ) -> Result<usize, OError> {
+        let winner = self.select(individuals, 1, rng)?.pop();
+        winner
+            .and_then(|winner| individuals.iter().position(|i| *i == winner))
+            .ok_or_else(|| {
+                OError::SelectorOperator(
+                    "Selector".to_string(),
+                    "The selected individual is not in the population".to_string(),
+                )
+            })
+    }
 }
 
 /// Tournament selection method between multiple competitors for choosing individuals from a
@@ -79,7 +106,7 @@ impl<Operator: BinaryComparisonOperator> Selector for TournamentSelector<Operato
     /// # Arguments
     ///
     /// * `individuals`:The individuals with the solutions.
-    /// * `rng`: The random number generator. Set this to `None`, if you are not using a seed.
+    /// * `rng`: The random number generator.
     ///
     /// returns: `Result<Individual, OError>`
     fn select_fit_individual(
@@ -87,7 +114,22 @@ impl<Operator: BinaryComparisonOperator> Selector for TournamentSelector<Operato
         individuals: &[Individual],
         rng: &mut dyn RngCore,
     ) -> Result<Individual, OError> {
-        // let population = population.lock().unwrap();
+        Ok(individuals[self.select_fit_index(individuals, rng)?].clone())
+    }
+
+    /// Select the fittest individual from the population and return its index.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`:The individuals with the solutions.
+    /// * `rng`: The random number generator.
+    ///
+    /// returns: `Result<usize, OError>`
+    fn select_fit_index(
+        &self,
+        individuals: &[Individual],
+        rng: &mut dyn RngCore,
+    ) -> Result<usize, OError> {
         if individuals.is_empty() {
             return Err(OError::SelectorOperator(
                 "BinaryComparisonOperator".to_string(),
@@ -100,19 +142,74 @@ impl<Operator: BinaryComparisonOperator> Selector for TournamentSelector<Operato
                 format!("The population size ({}) is smaller than the number of competitors needed in the tournament ({})", individuals.len(), self.number_of_competitors))
             );
         }
-        let mut winner = individuals.choose(rng).unwrap();
+        let mut winner = rng.gen_range(0..individuals.len());
 
         for _ in 0..self.number_of_competitors {
-            let potential_winner = individuals.choose(rng).unwrap();
-            let preferred_sol = Operator::compare(winner, potential_winner)?;
+            let potential_winner = rng.gen_range(0..individuals.len());
+            let preferred_sol =
+                Operator::compare(&individuals[winner], &individuals[potential_winner])?;
             if preferred_sol == PreferredSolution::Second {
                 winner = potential_winner;
             } else if preferred_sol == PreferredSolution::MutuallyPreferred {
                 // randomly select winner
-                winner = [winner, potential_winner].choose(rng).unwrap();
+                winner = *[winner, potential_winner].choose(rng).unwrap();
             }
         }
 
-        Ok(winner.clone())
+        Ok(winner)
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use rand::RngCore;
+
+    use crate::core::test_utils::individuals_from_obj_values_dummy;
+    use crate::core::utils::get_rng;
+    use crate::core::{Individual, OError, ObjectiveDirection};
+    use crate::operators::Selector;
+
+    /// Selector implementing only `select_fit_individual`, which picks the individual with the
+    /// smallest objective.
+    struct MinimumSelector;
+
+    impl Selector for MinimumSelector {
+        fn select_fit_individual(
+            &self,
+            individuals: &[Individual],
+            _rng: &mut dyn RngCore,
+        ) -> Result<Individual, OError> {
+            individuals
+                .iter()
+                .min_by(|a, b| {
+                    a.get_objective_value("obj0")
+                        .unwrap()
+                        .total_cmp(&b.get_objective_value("obj0").unwrap())
+                })
+                .cloned()
+                .ok_or(OError::SelectorOperator(
+                    "MinimumSelector".to_string(),
+                    "The population is empty".to_string(),
+                ))
+        }
+    }
+
+    #[test]
+    /// The default `select_fit_index` returns the index of the individual selected by a custom
+    /// selector.
+    fn test_default_select_fit_index() {
+        let individuals = individuals_from_obj_values_dummy(
+            &[vec![3.0], vec![1.0], vec![2.0]],
+            &[ObjectiveDirection::Minimise],
+            None,
+        );
+        let mut rng = get_rng(Some(1));
+        assert_eq!(
+            MinimumSelector
+                .select_fit_index(&individuals, &mut rng)
+                .unwrap(),
+            1
+        );
+        assert!(MinimumSelector.select_fit_index(&[], &mut rng).is_err());
     }
 }
@@ -0,0 +1,382 @@
+//! Kernel calculating the constrained dominance relation between all the pairs of individuals,
+//! used by the NSGA2 non-dominated sort.
+use rayon::prelude::*;
+
+use crate::core::Individual;
+use crate::utils::fixed_objectives::{
+    pareto_flags, pareto_flags_fixed, row, with_fixed_objectives,
+};
+
+/// The number of rows or columns in a tile of the dominance matrix. A tile of rows is processed
+/// by one task and a tile of columns fits in the cache while the rows are compared with it.
+const TILE_SIZE: usize = 64;
+
+/// The minimum number of individuals to compare the tiles in parallel.
+const PARALLEL_MIN_INDIVIDUALS: usize = 256;
+
+/// The result of the comparison of two points.
+#[derive(Debug, PartialEq, Clone, Copy)]
+enum Relation {
+    /// The first point dominates the second one.
+    Dominates,
+    /// The second point dominates the first one.
+    Dominated,
+    /// The points do not dominate each other.
+    NonDominated,
+}
+
+impl Relation {
+    /// Get the relation from the flags of the objective comparison.
+    ///
+    /// # Arguments
+    ///
+    /// * `flags`: Whether at least one objective of the first point is better and whether at
+    ///   least one is worse.
+    ///
+    /// returns: `Relation`
+    #[inline(always)]
+    fn from_flags(flags: (bool, bool)) -> Self {
+        match flags {
+            (true, false) => Relation::Dominates,
+            (false, true) => Relation::Dominated,
+            _ => Relation::NonDominated,
+        }
+    }
+}
+
+/// The relations found by comparing a tile of rows with the individuals following them.
+struct TileRelations {
+    /// For each row, the indexes of the following individuals it dominates and the number of
+    /// following individuals dominating it.
+    rows: Vec<(Vec<usize>, usize)>,
+    /// The pairs `(q, p)` where the column `q` dominates the row `p`. For each column, the rows
+    /// are in ascending order.
+    dominating_columns: Vec<(usize, usize)>,
+    /// The columns dominated by a row, once for each row dominating them.
+    dominated_columns: Vec<usize>,
+}
+
+/// The objective values and constraint violations of the individuals, stored in contiguous
+/// vectors.
+pub(crate) struct DominanceKernel {
+    /// The objective values stored in a row-major matrix. The values of maximised objectives are
+    /// negated, as stored in each [`Individual`].
+    objectives: Vec<f64>,
+    /// The number of objectives.
+    number_of_objectives: usize,
+    /// The constraint violation of each individual.
+    violations: Vec<f64>,
+    /// Whether each individual is feasible.
+    feasible: Vec<bool>,
+    /// Whether the problem has constraints.
+    has_constraints: bool,
+}
+
+impl DominanceKernel {
+    /// Copy the data of the individuals needed to calculate the dominance relations.
+    ///
+    /// # Arguments
+    ///
+    /// * `individuals`: The individuals.
+    ///
+    /// returns: `DominanceKernel`
+    pub(crate) fn new(individuals: &[Individual]) -> Self {
+        let number_of_objectives = individuals
+            .first()
+            .map_or(0, |ind| ind.objective_values_slice().len());
+        Self {
+            objectives: individuals
+                .iter()
+                .flat_map(|ind| ind.objective_values_slice().iter().copied())
+                .collect(),
+            number_of_objectives,
+            violations: individuals
+                .iter()
+                .map(|ind| ind.constraint_violation())
+                .collect(),
+            feasible: individuals.iter().map(|ind| ind.is_feasible()).collect(),
+            has_constraints: individuals
+                .first()
+                .is_some_and(|ind| !ind.constraint_values_slice().is_empty()),
+        }
+    }
+
+    /// Get the number of individuals.
+    ///
+    /// returns: `usize`
+    fn len(&self) -> usize {
+        self.violations.len()
+    }
+
+    /// Compare the individuals at index `p` and `q` using the constrained dominance. This gives
+    /// the same relation as [`crate::operators::ParetoConstrainedDominance`].
+    ///
+    /// # Arguments
+    ///
+    /// * `p`: The index of the first individual.
+    /// * `q`: The index of the second individual.
+    ///
+    /// returns: `Relation`
+    fn relation(&self, p: usize, q: usize) -> Relation {
+        if let Some(relation) = self.constraint_relation(p, q) {
+            return relation;
+        }
+        let m = self.number_of_objectives;
+        Relation::from_flags(pareto_flags(
+            &self.objectives[p * m..(p + 1) * m],
+            &self.objectives[q * m..(q + 1) * m],
+        ))
+    }
+
+    /// Same as [`DominanceKernel::relation`], but for a problem with `M` objectives.
+    ///
+    /// # Arguments
+    ///
+    /// * `p`: The index of the first individual.
+    /// * `q`: The index of the second individual.
+    ///
+    /// returns: `Relation`
+    #[inline(always)]
+    fn relation_fixed<const M: usize>(&self, p: usize, q: usize) -> Relation {
+        if let Some(relation) = self.constraint_relation(p, q) {
+            return relation;
+        }
+        Relation::from_flags(pareto_flags_fixed::<M>(
+            row(&self.objectives, p),
+            row(&self.objectives, q),
+        ))
+    }
+
+    /// Compare the constraint violations of the individuals at index `p` and `q`.
+    ///
+    /// # Arguments
+    ///
+    /// * `p`: The index of the first individual.
+    /// * `q`: The index of the second individual.
+    ///
+    /// returns: `Option<Relation>`. `None` when the objectives must be compared.
+    #[inline(always)]
+    fn constraint_relation(&self, p: usize, q: usize) -> Option<Relation> {
+        let (cv_p, cv_q) = (self.violations[p], self.violations[q]);
+        if self.has_constraints && cv_p != cv_q {
+            if self.feasible[p] {
+                return Some(Relation::Dominates);
+            } else if self.feasible[q] {
+                return Some(Relation::Dominated);
+            } else if cv_p < cv_q {
+                return Some(Relation::Dominates);
+            } else if cv_p > cv_q {
+                return Some(Relation::Dominated);
+            }
+        }
+        None
+    }
+
+    /// Compare the rows in a tile with the individuals following them. Each pair is compared
+    /// once and the relation is recorded for both individuals.
+    ///
+    /// # Arguments
+    ///
+    /// * `rows`: The indexes of the individuals in the tile.
+    /// * `relation`: The function comparing two individuals.
+    ///
+    /// returns: `TileRelations`
+    fn compare_tile(
+        &self,
+        rows: std::ops::Range<usize>,
+        relation: impl Fn(usize, usize) -> Relation,
+    ) -> TileRelations {
+        let mut relations = TileRelations {
+            rows: rows.clone().map(|_| (Vec::new(), 0)).collect(),
+            dominating_columns: Vec::new(),
+            dominated_columns: Vec::new(),
+        };
+        for column_start in (rows.start..self.len()).step_by(TILE_SIZE) {
+            let column_end = (column_start + TILE_SIZE).min(self.len());
+            for (p, (dominated, counter)) in rows.clone().zip(relations.rows.iter_mut()) {
+                for q in column_start.max(p + 1)..column_end {
+                    match relation(p, q) {
+                        Relation::Dominates => {
+                            dominated.push(q);
+                            relations.dominated_columns.push(q);
+                        }
+                        Relation::Dominated => {
+                            *counter += 1;
+                            relations.dominating_columns.push((q, p));
+                        }
+                        Relation::NonDominated => {}
+                    }
+                }
+            }
+        }
+        relations
+    }
+
+    /// Calculate the dominance relation between all the pairs of individuals in one pass. The
+    /// matrix is split into tiles of rows, which are compared in parallel with the individuals
+    /// following them, so that each pair is compared once. Each tile collects the relations of
+    /// its rows and of the columns it compares them with, therefore the tasks do not share any
+    /// data; these are then merged in order. With 2 to 4 objectives, the comparison is
+    /// specialised for the number of objectives.
+    ///
+    /// returns: `(Vec<Vec<usize>>, Vec<usize>)`. For each individual, the indexes (in ascending
+    /// order) of the individuals it dominates (`S_p` in the NSGA2 paper) and the number of
+    /// individuals dominating it (`n_p`).
+    pub(crate) fn dominance_lists(&self) -> (Vec<Vec<usize>>, Vec<usize>) {
+        with_fixed_objectives!(
+            self.number_of_objectives,
+            |M| self.dominance_lists_with(|p, q| self.relation_fixed::<M>(p, q)),
+            self.dominance_lists_with(|p, q| self.relation(p, q))
+        )
+    }
+
+    /// Calculate the dominance lists with the given comparison function (see
+    /// [`DominanceKernel::dominance_lists`]).
+    ///
+    /// # Arguments
+    ///
+    /// * `relation`: The function comparing two individuals.
+    ///
+    /// returns: `(Vec<Vec<usize>>, Vec<usize>)`
+    fn dominance_lists_with(
+        &self,
+        relation: impl Fn(usize, usize) -> Relation + Sync,
+    ) -> (Vec<Vec<usize>>, Vec<usize>) {
+        let tiles: Vec<std::ops::Range<usize>> = (0..self.len())
+            .step_by(TILE_SIZE)
+            .map(|start| start..(start + TILE_SIZE).min(self.len()))
+            .collect();
+        let results: Vec<TileRelations> = if self.len() >= PARALLEL_MIN_INDIVIDUALS {
+            tiles
+                .into_par_iter()
+                .map(|rows| self.compare_tile(rows, &relation))
+                .collect()
+        } else {
+            tiles
+                .into_iter()
+                .map(|rows| self.compare_tile(rows, &relation))
+                .collect()
+        };
+
+        // the dominated individuals preceding each individual come first, from the tiles in order
+        let mut dominated: Vec<Vec<usize>> = vec![Vec::new(); self.len()];
+        let mut counter = vec![0; self.len()];
+        for tile in results.iter() {
+            for (q, p) in tile.dominating_columns.iter() {
+                dominated[*q].push(*p);
+            }
+            for q in tile.dominated_columns.iter() {
+                counter[*q] += 1;
+            }
+        }
+        for (p, (row_dominated, row_counter)) in results
+            .into_iter()
+            .flat_map(|tile| tile.rows.into_iter())
+            .enumerate()
+        {
+            dominated[p].extend(row_dominated);
+            counter[p] += row_counter;
+        }
+        (dominated, counter)
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use std::sync::Arc;
+
+    use crate::core::utils::dummy_evaluator;
+    use crate::core::{
+        BoundedNumber, Constraint, Individual, Objective, ObjectiveDirection, Problem,
+        RelationalOperator, VariableType,
+    };
+    use crate::operators::{
+        BinaryComparisonOperator, ParetoConstrainedDominance, PreferredSolution,
+    };
+    use crate::utils::dominance_kernel::{DominanceKernel, Relation};
+
+    /// Check that the kernel gives the same relations as the comparison operator and the lists of
+    /// the NSGA2 sort, with more individuals than needed to compare the tiles in parallel.
+    fn assert_dominance_lists(number_of_objectives: usize) {
+        let objectives = (0..number_of_objectives)
+            .map(|i| {
+                let direction = if i % 2 == 0 {
+                    ObjectiveDirection::Minimise
+                } else {
+                    ObjectiveDirection::Maximise
+                };
+                Objective::new(format!("obj{i}").as_str(), direction)
+            })
+            .collect();
+        let variables = vec![VariableType::Real(
+            BoundedNumber::new("X", 0.0, 2.0).unwrap(),
+        )];
+        let constraints = vec![Constraint::new(
+            "c1",
+            RelationalOperator::LessOrEqualTo,
+            2.0,
+        )];
+        let problem = Arc::new(
+            Problem::new(objectives, variables, Some(constraints), dummy_evaluator()).unwrap(),
+        );
+
+        let mut state: u64 = 5;
+        let mut next = || {
+            state = state
+                .wrapping_mul(6364136223846793005)
+                .wrapping_add(1442695040888963407);
+            ((state >> 33) % 4) as f64
+        };
+        let individuals: Vec<Individual> = (0..300)
+            .map(|_| {
+                let mut ind = Individual::new(problem.clone());
+                for o in 0..number_of_objectives {
+                    ind.update_objective(format!("obj{o}").as_str(), next())
+                        .unwrap();
+                }
+                ind.update_constraint("c1", next()).unwrap();
+                ind
+            })
+            .collect();
+
+        let kernel = DominanceKernel::new(&individuals);
+        let mut expected_dominated: Vec<Vec<usize>> = vec![Vec::new(); individuals.len()];
+        let mut expected_counter = vec![0; individuals.len()];
+        for p in 0..individuals.len() {
+            for q in 0..individuals.len() {
+                let expected =
+                    ParetoConstrainedDominance::compare(&individuals[p], &individuals[q]).unwrap();
+                let relation = kernel.relation(p, q);
+                match expected {
+                    PreferredSolution::First => {
+                        assert_eq!(relation, Relation::Dominates);
+                        expected_dominated[p].push(q);
+                    }
+                    PreferredSolution::Second => {
+                        assert_eq!(relation, Relation::Dominated);
+                        expected_counter[p] += 1;
+                    }
+                    PreferredSolution::MutuallyPreferred => {
+                        assert_eq!(relation, Relation::NonDominated)
+                    }
+                }
+            }
+        }
+
+        let (dominated, counter) = kernel.dominance_lists();
+        assert_eq!(dominated, expected_dominated);
+        assert_eq!(counter, expected_counter);
+    }
+
+    #[test]
+    fn test_dominance_lists() {
+        assert_dominance_lists(6);
+    }
+
+    #[test]
+    /// Use the kernel specialised for the number of objectives.
+    fn test_dominance_lists_fixed() {
+        assert_dominance_lists(2);
+        assert_dominance_lists(3);
+    }
+}
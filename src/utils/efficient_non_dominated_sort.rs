@@ -0,0 +1,543 @@
+//! Non-dominated sorting algorithms working on a matrix of objective values. These only use the
+//! Pareto dominance between the points and are used by
+//! [`crate::utils::non_dominated_sort_with`], which handles the constraint violations.
+//!
+//! All the algorithms first sort the points lexicographically, so that a point can only be
+//! dominated by a point preceding it, and merge the duplicated points (which share the same
+//! rank).
+//!
+//! **IMPLEMENTATION NOTES**: all objectives are minimised and the values must not be NaN.
+use std::cmp::Ordering;
+
+/// Compare two points lexicographically.
+///
+/// # Arguments
+///
+/// * `a`: The first point.
+/// * `b`: The second point.
+///
+/// returns: `Ordering`
+fn lexicographic_cmp(a: &[f64], b: &[f64]) -> Ordering {
+    a.iter()
+        .zip(b)
+        .map(|(x, y)| x.total_cmp(y))
+        .find(|o| *o != Ordering::Equal)
+        .unwrap_or(Ordering::Equal)
+}
+
+/// Whether the point `a` is not worse than `b` in all the first `k + 1` objectives. When the
+/// points are distinct and `a` precedes `b` in lexicographic order, this means that `a`
+/// dominates `b`.
+///
+/// # Arguments
+///
+/// * `a`: The first point.
+/// * `b`: The second point.
+/// * `k`: The index of the last objective to compare.
+///
+/// returns: `bool`
+fn weakly_dominates(a: &[f64], b: &[f64], k: usize) -> bool {
+    a[..=k].iter().zip(&b[..=k]).all(|(x, y)| x <= y)
+}
+
+/// The distinct points sorted in lexicographic order.
+struct UniquePoints {
+    /// The distinct points stored in a row-major matrix.
+    values: Vec<f64>,
+    /// The number of objectives.
+    number_of_objectives: usize,
+    /// The index of the distinct point for each of the original points.
+    point_map: Vec<usize>,
+}
+
+impl UniquePoints {
+    /// Sort and merge the duplicated points.
+    ///
+    /// # Arguments
+    ///
+    /// * `points`: The points stored in a row-major matrix.
+    /// * `number_of_objectives`: The number of objectives.
+    ///
+    /// returns: `UniquePoints`
+    fn new(points: &[f64], number_of_objectives: usize) -> Self {
+        let m = number_of_objectives;
+        let row = |i: usize| &points[i * m..(i + 1) * m];
+        let mut order: Vec<usize> = (0..points.len() / m).collect();
+        order.sort_by(|a, b| lexicographic_cmp(row(*a), row(*b)));
+
+        let mut values: Vec<f64> = Vec::with_capacity(points.len());
+        let mut point_map = vec![0; order.len()];
+        for i in order {
+            let is_new = values.len() < m || row(i) != &values[values.len() - m..];
+            if is_new {
+                values.extend_from_slice(row(i));
+            }
+            point_map[i] = values.len() / m - 1;
+        }
+
+        Self {
+            values,
+            number_of_objectives,
+            point_map,
+        }
+    }
+
+    /// Get a distinct point.
+    ///
+    /// # Arguments
+    ///
+    /// * `index`: The point index.
+    ///
+    /// returns: `&[f64]`
+    fn point(&self, index: usize) -> &[f64] {
+        &self.values[index * self.number_of_objectives..(index + 1) * self.number_of_objectives]
+    }
+
+    /// Get the number of distinct points.
+    ///
+    /// returns: `usize`
+    fn len(&self) -> usize {
+        self.values.len() / self.number_of_objectives
+    }
+
+    /// Map the ranks of the distinct points to the original points.
+    ///
+    /// # Arguments
+    ///
+    /// * `ranks`: The ranks of the distinct points.
+    ///
+    /// returns: `Vec<usize>`
+    fn map_ranks(&self, ranks: &[usize]) -> Vec<usize> {
+        self.point_map.iter().map(|i| ranks[*i]).collect()
+    }
+}
+
+/// Efficient Non-dominated Sort (ENS) with complexity $O(M * N^2)$ in the worst case, but
+/// $O(M * N * \sqrt{N})$ on average. The points are processed in lexicographic order and each
+/// point is assigned to the first front that does not contain any point dominating it. The front
+/// is searched sequentially (ENS-SS) or with a binary search (ENS-BS). The sequential search is
+/// faster when there are only a few fronts.
+///
+/// Implemented based on:
+/// > X. Zhang, Y. Tian, R. Cheng and Y. Jin, "An Efficient Approach to Nondominated Sorting for
+/// > Evolutionary Multiobjective Optimization," in IEEE Transactions on Evolutionary Computation,
+/// > vol. 19, no. 2, pp. 201-213, April 2015, doi: 10.1109/TEVC.2014.2308305.
+///
+/// # Arguments
+///
+/// * `points`: The points stored in a row-major matrix.
+/// * `number_of_objectives`: The number of objectives.
+/// * `binary_search`: Whether to search the front with a binary search.
+///
+/// returns: `Vec<usize>`. The 0-based rank of each point.
+pub(crate) fn ens_ranks(
+    points: &[f64],
+    number_of_objectives: usize,
+    binary_search: bool,
+) -> Vec<usize> {
+    let unique = UniquePoints::new(points, number_of_objectives);
+    let k = number_of_objectives - 1;
+    let mut fronts: Vec<Vec<usize>> = Vec::new();
+    let mut ranks = vec![0; unique.len()];
+
+    // the points in a front are checked backwards, as the last points added are the most likely
+    // to dominate the new point
+    let is_dominated_by_front = |front: &[usize], p: usize| {
+        front
+            .iter()
+            .rev()
+            .any(|q| weakly_dominates(unique.point(*q), unique.point(p), k))
+    };
+
+    for p in 0..unique.len() {
+        let rank = if binary_search {
+            // if the point is dominated by a point in front `f`, it is dominated by a point in
+            // all the previous fronts
+            let (mut low, mut high) = (0, fronts.len());
+            while low < high {
+                let mid = (low + high) / 2;
+                if is_dominated_by_front(&fronts[mid], p) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            low
+        } else {
+            fronts
+                .iter()
+                .position(|front| !is_dominated_by_front(front, p))
+                .unwrap_or(fronts.len())
+        };
+
+        if rank == fronts.len() {
+            fronts.push(Vec::new());
+        }
+        fronts[rank].push(p);
+        ranks[p] = rank;
+    }
+
+    unique.map_ranks(&ranks)
+}
+
+/// Divide-and-conquer non-dominated sort by Jensen (2003), generalised by Fortin et al. (2013) to
+/// points sharing the same objective values, with complexity $O(N * log^{M-1} N)$. This is
+/// faster than [`ens_ranks`] for large sets with a few objectives.
+///
+/// Implemented based on:
+/// > M. T. Jensen, "Reducing the run-time complexity of multiobjective EAs: The NSGA-II and other
+/// > algorithms," in IEEE Transactions on Evolutionary Computation, vol. 7, no. 5, pp. 503-515,
+/// > Oct. 2003, doi: 10.1109/TEVC.2003.817234.
+///
+/// > F. A. Fortin, S. Grenier and M. Parizeau, "Generalizing the improved run-time complexity
+/// > algorithm for non-dominated sorting," in Proceedings of the 15th annual conference on
+/// > Genetic and evolutionary computation (GECCO '13), pp. 615–622, 2013,
+/// > doi: 10.1145/2463372.2463454.
+///
+/// # Arguments
+///
+/// * `points`: The points stored in a row-major matrix.
+/// * `number_of_objectives`: The number of objectives.
+///
+/// returns: `Vec<usize>`. The 0-based rank of each point.
+pub(crate) fn jensen_fortin_ranks(points: &[f64], number_of_objectives: usize) -> Vec<usize> {
+    let unique = UniquePoints::new(points, number_of_objectives);
+    let mut sorter = JensenFortin {
+        points: &unique,
+        ranks: vec![0; unique.len()],
+    };
+    let all: Vec<usize> = (0..unique.len()).collect();
+    if number_of_objectives == 1 {
+        // the points are distinct and sorted
+        sorter.ranks = all.clone();
+    } else {
+        sorter.helper_a(&all, number_of_objectives - 1);
+    }
+
+    unique.map_ranks(&sorter.ranks)
+}
+
+/// Fenwick tree to get the maximum rank of the points whose objective is below a value.
+struct MaxRankTree {
+    /// The tree nodes with the rank plus one (0 means that no point was inserted).
+    nodes: Vec<usize>,
+}
+
+impl MaxRankTree {
+    /// Create an empty tree.
+    ///
+    /// # Arguments
+    ///
+    /// * `size`: The number of distinct positions.
+    ///
+    /// returns: `MaxRankTree`
+    fn new(size: usize) -> Self {
+        Self {
+            nodes: vec![0; size + 1],
+        }
+    }
+
+    /// Insert a rank at a position.
+    ///
+    /// # Arguments
+    ///
+    /// * `position`: The 0-based position.
+    /// * `rank`: The rank.
+    ///
+    /// returns: `()`
+    fn insert(&mut self, position: usize, rank: usize) {
+        let mut i = position + 1;
+        while i < self.nodes.len() {
+            self.nodes[i] = self.nodes[i].max(rank + 1);
+            i += i & i.wrapping_neg();
+        }
+    }
+
+    /// Get the maximum rank inserted at the positions up to `position` (included).
+    ///
+    /// # Arguments
+    ///
+    /// * `position`: The 0-based position.
+    ///
+    /// returns: `Option<usize>`
+    fn max_rank(&self, position: usize) -> Option<usize> {
+        let mut i = position + 1;
+        let mut value = 0;
+        while i > 0 {
+            value = value.max(self.nodes[i]);
+            i -= i & i.wrapping_neg();
+        }
+        value.checked_sub(1)
+    }
+}
+
+/// The state of the divide-and-conquer sort.
+struct JensenFortin<'a> {
+    /// The distinct points in lexicographic order.
+    points: &'a UniquePoints,
+    /// The rank of each distinct point.
+    ranks: Vec<usize>,
+}
+
+impl JensenFortin<'_> {
+    /// Get the value of an objective for a point.
+    fn value(&self, point: usize, objective: usize) -> f64 {
+        self.points.point(point)[objective]
+    }
+
+    /// Update the rank of the point `h` if it is dominated by `l`.
+    fn update_rank(&mut self, l: usize, h: usize) {
+        self.ranks[h] = self.ranks[h].max(self.ranks[l] + 1);
+    }
+
+    /// Rank the points in `set` using the first `k + 1` objectives. The points must be in
+    /// lexicographic order and share the same values for the objectives after `k`.
+    ///
+    /// # Arguments
+    ///
+    /// * `set`: The points.
+    /// * `k`: The index of the last objective to use.
+    ///
+    /// returns: `()`
+    fn helper_a(&mut self, set: &[usize], k: usize) {
+        if set.len() < 2 {
+            return;
+        }
+        if set.len() == 2 {
+            if weakly_dominates(self.points.point(set[0]), self.points.point(set[1]), k) {
+                self.update_rank(set[0], set[1]);
+            }
+            return;
+        }
+        if k == 1 {
+            self.sweep_a(set);
+            return;
+        }
+
+        let first = self.value(set[0], k);
+        if set.iter().all(|p| self.value(*p, k) == first) {
+            self.helper_a(set, k - 1);
+            return;
+        }
+
+        // split the set so that no point in `worst` can dominate a point in `best`
+        let median = self.median(set, k);
+        let (best, worst) = self.split_a(set, k, median);
+        self.helper_a(&best, k);
+        self.helper_b(&best, &worst, k - 1);
+        self.helper_a(&worst, k);
+    }
+
+    /// Update the ranks of the points in `worst` that are dominated by the points in `best`,
+    /// using the first `k + 1` objectives. The ranks in `best` must be final and the points in
+    /// `best` must not be worse than the points in `worst` for the objectives after `k`.
+    ///
+    /// # Arguments
+    ///
+    /// * `best`: The points that can dominate.
+    /// * `worst`: The points whose rank is updated.
+    /// * `k`: The index of the last objective to use.
+    ///
+    /// returns: `()`
+    fn helper_b(&mut self, best: &[usize], worst: &[usize], k: usize) {
+        if best.is_empty() || worst.is_empty() {
+            return;
+        }
+        if best.len() == 1 || worst.len() == 1 {
+            for h in worst {
+                for l in best {
+                    if weakly_dominates(self.points.point(*l), self.points.point(*h), k) {
+                        self.update_rank(*l, *h);
+                    }
+                }
+            }
+            return;
+        }
+        if k == 1 {
+            self.sweep_b(best, worst);
+            return;
+        }
+
+        let best_min = best
+            .iter()
+            .map(|p| self.value(*p, k))
+            .fold(f64::MAX, f64::min);
+        let best_max = best
+            .iter()
+            .map(|p| self.value(*p, k))
+            .fold(f64::MIN, f64::max);
+        let worst_min = worst
+            .iter()
+            .map(|p| self.value(*p, k))
+            .fold(f64::MAX, f64::min);
+        let worst_max = worst
+            .iter()
+            .map(|p| self.value(*p, k))
+            .fold(f64::MIN, f64::max);
+        if best_max <= worst_min {
+            // the objective `k` does not discriminate the points
+            self.helper_b(best, worst, k - 1);
+            return;
+        }
+        if best_min > worst_max {
+            // no point in `best` can dominate a point in `worst`
+            return;
+        }
+
+        // split both sets with the same rule, so that no point in `best2` can dominate a point in
+        // `worst1`. The points equal to the median are added to the lower sets only if this
+        // reduces the size of the largest sub-problem
+        let all: Vec<usize> = best.iter().chain(worst).copied().collect();
+        let median = self.median(&all, k);
+        let largest_sub_problem = |include_equal: bool| {
+            let lower = all
+                .iter()
+                .filter(|p| Self::is_lower(self.value(**p, k), median, include_equal))
+                .count();
+            lower.max(all.len() - lower)
+        };
+        let include_equal = largest_sub_problem(true) <= largest_sub_problem(false);
+        let (best1, best2) = self.split(best, k, median, include_equal);
+        let (worst1, worst2) = self.split(worst, k, median, include_equal);
+        self.helper_b(&best1, &worst1, k);
+        self.helper_b(&best1, &worst2, k - 1);
+        self.helper_b(&best2, &worst2, k);
+    }
+
+    /// Rank the points using the first two objectives with a sweep. The points must be in
+    /// lexicographic order.
+    ///
+    /// # Arguments
+    ///
+    /// * `set`: The points.
+    ///
+    /// returns: `()`
+    fn sweep_a(&mut self, set: &[usize]) {
+        let positions = self.positions(set, set, false);
+        let mut tree = MaxRankTree::new(set.len());
+        for (p, position) in set.iter().zip(positions) {
+            if let Some(rank) = tree.max_rank(position) {
+                self.ranks[*p] = self.ranks[*p].max(rank + 1);
+            }
+            tree.insert(position, self.ranks[*p]);
+        }
+    }
+
+    /// Update the ranks of the points in `worst` dominated by the points in `best` using the
+    /// first two objectives with a sweep. The points must be in lexicographic order.
+    ///
+    /// # Arguments
+    ///
+    /// * `best`: The points that can dominate.
+    /// * `worst`: The points whose rank is updated.
+    ///
+    /// returns: `()`
+    fn sweep_b(&mut self, best: &[usize], worst: &[usize]) {
+        let best_positions = self.positions(best, best, false);
+        let worst_positions = self.positions(best, worst, true);
+        let mut tree = MaxRankTree::new(best.len());
+        let mut next_best = 0;
+        for (h, position) in worst.iter().zip(worst_positions) {
+            while next_best < best.len() && self.value(best[next_best], 0) <= self.value(*h, 0) {
+                tree.insert(best_positions[next_best], self.ranks[best[next_best]]);
+                next_best += 1;
+            }
+            // `position` is the number of points in `best` not worse than `h` in the 2nd
+            // objective
+            if position > 0 {
+                if let Some(rank) = tree.max_rank(position - 1) {
+                    self.ranks[*h] = self.ranks[*h].max(rank + 1);
+                }
+            }
+        }
+    }
+
+    /// For each point in `set`, count the points in `reference` whose 2nd objective is lower
+    /// than (or not larger than, when `inclusive` is `true`) the point value. Points with the same
+    /// value get the same position.
+    ///
+    /// # Arguments
+    ///
+    /// * `reference`: The points defining the positions.
+    /// * `set`: The points.
+    /// * `inclusive`: Whether to count the reference points with the same value.
+    ///
+    /// returns: `Vec<usize>`
+    fn positions(&self, reference: &[usize], set: &[usize], inclusive: bool) -> Vec<usize> {
+        let mut values: Vec<f64> = reference.iter().map(|p| self.value(*p, 1)).collect();
+        values.sort_by(|a, b| a.total_cmp(b));
+        set.iter()
+            .map(|p| {
+                let v = self.value(*p, 1);
+                values.partition_point(|x| *x < v || (inclusive && *x == v))
+            })
+            .collect()
+    }
+
+    /// Get the median of an objective.
+    ///
+    /// # Arguments
+    ///
+    /// * `set`: The points.
+    /// * `k`: The objective index.
+    ///
+    /// returns: `f64`
+    fn median(&self, set: &[usize], k: usize) -> f64 {
+        let mut values: Vec<f64> = set.iter().map(|p| self.value(*p, k)).collect();
+        let mid = values.len() / 2;
+        *values.select_nth_unstable_by(mid, |a, b| a.total_cmp(b)).1
+    }
+
+    /// Split the points in two sets based on the median of an objective. The points equal to the
+    /// median are added to the set that makes the split the most balanced.
+    ///
+    /// # Arguments
+    ///
+    /// * `set`: The points.
+    /// * `k`: The objective index.
+    /// * `median`: The median.
+    ///
+    /// returns: `(Vec<usize>, Vec<usize>)`. The points with the lowest and largest values.
+    fn split_a(&self, set: &[usize], k: usize, median: f64) -> (Vec<usize>, Vec<usize>) {
+        let lower = set.iter().filter(|p| self.value(**p, k) < median).count();
+        let equal = set.iter().filter(|p| self.value(**p, k) == median).count();
+        let upper = set.len() - lower - equal;
+        let include_equal = (lower + equal).abs_diff(upper) <= lower.abs_diff(upper + equal);
+        self.split(set, k, median, include_equal)
+    }
+
+    /// Split the points in two sets based on the median of an objective. The order of the points
+    /// is preserved.
+    ///
+    /// # Arguments
+    ///
+    /// * `set`: The points.
+    /// * `k`: The objective index.
+    /// * `median`: The median.
+    /// * `include_equal`: Whether to add the points equal to the median to the lower set.
+    ///
+    /// returns: `(Vec<usize>, Vec<usize>)`. The points with the lowest and largest values.
+    fn split(
+        &self,
+        set: &[usize],
+        k: usize,
+        median: f64,
+        include_equal: bool,
+    ) -> (Vec<usize>, Vec<usize>) {
+        set.iter()
+            .partition(|p| Self::is_lower(self.value(**p, k), median, include_equal))
+    }
+
+    /// Whether a value belongs to the lower set when splitting the points.
+    ///
+    /// # Arguments
+    ///
+    /// * `value`: The value.
+    /// * `median`: The median.
+    /// * `include_equal`: Whether the values equal to the median belong to the lower set.
+    ///
+    /// returns: `bool`
+    fn is_lower(value: f64, median: f64, include_equal: bool) -> bool {
+        value < median || (include_equal && value == median)
+    }
+}
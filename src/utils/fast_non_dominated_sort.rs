@@ -1,5 +1,6 @@
 use crate::core::{DataValue, Individual, OError};
-use crate::operators::{BinaryComparisonOperator, ParetoConstrainedDominance, PreferredSolution};
+use crate::utils::dominance_kernel::DominanceKernel;
+use crate::utils::efficient_non_dominated_sort::{ens_ranks, jensen_fortin_ranks};
 
 /// Outputs of the non-dominated sort algorithm.
 #[derive(Debug)]
@@ -17,6 +18,81 @@ pub struct NonDominatedSortResults {
     pub domination_counter: Vec<usize>,
 }
 
+/// Outputs of the non-dominated sort algorithm when the individuals are not copied into the
+/// fronts (see [`non_dominated_sort_with`]).
+#[derive(Debug)]
+pub struct NonDominatedSortIndexes {
+    /// A vector containing sub-vectors. Each child vector represents a front (with the first being
+    /// the primary non-dominated front with solutions of rank 1); each child vector contains
+    /// the indexes of the individuals belonging to that front. Each index refers to the vector of
+    /// individuals passed to [`non_dominated_sort_with`].
+    pub front_indexes: Vec<Vec<usize>>,
+    /// The rank of the individual at a given vector index. This is `None` when only the first
+    /// front is calculated and the individual is dominated.
+    pub ranks: Vec<Option<usize>>,
+    /// Number of individuals that dominates a solution at a given vector index. When the counter
+    /// is 0, the solution is non-dominated. This is `n_p` in the paper. This is only available
+    /// with [`NonDominatedSortMethod::Deb`], as the other methods do not compare all the pairs of
+    /// individuals.
+    pub domination_counter: Option<Vec<usize>>,
+}
+
+/// The algorithm used to sort the individuals in [`non_dominated_sort_with`].
+#[derive(Debug, Clone, Copy, PartialEq, Default)]
+pub enum NonDominatedSortMethod {
+    /// The fast non-dominated sort from the NSGA2 paper, with complexity $O(M * N^2)$ and
+    /// $O(N^2)$ memory, where `M` is the number of objectives and `N` the number of individuals.
+    Deb,
+    /// The Efficient Non-dominated Sort with a sequential search of the fronts (ENS-SS), which
+    /// is faster when there are only a few fronts.
+    EnsSequential,
+    /// The Efficient Non-dominated Sort with a binary search of the fronts (ENS-BS), which is
+    /// faster when there are many fronts.
+    EnsBinary,
+    /// The divide-and-conquer sort by Jensen (2003) and Fortin et al. (2013), with complexity
+    /// $O(N * log^{M-1} N)$, which is faster with large populations and 2 or 3 objectives.
+    JensenFortin,
+    /// Select the method based on the number of individuals and objectives.
+    #[default]
+    Auto,
+}
+
+impl NonDominatedSortMethod {
+    /// The minimum number of individuals to use [`NonDominatedSortMethod::JensenFortin`] with 3
+    /// objectives when [`NonDominatedSortMethod::Auto`] is selected.
+    const JENSEN_FORTIN_MIN_INDIVIDUALS_3D: usize = 10_000;
+
+    /// Get the method to use to sort a set of individuals. This resolves
+    /// [`NonDominatedSortMethod::Auto`]: the divide-and-conquer sort is used with 2 objectives and
+    /// with 3 objectives and large populations, ENS-SS otherwise.
+    ///
+    /// # Arguments
+    ///
+    /// * `number_of_individuals`: The number of individuals to sort.
+    /// * `number_of_objectives`: The number of objectives.
+    ///
+    /// returns: `NonDominatedSortMethod`
+    pub fn resolve(
+        &self,
+        number_of_individuals: usize,
+        number_of_objectives: usize,
+    ) -> NonDominatedSortMethod {
+        match self {
+            NonDominatedSortMethod::Auto => {
+                if number_of_objectives == 2
+                    || (number_of_objectives == 3
+                        && number_of_individuals >= Self::JENSEN_FORTIN_MIN_INDIVIDUALS_3D)
+                {
+                    NonDominatedSortMethod::JensenFortin
+                } else {
+                    NonDominatedSortMethod::EnsSequential
+                }
+            }
+            method => *method,
+        }
+    }
+}
+
 /// The data key where the rank is stored for each [`Individual`].
 const RANK_KEY: &str = "rank";
 
@@ -28,6 +104,10 @@ const RANK_KEY: &str = "rank";
 /// to the first front. The method also stores the `rank` property into each individual; to retrieve
 /// it, use `Individual::get_data("rank").unwrap()`.
 ///
+/// This returns a copy of the individuals in each front. When only the indexes are needed (for
+/// example to move the individuals into a new population), use [`non_dominated_sort_indexes`]
+/// or [`non_dominated_sort_with`] instead, which can also use faster sorting algorithms.
+///
 /// Implemented based on paragraph 3A in:
 /// > K. Deb, A. Pratap, S. Agarwal and T. Meyarivan, "A fast and elitist multi-objective genetic
 /// > algorithm: NSGA-II," in IEEE Transactions on Evolutionary Computation, vol. 6, no. 2, pp.
@@ -45,6 +125,68 @@ pub fn fast_non_dominated_sort(
     individuals: &mut [Individual],
     first_front_only: bool,
 ) -> Result<NonDominatedSortResults, OError> {
+    let results =
+        non_dominated_sort_with(individuals, first_front_only, NonDominatedSortMethod::Deb)?;
+
+    // map index to individuals
+    let fronts = results
+        .front_indexes
+        .iter()
+        .map(|front| front.iter().map(|i| individuals[*i].clone()).collect())
+        .collect();
+
+    Ok(NonDominatedSortResults {
+        fronts,
+        front_indexes: results.front_indexes,
+        domination_counter: results.domination_counter.unwrap_or_default(),
+    })
+}
+
+/// Sort the individuals by non-domination. This is [`fast_non_dominated_sort`], but only the front
+/// indexes and the ranks are returned and no individual is copied. The method to sort the
+/// individuals is selected with [`NonDominatedSortMethod::Auto`]. The `rank` property is still
+/// stored into each individual.
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals to sort by dominance.
+/// * `first_front_only`: Return the first front only with the rank 1 (i.e. containing only
+///    non-dominated individuals). If you need only the first front set this to true to avoid
+///    ranking the remaining individuals.
+///
+/// returns: `Result<NonDominatedSortIndexes, OError>`.
+pub fn non_dominated_sort_indexes(
+    individuals: &mut [Individual],
+    first_front_only: bool,
+) -> Result<NonDominatedSortIndexes, OError> {
+    non_dominated_sort_with(individuals, first_front_only, NonDominatedSortMethod::Auto)
+}
+
+/// Sort the individuals by non-domination with the given method. All methods use the constrained
+/// dominance of [`crate::operators::ParetoConstrainedDominance`] and return the same fronts and
+/// ranks, but the individuals are listed in ascending index order in each front, except with
+/// [`NonDominatedSortMethod::Deb`]. The `rank` property is stored into each individual.
+///
+/// With constrained dominance, an individual is dominated by all the individuals with a lower
+/// constraint violation. The methods other than [`NonDominatedSortMethod::Deb`] therefore group
+/// the individuals with the same violation, rank each group using the Pareto dominance only and
+/// shift the ranks of each group after the fronts of the groups with a lower violation.
+/// [`NonDominatedSortMethod::Deb`] is always used when an objective or a constraint violation is
+/// NaN.
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals to sort by dominance.
+/// * `first_front_only`: Return the first front only with the rank 1 (i.e. containing only
+///    non-dominated individuals).
+/// * `method`: The sorting algorithm.
+///
+/// returns: `Result<NonDominatedSortIndexes, OError>`.
+pub fn non_dominated_sort_with(
+    individuals: &mut [Individual],
+    first_front_only: bool,
+    method: NonDominatedSortMethod,
+) -> Result<NonDominatedSortIndexes, OError> {
     if individuals.len() < 2 {
         return Err(OError::SurvivalOperator(
             "fast non-dominated sort".to_string(),
@@ -55,114 +197,193 @@ pub fn fast_non_dominated_sort(
         ));
     }
 
-    // this set contains all the individuals being dominated by an individual `p`.This is `S_p` in
-    // the paper
-    let mut dominated_solutions: Vec<Vec<usize>> = individuals.iter().map(|_| Vec::new()).collect();
-    // number of individuals that dominates `p`. When the counter is 0, `p` is non-dominated. This
-    // is `n_p` in the paper
-    let mut domination_counter: Vec<usize> = individuals.iter().map(|_| 0).collect();
+    let violations: Vec<f64> = individuals
+        .iter()
+        .map(|ind| ind.constraint_violation())
+        .collect();
+    let has_nan = violations.iter().any(|v| v.is_nan())
+        || individuals
+            .iter()
+            .any(|ind| ind.objective_values_slice().iter().any(|v| v.is_nan()));
+    if method == NonDominatedSortMethod::Deb || has_nan {
+        return deb_non_dominated_sort(individuals, first_front_only);
+    }
 
-    // the front of given rank containing non-dominated solutions
-    let mut current_front: Vec<usize> = Vec::new();
-    // the vector with all fronts of sorted ranks. The first item has rank 1 and subsequent elements
-    // have increasing rank
-    let mut all_fronts: Vec<Vec<usize>> = Vec::new();
-
-    for pi in 0..individuals.len() {
-        for qi in pi..individuals.len() {
-            match ParetoConstrainedDominance::compare(&individuals[pi], &individuals[qi])? {
-                PreferredSolution::First => {
-                    // `p` dominates `q` - add `q` to the set of solutions dominated by `p`
-                    dominated_solutions[pi].push(qi);
-                    domination_counter[qi] += 1;
-                }
-                PreferredSolution::Second => {
-                    // q dominates p
-                    dominated_solutions[qi].push(pi);
-                    domination_counter[pi] += 1;
-                }
-                PreferredSolution::MutuallyPreferred => {
-                    // skip this
-                }
+    // group the individuals by constraint violation. The individuals in a group dominate all
+    // the individuals in the following groups
+    let mut order: Vec<usize> = (0..individuals.len()).collect();
+    order.sort_by(|a, b| violations[*a].total_cmp(&violations[*b]));
+
+    let number_of_objectives = individuals[0].objective_values_slice().len();
+    let mut ranks: Vec<Option<usize>> = vec![None; individuals.len()];
+    let mut rank_offset = 0;
+    for group in order.chunk_by(|a, b| violations[*a] == violations[*b]) {
+        let points: Vec<f64> = group
+            .iter()
+            .flat_map(|i| individuals[*i].objective_values_slice().iter().copied())
+            .collect();
+        let group_ranks = match method.resolve(group.len(), number_of_objectives) {
+            NonDominatedSortMethod::EnsBinary => ens_ranks(&points, number_of_objectives, true),
+            NonDominatedSortMethod::JensenFortin => {
+                jensen_fortin_ranks(&points, number_of_objectives)
             }
+            _ => ens_ranks(&points, number_of_objectives, false),
+        };
+
+        let mut number_of_fronts = 0;
+        for (i, rank) in group.iter().zip(group_ranks) {
+            ranks[*i] = Some(rank_offset + rank + 1);
+            number_of_fronts = number_of_fronts.max(rank + 1);
+        }
+        rank_offset += number_of_fronts;
+
+        // the first front belongs to the group with the lowest violation
+        if first_front_only {
+            break;
         }
+    }
 
-        // the solution `p` is non-dominated by any other and this solution belongs to the first
-        // front whose items have rank 1
-        if domination_counter[pi] == 0 {
-            current_front.push(pi);
-            individuals[pi].set_data(RANK_KEY, DataValue::Integer(1));
+    let mut front_indexes: Vec<Vec<usize>> = vec![Vec::new(); rank_offset];
+    for (i, rank) in ranks.iter_mut().enumerate() {
+        if first_front_only && *rank != Some(1) {
+            *rank = None;
+        }
+        if let Some(rank) = rank {
+            front_indexes[*rank - 1].push(i);
+            individuals[i].set_data(RANK_KEY, DataValue::Integer(*rank as i64));
         }
     }
+    if first_front_only {
+        front_indexes.truncate(1);
+    }
+
+    Ok(NonDominatedSortIndexes {
+        front_indexes,
+        ranks,
+        domination_counter: None,
+    })
+}
+
+/// Non-dominated fast sorting from NSGA2 paper. See [`fast_non_dominated_sort`]. The dominance
+/// relation of all the pairs of individuals is calculated in parallel by [`DominanceKernel`].
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals to sort by dominance.
+/// * `first_front_only`: Return the first front only with the rank 1.
+///
+/// returns: `Result<NonDominatedSortIndexes, OError>`.
+fn deb_non_dominated_sort(
+    individuals: &mut [Individual],
+    first_front_only: bool,
+) -> Result<NonDominatedSortIndexes, OError> {
+    // this set contains all the individuals being dominated by an individual `p` (this is `S_p`
+    // in the paper) and the number of individuals that dominates `p` (when the counter is 0, `p`
+    // is non-dominated; this is `n_p` in the paper)
+    let (dominated_solutions, domination_counter) =
+        DominanceKernel::new(individuals).dominance_lists();
+    let mut ranks: Vec<Option<usize>> = vec![None; individuals.len()];
+
+    // the solutions non-dominated by any other belong to the first front whose items have rank 1
+    let first_front: Vec<usize> = (0..individuals.len())
+        .filter(|pi| domination_counter[*pi] == 0)
+        .collect();
+    for pi in first_front.iter() {
+        ranks[*pi] = Some(1);
+        individuals[*pi].set_data(RANK_KEY, DataValue::Integer(1));
+    }
 
     // early return
     if first_front_only {
-        let first_front = current_front
-            .iter()
-            .map(|idx| individuals[*idx].clone())
-            .collect();
-        return Ok(NonDominatedSortResults {
-            fronts: vec![first_front],
-            front_indexes: vec![current_front],
-            domination_counter,
+        return Ok(NonDominatedSortIndexes {
+            front_indexes: vec![first_front],
+            ranks,
+            domination_counter: Some(domination_counter),
         });
     }
-    all_fronts.push(current_front.clone());
-    let e_domination_counter = domination_counter.clone();
+
+    // the vector with all fronts of sorted ranks. The first item has rank 1 and subsequent elements
+    // have increasing rank
+    let mut all_fronts: Vec<Vec<usize>> = vec![first_front];
+    // the counter is decremented while the fronts are collected
+    let mut remaining_counter = domination_counter.clone();
 
     // collect the other fronts
-    let mut i = 1;
+    let mut rank = 2;
     loop {
         let mut next_front: Vec<usize> = Vec::new();
         // loop individuals in the current non-dominated front
-        for pi in current_front.iter() {
+        for pi in all_fronts.last().unwrap().iter() {
             // loop solutions that are dominated by `p` in the current front
             for qi in dominated_solutions[*pi].iter() {
                 // decrement the domination count for individual `q`
-                domination_counter[*qi] -= 1;
+                remaining_counter[*qi] -= 1;
 
                 // if counter is 0 then none of the individuals in the subsequent fronts are
                 // dominated by `p` and `q` belongs to the next front
-                if domination_counter[*qi] == 0 {
+                if remaining_counter[*qi] == 0 {
                     next_front.push(*qi);
-                    individuals[*qi].set_data(RANK_KEY, DataValue::Integer(i + 1));
+                    ranks[*qi] = Some(rank);
+                    individuals[*qi].set_data(RANK_KEY, DataValue::Integer(rank as i64));
                 }
             }
         }
-        i += 1;
+        rank += 1;
 
         // stop when all solutions have been ranked
         if next_front.is_empty() {
             break;
         }
-
-        all_fronts.push(next_front.clone());
-        current_front = next_front;
+        all_fronts.push(next_front);
     }
 
-    // map index to individuals
-    let mut fronts: Vec<Vec<Individual>> = Vec::new();
-    for front in &all_fronts {
-        let mut sub_front: Vec<Individual> = Vec::new();
-        for i in front {
-            sub_front.push(individuals[*i].clone());
-        }
-        fronts.push(sub_front);
-    }
-
-    Ok(NonDominatedSortResults {
-        fronts,
+    Ok(NonDominatedSortIndexes {
         front_indexes: all_fronts,
-        domination_counter: e_domination_counter,
+        ranks,
+        domination_counter: Some(domination_counter),
     })
 }
 
+/// Move the individuals into their fronts without copying them. Individuals that do not belong
+/// to any front are dropped.
+///
+/// # Arguments
+///
+/// * `individuals`: The individuals that were sorted with [`non_dominated_sort_indexes`].
+/// * `front_indexes`: The front indexes from [`NonDominatedSortIndexes::front_indexes`].
+///
+/// returns: `Vec<Vec<Individual>>`. The individuals in each front.
+pub fn split_into_fronts(
+    individuals: Vec<Individual>,
+    front_indexes: &[Vec<usize>],
+) -> Vec<Vec<Individual>> {
+    let mut individuals: Vec<Option<Individual>> = individuals.into_iter().map(Some).collect();
+    front_indexes
+        .iter()
+        .map(|front| {
+            front
+                .iter()
+                .filter_map(|i| individuals.get_mut(*i).and_then(Option::take))
+                .collect()
+        })
+        .collect()
+}
+
 #[cfg(test)]
 mod test {
+    use std::sync::Arc;
+
     use crate::core::test_utils::individuals_from_obj_values_dummy;
-    use crate::core::{DataValue, ObjectiveDirection};
-    use crate::utils::fast_non_dominated_sort;
+    use crate::core::utils::dummy_evaluator;
+    use crate::core::{
+        BoundedNumber, Constraint, DataValue, Individual, Objective, ObjectiveDirection, Problem,
+        RelationalOperator, VariableType,
+    };
     use crate::utils::fast_non_dominated_sort::RANK_KEY;
+    use crate::utils::{
+        fast_non_dominated_sort, non_dominated_sort_indexes, non_dominated_sort_with,
+        split_into_fronts, NonDominatedSortMethod,
+    };
 
     #[test]
     /// Test the non-dominated sorting. The resulting fronts and ranks were manually calculated by
@@ -362,4 +583,123 @@ mod test {
         assert_eq!(result.domination_counter[0], 2);
         assert_eq!(result.domination_counter[3], 1);
     }
+
+    #[test]
+    /// Test that the index-based sorting returns the same fronts and ranks and that the
+    /// individuals can be moved into the fronts.
+    fn test_sorting_indexes() {
+        let objectives = vec![
+            vec![2.1, 3.1, 4.1],
+            vec![-1.1, 4.1, 8.1],
+            vec![0.1, -1.1, -2.1],
+            vec![0.1, 0.1, 0.1],
+        ];
+        let mut individuals = individuals_from_obj_values_dummy(
+            &objectives,
+            &[
+                ObjectiveDirection::Minimise,
+                ObjectiveDirection::Minimise,
+                ObjectiveDirection::Minimise,
+            ],
+            None,
+        );
+        let expected = fast_non_dominated_sort(&mut individuals, false).unwrap();
+        let result = non_dominated_sort_indexes(&mut individuals, false).unwrap();
+        assert_eq!(result.front_indexes, expected.front_indexes);
+        assert_eq!(result.domination_counter, None);
+        assert_eq!(result.ranks, vec![Some(3), Some(1), Some(1), Some(2)]);
+
+        let fronts = split_into_fronts(individuals, &result.front_indexes);
+        assert_eq!(fronts, expected.fronts);
+
+        // dominated individuals are not ranked
+        let mut individuals = individuals_from_obj_values_dummy(
+            &objectives,
+            &[
+                ObjectiveDirection::Minimise,
+                ObjectiveDirection::Minimise,
+                ObjectiveDirection::Minimise,
+            ],
+            None,
+        );
+        let result = non_dominated_sort_indexes(&mut individuals, true).unwrap();
+        assert_eq!(result.front_indexes, vec![vec![1, 2]]);
+        assert_eq!(result.ranks, vec![None, Some(1), Some(1), None]);
+        let fronts = split_into_fronts(individuals, &result.front_indexes);
+        assert_eq!(fronts.len(), 1);
+        assert_eq!(fronts[0].len(), 2);
+    }
+
+    #[test]
+    /// Test that all the sorting methods return the same ranks as the NSGA2 sort, with
+    /// duplicated objective values and infeasible individuals.
+    fn test_sorting_methods() {
+        for number_of_objectives in 2..=4 {
+            let objectives = (0..number_of_objectives)
+                .map(|i| Objective::new(format!("obj{i}").as_str(), ObjectiveDirection::Minimise))
+                .collect();
+            let variables = vec![VariableType::Real(
+                BoundedNumber::new("X", 0.0, 2.0).unwrap(),
+            )];
+            let constraints = vec![Constraint::new(
+                "c1",
+                RelationalOperator::LessOrEqualTo,
+                5.0,
+            )];
+            let problem = Arc::new(
+                Problem::new(objectives, variables, Some(constraints), dummy_evaluator()).unwrap(),
+            );
+
+            // pseudo-random values with ties
+            let mut state: u64 = 11;
+            let mut next = || {
+                state = state
+                    .wrapping_mul(6364136223846793005)
+                    .wrapping_add(1442695040888963407);
+                ((state >> 33) % 8) as f64
+            };
+            let mut individuals: Vec<Individual> = (0..150)
+                .map(|_| {
+                    let mut ind = Individual::new(problem.clone());
+                    for o in 0..number_of_objectives {
+                        ind.update_objective(format!("obj{o}").as_str(), next())
+                            .unwrap();
+                    }
+                    ind.update_constraint("c1", next()).unwrap();
+                    ind
+                })
+                .collect();
+
+            let expected =
+                non_dominated_sort_with(&mut individuals, false, NonDominatedSortMethod::Deb)
+                    .unwrap();
+            assert!(expected.front_indexes.len() > 3);
+            for method in [
+                NonDominatedSortMethod::EnsSequential,
+                NonDominatedSortMethod::EnsBinary,
+                NonDominatedSortMethod::JensenFortin,
+                NonDominatedSortMethod::Auto,
+            ] {
+                let result = non_dominated_sort_with(&mut individuals, false, method).unwrap();
+                assert_eq!(result.ranks, expected.ranks, "{method:?}");
+                for (front, expected_front) in
+                    result.front_indexes.iter().zip(&expected.front_indexes)
+                {
+                    let mut expected_front = expected_front.clone();
+                    expected_front.sort();
+                    assert_eq!(*front, expected_front, "{method:?}");
+                }
+                for (ind, rank) in individuals.iter().zip(&result.ranks) {
+                    assert_eq!(
+                        ind.get_data(RANK_KEY).unwrap(),
+                        DataValue::Integer(rank.unwrap() as i64)
+                    );
+                }
+
+                let first = non_dominated_sort_with(&mut individuals, true, method).unwrap();
+                assert_eq!(first.front_indexes.len(), 1);
+                assert_eq!(first.front_indexes[0], result.front_indexes[0]);
+            }
+        }
+    }
 }
@@ -0,0 +1,135 @@
+//! Kernels specialised at compile time for problems with few objectives. Most problems have 2 to 4
+//! objectives; with the number of objectives `M` known at compile time, the objective values of
+//! an individual are a `[f64; M]` row and the loops over the objectives are fully unrolled and
+//! branch-free. The generic kernels on slices are used for the other problems.
+
+/// Evaluate an expression with the number of objectives as a constant when this is between 2 and
+/// 4, or a generic expression otherwise. The number of objectives is matched once, so that the
+/// specialised kernel can be used for all the individuals.
+///
+/// # Arguments
+///
+/// * `$number_of_objectives`: The number of objectives.
+/// * `$M`: The name of the constant bound to the number of objectives in `$fixed`.
+/// * `$fixed`: The expression to evaluate with 2 to 4 objectives.
+/// * `$generic`: The expression to evaluate otherwise.
+macro_rules! with_fixed_objectives {
+    ($number_of_objectives: expr, |$M: ident| $fixed: expr, $generic: expr) => {
+        match $number_of_objectives {
+            2 => {
+                const $M: usize = 2;
+                $fixed
+            }
+            3 => {
+                const $M: usize = 3;
+                $fixed
+            }
+            4 => {
+                const $M: usize = 4;
+                $fixed
+            }
+            _ => $generic,
+        }
+    };
+}
+
+pub(crate) use with_fixed_objectives;
+
+/// The number of objectives compared at once by [`pareto_flags`]. The comparisons in a chunk are
+/// branch-free so that they can be vectorised.
+const LANES: usize = 4;
+
+/// Compare the objectives of two individuals with a fixed number of objectives `M`. All
+/// objectives are assumed to be minimised.
+///
+/// # Arguments
+///
+/// * `a`: The objective values of the first individual.
+/// * `b`: The objective values of the second individual.
+///
+/// returns: `(bool, bool)`. Whether at least one objective of `a` is better than the one of `b`
+/// and whether at least one objective of `a` is worse. `a` dominates `b` when only the first flag
+/// is `true`.
+#[inline(always)]
+pub(crate) fn pareto_flags_fixed<const M: usize>(a: &[f64; M], b: &[f64; M]) -> (bool, bool) {
+    let mut better = false;
+    let mut worse = false;
+    for k in 0..M {
+        better |= a[k] < b[k];
+        worse |= a[k] > b[k];
+    }
+    (better, worse)
+}
+
+/// Compare the objectives of two individuals with any number of objectives. This stops as soon
+/// as the individuals are known not to dominate each other. All objectives are assumed to be
+/// minimised.
+///
+/// # Arguments
+///
+/// * `a`: The objective values of the first individual.
+/// * `b`: The objective values of the second individual.
+///
+/// returns: `(bool, bool)`. See [`pareto_flags_fixed`].
+#[inline]
+pub(crate) fn pareto_flags(a: &[f64], b: &[f64]) -> (bool, bool) {
+    let mut better = false;
+    let mut worse = false;
+    for (chunk_a, chunk_b) in a.chunks(LANES).zip(b.chunks(LANES)) {
+        for (x, y) in chunk_a.iter().zip(chunk_b) {
+            better |= x < y;
+            worse |= x > y;
+        }
+        if better && worse {
+            break;
+        }
+    }
+    (better, worse)
+}
+
+/// Get the row with the `M` objective values of an individual from a row-major matrix.
+///
+/// # Arguments
+///
+/// * `values`: The objective values of all the individuals.
+/// * `index`: The individual index.
+///
+/// returns: `&[f64; M]`
+#[inline(always)]
+pub(crate) fn row<const M: usize>(values: &[f64], index: usize) -> &[f64; M] {
+    values[index * M..(index + 1) * M].try_into().unwrap()
+}
+
+#[cfg(test)]
+mod test {
+    use crate::utils::fixed_objectives::{pareto_flags, pareto_flags_fixed, row};
+
+    #[test]
+    /// The specialised comparison gives the same flags as the generic one, also with NaNs.
+    fn test_pareto_flags() {
+        let values = [0.0, 1.0, 2.0, f64::NAN];
+        let mut state: u64 = 3;
+        let mut next = || {
+            state = state
+                .wrapping_mul(6364136223846793005)
+                .wrapping_add(1442695040888963407);
+            values[((state >> 33) % 4) as usize]
+        };
+        for _ in 0..500 {
+            let points: Vec<f64> = (0..8).map(|_| next()).collect();
+            let (a, b) = points.split_at(4);
+            assert_eq!(
+                pareto_flags_fixed::<2>(row(a, 0), row(b, 0)),
+                pareto_flags(&a[..2], &b[..2])
+            );
+            assert_eq!(
+                pareto_flags_fixed::<3>(row(a, 0), row(b, 0)),
+                pareto_flags(&a[..3], &b[..3])
+            );
+            assert_eq!(
+                pareto_flags_fixed::<4>(row(a, 0), row(b, 0)),
+                pareto_flags(a, b)
+            );
+        }
+    }
+}
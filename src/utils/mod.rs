@@ -6,13 +6,19 @@ pub use algebra::{
     dot_product, perpendicular_distance, solve_linear_system, vector_magnitude,
     LinearSolverTolerance,
 };
-pub use fast_non_dominated_sort::{fast_non_dominated_sort, NonDominatedSortResults};
+pub use fast_non_dominated_sort::{
+    fast_non_dominated_sort, non_dominated_sort_indexes, non_dominated_sort_with,
+    split_into_fronts, NonDominatedSortIndexes, NonDominatedSortMethod, NonDominatedSortResults,
+};
 pub use reference_points::{DasDarren1998, NumberOfPartitions, TwoLayerPartitions};
 
 use crate::core::OError;
 
 mod algebra;
+mod dominance_kernel;
+mod efficient_non_dominated_sort;
 mod fast_non_dominated_sort;
+pub(crate) mod fixed_objectives;
 mod reference_points;
 
 /// Define the sort type
@@ -131,6 +137,22 @@ where
     })
 }
 
+/// Check if two vectors of numbers are equal. Unlike `==`, this treats two NaNs at the same
+/// position as equal.
+///
+/// # Arguments
+///
+/// * `a`: The first vector.
+/// * `b`: The second vector.
+///
+/// returns: `bool`
+pub fn vector_eq_with_nans(a: &[f64], b: &[f64]) -> bool {
+    a.len() == b.len()
+        && a.iter()
+            .zip(b)
+            .all(|(x, y)| (x.is_nan() && y.is_nan()) || x == y)
+}
+
 /// Return the vector items and its index corresponding to the minimum value returned by the closure.
 ///
 /// # Arguments